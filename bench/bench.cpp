@@ -0,0 +1,60 @@
+/*
+MIT License
+
+Copyright (c) 2018-2026 Zlatko Michailov 
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "inc/bench.h"
+
+
+double ops_per_sec(const bench_result& result) {
+    return result.elapsed_ns > 0 ? result.item_count * 1e9 / result.elapsed_ns : 0.0;
+}
+
+
+void write_json(std::ostream& stream, const bench_results& results) {
+    stream << "[\n";
+
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const bench_result& result = results[i];
+
+        stream << abc::strprintf("  { \"scenario\": \"%s\", \"item_count\": %zu, \"max_mapped_page_count\": %zu, \"elapsed_ns\": %llu, \"ops_per_sec\": %.1f, "
+                                 "\"map_hit_count\": %llu, \"map_miss_count\": %llu, \"eviction_count\": %llu }%s\n",
+                    result.scenario.c_str(), result.item_count, result.max_mapped_page_count, (unsigned long long)result.elapsed_ns, ops_per_sec(result),
+                    (unsigned long long)result.map_hit_count, (unsigned long long)result.map_miss_count, (unsigned long long)result.eviction_count,
+                    i + 1 < results.size() ? "," : "");
+    }
+
+    stream << "]\n";
+}
+
+
+void write_csv(std::ostream& stream, const bench_results& results) {
+    stream << "scenario,item_count,max_mapped_page_count,elapsed_ns,ops_per_sec,map_hit_count,map_miss_count,eviction_count\n";
+
+    for (const bench_result& result : results) {
+        stream << abc::strprintf("%s,%zu,%zu,%llu,%.1f,%llu,%llu,%llu\n",
+                    result.scenario.c_str(), result.item_count, result.max_mapped_page_count, (unsigned long long)result.elapsed_ns, ops_per_sec(result),
+                    (unsigned long long)result.map_hit_count, (unsigned long long)result.map_miss_count, (unsigned long long)result.eviction_count);
+    }
+}
@@ -0,0 +1,99 @@
+/*
+MIT License
+
+Copyright (c) 2018-2026 Zlatko Michailov 
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "../../src/vmem/all.h"
+
+
+/**
+ * @brief Settings passed in on the command line.
+ */
+struct bench_config {
+    /**
+     * @brief Directory where pool files are created.
+     */
+    std::string out_dir = "out/bench";
+
+    /**
+     * @brief Item counts, from `min_item_count` to `max_item_count`, multiplied by 10 at each step.
+     */
+    std::size_t min_item_count = 10000;
+    std::size_t max_item_count = 1000000;
+
+    /**
+     * @brief `max_mapped_page_count` values to run each scenario with.
+     */
+    std::vector<std::size_t> max_mapped_page_counts = { 16, 1024 };
+};
+
+
+/**
+ * @brief Measurement of a single scenario run.
+ */
+struct bench_result {
+    std::string   scenario;
+    std::size_t   item_count;
+    std::size_t   max_mapped_page_count;
+    std::uint64_t elapsed_ns;
+
+    /**
+     * @brief Pool stats accumulated during the run.
+     */
+    std::uint64_t map_hit_count;
+    std::uint64_t map_miss_count;
+    std::uint64_t eviction_count;
+};
+
+using bench_results = std::vector<bench_result>;
+
+
+/**
+ * @brief Measures the elapsed time since construction.
+ */
+class bench_timer {
+public:
+    bench_timer() noexcept
+        : _start(std::chrono::steady_clock::now()) {
+    }
+
+    std::uint64_t elapsed_ns() const noexcept {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _start).count());
+    }
+
+private:
+    std::chrono::steady_clock::time_point _start;
+};
+
+
+void write_json(std::ostream& stream, const bench_results& results);
+void write_csv(std::ostream& stream, const bench_results& results);
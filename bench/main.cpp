@@ -0,0 +1,114 @@
+/*
+MIT License
+
+Copyright (c) 2018-2026 Zlatko Michailov 
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "inc/bench.h"
+#include "inc/vmem.h"
+
+
+using bench_func = void (*)(const bench_config& config, std::size_t item_count, std::size_t max_mapped_page_count, bench_results& results);
+
+bool parse_args(int argc, const char* argv[], bench_config& config);
+
+
+int main(int argc, const char* argv[]) {
+    bench_config config;
+    if (!parse_args(argc, argv, config)) {
+        std::cerr << "Usage: " << argv[0] << " [--out-dir <dir>] [--min-items <count>] [--max-items <count>] [--pages <count>[,<count>...]]" << std::endl;
+        return 1;
+    }
+
+    const bench_func funcs[] = {
+        bench_vmem_map_insert_seq,
+        bench_vmem_map_insert_rand,
+        bench_vmem_list,
+    };
+
+    bench_results results;
+
+    for (std::size_t max_mapped_page_count : config.max_mapped_page_counts) {
+        for (std::size_t item_count = config.min_item_count; item_count <= config.max_item_count; item_count *= 10) {
+            for (bench_func func : funcs) {
+                std::size_t result_count = results.size();
+                func(config, item_count, max_mapped_page_count, results);
+
+                for (std::size_t i = result_count; i < results.size(); i++) {
+                    const bench_result& result = results[i];
+                    std::cout << abc::strprintf("%-16s items=%-10zu pages=%-6zu %12.3f ms  misses=%-10llu evictions=%llu",
+                                    result.scenario.c_str(), result.item_count, result.max_mapped_page_count, result.elapsed_ns / 1e6,
+                                    (unsigned long long)result.map_miss_count, (unsigned long long)result.eviction_count) << std::endl;
+                }
+            }
+        }
+    }
+
+    std::ofstream json(config.out_dir + "/vmem.json");
+    write_json(json, results);
+
+    std::ofstream csv(config.out_dir + "/vmem.csv");
+    write_csv(csv, results);
+
+    return json.good() && csv.good() ? 0 : 1;
+}
+
+
+bool parse_args(int argc, const char* argv[], bench_config& config) {
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 == argc) {
+            return false;
+        }
+
+        const char* value = argv[++i];
+
+        if (std::strcmp(argv[i - 1], "--out-dir") == 0) {
+            config.out_dir = value;
+        }
+        else if (std::strcmp(argv[i - 1], "--min-items") == 0) {
+            config.min_item_count = std::strtoull(value, nullptr, 10);
+        }
+        else if (std::strcmp(argv[i - 1], "--max-items") == 0) {
+            config.max_item_count = std::strtoull(value, nullptr, 10);
+        }
+        else if (std::strcmp(argv[i - 1], "--pages") == 0) {
+            config.max_mapped_page_counts.clear();
+            for (char* end = const_cast<char*>(value); *value != '\0'; value = end + (*end == ',' ? 1 : 0)) {
+                config.max_mapped_page_counts.push_back(std::strtoull(value, &end, 10));
+                if (end == value) {
+                    return false;
+                }
+            }
+        }
+        else {
+            return false;
+        }
+    }
+
+    return config.min_item_count > 0 && config.min_item_count <= config.max_item_count && !config.max_mapped_page_counts.empty();
+}
@@ -0,0 +1,261 @@
+/*
+MIT License
+
+Copyright (c) 2018-2026 Zlatko Michailov 
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include <cstdio>
+#include <random>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "inc/vmem.h"
+
+
+using map_type = abc::vmem::map<std::uint64_t, std::uint64_t>;
+using list_type = abc::vmem::list<std::uint64_t>;
+
+constexpr std::uint64_t random_seed = 0x5eed;
+
+// Keeps the compiler from optimizing the measured loops away.
+volatile std::uint64_t sink;
+
+
+map_type::value_type make_item(std::uint64_t key, std::uint64_t value);
+std::string make_file_path(const bench_config& config, const char* name, std::size_t item_count, std::size_t max_mapped_page_count);
+void drop_file_cache(const std::string& file_path);
+void add_result(bench_results& results, const char* scenario, std::size_t item_count, std::size_t max_mapped_page_count,
+                const bench_timer& timer, const abc::vmem::pool_stats& stats_before, const abc::vmem::pool_stats& stats_after);
+
+
+void bench_vmem_map_insert_seq(const bench_config& config, std::size_t item_count, std::size_t max_mapped_page_count, bench_results& results) {
+    std::string file_path = make_file_path(config, "map_seq", item_count, max_mapped_page_count);
+    std::remove(file_path.c_str());
+
+    {
+        abc::vmem::pool pool(abc::vmem::pool_config(file_path.c_str(), max_mapped_page_count));
+        abc::vmem::page start_page(&pool, abc::vmem::page_pos_start, nullptr);
+        map_type map(reinterpret_cast<abc::vmem::map_state*>(start_page.ptr()), &pool, nullptr);
+
+        {
+            abc::vmem::pool_stats stats_before = pool.stats();
+            bench_timer timer;
+
+            for (std::uint64_t i = 0; i < item_count; i++) {
+                map.insert(make_item(i, i));
+            }
+
+            add_result(results, "map_insert_seq", item_count, max_mapped_page_count, timer, stats_before, pool.stats());
+        }
+
+        {
+            abc::vmem::pool_stats stats_before = pool.stats();
+            bench_timer timer;
+
+            std::size_t found_count = 0;
+            for (std::uint64_t i = 0; i < item_count; i++) {
+                found_count += map.contains(i) ? 1 : 0;
+            }
+            sink = found_count;
+
+            add_result(results, "map_find_seq", item_count, max_mapped_page_count, timer, stats_before, pool.stats());
+        }
+
+        {
+            abc::vmem::pool_stats stats_before = pool.stats();
+            bench_timer timer;
+
+            std::uint64_t sum = 0;
+            for (map_type::const_iterator itr = map.cbegin(); itr != map.cend(); itr++) {
+                sum += itr->value;
+            }
+            sink = sum;
+
+            add_result(results, "map_scan_warm", item_count, max_mapped_page_count, timer, stats_before, pool.stats());
+        }
+    }
+
+    // Reopen the pool after the OS has dropped the file from its cache.
+    drop_file_cache(file_path);
+
+    {
+        abc::vmem::pool pool(abc::vmem::pool_config(file_path.c_str(), max_mapped_page_count));
+        abc::vmem::page start_page(&pool, abc::vmem::page_pos_start, nullptr);
+        map_type map(reinterpret_cast<abc::vmem::map_state*>(start_page.ptr()), &pool, nullptr);
+
+        abc::vmem::pool_stats stats_before = pool.stats();
+        bench_timer timer;
+
+        std::uint64_t sum = 0;
+        for (map_type::const_iterator itr = map.cbegin(); itr != map.cend(); itr++) {
+            sum += itr->value;
+        }
+        sink = sum;
+
+        add_result(results, "map_scan_cold", item_count, max_mapped_page_count, timer, stats_before, pool.stats());
+    }
+
+    std::remove(file_path.c_str());
+}
+
+
+void bench_vmem_map_insert_rand(const bench_config& config, std::size_t item_count, std::size_t max_mapped_page_count, bench_results& results) {
+    std::string file_path = make_file_path(config, "map_rand", item_count, max_mapped_page_count);
+    std::remove(file_path.c_str());
+
+    {
+        abc::vmem::pool pool(abc::vmem::pool_config(file_path.c_str(), max_mapped_page_count));
+        abc::vmem::page start_page(&pool, abc::vmem::page_pos_start, nullptr);
+        map_type map(reinterpret_cast<abc::vmem::map_state*>(start_page.ptr()), &pool, nullptr);
+
+        {
+            std::mt19937_64 random(random_seed);
+            abc::vmem::pool_stats stats_before = pool.stats();
+            bench_timer timer;
+
+            for (std::size_t i = 0; i < item_count; i++) {
+                std::uint64_t key = random();
+                map.insert(make_item(key, i));
+            }
+
+            add_result(results, "map_insert_rand", item_count, max_mapped_page_count, timer, stats_before, pool.stats());
+        }
+
+        {
+            // Replaying the same sequence looks up existing keys in random order.
+            std::mt19937_64 random(random_seed);
+            abc::vmem::pool_stats stats_before = pool.stats();
+            bench_timer timer;
+
+            std::size_t found_count = 0;
+            for (std::size_t i = 0; i < item_count; i++) {
+                found_count += map.contains(random()) ? 1 : 0;
+            }
+            sink = found_count;
+
+            add_result(results, "map_find_rand", item_count, max_mapped_page_count, timer, stats_before, pool.stats());
+        }
+    }
+
+    std::remove(file_path.c_str());
+}
+
+
+void bench_vmem_list(const bench_config& config, std::size_t item_count, std::size_t max_mapped_page_count, bench_results& results) {
+    std::string file_path = make_file_path(config, "list", item_count, max_mapped_page_count);
+    std::remove(file_path.c_str());
+
+    {
+        abc::vmem::pool pool(abc::vmem::pool_config(file_path.c_str(), max_mapped_page_count));
+        abc::vmem::page start_page(&pool, abc::vmem::page_pos_start, nullptr);
+        list_type list(reinterpret_cast<abc::vmem::list_state*>(start_page.ptr()), &pool, nullptr);
+
+        {
+            abc::vmem::pool_stats stats_before = pool.stats();
+            bench_timer timer;
+
+            for (std::uint64_t i = 0; i < item_count; i++) {
+                list.push_back(i);
+            }
+
+            add_result(results, "list_push_back", item_count, max_mapped_page_count, timer, stats_before, pool.stats());
+        }
+
+        {
+            abc::vmem::pool_stats stats_before = pool.stats();
+            bench_timer timer;
+
+            std::uint64_t sum = 0;
+            for (list_type::const_iterator itr = list.cbegin(); itr != list.cend(); itr++) {
+                sum += *itr;
+            }
+            sink = sum;
+
+            add_result(results, "list_scan_warm", item_count, max_mapped_page_count, timer, stats_before, pool.stats());
+        }
+    }
+
+    // Reopen the pool after the OS has dropped the file from its cache.
+    drop_file_cache(file_path);
+
+    {
+        abc::vmem::pool pool(abc::vmem::pool_config(file_path.c_str(), max_mapped_page_count));
+        abc::vmem::page start_page(&pool, abc::vmem::page_pos_start, nullptr);
+        list_type list(reinterpret_cast<abc::vmem::list_state*>(start_page.ptr()), &pool, nullptr);
+
+        abc::vmem::pool_stats stats_before = pool.stats();
+        bench_timer timer;
+
+        std::uint64_t sum = 0;
+        for (list_type::const_iterator itr = list.cbegin(); itr != list.cend(); itr++) {
+            sum += *itr;
+        }
+        sink = sum;
+
+        add_result(results, "list_scan_cold", item_count, max_mapped_page_count, timer, stats_before, pool.stats());
+    }
+
+    std::remove(file_path.c_str());
+}
+
+
+// --------------------------------------------------------------
+
+
+map_type::value_type make_item(std::uint64_t key, std::uint64_t value) {
+    map_type::value_type item;
+    item.key = key;
+    item.value = value;
+
+    return item;
+}
+
+
+std::string make_file_path(const bench_config& config, const char* name, std::size_t item_count, std::size_t max_mapped_page_count) {
+    return abc::strprintf("%s/%s_%zu_%zu.vmem", config.out_dir.c_str(), name, item_count, max_mapped_page_count);
+}
+
+
+void drop_file_cache(const std::string& file_path) {
+    int fd = ::open(file_path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        ::close(fd);
+    }
+}
+
+
+void add_result(bench_results& results, const char* scenario, std::size_t item_count, std::size_t max_mapped_page_count,
+                const bench_timer& timer, const abc::vmem::pool_stats& stats_before, const abc::vmem::pool_stats& stats_after) {
+    bench_result result;
+    result.scenario              = scenario;
+    result.item_count            = item_count;
+    result.max_mapped_page_count = max_mapped_page_count;
+    result.elapsed_ns            = timer.elapsed_ns();
+    result.map_hit_count         = stats_after.map_hit_count - stats_before.map_hit_count;
+    result.map_miss_count        = stats_after.map_miss_count - stats_before.map_miss_count;
+    result.eviction_count        = stats_after.eviction_count - stats_before.eviction_count;
+
+    results.push_back(std::move(result));
+}
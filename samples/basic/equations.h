@@ -41,7 +41,9 @@ public:
 
 protected:
     virtual std::unique_ptr<abc::net::tcp_server_socket> create_server_socket() override;
-    virtual void process_rest_request(abc::net::http::server& http, const abc::net::http::request& request) override;
+
+private:
+    void process_problem(abc::net::http::server& http, const abc::net::http::request& request);
 };
 
 
@@ -50,6 +52,13 @@ protected:
 
 inline equations_endpoint::equations_endpoint(abc::net::http::endpoint_config&& config, abc::diag::log_ostream* log)
     : base("equations_endpoint", std::move(config), log) {
+
+    // Requests to other resources get 404, and requests with other methods get 405.
+    // POST /shutdown is handled by the base class.
+    base::add_route(abc::net::http::method::POST, "/problem",
+        [this] (abc::net::http::server& http, const abc::net::http::request& request, const abc::net::http::route_params& /*params*/) {
+            process_problem(http, request);
+        });
 }
 
 
@@ -58,36 +67,10 @@ inline std::unique_ptr<abc::net::tcp_server_socket> equations_endpoint::create_s
 }
 
 
-inline void equations_endpoint::process_rest_request(abc::net::http::server& http, const abc::net::http::request& request) {
-    constexpr const char* suborigin = "process_rest_request()";
+inline void equations_endpoint::process_problem(abc::net::http::server& http, const abc::net::http::request& request) {
+    constexpr const char* suborigin = "process_problem()";
     base::put_any(suborigin, abc::diag::severity::callstack, 0x102f1, "Begin:");
 
-    // Support a graceful shutdown.
-    if (abc::ascii::are_equal_i(request.method.c_str(), abc::net::http::method::POST) && abc::ascii::are_equal_i(request.resource.path.c_str(), "/shutdown")) {
-        base::set_shutdown_requested();
-
-        base::send_simple_response(http, abc::net::http::status_code::OK, abc::net::http::reason_phrase::OK, abc::net::http::content_type::text, "Server is shuting down...", 0x102ce);
-
-        base::put_any(suborigin, abc::diag::severity::callstack, 0x107b7, "Return: 200");
-        return;
-    }
-
-    // If the resource is not /problem, return 404.
-    if (!abc::ascii::are_equal_i(request.resource.path.c_str(), "/problem")) {
-        base::send_simple_response(http, abc::net::http::status_code::Not_Found, abc::net::http::reason_phrase::Not_Found, abc::net::http::content_type::text, "The requested resource was not found.", 0x102cf);
-
-        base::put_any(suborigin, abc::diag::severity::callstack, 0x107b8, "Return: 404");
-        return;
-    }
-
-    // If the method is not POST, return 405.
-    if (!abc::ascii::are_equal_i(request.method.c_str(), abc::net::http::method::POST)) {
-        base::send_simple_response(http, abc::net::http::status_code::Method_Not_Allowed, abc::net::http::reason_phrase::Method_Not_Allowed, abc::net::http::content_type::text, "POST is the only supported method for resource '/problem'.", 0x102d0);
-
-        base::put_any(suborigin, abc::diag::severity::callstack, 0x107b9, "Return: 405");
-        return;
-    }
-
     // Require header Content-Type: application/json
     abc::net::http::headers::const_iterator content_type_itr = request.headers.find(abc::net::http::header::Content_Type);
     if (content_type_itr == request.headers.cend()) {
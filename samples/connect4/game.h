@@ -40,12 +40,6 @@ SOFTWARE.
 // --------------------------------------------------------------
 
 
-constexpr std::size_t len_request_path_games = 6U;
-
-
-// --------------------------------------------------------------
-
-
 inline vmem_bundle::vmem_bundle(abc::vmem::pool_config&& pool_config, abc::diag::log_ostream* log)
     : pool(std::move(pool_config), log)
     , start_page(&pool, abc::vmem::page_pos_start, log)
@@ -970,6 +964,37 @@ inline player_id_t endpoint_game::player_id(endpoint_player_id_t endpoint_player
 
 inline game_endpoint::game_endpoint(abc::net::http::endpoint_config&& config, abc::diag::log_ostream* log)
     : base(std::move(config), log) {
+
+    base::add_route(abc::net::http::method::POST, "/games",
+        [this] (abc::net::http::server& http, const abc::net::http::request& request, const abc::net::http::route_params& /*params*/) {
+            create_game(http, request);
+        });
+
+    base::add_route(abc::net::http::method::POST, "/games/{game_id}/players/{player_i}",
+        [this] (abc::net::http::server& http, const abc::net::http::request& request, const abc::net::http::route_params& params) {
+            claim_player(http, request, get_id_param("claim_player", 0x10f04, params, "game_id"), get_id_param("claim_player", 0x10f05, params, "player_i"));
+        });
+
+    base::add_route(abc::net::http::method::POST, "/games/{game_id}/players/{player_id}/moves",
+        [this] (abc::net::http::server& http, const abc::net::http::request& request, const abc::net::http::route_params& params) {
+            accept_move(http, request, get_id_param("accept_move", 0x10f06, params, "game_id"), get_id_param("accept_move", 0x10f07, params, "player_id"));
+        });
+
+    base::add_route(abc::net::http::method::GET, "/games/{game_id}/moves",
+        [this] (abc::net::http::server& http, const abc::net::http::request& request, const abc::net::http::route_params& params) {
+            abc::net::http::query::const_iterator query_since = request.resource.query.find("since");
+            unsigned since_move_i = 0;
+
+            require("get_moves", 0x10f08, query_since != request.resource.query.end() && std::sscanf(query_since->second.c_str(), "%u", &since_move_i) == 1,
+                abc::net::http::status_code::Bad_Request, abc::net::http::reason_phrase::Bad_Request, abc::net::http::content_type::text, "Resource error: A valid 'since' query parameter was not supplied.");
+
+            get_moves(http, request, get_id_param("get_moves", 0x10f09, params, "game_id"), since_move_i);
+        });
+
+    base::add_route(abc::net::http::method::POST, "/shutdown",
+        [this] (abc::net::http::server& http, const abc::net::http::request& request, const abc::net::http::route_params& /*params*/) {
+            process_shutdown(http, request);
+        });
 }
 
 
@@ -983,20 +1008,8 @@ inline void game_endpoint::process_rest_request(abc::net::http::server& http, co
     diag_base::put_any(suborigin, abc::diag::severity::callstack, 0x10626, "Begin: method=%s, path=%s", request.method.c_str(), request.resource.path.c_str());
 
     try {
-        if (abc::ascii::are_equal_i_n(request.resource.path.c_str(), "/games", len_request_path_games)) {
-            process_games(http, request);
-        }
-        else if (abc::ascii::are_equal_i(request.resource.path.c_str(), "/shutdown")) {
-            process_shutdown(http, request);
-        }
-        else {
-            // 404
-            throw_exception(suborigin, 0x10627,
-                abc::net::http::status_code::Not_Found, abc::net::http::reason_phrase::Not_Found, abc::net::http::content_type::text, "The requested resource was not found.");
-        }
-    }
-    catch (const abc::net::http::endpoint_error& err) {
-        base::send_simple_response(http, err.status_code, err.reason_phrase.c_str(), err.content_type.c_str(), err.body.c_str(), err.tag);
+        // The routes are added in the constructor.
+        base::process_rest_request(http, request);
     }
     catch (const std::runtime_error& err) {
         base::send_simple_response(http, abc::net::http::status_code::Bad_Request, abc::net::http::reason_phrase::Bad_Request, abc::net::http::content_type::text, err.what(), 0x10808);
@@ -1006,49 +1019,10 @@ inline void game_endpoint::process_rest_request(abc::net::http::server& http, co
 }
 
 
-inline void game_endpoint::process_games(abc::net::http::server& http, const abc::net::http::request& request) {
-    constexpr const char* suborigin = "process_games";
-    diag_base::put_any(suborigin, abc::diag::severity::callstack, 0x10809, "Begin: method=%s, path=%s", request.method.c_str(), request.resource.path.c_str());
-
-    const char* request_path_games = request.resource.path.c_str() + len_request_path_games;
-    if (abc::ascii::are_equal_i(request_path_games, "")) {
-        create_game(http, request);
-    }
-    else {
-        unsigned game_id = 0;
-        unsigned player_id = 0;
-        unsigned player_i = 0;
-        unsigned since_move_i = 0;
-        char moves[6 + 1 + 1];
-        moves[0] = '\0';
-
-        if (std::sscanf(request_path_games, "/%u/players/%u/%6s", &game_id, &player_id, moves) == 3) {
-            accept_move(http, request, static_cast<endpoint_game_id_t>(game_id), static_cast<endpoint_player_id_t>(player_id), moves);
-        }
-        else if (std::sscanf(request_path_games, "/%u/players/%u", &game_id, &player_i) == 2) {
-            claim_player(http, request, static_cast<endpoint_game_id_t>(game_id), player_i);
-        }
-        else {
-            abc::net::http::query::const_iterator query_since = request.resource.query.find("since");
-
-            if (std::sscanf(request_path_games, "/%u/moves", &game_id) == 1
-                && query_since != request.resource.query.end()
-                && std::sscanf(query_since->second.c_str(), "%u", &since_move_i) == 1) {
-
-                get_moves(http, request, static_cast<endpoint_game_id_t>(game_id), since_move_i);
-            }
-        }
-    }
-
-    diag_base::put_any(suborigin, abc::diag::severity::callstack, 0x1080a, "End:");
-}
-
-
 inline void game_endpoint::create_game(abc::net::http::server& http, const abc::net::http::request& request) {
     constexpr const char* suborigin = "create_game";
     diag_base::put_any(suborigin, abc::diag::severity::callstack, 0x10629, "Begin: method=%s", request.method.c_str());
 
-    require_method_post(suborigin, 0x1080b, request);
     require_content_type_json(suborigin, 0x1080c, request);
 
     player_types player_types = get_player_types(http, request);
@@ -1145,8 +1119,6 @@ inline void game_endpoint::claim_player(abc::net::http::server& http, const abc:
     constexpr const char* suborigin = "claim_player";
     diag_base::put_any(suborigin, abc::diag::severity::callstack, 0x10641, "Begin: method=%s, game_id=%u, player_i=%u", request.method.c_str(), (unsigned)endpoint_game_id, (unsigned)player_i);
 
-    require_method_post(suborigin, 0x10817, request);
-
     require(suborigin, 0x10818, endpoint_game_id > 0 && player_i <= 1,
         abc::net::http::status_code::Bad_Request, abc::net::http::reason_phrase::Bad_Request, abc::net::http::content_type::text, "Resource error: An invalid game ID or player ID was supplied.");
 
@@ -1179,16 +1151,12 @@ inline void game_endpoint::claim_player(abc::net::http::server& http, const abc:
 }
 
 
-inline void game_endpoint::accept_move(abc::net::http::server& http, const abc::net::http::request& request, endpoint_game_id_t endpoint_game_id, endpoint_player_id_t endpoint_player_id, const char* moves) {
+inline void game_endpoint::accept_move(abc::net::http::server& http, const abc::net::http::request& request, endpoint_game_id_t endpoint_game_id, endpoint_player_id_t endpoint_player_id) {
     constexpr const char* suborigin = "accept_move";
     diag_base::put_any(suborigin, abc::diag::severity::callstack, 0x1064a, "Begin: method=%s, game_id=%u, player_i=%u", request.method.c_str(), (unsigned)endpoint_game_id, (unsigned)endpoint_player_id);
 
-    require_method_post(suborigin, 0x1081b, request);
     require_content_type_json(suborigin, 0x1081c, request);
 
-    require(suborigin, 0x1064b, abc::ascii::are_equal_i(moves, "moves"),
-        abc::net::http::status_code::Bad_Request, abc::net::http::reason_phrase::Bad_Request, abc::net::http::content_type::text, "Resource error: The segment after the player ID must be 'moves'.");
-
     require(suborigin, 0x1064d, endpoint_game_id > 0 && endpoint_player_id > 0,
         abc::net::http::status_code::Bad_Request, abc::net::http::reason_phrase::Bad_Request, abc::net::http::content_type::text, "Resource error: An invalid game ID or player ID was supplied.");
 
@@ -1262,8 +1230,6 @@ inline void game_endpoint::get_moves(abc::net::http::server& http, const abc::ne
     constexpr const char* suborigin = "get_moves";
     diag_base::put_any(suborigin, abc::diag::severity::callstack, 0x10661, "Begin: method=%s, game_id=%u, move_i=%u", request.method.c_str(), (unsigned)endpoint_game_id, since_move_i);
 
-    require_method_get(suborigin, 0x10821, request);
-
     require(suborigin, 0x10662, endpoint_game_id > 0,
         abc::net::http::status_code::Bad_Request, abc::net::http::reason_phrase::Bad_Request, abc::net::http::content_type::text, "Resource error: An invalid game ID was supplied.");
 
@@ -1309,8 +1275,6 @@ inline void game_endpoint::process_shutdown(abc::net::http::server& http, const
     constexpr const char* suborigin = "process_shutdown";
     diag_base::put_any(suborigin, abc::diag::severity::callstack, 0x10824, "Begin: method=%s", request.method.c_str());
 
-    require_method_post(suborigin, 0x10825, request);
-
     base::set_shutdown_requested();
 
     // 200
@@ -1318,15 +1282,18 @@ inline void game_endpoint::process_shutdown(abc::net::http::server& http, const
 }
 
 
-inline void game_endpoint::require_method_get(const char* suborigin, abc::diag::tag_t tag, const abc::net::http::request& request) {
-    require(suborigin, tag, abc::ascii::are_equal_i(request.method.c_str(), abc::net::http::method::GET),
-        abc::net::http::status_code::Method_Not_Allowed, abc::net::http::reason_phrase::Method_Not_Allowed, abc::net::http::content_type::text, "Method error: Expected 'GET'.");
-}
+inline unsigned game_endpoint::get_id_param(const char* suborigin, abc::diag::tag_t tag, const abc::net::http::route_params& params, const char* name) {
+    abc::net::http::span value = params.find(name);
 
+    require(suborigin, tag, value.size > 0 && value.size <= 9 && abc::ascii::scan_while(value.data, value.size, abc::ascii::char_class::digit) == value.size,
+        abc::net::http::status_code::Bad_Request, abc::net::http::reason_phrase::Bad_Request, abc::net::http::content_type::text, "Resource error: An ID must be a decimal number.");
+
+    unsigned id = 0;
+    for (std::size_t i = 0; i < value.size; i++) {
+        id = id * 10 + (value.data[i] - '0');
+    }
 
-inline void game_endpoint::require_method_post(const char* suborigin, abc::diag::tag_t tag, const abc::net::http::request& request) {
-    require(suborigin, tag, abc::ascii::are_equal_i(request.method.c_str(), abc::net::http::method::POST),
-        abc::net::http::status_code::Method_Not_Allowed, abc::net::http::reason_phrase::Method_Not_Allowed, abc::net::http::content_type::text, "Method error: Expected 'POST'.");
+    return id;
 }
 
 
@@ -341,17 +341,15 @@ protected:
     virtual void process_rest_request(abc::net::http::server& http, const abc::net::http::request& request) override;
 
 private:
-    void process_games(abc::net::http::server& http, const abc::net::http::request& request);
     void process_shutdown(abc::net::http::server& http, const abc::net::http::request& request);
 
     void create_game(abc::net::http::server& http, const abc::net::http::request& request);
     player_types get_player_types(abc::net::http::server& http, const abc::net::http::request& request);
     void claim_player(abc::net::http::server& http, const abc::net::http::request& request, endpoint_game_id_t endpoint_game_id, unsigned player_i);
-    void accept_move(abc::net::http::server& http, const abc::net::http::request& request, endpoint_game_id_t endpoint_game_id, endpoint_player_id_t endpoint_player_id, const char* moves);
+    void accept_move(abc::net::http::server& http, const abc::net::http::request& request, endpoint_game_id_t endpoint_game_id, endpoint_player_id_t endpoint_player_id);
     void get_moves(abc::net::http::server& http, const abc::net::http::request& request, endpoint_game_id_t endpoint_game_id, unsigned since_move_i);
 
-    void require_method_get(const char* suborigin, abc::diag::tag_t tag, const abc::net::http::request& request);
-    void require_method_post(const char* suborigin, abc::diag::tag_t tag, const abc::net::http::request& request);
+    unsigned get_id_param(const char* suborigin, abc::diag::tag_t tag, const abc::net::http::route_params& params, const char* name);
     void require_content_type_json(const char* suborigin, abc::diag::tag_t tag, const abc::net::http::request& request);
 
 private:
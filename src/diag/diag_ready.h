@@ -41,19 +41,17 @@ namespace abc { namespace diag {
 
 
     template <typename OriginStr>
-    inline void diag_ready<OriginStr>::put_any(const char* suborigin, severity_t severity, tag_t tag, const char* format, ...) const noexcept {
-        std::va_list vlist;
-        va_start(vlist, format);
-
-        put_anyv(suborigin, severity, tag, format, vlist);
-
-        va_end(vlist);
+    template <typename... Args>
+    inline void diag_ready<OriginStr>::put_any(const char* suborigin, severity_t severity, tag_t tag, const char* format, Args... args) const noexcept {
+        if (severity::is_compiled(severity) && _log != nullptr) {
+            _log->put_any(c_str(_origin), suborigin, severity, tag, format, args...);
+        }
     }
 
 
     template <typename OriginStr>
     inline void diag_ready<OriginStr>::put_anyv(const char* suborigin, severity_t severity, tag_t tag, const char* format, std::va_list vlist) const noexcept {
-        if (_log != nullptr) {
+        if (severity::is_compiled(severity) && _log != nullptr) {
             _log->put_anyv(c_str(_origin), suborigin, severity, tag, format, vlist);
         }
     }
@@ -61,7 +59,7 @@ namespace abc { namespace diag {
 
     template <typename OriginStr>
     inline void diag_ready<OriginStr>::put_binary(const char* suborigin, severity_t severity, tag_t tag, const void* buffer, std::size_t buffer_size) const noexcept {
-        if (_log != nullptr) {
+        if (severity::is_compiled(severity) && _log != nullptr) {
             _log->put_binary(c_str(_origin), suborigin, severity, tag, buffer, buffer_size);
         }
     }
@@ -69,7 +67,7 @@ namespace abc { namespace diag {
 
     template <typename OriginStr>
     inline void diag_ready<OriginStr>::put_blank_line(severity_t severity) const noexcept {
-        if (_log != nullptr) {
+        if (severity::is_compiled(severity) && _log != nullptr) {
             _log->put_blank_line(c_str(_origin), severity);
         }
     }
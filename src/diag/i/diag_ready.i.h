@@ -31,6 +31,22 @@ SOFTWARE.
 #include "log.i.h"
 
 
+/**
+ * @brief          Calls `diag_ready::put_any()` only if `severity` is compiled in - see `ABC_MIN_LOG_SEVERITY`.
+ * @details        Unlike a plain call, the message arguments are not evaluated when the severity is compiled out, regardless of the optimization level.
+ * @param put_any  The method to call, e.g. `diag_base::put_any`.
+ * @param sub      Entry suborigin, e.g. method.
+ * @param sev      Entry severity.
+ * @param ...      Entry tag, message format, and message arguments.
+ */
+#define ABC_DIAG_PUT_ANY(put_any, sub, sev, ...) \
+    do { \
+        if (abc::diag::severity::is_compiled(sev)) { \
+            put_any(sub, sev, __VA_ARGS__); \
+        } \
+    } while (false)
+
+
 namespace abc { namespace diag {
 
     /**
@@ -65,13 +81,17 @@ namespace abc { namespace diag {
     protected:
         /**
          * @brief           Write a formatted message.
+         * @details         A template rather than a C variadic function, so that it gets inlined.
+         *                  Use `ABC_DIAG_PUT_ANY` to skip the evaluation of the arguments when `severity` is not compiled in - see `ABC_MIN_LOG_SEVERITY`.
+         * @tparam Args     Message argument types. Must be trivially copyable.
          * @param suborigin Entry suborigin, e.g. method.
          * @param severity  Entry severity.
          * @param tag       Entry tag.
          * @param format    Message format.
-         * @param ...       Message arguments.
+         * @param args      Message arguments.
          */
-        void put_any(const char* suborigin, severity_t severity, tag_t tag, const char* format, ...) const noexcept;
+        template <typename... Args>
+        void put_any(const char* suborigin, severity_t severity, tag_t tag, const char* format, Args... args) const noexcept;
 
         /**
          * @brief           Write a formatted message.
@@ -38,6 +38,16 @@ SOFTWARE.
 #include "../tag.h"
 
 
+#if !defined(ABC_MIN_LOG_SEVERITY)
+/**
+ * @brief   Least severe entries that are compiled in. Default: `debug`, i.e. all.
+ * @details Define it to, e.g., `abc::diag::severity::important` to compile out `callstack`, `optional`, `verbose`, and `debug` entries.
+ *          It must be the same in all translation units.
+ */
+#define ABC_MIN_LOG_SEVERITY abc::diag::severity::debug
+#endif
+
+
 namespace abc { namespace diag {
 
     namespace color {
@@ -71,6 +81,12 @@ namespace abc { namespace diag {
 
         bool is_higher(severity_t severity, severity_t other) noexcept;
         bool is_higher_or_equal(severity_t severity, severity_t other) noexcept;
+
+        /**
+         * @brief          Returns `true` if entries of the given severity are compiled in, i.e. if they are not less severe than `ABC_MIN_LOG_SEVERITY`.
+         * @param severity Entry severity.
+         */
+        constexpr bool is_compiled(severity_t severity) noexcept;
     }
 
 
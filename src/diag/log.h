@@ -389,4 +389,9 @@ namespace abc { namespace diag {
         return severity <= other;
     }
 
+
+    inline constexpr bool severity::is_compiled(severity_t severity) noexcept {
+        return severity <= ABC_MIN_LOG_SEVERITY;
+    }
+
 } }
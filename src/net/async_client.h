@@ -0,0 +1,1192 @@
+/*
+MIT License
+
+Copyright (c) 2018-2026 Zlatko Michailov 
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <future>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+
+#include "../root/ascii.h"
+#include "../stream/buffer_streambuf.h"
+#include "../diag/diag_ready.h"
+#include "socket.h"
+#include "http.h"
+#include "endpoint.h"
+#include "i/async_client.i.h"
+
+
+namespace abc { namespace net { namespace http {
+
+    inline async_client_config::async_client_config(std::size_t max_connections_per_host,
+                                                    std::chrono::milliseconds connect_timeout, std::chrono::milliseconds request_timeout,
+                                                    std::chrono::milliseconds keep_alive_timeout, std::chrono::milliseconds dns_cache_ttl,
+                                                    std::size_t max_response_size, socket::family family)
+        : max_connections_per_host(max_connections_per_host)
+
+        , connect_timeout(connect_timeout)
+        , request_timeout(request_timeout)
+        , keep_alive_timeout(keep_alive_timeout)
+        , dns_cache_ttl(dns_cache_ttl)
+
+        , max_response_size(max_response_size)
+        , family(family) {
+    }
+
+
+    // --------------------------------------------------------------
+
+
+    inline async_client::async_client(async_client_config&& config, diag::log_ostream* log)
+        : diag_base(copy<const char*>("abc::net::http::async_client"), log)
+        , _config(std::move(config))
+        , _is_stopping(false)
+        , _last_connection_id(0)
+        , _connect_count(0)
+        , _epoll_fd(-1)
+        , _wake_fd(-1) {
+
+        constexpr const char* suborigin = "async_client()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f10, "Begin: max_connections_per_host=%zu, connect_timeout=%lld, request_timeout=%lld, keep_alive_timeout=%lld, dns_cache_ttl=%lld, max_response_size=%zu",
+                            _config.max_connections_per_host, (long long)_config.connect_timeout.count(), (long long)_config.request_timeout.count(),
+                            (long long)_config.keep_alive_timeout.count(), (long long)_config.dns_cache_ttl.count(), _config.max_response_size);
+
+        diag_base::expect(suborigin, _config.max_connections_per_host > 0, 0x10f11, "_config.max_connections_per_host > 0");
+
+        _epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+        diag_base::require(suborigin, _epoll_fd != -1, 0x10f12, "::epoll_create1() errno=%d", errno);
+
+        _wake_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (_wake_fd == -1) {
+            int err = errno;
+            ::close(_epoll_fd);
+            diag_base::require(suborigin, false, 0x10f13, "::eventfd() errno=%d", err);
+        }
+
+        epoll_event wake_event{ };
+        wake_event.events = EPOLLIN;
+        wake_event.data.u64 = 0;
+        if (::epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _wake_fd, &wake_event) != 0) {
+            int err = errno;
+            ::close(_wake_fd);
+            ::close(_epoll_fd);
+            diag_base::require(suborigin, false, 0x10f14, "::epoll_ctl() errno=%d", err);
+        }
+
+        _loop_thread = std::thread(&async_client::run_loop, this);
+
+        try {
+            _resolver_thread = std::thread(&async_client::run_resolver, this);
+        }
+        catch (...) {
+            {
+                std::lock_guard<std::mutex> lock(_incoming_mutex);
+                _is_stopping = true;
+            }
+
+            std::uint64_t one = 1;
+            ssize_t written_len = ::write(_wake_fd, &one, sizeof(one));
+            (void)written_len;
+
+            _loop_thread.join();
+
+            ::close(_wake_fd);
+            ::close(_epoll_fd);
+            throw;
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f15, "End:");
+    }
+
+
+    inline async_client::~async_client() noexcept {
+        constexpr const char* suborigin = "~async_client()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f16, "Begin:");
+
+        {
+            std::lock_guard<std::mutex> lock(_incoming_mutex);
+            _is_stopping = true;
+        }
+
+        _resolve_cond.notify_all();
+
+        std::uint64_t one = 1;
+        ssize_t written_len = ::write(_wake_fd, &one, sizeof(one));
+        (void)written_len;
+
+        if (_resolver_thread.joinable()) {
+            _resolver_thread.join();
+        }
+
+        if (_loop_thread.joinable()) {
+            _loop_thread.join();
+        }
+
+        ::close(_wake_fd);
+        ::close(_epoll_fd);
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f17, "End:");
+    }
+
+
+    inline void async_client::send_async(const char* host, const char* port, request&& request, std::string&& body, async_callback&& callback) {
+        constexpr const char* suborigin = "send_async()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f18, "Begin: host='%s', port='%s', method='%s', path='%s'",
+                            host, port, request.method.c_str(), request.resource.path.c_str());
+
+        diag_base::expect(suborigin, host != nullptr && host[0] != '\0', 0x10f19, "host");
+        diag_base::expect(suborigin, port != nullptr && port[0] != '\0', 0x10f1a, "port");
+        diag_base::expect(suborigin, static_cast<bool>(callback), 0x10f1b, "callback");
+
+        std::unique_ptr<pending_request> pending(new pending_request());
+        pending->key.append(host).append(1, ':').append(port);
+        pending->host = host;
+        pending->port = port;
+        pending->is_head = request.method == method::HEAD;
+        pending->is_retry = false;
+        pending->callback = std::move(callback);
+
+        // Fill in what HTTP/1.1 requires.
+        if (request.protocol.empty()) {
+            request.protocol = protocol::HTTP_11;
+        }
+
+        if (request.headers.find(header::Host) == request.headers.cend()) {
+            // An IPv6 literal must be enclosed in brackets.
+            request.headers[header::Host] = std::strchr(host, ':') != nullptr ? "[" + std::string(host) + "]:" + port : pending->key;
+        }
+
+        if (!util::is_chunked(request.headers) && request.headers.find(header::Content_Length) == request.headers.cend()
+                && (!body.empty() || request.method == method::POST || request.method == method::PUT)) {
+            request.headers[header::Content_Length] = std::to_string(body.length());
+        }
+
+        // Serialize the request on the calling thread, so that the event loop only moves bytes.
+        {
+            std::stringbuf sb;
+            request_writer writer(&sb, diag_base::log());
+
+            writer.put_request(request);
+            if (!body.empty()) {
+                writer.put_body(body.data(), body.length());
+            }
+            writer.end_body();
+
+            pending->bytes = sb.str();
+        }
+
+        // The request timeout includes the time it takes to resolve the host.
+        pending->deadline = clock::now() + _config.request_timeout;
+        pending->addresses = find_dns_entry(pending->key);
+
+        if (pending->addresses != nullptr) {
+            post_request(std::move(pending));
+
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f1c, "End: cached");
+            return;
+        }
+
+        // Not cached. Let the resolver thread resolve the host.
+        bool is_stopping;
+        {
+            std::lock_guard<std::mutex> lock(_incoming_mutex);
+
+            is_stopping = _is_stopping;
+            if (!is_stopping) {
+                _resolve_requests.push_back(std::move(pending));
+            }
+        }
+
+        if (is_stopping) {
+            complete_callback(*pending, make_error(suborigin, 0x10f1d, "The client is being destroyed."), async_response());
+
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f1e, "End: stopping");
+            return;
+        }
+
+        _resolve_cond.notify_one();
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f1f, "End: resolving");
+    }
+
+
+    inline std::future<async_response> async_client::send_async(const char* host, const char* port, request&& request, std::string&& body) {
+        std::shared_ptr<std::promise<async_response>> promise = std::make_shared<std::promise<async_response>>();
+        std::future<async_response> future = promise->get_future();
+
+        send_async(host, port, std::move(request), std::move(body),
+            [promise] (std::exception_ptr error, async_response&& response) {
+                if (error != nullptr) {
+                    promise->set_exception(error);
+                }
+                else {
+                    promise->set_value(std::move(response));
+                }
+            });
+
+        return future;
+    }
+
+
+    inline std::size_t async_client::connect_count() const noexcept {
+        return _connect_count.load();
+    }
+
+
+    inline std::shared_ptr<const async_client::address_list> async_client::find_dns_entry(const std::string& key) {
+        std::lock_guard<std::mutex> lock(_dns_mutex);
+
+        std::map<std::string, dns_entry>::const_iterator itr = _dns_cache.find(key);
+        if (itr != _dns_cache.cend() && itr->second.expires > clock::now()) {
+            return itr->second.addresses;
+        }
+
+        return nullptr;
+    }
+
+
+    inline std::shared_ptr<const async_client::address_list> async_client::resolve(const char* host, const char* port, const std::string& key) {
+        constexpr const char* suborigin = "resolve()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f20, "Begin: key='%s'", key.c_str());
+
+        // Another resolution may have cached the addresses meanwhile.
+        std::shared_ptr<const address_list> cached_addresses = find_dns_entry(key);
+        if (cached_addresses != nullptr) {
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f21, "End: cached");
+            return cached_addresses;
+        }
+
+        clock::time_point now = clock::now();
+
+        addrinfo hints{ };
+        hints.ai_family   = static_cast<int>(_config.family);
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_protocol = IPPROTO_TCP;
+
+        addrinfo* host_list = nullptr;
+        int err = ::getaddrinfo(host, port, &hints, &host_list);
+        if (err != 0) {
+            diag_base::throw_exception<std::runtime_error>(suborigin, 0x10f22, "::getaddrinfo() key='%s', err=%d (%s)", key.c_str(), err, ::gai_strerror(err));
+        }
+
+        std::shared_ptr<address_list> addresses = std::make_shared<address_list>();
+        for (const addrinfo* info = host_list; info != nullptr; info = info->ai_next) {
+            if (info->ai_addrlen > sizeof(sockaddr_storage)) {
+                continue;
+            }
+
+            resolved_address address{ };
+            std::memcpy(&address.value, info->ai_addr, info->ai_addrlen);
+            address.size   = info->ai_addrlen;
+            address.family = info->ai_family;
+            addresses->push_back(address);
+        }
+
+        ::freeaddrinfo(host_list);
+
+        if (addresses->empty()) {
+            diag_base::throw_exception<std::runtime_error>(suborigin, 0x10f23, "::getaddrinfo() key='%s' returned no addresses", key.c_str());
+        }
+
+        if (_config.dns_cache_ttl.count() > 0) {
+            std::lock_guard<std::mutex> lock(_dns_mutex);
+
+            dns_entry& entry = _dns_cache[key];
+            entry.addresses = addresses;
+            entry.expires   = now + _config.dns_cache_ttl;
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f24, "End: addresses.size()=%zu", addresses->size());
+
+        return addresses;
+    }
+
+
+    inline void async_client::run_resolver() {
+        constexpr const char* suborigin = "run_resolver()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10ff7, "Begin:");
+
+        for (;;) {
+            std::vector<std::unique_ptr<pending_request>> requests;
+            {
+                std::unique_lock<std::mutex> lock(_incoming_mutex);
+
+                _resolve_cond.wait(lock, [this] () { return _is_stopping || !_resolve_requests.empty(); });
+                if (_is_stopping) {
+                    break;
+                }
+
+                // Take all the requests to the same host:port, so that they share a single resolution.
+                const std::string key = _resolve_requests.front()->key;
+                for (std::deque<std::unique_ptr<pending_request>>::iterator itr = _resolve_requests.begin(); itr != _resolve_requests.end(); ) {
+                    if ((*itr)->key == key) {
+                        requests.push_back(std::move(*itr));
+                        itr = _resolve_requests.erase(itr);
+                    }
+                    else {
+                        itr++;
+                    }
+                }
+            }
+
+            const pending_request& first = *requests.front();
+
+            std::shared_ptr<const address_list> addresses;
+            std::exception_ptr error;
+            try {
+                addresses = resolve(first.host.c_str(), first.port.c_str(), first.key);
+            }
+            catch (...) {
+                error = std::current_exception();
+            }
+
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10ff8, "key='%s', request_count=%zu, ok=%d", first.key.c_str(), requests.size(), error == nullptr);
+
+            for (std::unique_ptr<pending_request>& request : requests) {
+                request->addresses = addresses;
+                request->resolve_error = error;
+                post_request(std::move(request));
+            }
+        }
+
+        // Fail whatever has not been resolved. Callbacks that send new requests fail synchronously.
+        std::deque<std::unique_ptr<pending_request>> unresolved;
+        {
+            std::lock_guard<std::mutex> lock(_incoming_mutex);
+            unresolved.swap(_resolve_requests);
+        }
+
+        std::exception_ptr error = make_error(suborigin, 0x10ff9, "The client is being destroyed.");
+
+        for (std::unique_ptr<pending_request>& request : unresolved) {
+            complete_callback(*request, error, async_response());
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10ffa, "End: unresolved_count=%zu", unresolved.size());
+    }
+
+
+    inline void async_client::post_request(std::unique_ptr<pending_request>&& request) {
+        constexpr const char* suborigin = "post_request()";
+
+        bool is_stopping;
+        {
+            std::lock_guard<std::mutex> lock(_incoming_mutex);
+
+            is_stopping = _is_stopping;
+            if (!is_stopping) {
+                _incoming_requests.push_back(std::move(request));
+            }
+        }
+
+        if (is_stopping) {
+            complete_callback(*request, make_error(suborigin, 0x10ffb, "The client is being destroyed."), async_response());
+            return;
+        }
+
+        std::uint64_t one = 1;
+        ssize_t written_len = ::write(_wake_fd, &one, sizeof(one));
+        (void)written_len;
+    }
+
+
+    inline void async_client::invalidate_dns_entry(const std::string& key, const std::shared_ptr<const address_list>& addresses) {
+        std::lock_guard<std::mutex> lock(_dns_mutex);
+
+        std::map<std::string, dns_entry>::iterator itr = _dns_cache.find(key);
+        if (itr != _dns_cache.end() && itr->second.addresses == addresses) {
+            _dns_cache.erase(itr);
+        }
+    }
+
+
+    inline void async_client::run_loop() {
+        constexpr const char* suborigin = "run_loop()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f25, "Begin:");
+
+        std::vector<std::unique_ptr<pending_request>> incoming;
+        int timeout = -1;
+
+        for (;;) {
+            epoll_event events[size::_64];
+            int event_count = ::epoll_wait(_epoll_fd, events, size::_64, timeout);
+
+            if (event_count < 0) {
+                if (errno != EINTR) {
+                    ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::warning, 0x10f26, "::epoll_wait() errno=%d", errno);
+                }
+
+                event_count = 0;
+            }
+
+            for (int i = 0; i < event_count; i++) {
+                if (events[i].data.u64 == 0) {
+                    std::uint64_t value;
+                    ssize_t read_len = ::read(_wake_fd, &value, sizeof(value));
+                    (void)read_len;
+                    continue;
+                }
+
+                // The connection may have been closed while processing an earlier event.
+                std::map<std::uint64_t, std::unique_ptr<connection>>::iterator itr = _connections.find(events[i].data.u64);
+                if (itr != _connections.end()) {
+                    process_event(*itr->second, events[i].events);
+                }
+            }
+
+            bool is_stopping;
+            {
+                std::lock_guard<std::mutex> lock(_incoming_mutex);
+
+                incoming.swap(_incoming_requests);
+                is_stopping = _is_stopping;
+            }
+
+            if (is_stopping) {
+                break;
+            }
+
+            for (std::unique_ptr<pending_request>& request : incoming) {
+                if (request->resolve_error != nullptr) {
+                    complete_callback(*request, request->resolve_error, async_response());
+                }
+                else {
+                    dispatch_request(std::move(request));
+                }
+            }
+            incoming.clear();
+
+            timeout = process_deadlines(clock::now());
+        }
+
+        // Fail whatever is still outstanding. Callbacks that send new requests fail synchronously.
+        std::exception_ptr error = make_error(suborigin, 0x10f27, "The client is being destroyed.");
+
+        for (std::unique_ptr<pending_request>& request : incoming) {
+            complete_callback(*request, error, async_response());
+        }
+
+        for (std::pair<const std::string, connection_pool>& item : _pools) {
+            for (std::unique_ptr<pending_request>& request : item.second.waiting_requests) {
+                complete_callback(*request, error, async_response());
+            }
+
+            item.second.waiting_requests.clear();
+        }
+
+        while (!_connections.empty()) {
+            connection& conn = *_connections.begin()->second;
+            std::unique_ptr<pending_request> request = std::move(conn.request);
+
+            close_connection(conn);
+
+            if (request != nullptr) {
+                complete_callback(*request, error, async_response());
+            }
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f28, "End:");
+    }
+
+
+    inline void async_client::dispatch_request(std::unique_ptr<pending_request>&& request) {
+        connection_pool& pool = _pools[request->key];
+
+        if (!pool.idle_connections.empty()) {
+            // The most recently used connection is the least likely to have been closed by the server.
+            connection* conn = pool.idle_connections.back();
+            pool.idle_connections.pop_back();
+
+            start_request(*conn, std::move(request));
+        }
+        else if (pool.connection_count < _config.max_connections_per_host) {
+            open_connection(std::move(request));
+        }
+        else {
+            pool.waiting_requests.push_back(std::move(request));
+        }
+    }
+
+
+    inline void async_client::drain_waiting_requests(const std::string& key) {
+        for (;;) {
+            // Opening a connection may fail and destroy the pool, so it is looked up every time.
+            std::map<std::string, connection_pool>::iterator itr = _pools.find(key);
+            if (itr == _pools.end() || itr->second.waiting_requests.empty() || itr->second.connection_count >= _config.max_connections_per_host) {
+                return;
+            }
+
+            std::unique_ptr<pending_request> request = std::move(itr->second.waiting_requests.front());
+            itr->second.waiting_requests.pop_front();
+
+            open_connection(std::move(request));
+        }
+    }
+
+
+    inline void async_client::open_connection(std::unique_ptr<pending_request>&& request) {
+        constexpr const char* suborigin = "open_connection()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10f29, "key='%s'", request->key.c_str());
+
+        std::unique_ptr<connection> owner(new connection());
+        connection& conn = *owner;
+
+        conn.id        = ++_last_connection_id;
+        conn.key       = request->key;
+        conn.addresses = request->addresses;
+        conn.request   = std::move(request);
+
+        _connections[conn.id] = std::move(owner);
+        _pools[conn.key].connection_count++;
+        _connect_count++;
+
+        try_connect(conn);
+    }
+
+
+    inline bool async_client::try_connect(connection& conn) {
+        constexpr const char* suborigin = "try_connect()";
+
+        for (; conn.address_index < conn.addresses->size(); conn.address_index++) {
+            const resolved_address& address = (*conn.addresses)[conn.address_index];
+
+            socket::fd_t fd = ::socket(address.family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_TCP);
+            if (fd == socket::fd::invalid) {
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::important, 0x10f2a, "::socket() errno=%d", errno);
+                continue;
+            }
+
+            // Requests are written whole, so there is nothing to gain from delaying small segments.
+            int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+            int err = ::connect(fd, reinterpret_cast<const sockaddr*>(&address.value), address.size);
+            if (err == 0 || errno == EINPROGRESS) {
+                conn.fd       = fd;
+                conn.state    = connection_state::connecting;
+                conn.deadline = clock::now() + _config.connect_timeout;
+
+                // Writability signals that the connect has completed, successfully or not.
+                watch_connection(conn, EPOLLOUT, EPOLL_CTL_ADD);
+
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10f2b, "key='%s', address_index=%zu, fd=%d", conn.key.c_str(), conn.address_index, fd);
+                return true;
+            }
+
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::important, 0x10f2c, "::connect() key='%s', address_index=%zu, errno=%d", conn.key.c_str(), conn.address_index, errno);
+            ::close(fd);
+        }
+
+        // The addresses may be stale.
+        invalidate_dns_entry(conn.key, conn.addresses);
+
+        std::string key = conn.key;
+        fail_connection(conn, make_error(suborigin, 0x10f2d, "Could not connect to '%s'.", key.c_str()));
+
+        return false;
+    }
+
+
+    inline void async_client::connect_next_address(connection& conn) {
+        ::epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, conn.fd, nullptr);
+        ::close(conn.fd);
+
+        conn.fd = socket::fd::invalid;
+        conn.address_index++;
+
+        try_connect(conn);
+    }
+
+
+    inline void async_client::start_request(connection& conn, std::unique_ptr<pending_request>&& request) {
+        conn.request         = std::move(request);
+        conn.sent_len        = 0;
+
+        conn.received.clear();
+        conn.head_len        = 0;
+        conn.response        = http::response();
+        conn.framing         = body_framing::none;
+        conn.response_len    = 0;
+        conn.body.clear();
+        conn.chunk_pos       = 0;
+        conn.chunk_remaining = 0;
+        conn.is_in_trailers  = false;
+
+        conn.state           = connection_state::sending;
+        conn.deadline        = clock::time_point::max();
+
+        watch_connection(conn, EPOLLOUT, EPOLL_CTL_MOD);
+
+        // The socket is most likely writable already.
+        send_request(conn);
+    }
+
+
+    inline void async_client::process_event(connection& conn, std::uint32_t events) {
+        constexpr const char* suborigin = "process_event()";
+
+        switch (conn.state) {
+            case connection_state::connecting: {
+                int error = 0;
+                socklen_t error_len = sizeof(error);
+                if (::getsockopt(conn.fd, SOL_SOCKET, SO_ERROR, &error, &error_len) != 0) {
+                    error = errno;
+                }
+
+                if (error != 0) {
+                    ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::important, 0x10f2e, "connect key='%s', address_index=%zu, error=%d", conn.key.c_str(), conn.address_index, error);
+                    connect_next_address(conn);
+                    break;
+                }
+
+                conn.state    = connection_state::sending;
+                conn.deadline = clock::time_point::max();
+
+                send_request(conn);
+                break;
+            }
+
+            case connection_state::sending:
+                send_request(conn);
+                break;
+
+            case connection_state::receiving:
+                receive_response(conn);
+                break;
+
+            case connection_state::idle:
+                // The server has closed the connection, or it has sent something unsolicited.
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10f2f, "idle key='%s', events=0x%x", conn.key.c_str(), events);
+                close_connection(conn);
+                break;
+        }
+    }
+
+
+    inline void async_client::send_request(connection& conn) {
+        constexpr const char* suborigin = "send_request()";
+
+        const std::string& bytes = conn.request->bytes;
+        while (conn.sent_len < bytes.length()) {
+            ssize_t sent = ::send(conn.fd, bytes.data() + conn.sent_len, bytes.length() - conn.sent_len, MSG_NOSIGNAL);
+
+            if (sent < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    return;
+                }
+
+                fail_connection(conn, make_error(suborigin, 0x10f30, "::send() key='%s', errno=%d", conn.key.c_str(), errno));
+                return;
+            }
+
+            conn.sent_len += static_cast<std::size_t>(sent);
+        }
+
+        conn.state = connection_state::receiving;
+        watch_connection(conn, EPOLLIN | EPOLLRDHUP, EPOLL_CTL_MOD);
+    }
+
+
+    inline void async_client::receive_response(connection& conn) {
+        constexpr const char* suborigin = "receive_response()";
+
+        bool is_eof = false;
+        for (;;) {
+            char buffer[size::k16];
+            ssize_t received = ::recv(conn.fd, buffer, sizeof(buffer), 0);
+
+            if (received > 0) {
+                conn.received.append(buffer, static_cast<std::size_t>(received));
+
+                if (conn.received.length() > _config.max_response_size) {
+                    fail_connection(conn, make_error(suborigin, 0x10f31, "The response from '%s' is larger than %zu bytes.", conn.key.c_str(), _config.max_response_size));
+                    return;
+                }
+            }
+            else if (received == 0) {
+                is_eof = true;
+                break;
+            }
+            else if (errno == EINTR) {
+                continue;
+            }
+            else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            else {
+                fail_connection(conn, make_error(suborigin, 0x10f32, "::recv() key='%s', errno=%d", conn.key.c_str(), errno));
+                return;
+            }
+        }
+
+        bool is_complete;
+        try {
+            is_complete = frame_response(conn, is_eof);
+        }
+        catch (...) {
+            fail_connection(conn, std::current_exception());
+            return;
+        }
+
+        if (is_complete) {
+            complete_request(conn);
+        }
+        else if (is_eof) {
+            fail_connection(conn, make_error(suborigin, 0x10f33, "The connection to '%s' was closed before the response was complete.", conn.key.c_str()));
+        }
+    }
+
+
+    inline bool async_client::frame_response(connection& conn, bool is_eof) {
+        if (conn.head_len == 0 && !frame_head(conn)) {
+            return false;
+        }
+
+        switch (conn.framing) {
+            case body_framing::none:
+                return true;
+
+            case body_framing::length:
+                return conn.received.length() >= conn.response_len;
+
+            case body_framing::chunked:
+                return frame_chunks(conn);
+
+            case body_framing::close:
+                if (is_eof) {
+                    conn.response_len = conn.received.length();
+                }
+                return is_eof;
+        }
+
+        return false;
+    }
+
+
+    inline bool async_client::frame_head(connection& conn) {
+        constexpr const char* suborigin = "frame_head()";
+
+        for (;;) {
+            std::size_t head_end = conn.received.find("\r\n\r\n");
+            if (head_end == std::string::npos) {
+                return false;
+            }
+
+            conn.head_len = head_end + 4;
+
+            // Parse the status line and the headers with the regular reader over the head bytes.
+            stream::buffer_streambuf sb(&conn.received[0], 0, conn.head_len, nullptr, 0, 0);
+            response_reader reader(&sb, diag_base::log());
+            conn.response = reader.get_response();
+
+            status_code_t status = conn.response.status_code;
+            if (status == 101) {
+                diag_base::throw_exception<std::runtime_error>(suborigin, 0x10f34, "'%s' switched protocols, which is not supported.", conn.key.c_str());
+            }
+
+            if (status / 100 != 1) {
+                break;
+            }
+
+            // An interim response is followed by the final one.
+            conn.received.erase(0, conn.head_len);
+            conn.head_len = 0;
+        }
+
+        const http::headers& response_headers = conn.response.headers;
+        status_code_t status = conn.response.status_code;
+
+        if (conn.request->is_head || status == status_code::No_Content || status == status_code::Not_Modified) {
+            conn.framing      = body_framing::none;
+            conn.response_len = conn.head_len;
+        }
+        else if (util::is_chunked(response_headers)) {
+            conn.framing   = body_framing::chunked;
+            conn.chunk_pos = conn.head_len;
+        }
+        else {
+            headers::const_iterator itr = response_headers.find(header::Content_Length);
+            if (itr == response_headers.cend()) {
+                conn.framing = body_framing::close;
+            }
+            else {
+                const char* length_begin = itr->second.c_str();
+                char* length_end = nullptr;
+                unsigned long long length = std::strtoull(length_begin, &length_end, 10);
+
+                if (!ascii::is_digit(*length_begin) || *length_end != '\0') {
+                    diag_base::throw_exception<std::runtime_error>(suborigin, 0x10f35, "Invalid Content-Length='%s' from '%s'.", length_begin, conn.key.c_str());
+                }
+
+                if (length > _config.max_response_size - std::min(_config.max_response_size, conn.head_len)) {
+                    diag_base::throw_exception<std::runtime_error>(suborigin, 0x10f36, "The response from '%s' is larger than %zu bytes.", conn.key.c_str(), _config.max_response_size);
+                }
+
+                conn.framing      = body_framing::length;
+                conn.response_len = conn.head_len + static_cast<std::size_t>(length);
+            }
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10f37, "key='%s', status=%u, framing=%u", conn.key.c_str(), (unsigned)status, (unsigned)conn.framing);
+
+        return true;
+    }
+
+
+    inline bool async_client::frame_chunks(connection& conn) {
+        constexpr const char* suborigin = "frame_chunks()";
+
+        const std::string& received = conn.received;
+        for (;;) {
+            if (conn.chunk_remaining > 0) {
+                // Chunk data is followed by CRLF.
+                if (received.length() < conn.chunk_pos + conn.chunk_remaining + 2) {
+                    return false;
+                }
+
+                if (received.compare(conn.chunk_pos + conn.chunk_remaining, 2, "\r\n") != 0) {
+                    diag_base::throw_exception<std::runtime_error>(suborigin, 0x10f38, "Invalid chunk from '%s'.", conn.key.c_str());
+                }
+
+                conn.body.append(received, conn.chunk_pos, conn.chunk_remaining);
+                conn.chunk_pos += conn.chunk_remaining + 2;
+                conn.chunk_remaining = 0;
+                continue;
+            }
+
+            std::size_t line_end = received.find("\r\n", conn.chunk_pos);
+            if (line_end == std::string::npos) {
+                return false;
+            }
+
+            if (conn.is_in_trailers) {
+                // Trailers end with an empty line.
+                if (line_end == conn.chunk_pos) {
+                    conn.response_len = line_end + 2;
+                    return true;
+                }
+
+                conn.chunk_pos = line_end + 2;
+                continue;
+            }
+
+            // Chunk size, optionally followed by extensions.
+            const char* size_begin = received.c_str() + conn.chunk_pos;
+            char* size_end = nullptr;
+            unsigned long long chunk_size = std::strtoull(size_begin, &size_end, 16);
+
+            if (!ascii::is_hex(*size_begin) || chunk_size > _config.max_response_size) {
+                diag_base::throw_exception<std::runtime_error>(suborigin, 0x10f39, "Invalid chunk size from '%s'.", conn.key.c_str());
+            }
+
+            conn.chunk_pos = line_end + 2;
+            if (chunk_size == 0) {
+                conn.is_in_trailers = true;
+            }
+            else {
+                conn.chunk_remaining = static_cast<std::size_t>(chunk_size);
+            }
+        }
+    }
+
+
+    inline void async_client::complete_request(connection& conn) {
+        std::unique_ptr<pending_request> request = std::move(conn.request);
+
+        async_response response;
+        response.response = std::move(conn.response);
+
+        switch (conn.framing) {
+            case body_framing::length:
+            case body_framing::close:
+                response.body = conn.received.substr(conn.head_len, conn.response_len - conn.head_len);
+                break;
+
+            case body_framing::chunked:
+                response.body = std::move(conn.body);
+                break;
+
+            case body_framing::none:
+                break;
+        }
+
+        // Extra bytes after the response mean the connection is out of sync.
+        bool is_keep_alive = conn.framing != body_framing::close
+                          && conn.received.length() == conn.response_len
+                          && response.response.protocol == protocol::HTTP_11;
+
+        if (is_keep_alive) {
+            headers::const_iterator itr = response.response.headers.find(header::Connection);
+            if (itr != response.response.headers.cend()) {
+                std::size_t close_len = std::strlen(http::connection::close);
+
+                is_keep_alive = !util::any_list_item(itr->second,
+                    [close_len] (const char* token, std::size_t token_len) -> bool {
+                        return token_len == close_len && ascii::are_equal_i_n(token, http::connection::close, close_len);
+                    });
+            }
+        }
+
+        if (is_keep_alive) {
+            release_connection(conn);
+        }
+        else {
+            std::string key = conn.key;
+            close_connection(conn);
+            drain_waiting_requests(key);
+        }
+
+        complete_callback(*request, nullptr, std::move(response));
+    }
+
+
+    inline void async_client::fail_connection(connection& conn, std::exception_ptr error) {
+        std::string key = conn.key;
+        std::unique_ptr<pending_request> request = std::move(conn.request);
+
+        // The server may have closed a kept-alive connection just as the request was sent.
+        bool is_retriable = request != nullptr
+                         && conn.is_reused
+                         && conn.received.empty()
+                         && !request->is_retry
+                         && request->deadline > clock::now();
+
+        close_connection(conn);
+
+        if (is_retriable) {
+            ABC_DIAG_PUT_ANY(diag_base::put_any, "fail_connection()", diag::severity::optional, 0x10f3a, "Retrying key='%s'", key.c_str());
+
+            request->is_retry = true;
+            open_connection(std::move(request));
+        }
+        else if (request != nullptr) {
+            complete_callback(*request, error, async_response());
+        }
+
+        drain_waiting_requests(key);
+    }
+
+
+    inline void async_client::release_connection(connection& conn) {
+        connection_pool& pool = _pools[conn.key];
+        conn.is_reused = true;
+
+        if (!pool.waiting_requests.empty()) {
+            std::unique_ptr<pending_request> request = std::move(pool.waiting_requests.front());
+            pool.waiting_requests.pop_front();
+
+            start_request(conn, std::move(request));
+            return;
+        }
+
+        // The connection is already watched for input, which now means the server has closed it.
+        conn.state    = connection_state::idle;
+        conn.deadline = clock::now() + _config.keep_alive_timeout;
+        conn.received.clear();
+        conn.body.clear();
+
+        pool.idle_connections.push_back(&conn);
+    }
+
+
+    inline void async_client::close_connection(connection& conn) {
+        if (conn.fd != socket::fd::invalid) {
+            ::epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, conn.fd, nullptr);
+            ::close(conn.fd);
+        }
+
+        std::map<std::string, connection_pool>::iterator itr = _pools.find(conn.key);
+        if (itr != _pools.end()) {
+            connection_pool& pool = itr->second;
+            pool.connection_count--;
+
+            std::vector<connection*>::iterator idle_itr = std::find(pool.idle_connections.begin(), pool.idle_connections.end(), &conn);
+            if (idle_itr != pool.idle_connections.end()) {
+                pool.idle_connections.erase(idle_itr);
+            }
+
+            if (pool.connection_count == 0 && pool.waiting_requests.empty()) {
+                _pools.erase(itr);
+            }
+        }
+
+        _connections.erase(conn.id);
+    }
+
+
+    inline void async_client::watch_connection(const connection& conn, std::uint32_t events, int op) {
+        epoll_event event{ };
+        event.events   = events;
+        event.data.u64 = conn.id;
+
+        if (::epoll_ctl(_epoll_fd, op, conn.fd, &event) != 0) {
+            // The request will time out.
+            ABC_DIAG_PUT_ANY(diag_base::put_any, "watch_connection()", diag::severity::warning, 0x10f3b, "::epoll_ctl() key='%s', errno=%d", conn.key.c_str(), errno);
+        }
+    }
+
+
+    inline int async_client::process_deadlines(clock::time_point now) {
+        constexpr const char* suborigin = "process_deadlines()";
+
+        // Failing a connection changes the map, so the expired ones are collected first.
+        std::vector<std::uint64_t> expired;
+        for (const std::pair<const std::uint64_t, std::unique_ptr<connection>>& item : _connections) {
+            const connection& conn = *item.second;
+            if (conn.deadline <= now || (conn.request != nullptr && conn.request->deadline <= now)) {
+                expired.push_back(item.first);
+            }
+        }
+
+        for (std::uint64_t id : expired) {
+            std::map<std::uint64_t, std::unique_ptr<connection>>::iterator itr = _connections.find(id);
+            if (itr == _connections.end()) {
+                continue;
+            }
+
+            connection& conn = *itr->second;
+            if (conn.request != nullptr && conn.request->deadline <= now) {
+                fail_connection(conn, make_error(suborigin, 0x10f3c, "The request to '%s' timed out.", conn.key.c_str()));
+            }
+            else if (conn.state == connection_state::connecting) {
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::important, 0x10f3d, "connect timeout key='%s', address_index=%zu", conn.key.c_str(), conn.address_index);
+                connect_next_address(conn);
+            }
+            else if (conn.state == connection_state::idle) {
+                close_connection(conn);
+            }
+        }
+
+        for (std::pair<const std::string, connection_pool>& item : _pools) {
+            std::deque<std::unique_ptr<pending_request>>& waiting = item.second.waiting_requests;
+            for (std::deque<std::unique_ptr<pending_request>>::iterator itr = waiting.begin(); itr != waiting.end(); ) {
+                if ((*itr)->deadline > now) {
+                    itr++;
+                    continue;
+                }
+
+                std::unique_ptr<pending_request> request = std::move(*itr);
+                itr = waiting.erase(itr);
+
+                complete_callback(*request, make_error(suborigin, 0x10f3e, "The request to '%s' timed out.", request->key.c_str()), async_response());
+            }
+        }
+
+        // Wait until the nearest deadline.
+        clock::time_point next = clock::time_point::max();
+        for (const std::pair<const std::uint64_t, std::unique_ptr<connection>>& item : _connections) {
+            const connection& conn = *item.second;
+            next = std::min(next, conn.deadline);
+            if (conn.request != nullptr) {
+                next = std::min(next, conn.request->deadline);
+            }
+        }
+
+        for (const std::pair<const std::string, connection_pool>& item : _pools) {
+            for (const std::unique_ptr<pending_request>& request : item.second.waiting_requests) {
+                next = std::min(next, request->deadline);
+            }
+        }
+
+        if (next == clock::time_point::max()) {
+            return -1;
+        }
+
+        now = clock::now();
+        if (next <= now) {
+            return 0;
+        }
+
+        // Round up, so that the deadline has passed when the loop wakes up.
+        long long timeout = std::chrono::duration_cast<std::chrono::milliseconds>(next - now).count() + 1;
+        return static_cast<int>(std::min<long long>(timeout, INT_MAX));
+    }
+
+
+    inline void async_client::complete_callback(pending_request& request, std::exception_ptr error, async_response&& response) noexcept {
+        if (!request.callback) {
+            return;
+        }
+
+        // The callback is invoked exactly once.
+        async_callback callback = std::move(request.callback);
+        request.callback = nullptr;
+
+        try {
+            callback(error, std::move(response));
+        }
+        catch (...) {
+            ABC_DIAG_PUT_ANY(diag_base::put_any, "complete_callback()", diag::severity::warning, 0x10f3f, "The callback threw for key='%s'.", request.key.c_str());
+        }
+    }
+
+
+    inline std::exception_ptr async_client::make_error(const char* suborigin, diag::tag_t tag, const char* format, ...) const noexcept {
+        std::exception_ptr error;
+
+        std::va_list vlist;
+        va_start(vlist, format);
+
+        try {
+            diag_base::throw_exceptionv<std::runtime_error>(suborigin, tag, format, vlist);
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+
+        va_end(vlist);
+
+        return error;
+    }
+
+
+    // --------------------------------------------------------------
+
+} } }
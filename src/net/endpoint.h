@@ -25,18 +25,27 @@ SOFTWARE.
 
 #pragma once
 
+#include <algorithm>
+#include <cerrno>
 #include <iostream>
-#include <fstream>
 #include <system_error>
 #include <future>
 #include <thread>
 #include <atomic>
 #include <exception>
+#include <cstdlib>
+#include <cstdio>
 #include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
 #include <unistd.h>
 
+#include "../root/crc32c.h"
 #include "../diag/diag_ready.h"
 #include "socket.h"
 #include "http.h"
@@ -58,6 +67,439 @@ namespace abc { namespace net { namespace http {
     // --------------------------------------------------------------
 
 
+    inline file_cache::file_cache(std::size_t max_size, std::size_t max_file_size, diag::log_ostream* log)
+        : diag_base(copy<const char*>("abc::net::http::file_cache"), log)
+        , _max_size(max_size)
+        , _max_file_size(std::min(max_file_size, max_size))
+        , _size(0) {
+
+        constexpr const char* suborigin = "file_cache()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e90, "Begin: max_size=%zu, max_file_size=%zu", _max_size, _max_file_size);
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e91, "End:");
+    }
+
+
+    inline std::shared_ptr<const file_cache_entry> file_cache::get(const std::string& filepath) {
+        constexpr const char* suborigin = "get()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e92, "Begin: filepath='%s'", filepath.c_str());
+
+        // A stat() is much cheaper than reading the file, and it tells whether the cached content is still current.
+        struct stat st;
+        bool is_cacheable = ::stat(filepath.c_str(), &st) == 0 && S_ISREG(st.st_mode) && static_cast<std::size_t>(st.st_size) <= _max_file_size;
+
+        std::int64_t mtime_ns = 0;
+        if (is_cacheable) {
+            mtime_ns = static_cast<std::int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            std::map<std::string, slot>::iterator itr = _slots.find(filepath);
+            if (itr != _slots.end()) {
+                const file_cache_entry& entry = *itr->second.entry;
+
+                if (is_cacheable && entry.mtime_ns == mtime_ns && entry.inode == static_cast<std::uint64_t>(st.st_ino) && entry.content.size() == static_cast<std::size_t>(st.st_size)) {
+                    _recency.splice(_recency.begin(), _recency, itr->second.recency_itr);
+
+                    ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e93, "Return: hit");
+                    return itr->second.entry;
+                }
+
+                // The file has changed.
+                erase(itr);
+            }
+        }
+
+        if (!is_cacheable) {
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e94, "Return: not cacheable");
+            return nullptr;
+        }
+
+        // Read the file without holding the lock.
+        std::shared_ptr<const file_cache_entry> entry = load(filepath);
+        if (entry == nullptr) {
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e95, "Return: not loaded");
+            return nullptr;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            // Another thread may have loaded the same file in the meantime.
+            std::map<std::string, slot>::iterator itr = _slots.find(filepath);
+            if (itr != _slots.end()) {
+                erase(itr);
+            }
+
+            evict(entry->content.size());
+
+            _recency.push_front(filepath);
+            _slots[filepath] = slot{ entry, _recency.begin() };
+            _size += entry->content.size();
+
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10e96, "Loaded: size=%zu, etag=%s, cache_size=%zu", entry->content.size(), entry->etag.c_str(), _size);
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e97, "End: miss");
+
+        return entry;
+    }
+
+
+    inline void file_cache::clear() {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _slots.clear();
+        _recency.clear();
+        _size = 0;
+    }
+
+
+    inline std::size_t file_cache::size() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        return _size;
+    }
+
+
+    inline std::shared_ptr<const file_cache_entry> file_cache::load(const std::string& filepath) const {
+        constexpr const char* suborigin = "load()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e98, "Begin: filepath='%s'", filepath.c_str());
+
+        int file_fd = ::open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+        if (file_fd < 0) {
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e99, "Return: ::open() errno=%d", errno);
+            return nullptr;
+        }
+
+        struct stat st;
+        if (::fstat(file_fd, &st) != 0 || !S_ISREG(st.st_mode) || static_cast<std::size_t>(st.st_size) > _max_file_size) {
+            ::close(file_fd);
+
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e9a, "Return: ::fstat()");
+            return nullptr;
+        }
+
+        std::shared_ptr<file_cache_entry> entry = std::make_shared<file_cache_entry>();
+        entry->content.resize(static_cast<std::size_t>(st.st_size));
+        entry->mtime_ns = static_cast<std::int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+        entry->inode = static_cast<std::uint64_t>(st.st_ino);
+
+        std::size_t read_size = 0;
+        while (read_size < entry->content.size()) {
+            ssize_t chunk_size = ::pread(file_fd, &entry->content[read_size], entry->content.size() - read_size, static_cast<off_t>(read_size));
+            if (chunk_size < 0 && errno == EINTR) {
+                continue;
+            }
+
+            if (chunk_size <= 0) {
+                break;
+            }
+
+            read_size += static_cast<std::size_t>(chunk_size);
+        }
+
+        ::close(file_fd);
+
+        // A file that got truncated while being read will be reloaded on the next lookup.
+        if (read_size != entry->content.size()) {
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e9b, "Return: read_size=%zu, size=%zu", read_size, entry->content.size());
+            return nullptr;
+        }
+
+        // A strong entity tag must change whenever the content changes.
+        char etag[size::_64];
+        std::snprintf(etag, sizeof(etag), "\"%zx-%08x\"", entry->content.size(), (unsigned)crc32c(entry->content.data(), entry->content.size()));
+        entry->etag = etag;
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e9c, "End:");
+
+        return entry;
+    }
+
+
+    inline void file_cache::evict(std::size_t size) {
+        constexpr const char* suborigin = "evict()";
+
+        // The least recently used entry is at the back of the recency order.
+        while (!_recency.empty() && _size + size > _max_size) {
+            std::map<std::string, slot>::iterator lru_itr = _slots.find(_recency.back());
+
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10e9d, "Evicting: filepath='%s', size=%zu", lru_itr->first.c_str(), lru_itr->second.entry->content.size());
+
+            erase(lru_itr);
+        }
+    }
+
+
+    inline void file_cache::erase(std::map<std::string, slot>::iterator itr) {
+        _size -= itr->second.entry->content.size();
+        _recency.erase(itr->second.recency_itr);
+        _slots.erase(itr);
+    }
+
+
+    // --------------------------------------------------------------
+
+
+    inline route_params::route_params() noexcept
+        : count(0)
+        , names() {
+    }
+
+
+    inline span route_params::find(const char* name) const noexcept {
+        for (std::size_t i = 0; i < count; i++) {
+            if (ascii::are_equal(names[i], name)) {
+                return values[i];
+            }
+        }
+
+        return span();
+    }
+
+
+    // --------------------------------------------------------------
+
+
+    inline router::router(diag::log_ostream* log)
+        : diag_base(copy<const char*>("abc::net::http::router"), log)
+        , _nodes(1) {
+    }
+
+
+    inline void router::add(const char* method, const char* path_template, route_handler&& handler) {
+        route& route = insert(method, path_template);
+        route.handler = std::move(handler);
+        route.head_handler = nullptr;
+    }
+
+
+    inline void router::add(const char* method, const char* path_template, route_head_handler&& handler) {
+        route& route = insert(method, path_template);
+        route.handler = nullptr;
+        route.head_handler = std::move(handler);
+    }
+
+
+    inline router::route& router::insert(const char* method, const char* path_template) {
+        constexpr const char* suborigin = "insert()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10ede, "Begin: method='%s', path_template='%s'", method, path_template);
+
+        diag_base::expect(suborigin, method != nullptr && method[0] != '\0', 0x10edf, "method");
+        diag_base::expect(suborigin, path_template != nullptr && path_template[0] == '/', 0x10ee0, "path_template[0] == '/'");
+
+        std::size_t node_i = 0;
+        std::vector<std::string> param_names;
+
+        for (const char* segment = path_template + 1; ; ) {
+            const char* segment_end = std::strchr(segment, '/');
+            if (segment_end == nullptr) {
+                segment_end = segment + std::strlen(segment);
+            }
+
+            std::size_t len = segment_end - segment;
+
+            if (len >= 2 && segment[0] == '{' && segment[len - 1] == '}') {
+                // Parameter
+                param_names.emplace_back(segment + 1, len - 2);
+                diag_base::expect(suborigin, !param_names.back().empty(), 0x10ee1, "!param_name.empty()");
+                diag_base::expect(suborigin, param_names.size() <= max_route_params, 0x10ee2, "param_names.size() <= max_route_params");
+
+                if (_nodes[node_i].param == 0) {
+                    std::size_t child_i = _nodes.size();
+                    _nodes[node_i].param = child_i;
+                    _nodes.push_back(node());
+                }
+
+                node_i = _nodes[node_i].param;
+            }
+            else {
+                // Literal
+                std::string literal(segment, len);
+                diag_base::expect(suborigin, literal.find_first_of("{}") == std::string::npos, 0x10ee3, "segment='%s'", literal.c_str());
+
+                for (char& ch : literal) {
+                    ch = ascii::to_lower(ch);
+                }
+
+                std::vector<std::pair<std::string, std::size_t>>& literals = _nodes[node_i].literals;
+                std::vector<std::pair<std::string, std::size_t>>::iterator itr = std::lower_bound(literals.begin(), literals.end(), literal,
+                    [] (const std::pair<std::string, std::size_t>& item, const std::string& value) -> bool {
+                        return item.first < value;
+                    });
+
+                if (itr != literals.end() && itr->first == literal) {
+                    node_i = itr->second;
+                }
+                else {
+                    // Insert before growing _nodes, which invalidates `literals`.
+                    std::size_t child_i = _nodes.size();
+                    literals.insert(itr, std::make_pair(std::move(literal), child_i));
+                    _nodes.push_back(node());
+                    node_i = child_i;
+                }
+            }
+
+            if (*segment_end == '\0') {
+                break;
+            }
+
+            segment = segment_end + 1;
+        }
+
+        std::vector<route>& routes = _nodes[node_i].routes;
+        std::vector<route>::iterator itr = std::find_if(routes.begin(), routes.end(),
+            [method] (const route& item) -> bool {
+                return ascii::are_equal_i(item.method.c_str(), method);
+            });
+
+        if (itr != routes.end()) {
+            itr->param_names = std::move(param_names);
+        }
+        else {
+            routes.push_back(route { method, std::move(param_names), nullptr, nullptr });
+            itr = routes.end() - 1;
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10ee4, "End: node_i=%zu, node_count=%zu", node_i, _nodes.size());
+
+        return *itr;
+    }
+
+
+    inline route_status router::find(const char* method, const char* path, route_params& params, const route_handler*& handler) const {
+        if (method == nullptr || path == nullptr) {
+            params.count = 0;
+            handler = nullptr;
+            return route_status::not_found;
+        }
+
+        const route_head_handler* head_handler = nullptr;
+        return find(span(method, std::strlen(method)), span(path, std::strlen(path)), params, handler, head_handler);
+    }
+
+
+    inline route_status router::find(const span& method, const span& path, route_params& params, const route_handler*& handler, const route_head_handler*& head_handler) const {
+        params.count = 0;
+        handler = nullptr;
+        head_handler = nullptr;
+
+        if (path.size == 0 || path.data[0] != '/') {
+            return route_status::not_found;
+        }
+
+        std::size_t node_i = match(0, path.data + 1, path.data + path.size, params);
+        if (node_i == 0) {
+            return route_status::not_found;
+        }
+
+        for (const route& item : _nodes[node_i].routes) {
+            if (item.method.length() == method.size && ascii::are_equal_i_n(item.method.c_str(), method.data, method.size)) {
+                // All routes that end at the same node have parameters at the same positions.
+                for (std::size_t i = 0; i < params.count; i++) {
+                    params.names[i] = item.param_names[i].c_str();
+                }
+
+                if (item.head_handler) {
+                    head_handler = &item.head_handler;
+                }
+                else {
+                    handler = &item.handler;
+                }
+
+                return route_status::found;
+            }
+        }
+
+        params.count = 0;
+        return route_status::method_not_allowed;
+    }
+
+
+    inline std::size_t router::match(std::size_t node_i, const char* segment, const char* path_end, route_params& params) const {
+        const node& node = _nodes[node_i];
+
+        const char* segment_end = static_cast<const char*>(std::memchr(segment, '/', path_end - segment));
+        bool is_last = segment_end == nullptr;
+        if (is_last) {
+            segment_end = path_end;
+        }
+
+        std::size_t len = segment_end - segment;
+
+        // A literal takes precedence. Binary search for it.
+        std::size_t low = 0;
+        std::size_t high = node.literals.size();
+        while (low < high) {
+            std::size_t mid = low + (high - low) / 2;
+            int cmp = compare_segment(node.literals[mid].first, segment, len);
+
+            if (cmp < 0) {
+                low = mid + 1;
+            }
+            else if (cmp > 0) {
+                high = mid;
+            }
+            else {
+                std::size_t child_i = node.literals[mid].second;
+                std::size_t end_i = is_last
+                    ? (_nodes[child_i].routes.empty() ? 0 : child_i)
+                    : match(child_i, segment_end + 1, path_end, params);
+
+                if (end_i != 0) {
+                    return end_i;
+                }
+
+                break;
+            }
+        }
+
+        // Otherwise, try a parameter.
+        if (node.param != 0 && len > 0 && params.count < max_route_params) {
+            std::size_t count = params.count;
+            params.values[params.count++] = span(segment, len);
+
+            std::size_t end_i = is_last
+                ? (_nodes[node.param].routes.empty() ? 0 : node.param)
+                : match(node.param, segment_end + 1, path_end, params);
+
+            if (end_i != 0) {
+                return end_i;
+            }
+
+            params.count = count;
+        }
+
+        return 0;
+    }
+
+
+    inline int router::compare_segment(const std::string& literal, const char* segment, std::size_t len) noexcept {
+        std::size_t common_len = std::min(literal.length(), len);
+
+        for (std::size_t i = 0; i < common_len; i++) {
+            unsigned char literal_ch = static_cast<unsigned char>(literal[i]);
+            unsigned char segment_ch = static_cast<unsigned char>(ascii::to_lower(segment[i]));
+
+            if (literal_ch != segment_ch) {
+                return literal_ch < segment_ch ? -1 : 1;
+            }
+        }
+
+        if (literal.length() == len) {
+            return 0;
+        }
+
+        return literal.length() < len ? -1 : 1;
+    }
+
+
+    // --------------------------------------------------------------
+
+
     inline endpoint::endpoint(endpoint_config&& config, diag::log_ostream* log)
         : endpoint("abc::net::http::endpoint", std::move(config), log) {
     }
@@ -66,25 +508,37 @@ namespace abc { namespace net { namespace http {
     inline endpoint::endpoint(const char* origin, endpoint_config&& config, diag::log_ostream* log)
         : diag_base(copy(origin), log)
         , _config(std::move(config))
+        , _file_cache(_config.file_cache_size, _config.file_cache_max_file_size, log)
+        , _router(log)
         , _requests_in_progress(0)
-        , _is_shutdown_requested(false) {
+        , _is_shutdown_requested(false)
+        , _epoll_fd(-1)
+        , _is_stopping(false) {
 
         constexpr const char* suborigin = "endpoint()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108b7, "Begin: port='%s', queue_size=%d, rood_dir='%s', files_prefix='%s'",
-                            _config.port.c_str(), _config.listen_queue_size, _config.root_dir.c_str(), _config.files_prefix.c_str());
-
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108b8, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108b7, "Begin: port='%s', queue_size=%zu, rood_dir='%s', files_prefix='%s', worker_count=%zu, max_requests_per_connection=%zu, keep_alive_timeout=%lld, file_cache_size=%zu, file_cache_max_file_size=%zu",
+                            _config.port.c_str(), _config.listen_queue_size, _config.root_dir.c_str(), _config.files_prefix.c_str(), _config.worker_count,
+                            _config.max_requests_per_connection, (long long)_config.keep_alive_timeout.count(), _config.file_cache_size, _config.file_cache_max_file_size);
+
+        // Support a graceful shutdown.
+        add_route(method::POST, "/shutdown",
+            [this] (server& http, const request& /*request*/, const route_params& /*params*/) {
+                set_shutdown_requested();
+                send_simple_response(http, status_code::OK, reason_phrase::OK, content_type::text, "Server is shutting down...", 0x10ee5);
+            });
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108b8, "End:");
     }
 
 
     inline std::future<void> endpoint::start_async() {
         constexpr const char* suborigin = "start_async()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108b9, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108b9, "Begin:");
 
         // We can't use std::async() here because we want to detach the thread and return our own std::future.
         std::thread(start_thread_func, this).detach();
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108ba, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108ba, "End:");
 
         // Return our own future.
         return _promise.get_future();
@@ -92,58 +546,361 @@ namespace abc { namespace net { namespace http {
 
 
     inline void endpoint::start_thread_func(endpoint* this_ptr) {
-        this_ptr->start();
+        // An exception must not escape a detached thread. It is passed to the owner through the future instead.
+        try {
+            this_ptr->start();
+        }
+        catch (...) {
+            this_ptr->_promise.set_exception(std::current_exception());
+        }
     }
 
 
     inline void endpoint::start() {
         constexpr const char* suborigin = "start_async()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x102f1, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x102f1, "Begin:");
 
         // Create a listener, bind to a port, and start listening.
         std::unique_ptr<net::tcp_server_socket> listener = create_server_socket();
         listener->bind(_config.port.c_str());
         listener->listen(_config.listen_queue_size);
 
-        diag_base::put_any(suborigin, diag::severity::important, 0x102f2, "Listening (port='%s')", _config.port.c_str());
+        // The event loop must never block on accept.
+        listener->set_blocking(false);
+
+        _epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+        diag_base::require(suborigin, _epoll_fd != -1, 0x10e3f, "::epoll_create1() errno=%d", errno);
+
+        epoll_event listener_event{ };
+        listener_event.events = EPOLLIN;
+        listener_event.data.fd = listener->fd();
+        int err = ::epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, listener->fd(), &listener_event);
+        diag_base::require(suborigin, err == 0, 0x10e40, "::epoll_ctl() errno=%d", errno);
+
+        // Start the workers.
+        _is_stopping = false;
+        std::size_t worker_count = _config.worker_count > 0 ? _config.worker_count : std::max(1u, std::thread::hardware_concurrency());
+        std::vector<std::thread> workers;
+
+        try {
+            for (std::size_t i = 0; i < worker_count; i++) {
+                workers.emplace_back(worker_thread_func, this, listener.get());
+            }
+
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::important, 0x102f2, "Listening (port='%s', worker_count=%zu)", _config.port.c_str(), worker_count);
+            diag_base::put_blank_line(diag::severity::important);
+
+            run_event_loop(listener.get());
+        }
+        catch (...) {
+            // The workers must be joined before they are destroyed, or the process terminates.
+            stop_workers(workers);
+            throw;
+        }
+
+        stop_workers(workers);
+        listener.reset();
+
         diag_base::put_blank_line(diag::severity::important);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::important, 0x102f3, "Stopped (port='%s')", _config.port.c_str());
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108bb, "End:");
+
+        // The owner may destroy this instance as soon as the promise is set. So nothing may follow.
+        _promise.set_value();
+    }
+
+
+    inline void endpoint::run_event_loop(const net::tcp_server_socket* listener) {
+        constexpr const char* suborigin = "run_event_loop()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10fc4, "Begin:");
+
+        // While the process is out of descriptors, the listener is taken off the poll set, so that the pending connections don't keep waking up the loop.
+        bool is_accept_paused = false;
+        std::chrono::steady_clock::time_point accept_paused_since;
 
         while (_requests_in_progress != 0 || !_is_shutdown_requested) {
-            // Accept the next request and process it asynchronously.
-            std::unique_ptr<net::tcp_client_socket> connection = listener->accept();
-            std::thread(process_request_thread_func, this, std::move(connection)).detach();
+            if (is_accept_paused && std::chrono::steady_clock::now() - accept_paused_since >= endpoint_poll_timeout) {
+                epoll_event listener_event{ };
+                listener_event.events = EPOLLIN;
+                listener_event.data.fd = listener->fd();
+                int err = ::epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, listener->fd(), &listener_event);
+                diag_base::require(suborigin, err == 0, 0x10fc5, "::epoll_ctl() errno=%d", errno);
+
+                is_accept_paused = false;
+            }
+
+            // Close the idle connections that have timed out.
+            // The sockets are destroyed outside the lock.
+            std::vector<connection_entry> expired;
+            {
+                std::lock_guard<std::mutex> lock(_queue_mutex);
+
+                std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+                for (auto itr = _idle_connections.begin(); itr != _idle_connections.end(); ) {
+                    if (_is_shutdown_requested || now - itr->second.idle_since >= _config.keep_alive_timeout) {
+                        ::epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, itr->first, nullptr);
+                        expired.push_back(std::move(itr->second));
+                        itr = _idle_connections.erase(itr);
+                    }
+                    else {
+                        ++itr;
+                    }
+                }
+            }
+
+            if (!expired.empty()) {
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10e47, "Closing idle connections: count=%zu", expired.size());
+                expired.clear();
+            }
+
+            // While the queue is full, new connections are left in the listen backlog.
+            {
+                std::unique_lock<std::mutex> lock(_queue_mutex);
+                if (!_queue_not_full.wait_for(lock, endpoint_poll_timeout, [this] () { return _accept_queue.size() < _config.listen_queue_size; })) {
+                    continue;
+                }
+            }
+
+            epoll_event events[size::_64];
+            int event_count = ::epoll_wait(_epoll_fd, events, size::_64, static_cast<int>(endpoint_poll_timeout.count()));
+            if (event_count <= 0) {
+                // Timeout or interrupt.
+                continue;
+            }
+
+            std::size_t queued_count = 0;
+            {
+                std::lock_guard<std::mutex> lock(_queue_mutex);
+
+                for (int e = 0; e < event_count; e++) {
+                    if (events[e].data.fd == listener->fd()) {
+                        // Accept as many pending connections as the queue can take.
+                        while (_accept_queue.size() < _config.listen_queue_size) {
+                            bool is_exhausted = false;
+                            socket::fd_t fd = listener->try_accept_fd(is_exhausted);
+
+                            if (is_exhausted) {
+                                // Back off until the next poll. Meanwhile, the workers may release some descriptors.
+                                ::epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, listener->fd(), nullptr);
+                                is_accept_paused = true;
+                                accept_paused_since = std::chrono::steady_clock::now();
+                                break;
+                            }
+
+                            if (fd == socket::fd::invalid) {
+                                break;
+                            }
+
+                            connection_entry entry;
+                            entry.fd = fd;
+                            entry.request_count = 0;
+                            _accept_queue.push_back(std::move(entry));
+                            queued_count++;
+                        }
+                    }
+                    else {
+                        // The next request has arrived over an idle connection. It doesn't count against the queue limit, because it has already been accepted.
+                        auto itr = _idle_connections.find(events[e].data.fd);
+                        if (itr != _idle_connections.end()) {
+                            ::epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, itr->first, nullptr);
+                            _accept_queue.push_back(std::move(itr->second));
+                            _idle_connections.erase(itr);
+                            queued_count++;
+                        }
+                    }
+                }
+            }
+
+            for (std::size_t i = 0; i < queued_count; i++) {
+                _queue_not_empty.notify_one();
+            }
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108bb, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10fc6, "End:");
     }
 
 
-    inline void endpoint::process_request_thread_func(endpoint* this_ptr, std::unique_ptr<net::tcp_client_socket>&& connection) {
-        this_ptr->process_request(std::move(connection));
+    inline void endpoint::stop_workers(std::vector<std::thread>& workers) {
+        constexpr const char* suborigin = "stop_workers()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10fc7, "Begin: worker_count=%zu", workers.size());
+
+        {
+            std::lock_guard<std::mutex> lock(_queue_mutex);
+            _is_stopping = true;
+        }
+        _queue_not_empty.notify_all();
+
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+
+        // Connections that were not picked up by a worker are dropped.
+        // Connections that have not been accepted by a worker yet are only descriptors.
+        for (connection_entry& entry : _accept_queue) {
+            if (entry.connection == nullptr) {
+                ::close(entry.fd);
+            }
+        }
+        _accept_queue.clear();
+        _idle_connections.clear();
+
+        ::close(_epoll_fd);
+        _epoll_fd = -1;
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10fc8, "End:");
     }
 
 
-    inline void endpoint::process_request(std::unique_ptr<net::tcp_client_socket>&& connection) {
-        constexpr const char* suborigin = "process_request()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x102de, "Begin:");
+    inline void endpoint::worker_thread_func(endpoint* this_ptr, const net::tcp_server_socket* listener) {
+        this_ptr->process_connections(listener);
+    }
 
-        // If shutdown has been requested, bail out without any processing.
-        if (_is_shutdown_requested) {
-            diag_base::put_any(suborigin, diag::severity::callstack, 0x108bc, "Return: Shutdown requested.");
+
+    inline void endpoint::process_connections(const net::tcp_server_socket* listener) {
+        constexpr const char* suborigin = "process_connections()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e41, "Begin:");
+
+        while (true) {
+            connection_entry entry;
+            {
+                std::unique_lock<std::mutex> lock(_queue_mutex);
+                _queue_not_empty.wait(lock, [this] () { return _is_stopping || !_accept_queue.empty(); });
+
+                if (_is_stopping) {
+                    break;
+                }
+
+                entry = std::move(_accept_queue.front());
+                _accept_queue.pop_front();
+
+                // Counted while the lock is held, so that the event loop doesn't see a gap.
+                ++_requests_in_progress;
+            }
+
+            _queue_not_full.notify_one();
+
+            try {
+                // The handshake, if any, is done here rather than on the event loop.
+                if (entry.connection == nullptr) {
+                    entry.connection = listener->accept(entry.fd);
+                }
+
+                if (process_connection(entry.connection.get(), entry.request_count)) {
+                    park_connection(std::move(entry));
+                }
+            }
+            catch (const std::exception& ex) {
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::important, 0x10e42, "Request failed: %s", ex.what());
+            }
+
+            // Unless the connection has been parked, it gets closed here, before it stops counting as in progress.
+            entry.connection.reset();
+            --_requests_in_progress;
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e43, "End:");
+    }
+
+
+    inline void endpoint::park_connection(connection_entry&& entry) {
+        constexpr const char* suborigin = "park_connection()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e48, "Begin: fd=%d, request_count=%zu", entry.fd, entry.request_count);
+
+        std::lock_guard<std::mutex> lock(_queue_mutex);
+
+        // If the endpoint is stopping, the connection gets closed by the caller.
+        if (_is_stopping || _is_shutdown_requested) {
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e49, "Return: Shutdown requested.");
             return;
         }
 
+        // Register the descriptor while the lock is held, so that the event loop finds the entry when the descriptor becomes readable.
+        epoll_event event{ };
+        event.events = EPOLLIN;
+        event.data.fd = entry.fd;
+        int err = ::epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, entry.fd, &event);
+        diag_base::require(suborigin, err == 0, 0x10e4a, "::epoll_ctl() errno=%d", errno);
+
+        socket::fd_t fd = entry.fd;
+        entry.idle_since = std::chrono::steady_clock::now();
+        _idle_connections.emplace(fd, std::move(entry));
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e4b, "End:");
+    }
+
+
+    inline bool endpoint::process_connection(net::tcp_client_socket* connection, std::size_t& request_count) {
+        constexpr const char* suborigin = "process_connection()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e4c, "Begin: request_count=%zu", request_count);
+
         // Create a tcp_client_socket_streambuf over the connection.
-        tcp_client_socket_streambuf sb(connection.get(), diag_base::log());
+        // It lives only while there are received bytes, so nothing is lost when it is destroyed.
+        tcp_client_socket_streambuf sb(connection, diag_base::log());
+
+        bool keep_alive = true;
+        do {
+            // The client may close the connection instead of sending another request.
+            if (std::char_traits<char>::eq_int_type(sb.sgetc(), std::char_traits<char>::eof())) {
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10e4d, "Connection closed by the client: request_count=%zu", request_count);
+                keep_alive = false;
+                break;
+            }
+
+            request_count++;
+            bool is_last = _config.max_requests_per_connection > 0 && request_count >= _config.max_requests_per_connection;
+
+            keep_alive = process_request(sb, is_last) && !is_last && !_is_shutdown_requested;
+        }
+        // Pipelined requests that have already been received are processed right away.
+        while (keep_alive && (sb.in_avail() > 0 || connection->pending_receive_size() > 0));
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e4e, "End: keep_alive=%d, request_count=%zu", keep_alive, request_count);
+
+        return keep_alive;
+    }
+
+
+    inline bool endpoint::process_request(tcp_client_socket_streambuf& sb, bool is_last) {
+        constexpr const char* suborigin = "process_request()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x102de, "Begin: is_last=%d", is_last);
+
+        // If shutdown has been requested, bail out without any processing.
+        if (_is_shutdown_requested) {
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108bc, "Return: Shutdown requested.");
+            return false;
+        }
 
         // Create an http::server, which combines http::request_reader and http::response_writer.
+        // It is created per request, so that it starts in the right state.
         http::server http(&sb, diag_base::log());
 
+        // Parse the head in place while it fits in the receive buffer.
+        request_head head;
+        bool is_in_place = read_request_head(sb, head);
+
+        // Requests whose route has a route_head_handler are processed straight from the head, without making an http::request.
+        if (is_in_place && !is_file_request(head)) {
+            route_params params;
+            const route_handler* handler = nullptr;
+            const route_head_handler* head_handler = nullptr;
+
+            if (_router.find(head.method, head.path(), params, handler, head_handler) == route_status::found && head_handler != nullptr) {
+                bool keep_alive = process_head_request(http, sb, head, params, *head_handler, is_last);
+
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f63, "End: keep_alive=%d", keep_alive);
+
+                return keep_alive;
+            }
+        }
+
         // Read the request.
-        http::request request = http.get_request();
-        diag_base::put_any(suborigin, diag::severity::optional, 0x102e1, "Request received: protocol='%s', method='%s', path='%s'", request.protocol.c_str(), request.method.c_str(), request.resource.path.c_str());
+        http::request request = read_request(http, sb, is_in_place ? &head : nullptr);
+        std::size_t body_offset = sb.total_get_count();
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x102e1, "Request received: protocol='%s', method='%s', path='%s'", request.protocol.c_str(), request.method.c_str(), request.resource.path.c_str());
 
-        ++_requests_in_progress;
+        bool keep_alive = !is_last && is_keep_alive_request(request);
+        body_framing framing = get_body_framing(request.headers);
 
         // This endpoint supports two kinds of requests:
         //    a) requests for static files
@@ -155,101 +912,615 @@ namespace abc { namespace net { namespace http {
             process_rest_request(http, request);
         }
 
-        diag_base::put_any(suborigin, diag::severity::optional, 0x102e1, "Done processing request: protocol='%s', method='%s', path='%s'", request.protocol.c_str(), request.method.c_str(), request.resource.path.c_str());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x102e1, "Done processing request: protocol='%s', method='%s', path='%s'", request.protocol.c_str(), request.method.c_str(), request.resource.path.c_str());
         diag_base::put_blank_line(diag::severity::optional);
 
-        if (--_requests_in_progress == 0 && _is_shutdown_requested) {
-            diag_base::put_blank_line(diag::severity::important);
-            diag_base::put_any(suborigin, diag::severity::important, 0x102f3, "Stopped (port='%s')", _config.port.c_str());
+        // The next request can only be read if the end of this one is known.
+        keep_alive = keep_alive && skip_request_body(http, sb, framing, body_offset);
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108bd, "End: keep_alive=%d", keep_alive);
+
+        return keep_alive;
+    }
+
+
+    inline bool endpoint::read_request_head(tcp_client_socket_streambuf& sb, request_head& head) {
+        constexpr const char* suborigin = "read_request_head()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10eb6, "Begin:");
+
+        head_status status = head_status::incomplete;
+
+        for (;;) {
+            std::size_t size = 0;
+            const char* data = sb.peek_received(size);
+
+            status = util::parse_request_head(data, size, head);
+            if (status != head_status::incomplete || sb.receive_more() == 0) {
+                break;
+            }
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10eb7, "End: status=%u", (unsigned)status);
+
+        return status == head_status::complete;
+    }
+
+
+    inline request endpoint::read_request(server& http, tcp_client_socket_streambuf& sb, const request_head* head) {
+        constexpr const char* suborigin = "read_request()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f64, "Begin: in_place=%d", head != nullptr);
+
+        if (head != nullptr) {
+            request request = http.get_request(*head);
+            sb.skip_received(head->size);
+
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f65, "End: in place");
+            return request;
+        }
+
+        // Nothing has been consumed, so the stream reader starts at the beginning of the request.
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10eb8, "Reading the request as a stream.");
+
+        request request = http.get_request();
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10eb9, "End: stream");
+
+        return request;
+    }
+
+
+    inline bool endpoint::process_head_request(server& http, tcp_client_socket_streambuf& sb, const request_head& head, const route_params& params, const route_head_handler& head_handler, bool is_last) {
+        constexpr const char* suborigin = "process_head_request()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f66, "Begin: is_last=%d", is_last);
+
+        http.start_body(head);
+        sb.skip_received(head.size);
+        std::size_t body_offset = sb.total_get_count();
+
+        span path = head.path();
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10f67, "Request received in place: method='%.*s', path='%.*s', param_count=%zu",
+            (int)head.method.size, head.method.data, (int)path.size, path.data, params.count);
+
+        // The head is only valid until the handler reads the body. So everything that is needed after that is determined now.
+        bool keep_alive = !is_last && is_keep_alive_request(head);
+        body_framing framing = get_body_framing(head);
+
+        try {
+            head_handler(http, head, params);
+        }
+        catch (const endpoint_error& err) {
+            send_simple_response(http, err.status_code, err.reason_phrase.c_str(), err.content_type.c_str(), err.body.c_str(), err.tag);
+        }
+
+        diag_base::put_blank_line(diag::severity::optional);
 
-            _promise.set_value();
+        // The next request can only be read if the end of this one is known.
+        keep_alive = keep_alive && skip_request_body(http, sb, framing, body_offset);
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f68, "End: keep_alive=%d", keep_alive);
+
+        return keep_alive;
+    }
+
+
+    inline bool endpoint::is_keep_alive_request(const request& request) const {
+        http::headers::const_iterator connection_itr = request.headers.find(header::Connection);
+        span connection = connection_itr != request.headers.cend() ? span(connection_itr->second.data(), connection_itr->second.length()) : span();
+
+        return is_keep_alive(span(request.protocol.data(), request.protocol.length()), connection_itr != request.headers.cend() ? &connection : nullptr);
+    }
+
+
+    inline bool endpoint::is_keep_alive_request(const request_head& head) const noexcept {
+        return is_keep_alive(head.protocol, head.find_header(header::Connection));
+    }
+
+
+    inline bool endpoint::is_keep_alive(const span& request_protocol, const span* connection_value) noexcept {
+        // HTTP/1.0 clients have to opt in, but they expect the response to say so as well. So they are not kept alive.
+        if (!request_protocol.equals_i(protocol::HTTP_11)) {
+            return false;
+        }
+
+        if (connection_value == nullptr) {
+            return true;
+        }
+
+        // The value is a comma-separated list of tokens.
+        std::size_t close_len = std::strlen(connection::close);
+
+        return !util::any_list_item(*connection_value,
+            [close_len] (const char* token, std::size_t token_len) -> bool {
+                return token_len == close_len && ascii::are_equal_i_n(token, connection::close, close_len);
+            });
+    }
+
+
+    inline endpoint::body_framing endpoint::get_body_framing(const headers& headers) {
+        http::headers::const_iterator transfer_encoding_itr = headers.find(header::Transfer_Encoding);
+        span transfer_encoding = transfer_encoding_itr != headers.cend() ? span(transfer_encoding_itr->second.data(), transfer_encoding_itr->second.length()) : span();
+
+        http::headers::const_iterator content_length_itr = headers.find(header::Content_Length);
+        span content_length = content_length_itr != headers.cend() ? span(content_length_itr->second.data(), content_length_itr->second.length()) : span();
+
+        return get_body_framing(util::is_chunked(headers),
+                    transfer_encoding_itr != headers.cend() ? &transfer_encoding : nullptr,
+                    content_length_itr != headers.cend() ? &content_length : nullptr);
+    }
+
+
+    inline endpoint::body_framing endpoint::get_body_framing(const request_head& head) noexcept {
+        return get_body_framing(util::is_chunked(head), head.find_header(header::Transfer_Encoding), head.find_header(header::Content_Length));
+    }
+
+
+    inline endpoint::body_framing endpoint::get_body_framing(bool is_chunked, const span* transfer_encoding, const span* content_length) noexcept {
+        body_framing framing { is_chunked, true, 0 };
+
+        // A chunked body is delimited by its last chunk. Other codings are not delimited.
+        if (is_chunked || transfer_encoding != nullptr) {
+            framing.is_delimited = is_chunked;
+            return framing;
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108bd, "End:");
+        // Without a Content-Length, only requests without a body can be delimited.
+        if (content_length != nullptr) {
+            framing.is_delimited = content_length->size > 0;
+
+            for (std::size_t i = 0; i < content_length->size && framing.is_delimited; i++) {
+                char ch = content_length->data[i];
+                std::size_t digit = static_cast<std::size_t>(ch - '0');
+
+                framing.is_delimited = ascii::is_digit(ch) && framing.content_length <= (static_cast<std::size_t>(-1) - digit) / 10;
+                if (framing.is_delimited) {
+                    framing.content_length = framing.content_length * 10 + digit;
+                }
+            }
+        }
+
+        return framing;
+    }
+
+
+    inline bool endpoint::skip_request_body(server& http, tcp_client_socket_streambuf& sb, const body_framing& framing, std::size_t body_offset) {
+        constexpr const char* suborigin = "skip_request_body()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e4f, "Begin:");
+
+        // A chunked body is skipped by decoding it.
+        // If it has been read around the decoder, the decoder fails, and the connection cannot be reused.
+        if (framing.is_chunked) {
+            while (!http.is_body_complete() && !http.get_body(size::k4).empty()) {
+            }
+
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e68, "Return: is_body_complete=%d", http.is_body_complete());
+            return http.is_body_complete();
+        }
+
+        if (!framing.is_delimited) {
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e50, "Return: Not delimited");
+            return false;
+        }
+
+        std::size_t content_length = framing.content_length;
+
+        // If more than the body has been read, the stream is out of sync.
+        std::size_t read_size = sb.total_get_count() - body_offset;
+        if (read_size > content_length) {
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e52, "Return: read_size=%zu, content_length=%zu", read_size, content_length);
+            return false;
+        }
+
+        std::size_t skip_size = content_length - read_size;
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10e53, "skip_size=%zu", skip_size);
+
+        char buffer[size::k4];
+        while (skip_size > 0) {
+            std::streamsize chunk_size = static_cast<std::streamsize>(std::min(skip_size, sizeof(buffer)));
+            std::streamsize got_size = sb.sgetn(buffer, chunk_size);
+            if (got_size <= 0) {
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e54, "Return: eof");
+                return false;
+            }
+
+            skip_size -= static_cast<std::size_t>(got_size);
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e55, "End:");
+
+        return true;
     }
 
 
     inline void endpoint::process_file_request(server& http, const request& request) {
         constexpr const char* suborigin = "process_file_request()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x102e4, "Begin: method='%s', path='%s'", request.method.c_str(), request.resource.path.c_str());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x102e4, "Begin: method='%s', path='%s'", request.method.c_str(), request.resource.path.c_str());
 
         // If the method is not GET, return 405.
         if (!ascii::are_equal_i(request.method.c_str(), method::GET)) {
             send_simple_response(http, status_code::Method_Not_Allowed, reason_phrase::Method_Not_Allowed, content_type::text, "GET is the only supported method for static files.", 0x102e5);
-            diag_base::put_any(suborigin, diag::severity::callstack, 0x108be, "Return: 405");
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108be, "Return: 405");
             return;
         }
 
         std::string filepath = make_root_dir_path(request);
-        diag_base::put_any(suborigin, diag::severity::optional, 0x102e6, "filepath='%s'", filepath.c_str());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x102e6, "filepath='%s'", filepath.c_str());
+
+        // Small files are served from memory.
+        if (_config.file_cache_size > 0) {
+            std::shared_ptr<const file_cache_entry> entry = _file_cache.get(filepath);
+
+            if (entry != nullptr) {
+                send_cached_file(http, request, filepath, std::move(entry));
+
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e9e, "Return: cached");
+                return;
+            }
+        }
+
+        int file_fd = ::open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
 
         struct stat st;
-        int err = ::stat(filepath.c_str(), &st);
+        int err = file_fd < 0 ? -1 : ::fstat(file_fd, &st);
 
         // If the file was not found, return 404.
-        if (err != 0) {
+        if (err != 0 || !S_ISREG(st.st_mode)) {
+            if (file_fd >= 0) {
+                ::close(file_fd);
+            }
+
             send_simple_response(http, status_code::Not_Found, reason_phrase::Not_Found, content_type::text, "Error: The requested resource was not found.", 0x102e7);
-            diag_base::put_any(suborigin, diag::severity::callstack, 0x108bf, "Return: 404");
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108bf, "Return: 404");
             return;
         }
 
-        // The file was found, return 200.
-        std::size_t fsize = static_cast<std::size_t>(st.st_size);
-        std::string content_length = std::to_string(fsize);
+        try {
+            std::size_t begin = 0;
+            std::size_t end = 0;
 
-        diag_base::put_any(suborigin, diag::severity::optional, 0x102e9, "Status Code    = 200");
-        diag_base::put_any(suborigin, diag::severity::optional, 0x102e8, "Content-Length = %s", content_length.c_str());
+            response response;
+            bool has_body = make_file_response(request, filepath.c_str(), static_cast<std::size_t>(st.st_size), response, begin, end);
+
+            http.put_response(response);
+
+            if (has_body) {
+                send_file_body(http, file_fd, begin, end - begin);
+            }
+        }
+        catch (...) {
+            ::close(file_fd);
+            throw;
+        }
+
+        ::close(file_fd);
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108c0, "End:");
+    }
+
+
+    inline bool endpoint::make_file_response(const request& request, const char* filepath, std::size_t file_size, response& response, std::size_t& begin, std::size_t& end) {
+        constexpr const char* suborigin = "make_file_response()";
+
+        begin = 0;
+        end = file_size;
+        bool is_satisfiable = true;
+
+        http::headers::const_iterator range_itr = request.headers.find(header::Range);
+        bool is_range = range_itr != request.headers.cend() && parse_range(range_itr->second, file_size, begin, end, is_satisfiable);
 
-        response response;
         response.protocol = protocol::HTTP_11;
-        response.status_code = status_code::OK;
-        response.reason_phrase = reason_phrase::OK;
-        response.headers = {
-            { header::Content_Length, std::move(content_length) },
-        }; 
+        response.headers[header::Accept_Ranges] = "bytes";
+
+        if (!is_satisfiable) {
+            // The range is outside the file, return 416.
+            response.status_code = status_code::Range_Not_Satisfiable;
+            response.reason_phrase = reason_phrase::Range_Not_Satisfiable;
+            response.headers[header::Content_Range] = "bytes */" + std::to_string(file_size);
+            response.headers[header::Content_Length] = "0";
+
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10e82, "Status Code    = 416");
+            return false;
+        }
+
+        // The file was found, return 200, or 206 for a range.
+        std::string content_length = std::to_string(end - begin);
 
-        const char* content_type = get_content_type_from_path(filepath.c_str());
+        if (is_range) {
+            response.status_code = status_code::Partial_Content;
+            response.reason_phrase = reason_phrase::Partial_Content;
+            response.headers[header::Content_Range] = "bytes " + std::to_string(begin) + "-" + std::to_string(end - 1) + "/" + std::to_string(file_size);
+        }
+        else {
+            response.status_code = status_code::OK;
+            response.reason_phrase = reason_phrase::OK;
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x102e9, "Status Code    = %u", (unsigned)response.status_code);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x102e8, "Content-Length = %s", content_length.c_str());
+
+        response.headers[header::Content_Length] = std::move(content_length);
+
+        const char* content_type = get_content_type_from_path(filepath);
         if (content_type != nullptr) {
             response.headers[header::Content_Type] = std::string(content_type);
         }
 
+        return true;
+    }
+
+
+    inline void endpoint::send_cached_file(server& http, const request& request, const std::string& filepath, std::shared_ptr<const file_cache_entry>&& entry) {
+        constexpr const char* suborigin = "send_cached_file()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e9f, "Begin: filepath='%s'", filepath.c_str());
+
+        response response;
+        response.headers[header::Vary] = header::Accept_Encoding;
+
+        // Prefer a precompressed sibling that the client accepts, unless it is older than the file itself.
+        http::headers::const_iterator accept_encoding_itr = request.headers.find(header::Accept_Encoding);
+        if (accept_encoding_itr != request.headers.cend()) {
+            static constexpr const char* encodings[][2] = {
+                { content_encoding::br,   ".br" },
+                { content_encoding::gzip, ".gz" },
+            };
+
+            for (const auto& encoding : encodings) {
+                if (is_encoding_accepted(accept_encoding_itr->second, encoding[0])) {
+                    std::shared_ptr<const file_cache_entry> variant = _file_cache.get(filepath + encoding[1]);
+
+                    if (variant != nullptr && variant->mtime_ns >= entry->mtime_ns) {
+                        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10ea0, "Content-Encoding = %s", encoding[0]);
+
+                        response.headers[header::Content_Encoding] = encoding[0];
+                        entry = std::move(variant);
+                        break;
+                    }
+                }
+            }
+        }
+
+        response.headers[header::ETag] = entry->etag;
+
+        // If the client has the same content, return 304.
+        http::headers::const_iterator if_none_match_itr = request.headers.find(header::If_None_Match);
+        if (if_none_match_itr != request.headers.cend() && is_etag_matched(if_none_match_itr->second, entry->etag)) {
+            response.protocol = protocol::HTTP_11;
+            response.status_code = status_code::Not_Modified;
+            response.reason_phrase = reason_phrase::Not_Modified;
+            response.headers.erase(header::Content_Encoding);
+
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10ea1, "Status Code    = 304");
+
+            http.put_response(response);
+
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10ea2, "Return: 304");
+            return;
+        }
+
+        std::size_t begin = 0;
+        std::size_t end = 0;
+        bool has_body = make_file_response(request, filepath.c_str(), entry->content.size(), response, begin, end);
+
         http.put_response(response);
 
-        std::ifstream file(filepath);
-        char file_chunk[size::k4];
-        for (std::size_t sent_size = 0; sent_size < fsize; sent_size += sizeof(file_chunk)) {
-            file.read(file_chunk, sizeof(file_chunk));
-            http.put_body(file_chunk, file.gcount());
+        if (has_body && end > begin) {
+            http.put_body(entry->content.data() + begin, end - begin);
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10ea3, "End:");
+    }
+
+
+    inline void endpoint::send_file_body(server& http, int file_fd, std::size_t begin, std::size_t size) {
+        constexpr const char* suborigin = "send_file_body()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e83, "Begin: begin=%zu, size=%zu", begin, size);
+
+        // Over a socket, the file goes straight to the socket, which may not copy it through user space.
+        std::streambuf* sb = static_cast<const request_reader&>(http).rdbuf();
+        tcp_client_socket_streambuf* socket_sb = dynamic_cast<tcp_client_socket_streambuf*>(sb);
+
+        if (socket_sb != nullptr) {
+            std::size_t sent_size = socket_sb->send_file(file_fd, begin, size);
+
+            // A partial body cannot be recovered from. The connection must be closed.
+            diag_base::require(suborigin, sent_size == size, 0x10e84, "send_file() sent_size=%zu, size=%zu", sent_size, size);
+        }
+        else {
+            std::vector<char> buffer(std::min(size, socket::file_buffer_size));
+
+            for (std::size_t sent_size = 0; sent_size < size; ) {
+                std::size_t read_size = std::min(size - sent_size, buffer.size());
+                ssize_t chunk_size = ::pread(file_fd, buffer.data(), read_size, static_cast<off_t>(begin + sent_size));
+                diag_base::require(suborigin, chunk_size > 0, 0x10e85, "::pread() chunk_size=%ld, errno=%d", (long)chunk_size, errno);
+
+                http.put_body(buffer.data(), static_cast<std::size_t>(chunk_size));
+                sent_size += static_cast<std::size_t>(chunk_size);
+            }
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e86, "End:");
+    }
+
+
+    inline bool endpoint::parse_range(const std::string& range, std::size_t file_size, std::size_t& begin, std::size_t& end, bool& is_satisfiable) {
+        // Format: bytes=first-last | bytes=first- | bytes=-suffix_length
+        constexpr const char* unit = "bytes=";
+        constexpr std::size_t unit_len = 6;
+
+        is_satisfiable = true;
+
+        if (range.length() <= unit_len || !ascii::are_equal_i_n(range.c_str(), unit, unit_len) || range.find(',') != std::string::npos) {
+            return false;
+        }
+
+        const char* spec = range.c_str() + unit_len;
+        const char* dash = std::strchr(spec, '-');
+        if (dash == nullptr) {
+            return false;
+        }
+
+        bool has_first = dash > spec;
+        bool has_last = *(dash + 1) != '\0';
+
+        char* parse_end = nullptr;
+        unsigned long long first = 0;
+        if (has_first) {
+            first = std::strtoull(spec, &parse_end, 10);
+            if (parse_end != dash || !ascii::is_digit(*spec)) {
+                return false;
+            }
+        }
+
+        unsigned long long last = 0;
+        if (has_last) {
+            last = std::strtoull(dash + 1, &parse_end, 10);
+            if (*parse_end != '\0' || !ascii::is_digit(*(dash + 1))) {
+                return false;
+            }
+        }
+
+        if (has_first) {
+            if (has_last && last < first) {
+                return false;
+            }
+
+            begin = static_cast<std::size_t>(first);
+            // last is clamped before it is incremented, because strtoull() saturates oversized numbers to ULLONG_MAX.
+            end = has_last && last < file_size ? static_cast<std::size_t>(last + 1) : file_size;
+            is_satisfiable = first < file_size;
+        }
+        else if (has_last) {
+            // Suffix
+            std::size_t suffix_length = static_cast<std::size_t>(std::min<unsigned long long>(last, file_size));
+            begin = file_size - suffix_length;
+            end = file_size;
+            is_satisfiable = suffix_length > 0;
+        }
+        else {
+            return false;
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108c0, "End:");
+        return true;
+    }
+
+
+    inline bool endpoint::is_encoding_accepted(const std::string& accept_encoding, const char* encoding) {
+        // Format: coding[;q=weight], ...
+        std::size_t encoding_len = std::strlen(encoding);
+
+        return util::any_list_item(accept_encoding,
+            [encoding, encoding_len] (const char* item, std::size_t item_len) -> bool {
+                std::size_t name_len = 0;
+                while (name_len < item_len && item[name_len] != ';' && !ascii::is_space(item[name_len])) {
+                    name_len++;
+                }
+
+                bool is_match = (name_len == encoding_len && ascii::are_equal_i_n(item, encoding, encoding_len))
+                             || (name_len == 1 && item[0] == '*');
+                if (!is_match) {
+                    return false;
+                }
+
+                // A weight of 0 means "not acceptable".
+                for (std::size_t i = name_len; i + 1 < item_len; i++) {
+                    if ((item[i] == 'q' || item[i] == 'Q') && item[i + 1] == '=') {
+                        return std::strtod(item + i + 2, nullptr) > 0.0;
+                    }
+                }
+
+                return true;
+            });
+    }
+
+
+    inline bool endpoint::is_etag_matched(const std::string& if_none_match, const std::string& etag) {
+        // If-None-Match uses the weak comparison, i.e. the W/ prefix is ignored.
+        return util::any_list_item(if_none_match,
+            [&etag] (const char* item, std::size_t item_len) -> bool {
+                if (item_len == 1 && item[0] == '*') {
+                    return true;
+                }
+
+                if (item_len > 2 && item[0] == 'W' && item[1] == '/') {
+                    item += 2;
+                    item_len -= 2;
+                }
+
+                return item_len == etag.length() && std::memcmp(item, etag.data(), item_len) == 0;
+            });
     }
 
 
     inline void endpoint::process_rest_request(server& http, const request& request) {
         constexpr const char* suborigin = "process_rest_request()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x102ea, "Begin: method='%s', path='%s'", request.method.c_str(), request.resource.path.c_str());
-
-        if (ascii::are_equal_i(request.method.c_str(), method::POST) && ascii::are_equal_i(request.resource.path.c_str(), "/shutdown")) {
-            set_shutdown_requested();
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x102ea, "Begin: method='%s', path='%s'", request.method.c_str(), request.resource.path.c_str());
+
+        route_params params;
+        const route_handler* handler = nullptr;
+        route_status status = _router.find(request.method.c_str(), request.resource.path.c_str(), params, handler);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10ee6, "Route: status=%u, param_count=%zu", (unsigned)status, params.count);
+
+        try {
+            switch (status) {
+            case route_status::found:
+                if (handler != nullptr) {
+                    (*handler)(http, request, params);
+                }
+                else {
+                    // The route has a route_head_handler, but the head could not be parsed in place.
+                    // The handler gets a head over the request instead. The route is matched again on the raw path, so that the parameters are the same as they would be in place.
+                    request_head head;
+                    util::make_request_head(request, head);
+
+                    const route_head_handler* head_handler = nullptr;
+                    status = _router.find(head.method, head.path(), params, handler, head_handler);
+                    ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10f69, "Head route: status=%u, param_count=%zu", (unsigned)status, params.count);
+
+                    if (status == route_status::found && head_handler != nullptr) {
+                        (*head_handler)(http, head, params);
+                    }
+                    else {
+                        send_simple_response(http, status_code::Not_Found, reason_phrase::Not_Found, content_type::text, "The requested resource was not found.", 0x10fda);
+                    }
+                }
+                break;
+
+            case route_status::method_not_allowed:
+                send_simple_response(http, status_code::Method_Not_Allowed, reason_phrase::Method_Not_Allowed, content_type::text, "The requested method is not supported for this resource.", 0x102eb);
+                break;
+
+            default:
+                send_simple_response(http, status_code::Not_Found, reason_phrase::Not_Found, content_type::text, "The requested resource was not found.", 0x10ee7);
+                break;
+            }
+        }
+        catch (const endpoint_error& err) {
+            send_simple_response(http, err.status_code, err.reason_phrase.c_str(), err.content_type.c_str(), err.body.c_str(), err.tag);
         }
 
-        send_simple_response(http, status_code::OK, reason_phrase::OK, content_type::text, "Consider overriding process_rest_request().", 0x102eb);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108c1, "End:");
+    }
+
+
+    inline void endpoint::add_route(const char* method, const char* path_template, route_handler&& handler) {
+        _router.add(method, path_template, std::move(handler));
+    }
+
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108c1, "End:");
+    inline void endpoint::add_route(const char* method, const char* path_template, route_head_handler&& handler) {
+        _router.add(method, path_template, std::move(handler));
     }
 
 
     inline void endpoint::send_simple_response(server& http, status_code_t status_code, const char* reason_phrase, const char* content_type, const char* body, diag::tag_t tag) {
         constexpr const char* suborigin = "send_simple_response()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x102ec, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x102ec, "Begin:");
 
         std::string content_length = std::to_string(std::strlen(body));
 
-        diag_base::put_any(suborigin, diag::severity::callstack, tag, "Status Code    = %u", (unsigned)status_code);
-        diag_base::put_any(suborigin, diag::severity::callstack, tag, "Content-Type   = %s", content_type);
-        diag_base::put_any(suborigin, diag::severity::callstack, tag, "Content-Length = %s", content_length.c_str());
-        diag_base::put_any(suborigin, diag::severity::callstack, tag, "Body           = %s", body);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, tag, "Status Code    = %u", (unsigned)status_code);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, tag, "Content-Type   = %s", content_type);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, tag, "Content-Length = %s", content_length.c_str());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, tag, "Body           = %s", body);
 
         response response;
         response.protocol = protocol::HTTP_11;
@@ -264,7 +1535,7 @@ namespace abc { namespace net { namespace http {
 
         http.put_body(body);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108c2, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108c2, "End:");
     }
 
 
@@ -318,15 +1589,23 @@ namespace abc { namespace net { namespace http {
     }
 
 
+    inline bool endpoint::is_file_request(const request_head& head) {
+        span path = head.path();
+
+        return (path.size >= _config.files_prefix.size() && ascii::are_equal_i_n(path.data, _config.files_prefix.c_str(), _config.files_prefix.size()))
+            || (head.method.equals_i(method::GET) && path.equals_i("/favicon.ico"));
+    }
+
+
     inline void endpoint::set_shutdown_requested() {
         constexpr const char* suborigin = "send_simple_response()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108c3, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108c3, "Begin:");
 
-        diag_base::put_any(suborigin, diag::severity::important, 0x102ed, "--- Shutdown requested ---");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::important, 0x102ed, "--- Shutdown requested ---");
 
         _is_shutdown_requested = true;
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108c4, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108c4, "End:");
     }
 
 
@@ -337,7 +1616,7 @@ namespace abc { namespace net { namespace http {
 
     inline std::string endpoint::make_root_dir_path(const request& request) const {
         constexpr const char* suborigin = "make_root_dir_path()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108c5, "Begin: root_dir='%s', path='%s'", _config.root_dir.c_str(), request.resource.path.c_str());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108c5, "Begin: root_dir='%s', path='%s'", _config.root_dir.c_str(), request.resource.path.c_str());
 
         std::string filepath(_config.root_dir);
         if (filepath.back() != '/') {
@@ -345,7 +1624,7 @@ namespace abc { namespace net { namespace http {
         }
         filepath.append(request.resource.path);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108c6, "End: path='%s'", filepath.c_str());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108c6, "End: path='%s'", filepath.c_str());
 
         return filepath;
     }
@@ -372,7 +1651,10 @@ namespace abc { namespace net { namespace http {
 
 
     inline endpoint_config::endpoint_config(const char* port, std::size_t listen_queue_size, const char* root_dir, const char* files_prefix,
-                                            const char* cert_file_path, const char* pkey_file_path, const char* pkey_file_password)
+                                            const char* cert_file_path, const char* pkey_file_path, const char* pkey_file_password,
+                                            std::size_t worker_count,
+                                            std::size_t max_requests_per_connection, std::chrono::milliseconds keep_alive_timeout,
+                                            std::size_t file_cache_size, std::size_t file_cache_max_file_size)
         : port(port)
 
         , listen_queue_size(listen_queue_size)
@@ -382,7 +1664,15 @@ namespace abc { namespace net { namespace http {
         
         , cert_file_path(cert_file_path)
         , pkey_file_path(pkey_file_path)
-        , pkey_file_password(pkey_file_password) {
+        , pkey_file_password(pkey_file_password)
+
+        , worker_count(worker_count)
+
+        , max_requests_per_connection(max_requests_per_connection)
+        , keep_alive_timeout(keep_alive_timeout)
+
+        , file_cache_size(file_cache_size)
+        , file_cache_max_file_size(file_cache_max_file_size) {
     }
 
 
@@ -25,7 +25,13 @@ SOFTWARE.
 
 #pragma once
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "../root/ascii.h"
 #include "../root/util.h"
@@ -36,24 +42,73 @@ SOFTWARE.
 
 namespace abc { namespace net { namespace http {
 
+    inline span::span(const char* data, std::size_t size) noexcept
+        : data(data)
+        , size(size) {
+    }
+
+
+    inline std::string span::to_string() const {
+        return std::string(data, size);
+    }
+
+
+    inline bool span::equals_i(const char* chars) const noexcept {
+        return std::strlen(chars) == size && ascii::are_equal_i_n(data, chars, size);
+    }
+
+
+    // --------------------------------------------------------------
+
+
+    inline const span* request_head::find_header(const char* name) const noexcept {
+        for (std::size_t i = 0; i < header_count; i++) {
+            if (headers[i].name.equals_i(name)) {
+                return &headers[i].value;
+            }
+        }
+
+        for (const header_span& header : more_headers) {
+            if (header.name.equals_i(name)) {
+                return &header.value;
+            }
+        }
+
+        return nullptr;
+    }
+
+
+    inline span request_head::path() const noexcept {
+        std::size_t size = 0;
+        while (size < target.size && target.data[size] != '?' && target.data[size] != '#') {
+            size++;
+        }
+
+        return span(target.data, size);
+    }
+
+
+    // --------------------------------------------------------------
+
+
     inline state::state(const char* origin, item next, diag::log_ostream* log) noexcept
         : diag_base(copy(origin), log)
         , _next(next) {
 
         constexpr const char* suborigin = "state()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108c7, "Begin: origin='%s' next=%u", origin, (unsigned)next);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108c7, "Begin: origin='%s' next=%u", origin, (unsigned)next);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108c8, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108c8, "End:");
     }
 
 
     inline void state::reset(item next) {
         constexpr const char* suborigin = "reset()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108c9, "Begin: next=%u", (unsigned)next);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108c9, "Begin: next=%u", (unsigned)next);
 
         _next = next;
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108ca, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108ca, "End:");
     }
 
 
@@ -64,11 +119,11 @@ namespace abc { namespace net { namespace http {
 
     inline void state::assert_next(item item) {
         constexpr const char* suborigin = "assert_next()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108cb, "Begin: item=%u", (unsigned)item);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108cb, "Begin: item=%u", (unsigned)item);
 
         diag_base::assert(suborigin, _next == item, 0x108cc, "_next=%u, item=%u:", (unsigned)_next, (unsigned)item);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108cd, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108cd, "End:");
     }
 
 
@@ -80,23 +135,25 @@ namespace abc { namespace net { namespace http {
         , state_base(origin, next, log) {
 
         constexpr const char* suborigin = "istream()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108ce, "Begin: origin='%s', next=%u", origin, (unsigned)next);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108ce, "Begin: origin='%s', next=%u", origin, (unsigned)next);
 
         diag_base::expect(suborigin, sb != nullptr, 0x108cf, "sb");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108d0, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108d0, "End:");
     }
 
 
     inline istream::istream(istream&& other) noexcept
         : base(std::move(other))
-        , state_base(std::move(other)) {
+        , state_base(std::move(other))
+        , _is_chunked(other._is_chunked)
+        , _chunk_remaining(other._chunk_remaining) {
     }
 
 
     inline std::string istream::get_protocol() {
         constexpr const char* suborigin = "get_protocol()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108d1, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108d1, "Begin:");
 
         state_base::assert_next(item::protocol);
 
@@ -157,7 +214,7 @@ namespace abc { namespace net { namespace http {
 
         skip_spaces();
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108d2, "End: protocol='%s'", protocol.c_str());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108d2, "End: protocol='%s'", protocol.c_str());
 
         return protocol;
     }
@@ -165,7 +222,7 @@ namespace abc { namespace net { namespace http {
 
     inline headers istream::get_headers() {
         constexpr const char* suborigin = "get_headers()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108d3, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108d3, "Begin:");
 
         state_base::assert_next(item::header_name);
 
@@ -189,8 +246,9 @@ namespace abc { namespace net { namespace http {
         }
 
         set_gstate(gcount, item::body);
+        reset_body(headers);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108d4, "End: headers.size()=%zu", headers.size());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108d4, "End: headers.size()=%zu, is_chunked=%d", headers.size(), _is_chunked);
 
         return headers;
     }
@@ -198,7 +256,7 @@ namespace abc { namespace net { namespace http {
 
     inline std::string istream::get_header_name() {
         constexpr const char* suborigin = "get_header_name()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108d5, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108d5, "Begin:");
 
         state_base::assert_next(item::header_name);
 
@@ -228,7 +286,7 @@ namespace abc { namespace net { namespace http {
 
         set_gstate(header_name.length(), item::header_value);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108d6, "End: header_name='%s'", header_name.c_str());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108d6, "End: header_name='%s'", header_name.c_str());
 
         return header_name;
     }
@@ -236,7 +294,7 @@ namespace abc { namespace net { namespace http {
 
     inline std::string istream::get_header_value() {
         constexpr const char* suborigin = "get_header_value()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108d7, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108d7, "Begin:");
 
         state_base::assert_next(item::header_value);
 
@@ -272,7 +330,7 @@ namespace abc { namespace net { namespace http {
 
         set_gstate(header_value.length(), item::header_name);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108d8, "End: header_value='%s'", header_value.c_str());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108d8, "End: header_value='%s'", header_value.c_str());
 
         return header_value;
     }
@@ -280,48 +338,161 @@ namespace abc { namespace net { namespace http {
 
     inline std::string istream::get_body(std::size_t max_len) {
         constexpr const char* suborigin = "get_body()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108d9, "Begin: max_len=%zu", max_len);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108d9, "Begin: max_len=%zu", max_len);
+
+        // There is no more to read.
+        if (state_base::next() == item::eof) {
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e5d, "Return: eof");
+            return std::string();
+        }
 
         state_base::assert_next(item::body);
 
+        if (_is_chunked) {
+            std::string body = get_chunked_body(max_len);
+
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e5e, "End: body.length()=%zu", body.length());
+
+            return body;
+        }
+
         constexpr std::size_t estimated_len = size::k4;
         std::string body = get_any_chars(estimated_len, max_len);
 
         set_gstate(body.length(), base::eof() ? item::eof : item::body);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108da, "End: body='%s'", body.c_str());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108da, "End: body='%s'", body.c_str());
+
+        return body;
+    }
+
+
+    inline bool istream::is_body_complete() const {
+        return _is_chunked && state_base::next() == item::eof && base::is_good();
+    }
+
+
+    inline void istream::reset_body(const headers& headers) {
+        // The body framing is determined by the headers of each message.
+        reset_body(util::is_chunked(headers));
+    }
+
+
+    inline void istream::reset_body(bool is_chunked) noexcept {
+        _is_chunked = is_chunked;
+        _chunk_remaining = 0;
+    }
+
+
+    inline std::string istream::get_chunked_body(std::size_t max_len) {
+        constexpr const char* suborigin = "get_chunked_body()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e5f, "Begin: max_len=%zu, chunk_remaining=%zu", max_len, _chunk_remaining);
+
+        // Format: size [; extensions] CRLF data CRLF ... 0 CRLF [trailers] CRLF
+
+        if (_chunk_remaining == 0 && max_len > 0) {
+            _chunk_remaining = get_chunk_size();
+
+            if (_chunk_remaining == 0 || !base::is_good()) {
+                // The last chunk.
+                if (base::is_good()) {
+                    skip_trailers();
+                }
+
+                set_gstate(0, item::eof);
+
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e60, "Return: Last chunk.");
+                return std::string();
+            }
+        }
+
+        std::size_t len = std::min(max_len, _chunk_remaining);
+        std::string body = get_any_chars(std::min(len, size::k4), len);
+        _chunk_remaining -= body.length();
+
+        if (body.length() < len) {
+            // The stream ended in the middle of a chunk.
+            base::set_bad();
+        }
+        else if (_chunk_remaining == 0) {
+            skip_crlf();
+        }
+
+        set_gstate(body.length(), base::is_good() ? item::body : item::eof);
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e61, "End: body.length()=%zu, chunk_remaining=%zu", body.length(), _chunk_remaining);
 
         return body;
     }
 
 
+    inline std::size_t istream::get_chunk_size() {
+        constexpr const char* suborigin = "get_chunk_size()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e62, "Begin:");
+
+        constexpr std::size_t estimated_len = size::_16;
+        std::string hex = get_chars(ascii::char_class::hex, estimated_len, size::_16);
+
+        std::size_t chunk_size = 0;
+        if (hex.empty()) {
+            base::set_bad();
+        }
+        else {
+            chunk_size = static_cast<std::size_t>(std::strtoull(hex.c_str(), nullptr, 16));
+        }
+
+        // Chunk extensions are ignored.
+        skip_chars([] (char ch) -> bool { return ch != '\r'; });
+        skip_crlf();
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e63, "End: chunk_size=%zu", chunk_size);
+
+        return chunk_size;
+    }
+
+
+    inline void istream::skip_trailers() {
+        constexpr const char* suborigin = "skip_trailers()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e64, "Begin:");
+
+        // Trailer fields are ignored. They end with a blank line.
+        while (base::is_good() && skip_chars([] (char ch) -> bool { return ch != '\r'; }) > 0) {
+            skip_crlf();
+        }
+
+        skip_crlf();
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e65, "End:");
+    }
+
+
     inline std::string istream::get_token(std::size_t estimated_len) {
-        return get_chars(ascii::http::is_token, estimated_len);
+        return get_chars(ascii::char_class::http_token, estimated_len);
     }
 
 
     inline std::string istream::get_prints(std::size_t estimated_len) {
-        return get_chars(ascii::is_abcprint, estimated_len);
+        return get_chars(ascii::char_class::abcprint, estimated_len);
     }
 
 
     inline std::string istream::get_prints_and_spaces(std::size_t estimated_len) {
-        return get_chars(ascii::is_abcprint_or_space, estimated_len);
+        return get_chars(ascii::char_class::abcprint_or_space, estimated_len);
     }
 
 
     inline std::string istream::get_alphas(std::size_t estimated_len) {
-        return get_chars(ascii::is_alpha, estimated_len);
+        return get_chars(ascii::char_class::alpha, estimated_len);
     }
 
 
     inline std::string istream::get_digits(std::size_t estimated_len) {
-        return get_chars(ascii::is_digit, estimated_len);
+        return get_chars(ascii::char_class::digit, estimated_len);
     }
 
 
     inline std::string istream::get_any_chars(std::size_t estimated_len, std::size_t max_len) {
-        return get_chars(ascii::is_any, estimated_len, max_len);
+        return get_chars(ascii::char_class::any, estimated_len, max_len);
     }
 
 
@@ -331,7 +502,31 @@ namespace abc { namespace net { namespace http {
 
         std::size_t len = 0;
 
-        while (predicate(peek_char()) && base::is_good() && len++ < max_len) {
+        // Check the length first, so that no more than max_len chars are requested from the streambuf.
+        while (len < max_len && predicate(peek_char()) && base::is_good()) {
+            chars.push_back(get_char());
+            len++;
+        }
+
+        return chars;
+    }
+
+
+    inline std::string istream::get_chars(ascii::char_class_t cls, std::size_t estimated_len, std::size_t max_len) {
+        std::string chars;
+        chars.reserve(std::min(estimated_len, max_len));
+
+        while (chars.length() < max_len && base::is_good()) {
+            if (base::get_buffered(chars, cls, max_len - chars.length()) > 0) {
+                continue;
+            }
+
+            // The get area is empty, or the next char is not in the class.
+            // peek_char() refills the get area. A char at a time is also the fallback for unbuffered streambufs.
+            if (!ascii::is_class(peek_char(), cls) || !base::is_good()) {
+                break;
+            }
+
             chars.push_back(get_char());
         }
 
@@ -366,7 +561,7 @@ namespace abc { namespace net { namespace http {
 
 
     inline std::size_t istream::skip_spaces() {
-        return skip_chars(ascii::is_space);
+        return skip_chars(ascii::char_class::space);
     }
 
 
@@ -397,16 +592,38 @@ namespace abc { namespace net { namespace http {
 
         return gcount;
     }
+
+
+    inline std::size_t istream::skip_chars(ascii::char_class_t cls) {
+        std::size_t gcount = 0;
+
+        while (base::is_good()) {
+            std::size_t skipped = base::skip_buffered(cls, size::strlen);
+            if (skipped > 0) {
+                gcount += skipped;
+                continue;
+            }
+
+            if (!ascii::is_class(peek_char(), cls) || !base::is_good()) {
+                break;
+            }
+
+            base::get();
+            gcount++;
+        }
+
+        return gcount;
+    }
     
     
     inline void istream::set_gstate(std::size_t gcount, item next) {
         constexpr const char* suborigin = "set_gstate()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108db, "Begin: gcount=%zu, next=%u", gcount, (unsigned)next);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108db, "Begin: gcount=%zu, next=%u", gcount, (unsigned)next);
 
         base::set_gcount(gcount);
         state_base::reset(next);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108dc, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108dc, "End:");
     }
 
 
@@ -418,21 +635,22 @@ namespace abc { namespace net { namespace http {
         , state_base(origin, next, log) {
 
         constexpr const char* suborigin = "ostream()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108dd, "Begin: origin='%s', next=%u", origin, (unsigned)next);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108dd, "Begin: origin='%s', next=%u", origin, (unsigned)next);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108de, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108de, "End:");
     }
 
 
     inline ostream::ostream(ostream&& other) noexcept
         : base(std::move(other))
-        , state_base(std::move(other)) {
+        , state_base(std::move(other))
+        , _is_chunked(other._is_chunked) {
     }
 
 
     inline void ostream::put_headers(const headers& headers) {
         constexpr const char* suborigin = "put_headers()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108df, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108df, "Begin:");
 
         for (const headers::value_type& header : headers) {
             put_header_name(header.first.c_str());
@@ -441,13 +659,16 @@ namespace abc { namespace net { namespace http {
 
         end_headers();
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108e0, "End:");
+        // The body framing is determined by the headers of each message.
+        _is_chunked = util::is_chunked(headers);
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108e0, "End: is_chunked=%d", _is_chunked);
     }
 
 
     inline void ostream::put_header_name(const char* header_name, std::size_t header_name_len) {
         constexpr const char* suborigin = "put_header_name()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108e1, "Begin: header_name='%s'", header_name);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108e1, "Begin: header_name='%s'", header_name);
 
         diag_base::expect(suborigin, header_name != nullptr, 0x108e2, "header_name != nullptr");
 
@@ -472,13 +693,13 @@ namespace abc { namespace net { namespace http {
 
         set_pstate(item::header_value);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108e3, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108e3, "End:");
     }
 
 
     inline void ostream::put_header_value(const char* header_value, std::size_t header_value_len) {
         constexpr const char* suborigin = "put_header_value()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108e4, "Begin: header_value='%s'", header_value);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108e4, "Begin: header_value='%s'", header_value);
 
         diag_base::expect(suborigin, header_value != nullptr, 0x108e5, "header_value != nullptr");
 
@@ -513,13 +734,13 @@ namespace abc { namespace net { namespace http {
 
         set_pstate(item::header_name);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108e6, "End: pcount=%zu", pcount);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108e6, "End: pcount=%zu", pcount);
     }
 
 
     inline void ostream::end_headers() {
         constexpr const char* suborigin = "put_header_value()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108e7, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108e7, "Begin:");
 
         state_base::assert_next(item::header_name);
 
@@ -527,13 +748,13 @@ namespace abc { namespace net { namespace http {
 
         set_pstate(item::body);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108e8, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108e8, "End:");
     }
 
 
     inline void ostream::put_body(const char* body, std::size_t body_len) {
         constexpr const char* suborigin = "put_body()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108e9, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108e9, "Begin:");
 
         diag_base::expect(suborigin, body != nullptr, 0x108ea, "body != nullptr");
 
@@ -543,17 +764,49 @@ namespace abc { namespace net { namespace http {
             body_len = std::strlen(body);
         }
 
-        std::size_t pcount = put_any_chars(body, body_len);
+        std::size_t pcount = 0;
+        if (!_is_chunked) {
+            pcount = put_any_chars(body, body_len);
+        }
+        else if (body_len > 0) {
+            // An empty chunk would mean the end of the body.
+            char hex[size::_32];
+            std::snprintf(hex, sizeof(hex), "%zx", body_len);
+
+            put_any_chars(hex, std::strlen(hex));
+            put_crlf();
+            pcount = put_any_chars(body, body_len);
+            put_crlf();
+        }
 
         set_pstate(item::body);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108eb, "End: pcount=%zu", pcount);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108eb, "End: pcount=%zu", pcount);
+    }
+
+
+    inline void ostream::end_body() {
+        constexpr const char* suborigin = "end_body()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e66, "Begin:");
+
+        state_base::assert_next(item::body);
+
+        if (_is_chunked) {
+            // The last chunk, and no trailers.
+            put_char('0');
+            put_crlf();
+            put_crlf();
+        }
+
+        set_pstate(item::eof);
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e67, "End:");
     }
 
 
     inline std::size_t ostream::put_protocol(const char* protocol, std::size_t protocol_len) {
         constexpr const char* suborigin = "put_protocol()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108ec, "Begin: protocol='%s'", protocol);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108ec, "Begin: protocol='%s'", protocol);
 
         diag_base::expect(suborigin, protocol != nullptr, 0x108ed, "protocol != nullptr");
 
@@ -606,7 +859,7 @@ namespace abc { namespace net { namespace http {
             base::set_bad();
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108ee, "End: pcount=%zu", pcount);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108ee, "End: pcount=%zu", pcount);
 
         return pcount;
     }
@@ -660,7 +913,7 @@ namespace abc { namespace net { namespace http {
 
     inline std::size_t ostream::put_chars(ascii::predicate_t&& predicate, const char* chars, std::size_t chars_len) {
         constexpr const char* suborigin = "put_chars()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108ef, "Begin: chars='%s'", chars);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108ef, "Begin: chars='%s'", chars);
 
         diag_base::expect(suborigin, chars != nullptr, 0x108f0, "chars != nullptr");
 
@@ -674,7 +927,7 @@ namespace abc { namespace net { namespace http {
             base::put(chars[pcount++]);
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108f1, "End: pcount=%zu", pcount);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108f1, "End: pcount=%zu", pcount);
 
         return pcount;
     }
@@ -710,12 +963,12 @@ namespace abc { namespace net { namespace http {
 
     inline void ostream::set_pstate(item next) {
         constexpr const char* suborigin = "set_pstate()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108f2, "Begin: next=%u", (unsigned)next);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108f2, "Begin: next=%u", (unsigned)next);
 
         base::flush();
         state_base::reset(next);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108f3, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108f3, "End:");
     }
 
 
@@ -726,9 +979,9 @@ namespace abc { namespace net { namespace http {
         : base(origin, sb, item::method, log) {
 
         constexpr const char* suborigin = "request_istream()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108f4, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108f4, "Begin:");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108f5, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108f5, "End:");
     }
 
 
@@ -744,17 +997,17 @@ namespace abc { namespace net { namespace http {
 
     inline void request_istream::reset() {
         constexpr const char* suborigin = "reset()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108f6, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108f6, "Begin:");
 
         base::set_gstate(0, item::method);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108f7, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108f7, "End:");
     }
 
 
     inline std::string request_istream::get_method() {
         constexpr const char* suborigin = "get_method()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108f8, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108f8, "Begin:");
 
         base::assert_next(item::method);
 
@@ -764,27 +1017,34 @@ namespace abc { namespace net { namespace http {
 
         base::set_gstate(method.length(), item::resource);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108f9, "End: gcount=%zu, method='%s'", method.length(), method.c_str());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108f9, "End: gcount=%zu, method='%s'", method.length(), method.c_str());
 
         return method;
     }
 
 
     inline resource request_istream::get_resource() {
+        std::string raw_resource;
+
+        return get_resource(raw_resource);
+    }
+
+
+    inline resource request_istream::get_resource(std::string& raw_resource) {
         constexpr const char* suborigin = "get_resource()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108fa, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108fa, "Begin:");
 
         base::assert_next(item::resource);
 
         constexpr std::size_t estimated_len = size::k2;
-        std::string raw_resource = base::get_prints(estimated_len);
+        raw_resource = base::get_prints(estimated_len);
         base::skip_spaces();
 
         base::set_gstate(raw_resource.length(), item::protocol);
 
         resource resource = split_resource(raw_resource);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108fb, "End: gcount=%zu, raw_resource='%s'", raw_resource.length(), raw_resource.c_str());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108fb, "End: gcount=%zu, raw_resource='%s'", raw_resource.length(), raw_resource.c_str());
 
         return resource;
     }
@@ -792,14 +1052,14 @@ namespace abc { namespace net { namespace http {
 
     inline std::string request_istream::get_protocol() {
         constexpr const char* suborigin = "get_protocol()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108fc, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108fc, "Begin:");
 
         std::string protocol = base::get_protocol();
         base::skip_crlf();
 
         base::set_gstate(protocol.length(), item::header_name);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108fd, "End: gcount=%zu, protocol='%s'", protocol.length(), protocol.c_str());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108fd, "End: gcount=%zu, protocol='%s'", protocol.length(), protocol.c_str());
 
         return protocol;
     }
@@ -807,7 +1067,7 @@ namespace abc { namespace net { namespace http {
 
     inline resource request_istream::split_resource(const std::string& raw_resource) {
         constexpr const char* suborigin = "split_resource()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108fe, "Begin: raw_resource='%s'", raw_resource.c_str());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108fe, "Begin: raw_resource='%s'", raw_resource.c_str());
 
         // Format: path?param1=...&param2=...#...
 
@@ -863,7 +1123,7 @@ namespace abc { namespace net { namespace http {
             }
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x108ff, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x108ff, "End:");
 
         return resource;
     }
@@ -876,9 +1136,9 @@ namespace abc { namespace net { namespace http {
         : base(origin, sb, log) {
 
         constexpr const char* suborigin = "request_reader()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10900, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10900, "Begin:");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10901, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10901, "End:");
     }
 
 
@@ -894,26 +1154,71 @@ namespace abc { namespace net { namespace http {
 
     inline request request_reader::get_request() {
         constexpr const char* suborigin = "get_request()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10902, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10902, "Begin:");
 
         request request;
 
         request.method   = base::get_method();
-        request.resource = base::get_resource();
+        request.resource = base::get_resource(request.target);
         request.protocol = base::get_protocol();
         request.headers  = base::get_headers();
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10903, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10903, "End:");
 
         return request;
     }
 
 
+    inline request request_reader::get_request(const request_head& head) {
+        constexpr const char* suborigin = "get_request()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10eb4, "Begin: head.size=%zu, head.header_count=%zu", head.size, head.header_count);
+
+        base::assert_next(item::method);
+
+        request request;
+
+        request.method.assign(head.method.data, head.method.size);
+        request.target.assign(head.target.data, head.target.size);
+        request.resource = base::split_resource(request.target);
+        request.protocol.assign(head.protocol.data, head.protocol.size);
+
+        for (std::size_t i = 0; i < head.header_count; i++) {
+            std::pair<std::string, std::string> pair(head.headers[i].name.to_string(), head.headers[i].value.to_string());
+            request.headers.insert(std::move(pair));
+        }
+
+        base::set_gstate(head.size, item::body);
+        base::reset_body(request.headers);
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10eb5, "End:");
+
+        return request;
+    }
+
+
+    inline void request_reader::start_body(const request_head& head) {
+        constexpr const char* suborigin = "start_body()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f6a, "Begin: head.size=%zu, head.header_count=%zu", head.size, head.header_count);
+
+        base::assert_next(item::method);
+
+        base::set_gstate(head.size, item::body);
+        base::reset_body(util::is_chunked(head));
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f6b, "End:");
+    }
+
+
     inline std::string request_reader::get_body(std::size_t max_len) {
         return base::get_body(max_len);
     }
 
 
+    inline bool request_reader::is_body_complete() const {
+        return base::is_body_complete();
+    }
+
+
     inline std::streambuf* request_reader::rdbuf() const {
         return base::rdbuf();
     }
@@ -926,9 +1231,9 @@ namespace abc { namespace net { namespace http {
         : base(origin, sb, item::method, log) {
 
         constexpr const char* suborigin = "request_ostream()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10904, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10904, "Begin:");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10905, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10905, "End:");
     }
 
 
@@ -944,17 +1249,17 @@ namespace abc { namespace net { namespace http {
 
     inline void request_ostream::reset() {
         constexpr const char* suborigin = "reset()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10906, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10906, "Begin:");
 
         base::set_pstate(item::method);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10907, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10907, "End:");
     }
 
 
     inline void request_ostream::put_method(const char* method, std::size_t method_len) {
         constexpr const char* suborigin = "put_method()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10908, "Begin: method='%s'", method);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10908, "Begin: method='%s'", method);
 
         diag_base::expect(suborigin, method != nullptr, 0x10909, "method != nullptr");
 
@@ -969,13 +1274,13 @@ namespace abc { namespace net { namespace http {
 
         base::set_pstate(item::resource);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1090a, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1090a, "End:");
     }
 
 
     inline void request_ostream::put_resource(const resource& resource) {
         constexpr const char* suborigin = "put_resource()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1090b, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1090b, "Begin:");
 
         base::assert_next(item::resource);
 
@@ -1014,13 +1319,13 @@ namespace abc { namespace net { namespace http {
 
         base::set_pstate(item::protocol);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1090c, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1090c, "End:");
     }
 
 
     inline void request_ostream::put_resource(const char* resource, std::size_t resource_len) {
         constexpr const char* suborigin = "put_method()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1090d, "Begin: resource='%s'", resource);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1090d, "Begin: resource='%s'", resource);
 
         diag_base::expect(suborigin, resource != nullptr, 0x1090e, "resource != nullptr");
 
@@ -1035,13 +1340,13 @@ namespace abc { namespace net { namespace http {
 
         base::set_pstate(item::protocol);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1090f, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1090f, "End:");
     }
 
 
     inline void request_ostream::put_protocol(const char* protocol, std::size_t protocol_len) {
         constexpr const char* suborigin = "put_protocol()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10910, "Begin: protocol='%s'", protocol);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10910, "Begin: protocol='%s'", protocol);
 
         diag_base::expect(suborigin, protocol != nullptr, 0x10911, "protocol != nullptr");
 
@@ -1050,7 +1355,7 @@ namespace abc { namespace net { namespace http {
 
         base::set_pstate(item::header_name);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10912, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10912, "End:");
     }
 
 
@@ -1061,9 +1366,9 @@ namespace abc { namespace net { namespace http {
         : base(origin, sb, log) {
 
         constexpr const char* suborigin = "request_writer()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10913, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10913, "Begin:");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10914, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10914, "End:");
     }
 
 
@@ -1079,7 +1384,7 @@ namespace abc { namespace net { namespace http {
 
     inline void request_writer::put_request(const request& request) {
         constexpr const char* suborigin = "put_request()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10915, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10915, "Begin:");
 
         base::put_method(request.method.c_str(), request.method.length());
         base::put_resource(request.resource);
@@ -1088,7 +1393,7 @@ namespace abc { namespace net { namespace http {
 
         base::flush();
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10916, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10916, "End:");
     }
 
 
@@ -1099,6 +1404,13 @@ namespace abc { namespace net { namespace http {
     }
 
 
+    inline void request_writer::end_body() {
+        base::end_body();
+
+        base::flush();
+    }
+
+
     inline std::streambuf* request_writer::rdbuf() const {
         return base::rdbuf();
     }
@@ -1111,9 +1423,9 @@ namespace abc { namespace net { namespace http {
         : base(origin, sb, item::protocol, log) {
 
         constexpr const char* suborigin = "response_istream()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10917, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10917, "Begin:");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10918, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10918, "End:");
     }
 
 
@@ -1129,23 +1441,23 @@ namespace abc { namespace net { namespace http {
 
     inline void response_istream::reset() {
         constexpr const char* suborigin = "reset()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10919, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10919, "Begin:");
 
         base::set_gstate(0, item::protocol);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1091a, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1091a, "End:");
     }
 
 
     inline std::string response_istream::get_protocol() {
         constexpr const char* suborigin = "get_protocol()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1091b, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1091b, "Begin:");
 
         std::string protocol = base::get_protocol();
 
         base::set_gstate(protocol.length(), item::status_code);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1091c, "End: gcount=%zu, protocol='%s'", protocol.length(), protocol.c_str());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1091c, "End: gcount=%zu, protocol='%s'", protocol.length(), protocol.c_str());
 
         return protocol;
     }
@@ -1153,7 +1465,7 @@ namespace abc { namespace net { namespace http {
 
     inline status_code_t response_istream::get_status_code() {
         constexpr const char* suborigin = "get_status_code()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1091d, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1091d, "Begin:");
 
         base::assert_next(item::status_code);
 
@@ -1165,7 +1477,7 @@ namespace abc { namespace net { namespace http {
 
         base::set_gstate(digits.length(), item::reason_phrase);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1091e, "End: gcount=%zu, status_code='%u'", digits.length(), (unsigned)status_code);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1091e, "End: gcount=%zu, status_code='%u'", digits.length(), (unsigned)status_code);
 
         return status_code;
     }
@@ -1173,7 +1485,7 @@ namespace abc { namespace net { namespace http {
 
     inline std::string response_istream::get_reason_phrase() {
         constexpr const char* suborigin = "get_reason_phrase()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1091f, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1091f, "Begin:");
 
         base::assert_next(item::reason_phrase);
 
@@ -1184,7 +1496,7 @@ namespace abc { namespace net { namespace http {
 
         base::set_gstate(reason_phrase.length(), item::header_name);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10920, "End: gcount=%zu, reason_phrase='%s'", reason_phrase.length(), reason_phrase.c_str());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10920, "End: gcount=%zu, reason_phrase='%s'", reason_phrase.length(), reason_phrase.c_str());
 
         return reason_phrase;
     }
@@ -1197,9 +1509,9 @@ namespace abc { namespace net { namespace http {
         : base(origin, sb, log) {
 
         constexpr const char* suborigin = "response_reader()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10921, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10921, "Begin:");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10922, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10922, "End:");
     }
 
 
@@ -1215,7 +1527,7 @@ namespace abc { namespace net { namespace http {
 
     inline response response_reader::get_response() {
         constexpr const char* suborigin = "get_response()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10923, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10923, "Begin:");
 
         response response;
 
@@ -1224,7 +1536,7 @@ namespace abc { namespace net { namespace http {
         response.reason_phrase = base::get_reason_phrase();
         response.headers       = base::get_headers();
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10924, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10924, "End:");
 
         return response;
     }
@@ -1235,6 +1547,11 @@ namespace abc { namespace net { namespace http {
     }
 
 
+    inline bool response_reader::is_body_complete() const {
+        return base::is_body_complete();
+    }
+
+
     inline std::streambuf* response_reader::rdbuf() const {
         return base::rdbuf();
     }
@@ -1247,9 +1564,9 @@ namespace abc { namespace net { namespace http {
         : base(origin, sb, item::protocol, log) {
 
         constexpr const char* suborigin = "response_ostream()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10925, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10925, "Begin:");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10926, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10926, "End:");
     }
 
 
@@ -1265,17 +1582,17 @@ namespace abc { namespace net { namespace http {
 
     inline void response_ostream::reset() {
         constexpr const char* suborigin = "reset()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10927, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10927, "Begin:");
 
         base::set_pstate(item::protocol);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10928, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10928, "End:");
     }
 
 
     inline void response_ostream::put_protocol(const char* protocol, std::size_t protocol_len) {
         constexpr const char* suborigin = "put_protocol()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10929, "Begin: protocol='%s'", protocol);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10929, "Begin: protocol='%s'", protocol);
 
         diag_base::expect(suborigin, protocol != nullptr, 0x1092a, "protocol != nullptr");
 
@@ -1284,13 +1601,13 @@ namespace abc { namespace net { namespace http {
 
         base::set_pstate(item::status_code);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1092b, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1092b, "End:");
     }
 
 
     inline void response_ostream::put_status_code(status_code_t status_code) {
         constexpr const char* suborigin = "put_status_code()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1092c, "Begin: status_code='%u'", (unsigned)status_code);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1092c, "Begin: status_code='%u'", (unsigned)status_code);
 
         base::assert_next(item::status_code);
 
@@ -1302,13 +1619,13 @@ namespace abc { namespace net { namespace http {
 
         base::set_pstate(item::reason_phrase);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1092d, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1092d, "End:");
     }
 
 
     inline void response_ostream::put_reason_phrase(const char* reason_phrase, std::size_t reason_phrase_len) {
         constexpr const char* suborigin = "put_reason_phrase()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1092e, "Begin: reason_phrase='%s'", reason_phrase);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1092e, "Begin: reason_phrase='%s'", reason_phrase);
 
         base::assert_next(item::reason_phrase);
 
@@ -1324,7 +1641,7 @@ namespace abc { namespace net { namespace http {
 
         base::set_pstate(item::header_name);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1092f, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1092f, "End:");
     }
 
 
@@ -1335,9 +1652,9 @@ namespace abc { namespace net { namespace http {
         : base(origin, sb, log) {
 
         constexpr const char* suborigin = "response_writer()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10930, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10930, "Begin:");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10931, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10931, "End:");
     }
 
 
@@ -1353,7 +1670,7 @@ namespace abc { namespace net { namespace http {
 
     inline void response_writer::put_response(const response& response) {
         constexpr const char* suborigin = "put_response()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10932, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10932, "Begin:");
 
         base::put_protocol(response.protocol.c_str(), response.protocol.length());
         base::put_status_code(response.status_code);
@@ -1362,7 +1679,7 @@ namespace abc { namespace net { namespace http {
 
         base::flush();
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10933, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10933, "End:");
     }
 
 
@@ -1373,6 +1690,13 @@ namespace abc { namespace net { namespace http {
     }
 
 
+    inline void response_writer::end_body() {
+        base::end_body();
+
+        base::flush();
+    }
+
+
     inline std::streambuf* response_writer::rdbuf() const {
         return base::rdbuf();
     }
@@ -1464,5 +1788,302 @@ namespace abc { namespace net { namespace http {
         return result;
     }
 
+
+    inline bool util::is_chunked(const headers& headers) {
+        headers::const_iterator itr = headers.find("Transfer-Encoding");
+        if (itr == headers.cend()) {
+            return false;
+        }
+
+        return is_chunked(span(itr->second.data(), itr->second.length()));
+    }
+
+
+    inline bool util::is_chunked(const request_head& head) noexcept {
+        const span* transfer_encoding = head.find_header("Transfer-Encoding");
+
+        return transfer_encoding != nullptr && is_chunked(*transfer_encoding);
+    }
+
+
+    inline bool util::is_chunked(const span& transfer_encoding) noexcept {
+        // Codings are applied in order, so chunked must be the last one.
+        const char* value = transfer_encoding.data;
+        std::size_t end = transfer_encoding.size;
+        while (end > 0 && ascii::is_space(value[end - 1])) {
+            end--;
+        }
+
+        std::size_t begin = end;
+        while (begin > 0 && value[begin - 1] != ',') {
+            begin--;
+        }
+
+        while (begin < end && ascii::is_space(value[begin])) {
+            begin++;
+        }
+
+        constexpr std::size_t chunked_len = 7;
+        return end - begin == chunked_len && ascii::are_equal_i_n(value + begin, "chunked", chunked_len);
+    }
+
+
+    template <typename Predicate>
+    inline bool util::any_list_item(const std::string& list, Predicate&& predicate) {
+        return any_list_item(span(list.data(), list.length()), std::forward<Predicate>(predicate));
+    }
+
+
+    template <typename Predicate>
+    inline bool util::any_list_item(const span& list, Predicate&& predicate) {
+        for (std::size_t begin = 0; begin < list.size; ) {
+            const char* comma = static_cast<const char*>(std::memchr(list.data + begin, ',', list.size - begin));
+            std::size_t end = comma != nullptr ? comma - list.data : list.size;
+
+            std::size_t item_begin = begin;
+            while (item_begin < end && ascii::is_space(list.data[item_begin])) {
+                item_begin++;
+            }
+
+            std::size_t item_end = end;
+            while (item_end > item_begin && ascii::is_space(list.data[item_end - 1])) {
+                item_end--;
+            }
+
+            if (item_end > item_begin && predicate(list.data + item_begin, item_end - item_begin)) {
+                return true;
+            }
+
+            begin = end + 1;
+        }
+
+        return false;
+    }
+
+
+    inline head_status util::parse_request_head(const char* buffer, std::size_t size, request_head& head) noexcept {
+        const char* const buffer_end = buffer + size;
+
+        head.header_count = 0;
+        head.more_headers.clear();
+        head.size = 0;
+
+        // Format: method SP target SP protocol CR LF
+        const char* line = buffer;
+        const char* lf = static_cast<const char*>(std::memchr(line, '\n', buffer_end - line));
+        if (lf == nullptr) {
+            return head_status::incomplete;
+        }
+
+        if (lf == line || lf[-1] != '\r') {
+            return head_status::unsupported;
+        }
+
+        const char* line_end = lf - 1;
+
+        // Method
+        const char* method_end = static_cast<const char*>(std::memchr(line, ' ', line_end - line));
+        if (method_end == nullptr || method_end == line) {
+            return head_status::unsupported;
+        }
+
+        if (ascii::scan_while(line, method_end - line, ascii::char_class::http_token) != static_cast<std::size_t>(method_end - line)) {
+            return head_status::unsupported;
+        }
+
+        head.method = span(line, method_end - line);
+
+        // Target
+        const char* target = method_end + 1;
+        const char* target_end = static_cast<const char*>(std::memchr(target, ' ', line_end - target));
+        if (target_end == nullptr || target_end == target) {
+            return head_status::unsupported;
+        }
+
+        if (ascii::scan_while(target, target_end - target, ascii::char_class::abcprint) != static_cast<std::size_t>(target_end - target)) {
+            return head_status::unsupported;
+        }
+
+        head.target = span(target, target_end - target);
+
+        // Protocol: HTTP/d.d
+        const char* protocol = target_end + 1;
+        constexpr std::size_t protocol_len = 8;
+        if (line_end - protocol != protocol_len || !ascii::are_equal_i_n(protocol, "HTTP/", 5)
+            || !ascii::is_digit(protocol[5]) || protocol[6] != '.' || !ascii::is_digit(protocol[7])) {
+            return head_status::unsupported;
+        }
+
+        head.protocol = span(protocol, protocol_len);
+
+        // Format: name: value CR LF ... CR LF
+        for (line = lf + 1; ; line = lf + 1) {
+            lf = static_cast<const char*>(std::memchr(line, '\n', buffer_end - line));
+            if (lf == nullptr) {
+                return head_status::incomplete;
+            }
+
+            if (lf == line || lf[-1] != '\r') {
+                return head_status::unsupported;
+            }
+
+            line_end = lf - 1;
+
+            // The empty line ends the headers.
+            if (line_end == line) {
+                head.size = lf + 1 - buffer;
+                return head_status::complete;
+            }
+
+            // Obsolete line folding is left to the stream reader, which joins the lines.
+            if (ascii::is_space(*line) || head.header_count == max_request_head_headers) {
+                return head_status::unsupported;
+            }
+
+            // Name
+            const char* name_end = static_cast<const char*>(std::memchr(line, ':', line_end - line));
+            if (name_end == nullptr || name_end == line) {
+                return head_status::unsupported;
+            }
+
+            if (ascii::scan_while(line, name_end - line, ascii::char_class::http_token) != static_cast<std::size_t>(name_end - line)) {
+                return head_status::unsupported;
+            }
+
+            // Value
+            const char* value = name_end + 1;
+            while (value < line_end && ascii::is_space(*value)) {
+                value++;
+            }
+
+            const char* value_end = line_end;
+            while (value_end > value && ascii::is_space(value_end[-1])) {
+                value_end--;
+            }
+
+            if (ascii::scan_while(value, value_end - value, ascii::char_class::abcprint_or_space) != static_cast<std::size_t>(value_end - value)) {
+                return head_status::unsupported;
+            }
+
+            header_span& header = head.headers[head.header_count++];
+            header.name = span(line, name_end - line);
+            header.value = span(value, value_end - value);
+        }
+    }
+
+
+    inline void util::make_request_head(const request& request, request_head& head) {
+        head.method = span(request.method.data(), request.method.length());
+        head.target = span(request.target.data(), request.target.length());
+        head.protocol = span(request.protocol.data(), request.protocol.length());
+
+        head.header_count = 0;
+        head.more_headers.clear();
+        head.size = 0;
+
+        for (const headers::value_type& header : request.headers) {
+            header_span header_span{ span(header.first.data(), header.first.length()), span(header.second.data(), header.second.length()) };
+
+            if (head.header_count < max_request_head_headers) {
+                head.headers[head.header_count++] = header_span;
+            }
+            else {
+                head.more_headers.push_back(header_span);
+            }
+        }
+    }
+
+
+    // --------------------------------------------------------------
+
+
+    template <typename Writer>
+    inline body_ostreambuf<Writer>::body_ostreambuf(Writer* writer, std::size_t buffer_size)
+        : base()
+        , _writer(writer)
+        , _put_buffer(buffer_size) {
+
+        setp(_put_buffer.data(), _put_buffer.data() + _put_buffer.size());
+    }
+
+
+    template <typename Writer>
+    inline body_ostreambuf<Writer>::~body_ostreambuf() noexcept {
+        try {
+            (void)sync();
+        }
+        catch (...) {
+        }
+    }
+
+
+    template <typename Writer>
+    inline void body_ostreambuf<Writer>::end_body() {
+        (void)sync();
+
+        _writer->end_body();
+    }
+
+
+    template <typename Writer>
+    inline std::streambuf::int_type body_ostreambuf<Writer>::overflow(std::streambuf::int_type ch) {
+        if (sync() != 0) {
+            return traits_type::eof();
+        }
+
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+
+        return traits_type::not_eof(ch);
+    }
+
+
+    template <typename Writer>
+    inline int body_ostreambuf<Writer>::sync() {
+        std::size_t size = pptr() - pbase();
+        if (size > 0) {
+            _writer->put_body(pbase(), size);
+        }
+
+        setp(_put_buffer.data(), _put_buffer.data() + _put_buffer.size());
+
+        return 0;
+    }
+
+
+    // --------------------------------------------------------------
+
+
+    template <typename Reader>
+    inline body_istreambuf<Reader>::body_istreambuf(Reader* reader, std::size_t buffer_size)
+        : base()
+        , _reader(reader)
+        , _buffer_size(buffer_size) {
+
+        setg(nullptr, nullptr, nullptr);
+    }
+
+
+    template <typename Reader>
+    inline std::streambuf::int_type body_istreambuf<Reader>::underflow() {
+        if (gptr() < egptr()) {
+            return traits_type::to_int_type(*gptr());
+        }
+
+        // An empty block means the end of the body.
+        _get_buffer = _reader->get_body(_buffer_size);
+        if (_get_buffer.empty()) {
+            setg(nullptr, nullptr, nullptr);
+            return traits_type::eof();
+        }
+
+        char* begin = &_get_buffer[0];
+        setg(begin, begin, begin + _get_buffer.size());
+
+        return traits_type::to_int_type(*gptr());
+    }
+
 } } }
 
@@ -0,0 +1,612 @@
+/*
+MIT License
+
+Copyright (c) 2018-2026 Zlatko Michailov 
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+
+#include "../../root/size.h"
+#include "../../diag/i/diag_ready.i.h"
+#include "socket.i.h"
+#include "http.i.h"
+
+
+namespace abc { namespace net { namespace http {
+
+    /**
+     * @brief `async_client` settings.
+     */
+    struct async_client_config {
+        /**
+         * @brief                          Constructor. Properties can only be set at construction.
+         * @param max_connections_per_host Maximum number of concurrent connections to a single host:port. Requests beyond that wait for a connection to become free.
+         * @param connect_timeout          How long a connection attempt to a single address may take.
+         * @param request_timeout          How long a request may take from the time it is sent until its response is received, including the time it waits for a connection.
+         * @param keep_alive_timeout       How long an idle connection is kept open waiting for the next request.
+         * @param dns_cache_ttl            How long resolved addresses are reused before they are resolved again.
+         * @param max_response_size        Maximum size of a response, head and body. Larger responses fail.
+         * @param family                   Address family to resolve host names to.
+         */
+        async_client_config(std::size_t max_connections_per_host = 4,
+                            std::chrono::milliseconds connect_timeout = std::chrono::seconds(5), std::chrono::milliseconds request_timeout = std::chrono::seconds(30),
+                            std::chrono::milliseconds keep_alive_timeout = std::chrono::seconds(30), std::chrono::milliseconds dns_cache_ttl = std::chrono::seconds(60),
+                            std::size_t max_response_size = 16 * size::m1, socket::family family = socket::family::ipv4);
+
+        /**
+         * @brief Maximum number of concurrent connections to a single host:port.
+         */
+        const std::size_t max_connections_per_host;
+
+        /**
+         * @brief How long a connection attempt to a single address may take.
+         */
+        const std::chrono::milliseconds connect_timeout;
+
+        /**
+         * @brief How long a request may take, including the time it waits for a connection.
+         */
+        const std::chrono::milliseconds request_timeout;
+
+        /**
+         * @brief How long an idle connection is kept open waiting for the next request.
+         */
+        const std::chrono::milliseconds keep_alive_timeout;
+
+        /**
+         * @brief How long resolved addresses are reused.
+         */
+        const std::chrono::milliseconds dns_cache_ttl;
+
+        /**
+         * @brief Maximum size of a response, head and body.
+         */
+        const std::size_t max_response_size;
+
+        /**
+         * @brief Address family to resolve host names to.
+         */
+        const socket::family family;
+    };
+
+
+    // --------------------------------------------------------------
+
+
+    /**
+     * @brief Response received by `async_client`.
+     */
+    struct async_response {
+        /**
+         * @brief Status line and headers.
+         */
+        http::response response;
+
+        /**
+         * @brief Body. A chunked body is already decoded.
+         */
+        std::string body;
+    };
+
+
+    /**
+     * @brief Completion callback of `async_client::send_async()`.
+     * @details Exactly one of `error` and `response` is meaningful - `response` is empty when `error` is not `nullptr`.
+     */
+    using async_callback = std::function<void(std::exception_ptr error, async_response&& response)>;
+
+
+    // --------------------------------------------------------------
+
+
+    /**
+     * @brief HTTP client that multiplexes concurrent requests over pooled keep-alive connections.
+     * @details A single event loop thread connects, sends, and receives for all requests without blocking.
+     *          Connections are pooled per host:port, and resolved addresses are cached.
+     *          Host names that are not in the cache are resolved on a resolver thread, so that a slow resolver stalls neither the caller nor the event loop.
+     *          Callbacks are invoked on the event loop thread, and must not block.
+     *          Only plain TCP is supported.
+     */
+    class async_client
+        : protected diag::diag_ready<const char*> {
+
+        using diag_base = diag::diag_ready<const char*>;
+        using clock     = std::chrono::steady_clock;
+
+    public:
+        /**
+         * @brief        Constructor. Starts the event loop thread and the resolver thread.
+         * @param config `async_client_config` instance.
+         * @param log    `diag::log_ostream` pointer. May be `nullptr`.
+         */
+        async_client(async_client_config&& config, diag::log_ostream* log = nullptr);
+
+        /**
+         * @brief Deleted.
+         */
+        async_client(const async_client& other) = delete;
+
+        /**
+         * @brief Deleted.
+         */
+        async_client(async_client&& other) = delete;
+
+        /**
+         * @brief   Destructor. Stops the event loop, fails the outstanding requests, and closes all connections.
+         * @details Waits for a resolution that is in progress to complete.
+         */
+        ~async_client() noexcept;
+
+    public:
+        /**
+         * @brief          Sends a request asynchronously, and invokes a callback when the response is received or the request fails.
+         * @details        `Host` and `Content-Length` headers are added when missing. The protocol defaults to `HTTP/1.1`.
+         *                 Never blocks on name resolution. If the host cannot be resolved, the request fails through the callback.
+         * @param host     Host name or address.
+         * @param port     Port number or service name.
+         * @param request  Request. Taken over.
+         * @param body     Request body. Taken over. May be empty.
+         * @param callback Completion callback. Invoked exactly once.
+         */
+        void send_async(const char* host, const char* port, request&& request, std::string&& body, async_callback&& callback);
+
+        /**
+         * @brief         Sends a request asynchronously.
+         * @param host    Host name or address.
+         * @param port    Port number or service name.
+         * @param request Request. Taken over.
+         * @param body    Request body. Taken over. May be empty.
+         * @return        `std::future<async_response>` that gets set when the response is received, or that throws when the request fails.
+         */
+        std::future<async_response> send_async(const char* host, const char* port, request&& request, std::string&& body = std::string());
+
+        /**
+         * @brief Returns the number of connections opened so far.
+         */
+        std::size_t connect_count() const noexcept;
+
+    private:
+        /**
+         * @brief A resolved address. Unlike `socket::address`, it fits IPv6 too.
+         */
+        struct resolved_address {
+            sockaddr_storage value;
+            socklen_t        size;
+            int              family;
+        };
+
+        using address_list = std::vector<resolved_address>;
+
+        /**
+         * @brief Cached resolution of a host:port.
+         */
+        struct dns_entry {
+            std::shared_ptr<const address_list> addresses;
+            clock::time_point                   expires;
+        };
+
+        /**
+         * @brief A request that has been serialized and is waiting for, or is being processed over, a connection.
+         */
+        struct pending_request {
+            /**
+             * @brief host:port. The key of the connection pool and of the DNS cache.
+             */
+            std::string key;
+
+            /**
+             * @brief Host and port to resolve when they are not in the DNS cache.
+             */
+            std::string host;
+            std::string port;
+
+            /**
+             * @brief Resolved addresses of the host.
+             */
+            std::shared_ptr<const address_list> addresses;
+
+            /**
+             * @brief Why the host could not be resolved. The event loop fails the request with it.
+             */
+            std::exception_ptr resolve_error;
+
+            /**
+             * @brief Serialized request, head and body.
+             */
+            std::string bytes;
+
+            /**
+             * @brief Whether the request is `HEAD`, i.e. whether the response has no body regardless of its headers.
+             */
+            bool is_head;
+
+            /**
+             * @brief Whether the request has already been retried after a kept-alive connection was closed by the server.
+             */
+            bool is_retry;
+
+            /**
+             * @brief When the request times out.
+             */
+            clock::time_point deadline;
+
+            /**
+             * @brief Completion callback.
+             */
+            async_callback callback;
+        };
+
+        /**
+         * @brief State of a connection.
+         */
+        enum class connection_state : std::uint8_t {
+            connecting,
+            sending,
+            receiving,
+            idle,
+        };
+
+        /**
+         * @brief How the end of a response body is determined.
+         */
+        enum class body_framing : std::uint8_t {
+            none,
+            length,
+            chunked,
+            close,
+        };
+
+        /**
+         * @brief A pooled connection and the progress of its current request.
+         */
+        struct connection {
+            /**
+             * @brief Unique id. Unlike descriptors, ids are never reused, so a stale epoll event cannot reach a newer connection.
+             */
+            std::uint64_t                       id              = 0;
+            socket::fd_t                        fd              = socket::fd::invalid;
+            std::string                         key;
+            connection_state                    state           = connection_state::connecting;
+
+            /**
+             * @brief Addresses to connect to, and the one currently tried.
+             */
+            std::shared_ptr<const address_list> addresses;
+            std::size_t                         address_index   = 0;
+
+            /**
+             * @brief Connect timeout while connecting, idle timeout while idle.
+             */
+            clock::time_point                   deadline        = clock::time_point::max();
+
+            /**
+             * @brief Whether the connection has completed a request before, i.e. whether the server may have closed it meanwhile.
+             */
+            bool                                is_reused       = false;
+
+            /**
+             * @brief Current request. `nullptr` while idle.
+             */
+            std::unique_ptr<pending_request>    request;
+            std::size_t                         sent_len        = 0;
+
+            /**
+             * @brief Bytes received for the current response, and the progress of framing them.
+             */
+            std::string                         received;
+            std::size_t                         head_len        = 0;
+            http::response                      response;
+            body_framing                        framing         = body_framing::none;
+            std::size_t                         response_len    = 0;
+            std::string                         body;
+            std::size_t                         chunk_pos       = 0;
+            std::size_t                         chunk_remaining = 0;
+            bool                                is_in_trailers  = false;
+        };
+
+        /**
+         * @brief Connections and waiting requests of a single host:port.
+         */
+        struct connection_pool {
+            std::size_t                                  connection_count = 0;
+            std::vector<connection*>                     idle_connections;
+            std::deque<std::unique_ptr<pending_request>> waiting_requests;
+        };
+
+    private:
+        /**
+         * @brief     Returns the addresses of a host:port from the DNS cache.
+         * @param key host:port.
+         * @return    `nullptr` = not cached, or expired.
+         */
+        std::shared_ptr<const address_list> find_dns_entry(const std::string& key);
+
+        /**
+         * @brief      Returns the addresses of a host:port from the DNS cache, or resolves them and caches them.
+         * @details    Blocks on the resolver. Only called on the resolver thread.
+         * @param host Host name or address.
+         * @param port Port number or service name.
+         * @param key  host:port.
+         */
+        std::shared_ptr<const address_list> resolve(const char* host, const char* port, const std::string& key);
+
+        /**
+         * @brief   Resolves the hosts of queued requests until the client is destroyed, and passes the requests on to the event loop.
+         * @details Requests to the same host:port that are queued at the same time share a single resolution.
+         */
+        void run_resolver();
+
+        /**
+         * @brief         Queues a request for the event loop, and wakes it up.
+         * @param request Request.
+         */
+        void post_request(std::unique_ptr<pending_request>&& request);
+
+        /**
+         * @brief           Removes a DNS cache entry, unless it has already been replaced.
+         * @param key       host:port.
+         * @param addresses The addresses that failed.
+         */
+        void invalidate_dns_entry(const std::string& key, const std::shared_ptr<const address_list>& addresses);
+
+        /**
+         * @brief Runs the event loop until the client is destroyed.
+         */
+        void run_loop();
+
+        /**
+         * @brief         Starts a request over an idle connection, over a new connection, or queues it.
+         * @param request Request.
+         */
+        void dispatch_request(std::unique_ptr<pending_request>&& request);
+
+        /**
+         * @brief     Opens new connections for waiting requests while the pool has room.
+         * @param key host:port.
+         */
+        void drain_waiting_requests(const std::string& key);
+
+        /**
+         * @brief         Opens a new connection for a request.
+         * @param request Request.
+         */
+        void open_connection(std::unique_ptr<pending_request>&& request);
+
+        /**
+         * @brief      Tries the addresses of a connection starting with the current one until a connect is in progress or has completed.
+         * @param conn Connection.
+         * @return     `false` = all addresses failed, and the connection has been destroyed.
+         */
+        bool try_connect(connection& conn);
+
+        /**
+         * @brief      Abandons the address currently tried, and tries the next ones.
+         * @param conn Connection.
+         */
+        void connect_next_address(connection& conn);
+
+        /**
+         * @brief         Starts sending a request over a connected connection.
+         * @param conn    Connection.
+         * @param request Request.
+         */
+        void start_request(connection& conn, std::unique_ptr<pending_request>&& request);
+
+        /**
+         * @brief        Handles an epoll event of a connection.
+         * @param conn   Connection.
+         * @param events epoll events.
+         */
+        void process_event(connection& conn, std::uint32_t events);
+
+        /**
+         * @brief      Sends as much of the current request as the socket accepts.
+         * @param conn Connection.
+         */
+        void send_request(connection& conn);
+
+        /**
+         * @brief      Receives as much of the current response as is available.
+         * @param conn Connection.
+         */
+        void receive_response(connection& conn);
+
+        /**
+         * @brief        Frames the bytes received so far.
+         * @param conn   Connection.
+         * @param is_eof Whether the server has closed the connection.
+         * @return       `true` = the response is complete.
+         */
+        bool frame_response(connection& conn, bool is_eof);
+
+        /**
+         * @brief      Parses the status line and the headers once they have been received, and determines the body framing.
+         * @param conn Connection.
+         * @return     `true` = the head is complete.
+         */
+        bool frame_head(connection& conn);
+
+        /**
+         * @brief      Decodes the chunks received so far.
+         * @param conn Connection.
+         * @return     `true` = the last chunk and the trailers have been received.
+         */
+        bool frame_chunks(connection& conn);
+
+        /**
+         * @brief      Completes the current request with the received response, and reuses or closes the connection.
+         * @param conn Connection.
+         */
+        void complete_request(connection& conn);
+
+        /**
+         * @brief       Fails the current request of a connection, and closes the connection.
+         * @details     A request that fails over a reused connection before any of its response is received, and before it times out, is retried once over a new connection.
+         * @param conn  Connection.
+         * @param error Error.
+         */
+        void fail_connection(connection& conn, std::exception_ptr error);
+
+        /**
+         * @brief      Hands a connection to the next waiting request, or parks it as idle.
+         * @param conn Connection.
+         */
+        void release_connection(connection& conn);
+
+        /**
+         * @brief      Closes a connection, and destroys it.
+         * @param conn Connection.
+         */
+        void close_connection(connection& conn);
+
+        /**
+         * @brief        Updates the epoll events a connection is waiting for.
+         * @param conn   Connection.
+         * @param events epoll events.
+         * @param op     `EPOLL_CTL_ADD` or `EPOLL_CTL_MOD`.
+         */
+        void watch_connection(const connection& conn, std::uint32_t events, int op);
+
+        /**
+         * @brief     Fails the requests and closes the connections whose deadlines have passed.
+         * @param now Current time.
+         * @return    Time until the next deadline. `-1` = no deadline.
+         */
+        int process_deadlines(clock::time_point now);
+
+        /**
+         * @brief          Invokes the callback of a request.
+         * @param request  Request.
+         * @param error    Error. `nullptr` = success.
+         * @param response Response.
+         */
+        void complete_callback(pending_request& request, std::exception_ptr error, async_response&& response) noexcept;
+
+        /**
+         * @brief           Creates an exception that is delivered to a callback instead of being thrown.
+         * @param suborigin Suborigin.
+         * @param tag       Tag.
+         * @param format    Message format.
+         * @param ...       Message arguments.
+         */
+        std::exception_ptr make_error(const char* suborigin, diag::tag_t tag, const char* format, ...) const noexcept;
+
+    private:
+        /**
+         * @brief The config passed in to the constructor.
+         */
+        const async_client_config _config;
+
+        /**
+         * @brief Protects the DNS cache.
+         */
+        std::mutex _dns_mutex;
+
+        /**
+         * @brief Resolved addresses by host:port.
+         */
+        std::map<std::string, dns_entry> _dns_cache;
+
+        /**
+         * @brief Protects the incoming queue, the resolve queue, and the stopping flag.
+         */
+        std::mutex _incoming_mutex;
+
+        /**
+         * @brief Requests sent since the event loop last woke up.
+         */
+        std::vector<std::unique_ptr<pending_request>> _incoming_requests;
+
+        /**
+         * @brief Requests whose hosts are not in the DNS cache, waiting for the resolver thread.
+         */
+        std::deque<std::unique_ptr<pending_request>> _resolve_requests;
+
+        /**
+         * @brief Wakes up the resolver thread when requests are queued or when the client is destroyed.
+         */
+        std::condition_variable _resolve_cond;
+
+        /**
+         * @brief Flag that tells the event loop to exit.
+         */
+        bool _is_stopping;
+
+        /**
+         * @brief Connection pools by host:port. Only accessed by the event loop.
+         */
+        std::map<std::string, connection_pool> _pools;
+
+        /**
+         * @brief Connections by id. Only accessed by the event loop.
+         */
+        std::map<std::uint64_t, std::unique_ptr<connection>> _connections;
+
+        /**
+         * @brief Id of the last connection. `0` identifies the eventfd.
+         */
+        std::uint64_t _last_connection_id;
+
+        /**
+         * @brief Number of connections opened so far.
+         */
+        std::atomic<std::size_t> _connect_count;
+
+        /**
+         * @brief The epoll instance of the event loop.
+         */
+        int _epoll_fd;
+
+        /**
+         * @brief eventfd that wakes up the event loop when requests are sent or when the client is destroyed.
+         */
+        int _wake_fd;
+
+        /**
+         * @brief The event loop thread.
+         */
+        std::thread _loop_thread;
+
+        /**
+         * @brief The resolver thread.
+         */
+        std::thread _resolver_thread;
+    };
+
+
+    // --------------------------------------------------------------
+
+} } }
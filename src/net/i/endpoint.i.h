@@ -25,7 +25,17 @@ SOFTWARE.
 
 #include <future>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "../../root/size.h"
 #include "../../diag/i/diag_ready.i.h"
@@ -48,9 +58,17 @@ namespace abc { namespace net { namespace http {
          * @param cert_file_path     Full path to the TLS certificate file. May be `""`.
          * @param pkey_file_path     Full path to the TLS private key file. May be `""`.
          * @param pkey_file_password Password for the TLS private key file. May be `""`.
+         * @param worker_count       Number of threads that process requests. `0` = the number of hardware threads.
+         * @param max_requests_per_connection Maximum number of requests processed over a single connection. `0` = no limit. `1` = no keep-alive.
+         * @param keep_alive_timeout How long an idle connection is kept open waiting for the next request.
+         * @param file_cache_size    Maximum total size of the static files kept in memory. `0` = no caching.
+         * @param file_cache_max_file_size Maximum size of a static file that is kept in memory. Larger files are sent from disk.
          */
         endpoint_config(const char* port, std::size_t listen_queue_size, const char* root_dir, const char* files_prefix,
-                        const char* cert_file_path = "", const char* pkey_file_path = "", const char* pkey_file_password = "");
+                        const char* cert_file_path = "", const char* pkey_file_path = "", const char* pkey_file_password = "",
+                        std::size_t worker_count = 0,
+                        std::size_t max_requests_per_connection = 100, std::chrono::milliseconds keep_alive_timeout = std::chrono::seconds(5),
+                        std::size_t file_cache_size = 16 * size::m1, std::size_t file_cache_max_file_size = size::m1);
 
         /**
          * @brief Port number to listen at.
@@ -86,9 +104,40 @@ namespace abc { namespace net { namespace http {
          * @brief Password for the TLS private key file.
          */
         const std::string pkey_file_password;
+
+        /**
+         * @brief Number of threads that process requests.
+         */
+        const std::size_t worker_count;
+
+        /**
+         * @brief Maximum number of requests processed over a single connection.
+         */
+        const std::size_t max_requests_per_connection;
+
+        /**
+         * @brief How long an idle connection is kept open waiting for the next request.
+         */
+        const std::chrono::milliseconds keep_alive_timeout;
+
+        /**
+         * @brief Maximum total size of the static files kept in memory.
+         */
+        const std::size_t file_cache_size;
+
+        /**
+         * @brief Maximum size of a static file that is kept in memory.
+         */
+        const std::size_t file_cache_max_file_size;
     };
 
 
+    /**
+     * @brief How long the `endpoint` event loop waits for new connections before it checks for shutdown.
+     */
+    constexpr std::chrono::milliseconds endpoint_poll_timeout(100);
+
+
     // --------------------------------------------------------------
 
 
@@ -110,9 +159,12 @@ namespace abc { namespace net { namespace http {
         constexpr status_code_t OK                    = 200;
         constexpr status_code_t Created               = 201;
         constexpr status_code_t Accepted              = 202;
+        constexpr status_code_t No_Content            = 204;
+        constexpr status_code_t Partial_Content       = 206;
 
         constexpr status_code_t Moved_Permanently     = 301;
         constexpr status_code_t Found                 = 302;
+        constexpr status_code_t Not_Modified          = 304;
 
         constexpr status_code_t Bad_Request           = 400;
         constexpr status_code_t Unauthorized          = 401;
@@ -122,6 +174,7 @@ namespace abc { namespace net { namespace http {
         constexpr status_code_t Conflict              = 409;
         constexpr status_code_t Payload_Too_Large     = 413;
         constexpr status_code_t URI_Too_Long          = 414;
+        constexpr status_code_t Range_Not_Satisfiable = 416;
         constexpr status_code_t Too_Many_Requests     = 429;
 
         constexpr status_code_t Internal_Server_Error = 500;
@@ -134,9 +187,12 @@ namespace abc { namespace net { namespace http {
         constexpr const char* OK                      = "OK";
         constexpr const char* Created                 = "Created";
         constexpr const char* Accepted                = "Accepted";
+        constexpr const char* No_Content              = "No Content";
+        constexpr const char* Partial_Content         = "Partial Content";
 
         constexpr const char* Moved_Permanently       = "Moved Permanently";
         constexpr const char* Found                   = "Found";
+        constexpr const char* Not_Modified            = "Not Modified";
 
         constexpr const char* Bad_Request             = "Bad Request";
         constexpr const char* Unauthorized            = "Unauthorized";
@@ -146,6 +202,7 @@ namespace abc { namespace net { namespace http {
         constexpr const char* Conflict                = "Conflict";
         constexpr const char* Payload_Too_Large       = "Payload Too Large";
         constexpr const char* URI_Too_Long            = "URI Too Long";
+        constexpr const char* Range_Not_Satisfiable   = "Range Not Satisfiable";
         constexpr const char* Too_Many_Requests       = "Too Many Requests";
 
         constexpr const char* Internal_Server_Error   = "Internal Server Error";
@@ -155,8 +212,31 @@ namespace abc { namespace net { namespace http {
 
 
     namespace header {
+        constexpr const char* Host                    = "Host";
         constexpr const char* Content_Type            = "Content-Type";
         constexpr const char* Content_Length          = "Content-Length";
+        constexpr const char* Connection              = "Connection";
+        constexpr const char* Transfer_Encoding       = "Transfer-Encoding";
+        constexpr const char* Range                   = "Range";
+        constexpr const char* Content_Range           = "Content-Range";
+        constexpr const char* Accept_Ranges           = "Accept-Ranges";
+        constexpr const char* ETag                    = "ETag";
+        constexpr const char* If_None_Match           = "If-None-Match";
+        constexpr const char* Accept_Encoding         = "Accept-Encoding";
+        constexpr const char* Content_Encoding        = "Content-Encoding";
+        constexpr const char* Vary                    = "Vary";
+    }
+
+
+    namespace connection {
+        constexpr const char* close                   = "close";
+        constexpr const char* keep_alive              = "keep-alive";
+    }
+
+
+    namespace content_encoding {
+        constexpr const char* br                      = "br";
+        constexpr const char* gzip                    = "gzip";
     }
 
 
@@ -233,10 +313,364 @@ namespace abc { namespace net { namespace http {
     // --------------------------------------------------------------
 
 
+    /**
+     * @brief A static file kept in memory by `file_cache`.
+     */
+    struct file_cache_entry {
+        /**
+         * @brief Content of the file.
+         */
+        std::string content;
+
+        /**
+         * @brief Strong entity tag (quoted) derived from the content.
+         */
+        std::string etag;
+
+        /**
+         * @brief Modification time of the file in nanoseconds.
+         */
+        std::int64_t mtime_ns;
+
+        /**
+         * @brief Inode number of the file.
+         */
+        std::uint64_t inode;
+    };
+
+
+    /**
+     * @brief         Thread-safe in-memory cache of static files, keyed by local path.
+     * @details       Each lookup checks the file's modification time, size, and inode, and reloads the file if any of them has changed.
+     *                When the cache is full, the least recently used files are evicted.
+     *                Entries are shared, so an entry that is being sent remains valid after it gets evicted.
+     */
+    class file_cache
+        : protected diag::diag_ready<const char*> {
+
+        using diag_base = diag::diag_ready<const char*>;
+
+    public:
+        /**
+         * @brief               Constructor.
+         * @param max_size      Maximum total size of the cached files.
+         * @param max_file_size Maximum size of a single cached file.
+         * @param log           `diag::log_ostream` pointer. May be `nullptr`.
+         */
+        file_cache(std::size_t max_size, std::size_t max_file_size, diag::log_ostream* log);
+
+        /**
+         * @brief Deleted.
+         */
+        file_cache(const file_cache& other) = delete;
+
+    public:
+        /**
+         * @brief          Returns the cached content of a file, and loads the file if it is not cached or if it has changed.
+         * @param filepath Local file path.
+         * @return         The entry, or `nullptr` if the file is not a regular file, or if it is too large to be cached.
+         */
+        std::shared_ptr<const file_cache_entry> get(const std::string& filepath);
+
+        /**
+         * @brief Evicts all files.
+         */
+        void clear();
+
+        /**
+         * @brief Returns the total size of the cached files.
+         */
+        std::size_t size() const;
+
+    private:
+        /**
+         * @brief          Reads a file into a new entry.
+         * @param filepath Local file path.
+         * @return         The entry, or `nullptr` if the file could not be read or has changed while being read.
+         */
+        std::shared_ptr<const file_cache_entry> load(const std::string& filepath) const;
+
+        /**
+         * @brief      Evicts the least recently used files until the given size fits. Must be called under `_mutex`.
+         * @param size Size that has to fit.
+         */
+        void evict(std::size_t size);
+
+        /**
+         * @brief An entry with its position in the recency order.
+         */
+        struct slot {
+            /**
+             * @brief Entry.
+             */
+            std::shared_ptr<const file_cache_entry> entry;
+
+            /**
+             * @brief Position of the local path in `_recency`.
+             */
+            std::list<std::string>::iterator recency_itr;
+        };
+
+        /**
+         * @brief     Removes a slot and its position in the recency order. Must be called under `_mutex`.
+         * @param itr Slot iterator.
+         */
+        void erase(std::map<std::string, slot>::iterator itr);
+
+    private:
+        /**
+         * @brief Maximum total size of the cached files.
+         */
+        const std::size_t _max_size;
+
+        /**
+         * @brief Maximum size of a single cached file.
+         */
+        const std::size_t _max_file_size;
+
+        /**
+         * @brief Guards `_slots`, `_recency`, and `_size`.
+         */
+        mutable std::mutex _mutex;
+
+        /**
+         * @brief Entries by local path.
+         */
+        std::map<std::string, slot> _slots;
+
+        /**
+         * @brief Local paths of the entries from the most recently used to the least recently used.
+         */
+        std::list<std::string> _recency;
+
+        /**
+         * @brief Total size of the cached files.
+         */
+        std::size_t _size;
+    };
+
+
+    // --------------------------------------------------------------
+
+
+    /**
+     * @brief Maximum number of parameters in a route path template.
+     */
+    constexpr std::size_t max_route_params = 8;
+
+
+    /**
+     * @brief Values of the path parameters captured by `router::find()`.
+     */
+    struct route_params {
+        /**
+         * @brief Constructor. Empty.
+         */
+        route_params() noexcept;
+
+        /**
+         * @brief      Returns the value of a parameter.
+         * @param name Parameter name as it appears in the path template, without the braces.
+         * @return     The value, which points into the request path, or an empty `span` if there is no such parameter.
+         */
+        span find(const char* name) const noexcept;
+
+        /**
+         * @brief Number of parameters.
+         */
+        std::size_t count;
+
+        /**
+         * @brief Parameter names, in path order. Owned by the `router`.
+         */
+        const char* names[max_route_params];
+
+        /**
+         * @brief Parameter values, in path order.
+         */
+        span values[max_route_params];
+    };
+
+
+    /**
+     * @brief Handler of a REST request that has matched a route.
+     */
+    using route_handler = std::function<void(server& http, const request& request, const route_params& params)>;
+
+
+    /**
+     * @brief   Handler of a REST request that has matched a route, which gets the request head in place instead of an `http::request`.
+     * @details The spans of the head and of the path parameters point into the receive buffer of the connection. They are valid until the handler reads the body.
+     *          Path parameters are not URL-decoded.
+     */
+    using route_head_handler = std::function<void(server& http, const request_head& head, const route_params& params)>;
+
+
+    /**
+     * @brief Result of `router::find()`.
+     */
+    enum class route_status {
+        found,
+        not_found,
+        method_not_allowed,
+    };
+
+
+    /**
+     * @brief         Dispatch table of REST handlers by method and path template.
+     * @details       Path templates are split into segments at '/'. A segment is either a literal, which is matched case-insensitively, or a `{name}` parameter, which matches any non-empty segment.
+     *                The segments are kept in a trie whose literal children are sorted, so a lookup costs a binary search per segment regardless of the number of routes.
+     *                A literal segment takes precedence over a parameter at the same position.
+     *                Routes are added before the endpoint starts. Lookups do not allocate, and are safe to run concurrently.
+     */
+    class router
+        : protected diag::diag_ready<const char*> {
+
+        using diag_base = diag::diag_ready<const char*>;
+
+    public:
+        /**
+         * @brief     Constructor.
+         * @param log `diag::log_ostream` pointer. May be `nullptr`.
+         */
+        router(diag::log_ostream* log);
+
+        /**
+         * @brief Deleted.
+         */
+        router(const router& other) = delete;
+
+    public:
+        /**
+         * @brief               Adds a route. Replaces the handler of an existing route with the same method and path template.
+         * @param method        Http method.
+         * @param path_template Path template, e.g. `/games/{game_id}/moves`. Must start with '/'.
+         * @param handler       Handler.
+         */
+        void add(const char* method, const char* path_template, route_handler&& handler);
+
+        /**
+         * @brief               Adds a route whose handler gets the request head in place. Replaces the handler of an existing route with the same method and path template.
+         * @param method        Http method.
+         * @param path_template Path template, e.g. `/games/{game_id}/moves`. Must start with '/'.
+         * @param handler       Handler.
+         */
+        void add(const char* method, const char* path_template, route_head_handler&& handler);
+
+        /**
+         * @brief         Finds the route of a request.
+         * @param method  Http method.
+         * @param path    Request path.
+         * @param params  Set to the captured path parameters.
+         * @param handler Set to the handler of the route, or to `nullptr` if there is none or if the route has a `route_head_handler`.
+         * @return        `found`, `not_found` if no path template matches, or `method_not_allowed` if a path template matches but not with this method.
+         */
+        route_status find(const char* method, const char* path, route_params& params, const route_handler*& handler) const;
+
+        /**
+         * @brief              Finds the route of a request whose head has been parsed in place.
+         * @param method       Http method.
+         * @param path         Request path, e.g. `request_head::path()`.
+         * @param params       Set to the captured path parameters, which point into `path`.
+         * @param handler      Set to the `route_handler` of the route, or to `nullptr`.
+         * @param head_handler Set to the `route_head_handler` of the route, or to `nullptr`.
+         * @return             `found`, `not_found` if no path template matches, or `method_not_allowed` if a path template matches but not with this method.
+         */
+        route_status find(const span& method, const span& path, route_params& params, const route_handler*& handler, const route_head_handler*& head_handler) const;
+
+    private:
+        /**
+         * @brief A route that ends at a trie node.
+         */
+        struct route {
+            /**
+             * @brief Http method.
+             */
+            std::string method;
+
+            /**
+             * @brief Parameter names, in path order.
+             */
+            std::vector<std::string> param_names;
+
+            /**
+             * @brief Handler. Empty if the route has a `head_handler`.
+             */
+            route_handler handler;
+
+            /**
+             * @brief Handler that gets the request head in place. Empty if the route has a `handler`.
+             */
+            route_head_handler head_handler;
+        };
+
+        /**
+         * @brief A path segment in the trie.
+         */
+        struct node {
+            /**
+             * @brief Literal children as (lowercase segment, node index) pairs, sorted by segment.
+             */
+            std::vector<std::pair<std::string, std::size_t>> literals;
+
+            /**
+             * @brief Index of the parameter child, or 0 if there is none.
+             */
+            std::size_t param;
+
+            /**
+             * @brief Routes that end at this node.
+             */
+            std::vector<route> routes;
+        };
+
+        /**
+         * @brief               Finds the route with the given method and path template, or inserts an empty one.
+         * @param method        Http method.
+         * @param path_template Path template.
+         * @return              A reference to the route.
+         */
+        route& insert(const char* method, const char* path_template);
+
+        /**
+         * @brief          Matches the remaining segments of a path against the subtrie of a node.
+         * @param node_i   Node index.
+         * @param segment  The first remaining segment.
+         * @param path_end End of the path.
+         * @param params   Gets the captured path parameters appended.
+         * @return         Index of the node where the path ends, or 0 if there is none.
+         */
+        std::size_t match(std::size_t node_i, const char* segment, const char* path_end, route_params& params) const;
+
+        /**
+         * @brief         Compares a lowercase literal segment to a path segment case-insensitively.
+         * @param literal Lowercase literal segment.
+         * @param segment Path segment.
+         * @param len     Length of the path segment.
+         * @return        Negative, zero, or positive like `std::strcmp()`.
+         */
+        static int compare_segment(const std::string& literal, const char* segment, std::size_t len) noexcept;
+
+    private:
+        /**
+         * @brief Trie nodes. The root is at index 0.
+         */
+        std::vector<node> _nodes;
+    };
+
+
+    // --------------------------------------------------------------
+
+
     /**
      * @brief               Base http endpoint.
      * @details             This class supports the most common functionality - reads requests and dispatches them for REST- or file-processing.
      *                      This class must be subclassed to implement the processing of requests.
+     *                      An event loop accepts connections from a non-blocking listener, and queues them up to `endpoint_config::listen_queue_size`.
+     *                      While the queue is full, new connections wait in the listen backlog.
+     *                      A fixed pool of `endpoint_config::worker_count` threads processes the queued connections.
+     *                      HTTP/1.1 connections are kept alive, unless the client sends `Connection: close`, or `endpoint_config::max_requests_per_connection` is reached.
+     *                      Pipelined requests are processed in order. Idle connections are handed back to the event loop, which closes them after `endpoint_config::keep_alive_timeout`.
      */
     class endpoint
         : protected diag::diag_ready<const char*>  {
@@ -279,7 +713,7 @@ namespace abc { namespace net { namespace http {
 
         /**
          * @brief   Starts the endpoint on the current thread.
-         * @details This thread will block until a `POST /shutdown` is received from a client.
+         * @details This thread runs the event loop, and will block until a `POST /shutdown` is received from a client.
          */
         void start();
 
@@ -291,6 +725,10 @@ namespace abc { namespace net { namespace http {
 
         /**
          * @brief         Processes a GET request for a static file.
+         * @details       Supports a single `Range` of bytes.
+         *                Files up to `endpoint_config::file_cache_max_file_size` are served from a `file_cache` with a strong `ETag`, and `If-None-Match` is answered with 304.
+         *                A `.br` or `.gz` sibling that is not older than the file is sent instead when the client accepts that `Content-Encoding`.
+         *                Larger files are sent with `tcp_client_socket::send_file()` over a `tcp_client_socket_streambuf`.
          * @param http    A reference to `http::server`.
          * @param request A reference to `http::request`.
          */
@@ -298,11 +736,35 @@ namespace abc { namespace net { namespace http {
 
         /**
          * @brief         Processes a REST request.
+         * @details       Dispatches the request to the handler of its route that was added with `add_route()`.
+         *                Responds with 404 if no route matches the path, and with 405 if a route matches the path but not the method.
+         *                An `endpoint_error` thrown by a handler is sent back as a simple response.
          * @param http    A reference to `http::server`.
          * @param request A reference to `http::request`.
          */
         virtual void process_rest_request(server& http, const request& request);
 
+        /**
+         * @brief               Adds a route for `process_rest_request()`.
+         * @details             Routes should be added before the endpoint is started, typically from the constructor of the subclass.
+         *                      `POST /shutdown` is added by the `endpoint` constructor, and may be replaced.
+         * @param method        Http method.
+         * @param path_template Path template, e.g. `/games/{game_id}/moves`. See `router`.
+         * @param handler       Handler.
+         */
+        void add_route(const char* method, const char* path_template, route_handler&& handler);
+
+        /**
+         * @brief               Adds a route whose handler gets the request head in place, so no `http::request` is made for it.
+         * @details             Such requests are dispatched straight from `process_request()`, i.e. they do not go through `process_rest_request()`, as long as their heads can be parsed in place.
+         *                      An `endpoint_error` thrown by the handler is sent back as a simple response.
+         *                      Requests whose heads cannot be parsed in place (see `util::parse_request_head()`) are read as a stream, and the handler gets a head made over that request (see `util::make_request_head()`).
+         * @param method        Http method.
+         * @param path_template Path template, e.g. `/games/{game_id}/moves`. See `router`.
+         * @param handler       Handler.
+         */
+        void add_route(const char* method, const char* path_template, route_head_handler&& handler);
+
         /**
          * @brief         Checks if the resource is a static file.
          * @param request A reference to `http::request`.
@@ -310,6 +772,14 @@ namespace abc { namespace net { namespace http {
          */
         virtual bool is_file_request(const request& request);
 
+        /**
+         * @brief      Checks if the resource of a request head that has been parsed in place is a static file.
+         * @details    Compares the path before it is URL-decoded. Should be overridden together with `is_file_request(const request&)`.
+         * @param head A reference to the parsed `request_head`.
+         * @return     Whether the resource is a static file.
+         */
+        virtual bool is_file_request(const request_head& head);
+
         /**
          * @brief               Sends a response with the given content.
          * @param http          A reference to `http::server`.
@@ -330,11 +800,65 @@ namespace abc { namespace net { namespace http {
 
     protected:
         /**
-         * @brief            Processes (any kind of) a request.
-         * @details          This is the top-level method that reads the http request line, and calls either `process_file_request()` or `process_rest_request()`.
-         * @param connection Connection/client socket to read the request from and to send the response to.
+         * @brief               Processes requests from a connection until the connection has to be closed, or until no more request bytes have been received.
+         * @param connection    Connection/client socket to read the requests from and to send the responses to.
+         * @param request_count Number of requests processed over this connection so far. Gets updated.
+         * @return              `true` = the connection should be kept alive. `false` = the connection should be closed.
+         */
+        bool process_connection(net::tcp_client_socket* connection, std::size_t& request_count);
+
+        /**
+         * @brief         Processes (any kind of) a request.
+         * @details       This is the top-level method that reads the http request line, and calls either `process_file_request()` or `process_rest_request()`.
+         *                Whatever is left of the request body afterwards is skipped, so that the next request could be read.
+         * @param sb      Streambuf over the connection to read the request from and to send the response to.
+         * @param is_last Whether this is the last request allowed over the connection.
+         * @return        `true` = the connection may be reused for another request. `false` = the connection should be closed.
+         */
+        bool process_request(tcp_client_socket_streambuf& sb, bool is_last);
+
+        /**
+         * @brief      Parses a request line and headers in place in the receive buffer with `util::parse_request_head()`. Nothing is consumed.
+         * @param sb   Streambuf over the connection.
+         * @param head Set to spans into the receive buffer.
+         * @return     `true` if the head has been parsed. `false` if it is larger than the receive buffer or uses rare forms.
          */
-        void process_request(std::unique_ptr<net::tcp_client_socket>&& connection);
+        bool read_request_head(tcp_client_socket_streambuf& sb, request_head& head);
+
+        /**
+         * @brief      Reads a request line and headers, and positions the `http::server` at the body.
+         * @param http A reference to `http::server` created over `sb`.
+         * @param sb   Streambuf over the connection.
+         * @param head Pointer to the head parsed by `read_request_head()`, or `nullptr` to read the request as a stream.
+         * @return     The request.
+         */
+        request read_request(server& http, tcp_client_socket_streambuf& sb, const request_head* head);
+
+        /**
+         * @brief              Processes a request whose route has a `route_head_handler` without making an `http::request`.
+         * @param http         A reference to `http::server` created over `sb`.
+         * @param sb           Streambuf over the connection.
+         * @param head         A reference to the head parsed by `read_request_head()`.
+         * @param params       Path parameters.
+         * @param head_handler Handler.
+         * @param is_last      Whether this is the last request allowed over the connection.
+         * @return             `true` = the connection may be reused for another request. `false` = the connection should be closed.
+         */
+        bool process_head_request(server& http, tcp_client_socket_streambuf& sb, const request_head& head, const route_params& params, const route_head_handler& head_handler, bool is_last);
+
+        /**
+         * @brief         Checks whether the client allows the connection to be reused after this request.
+         * @param request A reference to `http::request`.
+         * @return        `true` for HTTP/1.1 requests without `Connection: close`.
+         */
+        bool is_keep_alive_request(const request& request) const;
+
+        /**
+         * @brief      Checks whether the client allows the connection to be reused after this request.
+         * @param head A reference to the parsed `request_head`.
+         * @return     `true` for HTTP/1.1 requests without `Connection: close`.
+         */
+        bool is_keep_alive_request(const request_head& head) const noexcept;
 
         /**
          * @brief Sets the "shutdown requested" flag.
@@ -383,9 +907,172 @@ namespace abc { namespace net { namespace http {
         static void start_thread_func(endpoint* this_ptr);
 
         /**
-         * @brief Thread function for the 'process_request' thread.
+         * @brief          Thread function for the worker threads.
+         * @param listener The listener that the queued connections were accepted from.
          */
-        static void process_request_thread_func(endpoint* this_ptr, std::unique_ptr<net::tcp_client_socket>&& connection);
+        static void worker_thread_func(endpoint* this_ptr, const net::tcp_server_socket* listener);
+
+        /**
+         * @brief          Processes queued connections until the endpoint stops.
+         * @param listener The listener that the queued connections were accepted from.
+         */
+        void process_connections(const net::tcp_server_socket* listener);
+
+        /**
+         * @brief          Runs the event loop until a shutdown is requested and no request is in progress.
+         * @param listener The listener to accept connections from.
+         */
+        void run_event_loop(const net::tcp_server_socket* listener);
+
+        /**
+         * @brief         Stops and joins the workers, and drops the connections that are still queued or idle.
+         * @param workers Worker threads.
+         */
+        void stop_workers(std::vector<std::thread>& workers);
+
+        /**
+         * @brief A connection that is waiting for a worker or for its next request.
+         */
+        struct connection_entry {
+            /**
+             * @brief Descriptor.
+             */
+            socket::fd_t fd;
+
+            /**
+             * @brief Connection. `nullptr` until a worker accepts it.
+             */
+            std::unique_ptr<net::tcp_client_socket> connection;
+
+            /**
+             * @brief Number of requests processed over the connection so far.
+             */
+            std::size_t request_count;
+
+            /**
+             * @brief When the connection became idle.
+             */
+            std::chrono::steady_clock::time_point idle_since;
+        };
+
+        /**
+         * @brief       Hands an idle connection back to the event loop, which queues it again when its next request arrives.
+         * @param entry Connection entry.
+         */
+        void park_connection(connection_entry&& entry);
+
+        /**
+         * @brief How the end of a request body is determined.
+         */
+        struct body_framing {
+            /**
+             * @brief The body is chunked.
+             */
+            bool is_chunked;
+
+            /**
+             * @brief The end of the body can be determined.
+             */
+            bool is_delimited;
+
+            /**
+             * @brief Length of a body that is not chunked.
+             */
+            std::size_t content_length;
+        };
+
+        /**
+         * @brief         Determines how the end of a request body is determined.
+         * @param headers Request headers.
+         */
+        static body_framing get_body_framing(const headers& headers);
+
+        /**
+         * @brief      Determines how the end of a request body is determined.
+         * @param head A reference to the parsed `request_head`.
+         */
+        static body_framing get_body_framing(const request_head& head) noexcept;
+
+        /**
+         * @brief                   Determines how the end of a request body is determined.
+         * @param is_chunked        Whether the body is chunked.
+         * @param transfer_encoding `Transfer-Encoding` header value, or `nullptr`.
+         * @param content_length    `Content-Length` header value, or `nullptr`.
+         */
+        static body_framing get_body_framing(bool is_chunked, const span* transfer_encoding, const span* content_length) noexcept;
+
+        /**
+         * @brief                  Checks whether the client allows the connection to be reused.
+         * @param request_protocol Http protocol of the request.
+         * @param connection_value `Connection` header value, or `nullptr`.
+         */
+        static bool is_keep_alive(const span& request_protocol, const span* connection_value) noexcept;
+
+        /**
+         * @brief             Skips the rest of the request body.
+         * @param http        A reference to `http::server` that read the request.
+         * @param sb          Streambuf over the connection.
+         * @param framing     How the end of the body is determined.
+         * @param body_offset Stream position where the body started.
+         * @return            `true` = the stream is positioned at the next request. `false` = the end of the body cannot be determined.
+         */
+        bool skip_request_body(server& http, tcp_client_socket_streambuf& sb, const body_framing& framing, std::size_t body_offset);
+
+        /**
+         * @brief                Parses a `Range` header value.
+         * @details              Only a single range of bytes is supported. Anything else is ignored, i.e. the whole file is sent.
+         * @param range          `Range` header value.
+         * @param file_size      File size.
+         * @param begin          Set to the offset of the first byte in the range.
+         * @param end            Set to the offset after the last byte in the range.
+         * @param is_satisfiable Set to whether the range overlaps with the file.
+         * @return               `true` = the range is supported. `false` = the header should be ignored.
+         */
+        static bool parse_range(const std::string& range, std::size_t file_size, std::size_t& begin, std::size_t& end, bool& is_satisfiable);
+
+        /**
+         * @brief           Fills in the status and the headers of a response for a static file or for a range of it.
+         * @param request   A reference to `http::request`.
+         * @param filepath  Local file path, which determines the Content-Type.
+         * @param file_size File size.
+         * @param response  Response to fill in.
+         * @param begin     Set to the offset of the body in the file.
+         * @param end       Set to the offset after the body in the file.
+         * @return          `true` = a body should follow. `false` = the range is not satisfiable.
+         */
+        bool make_file_response(const request& request, const char* filepath, std::size_t file_size, response& response, std::size_t& begin, std::size_t& end);
+
+        /**
+         * @brief          Sends a static file from the cache.
+         * @param http     A reference to `http::server`.
+         * @param request  A reference to `http::request`.
+         * @param filepath Local file path.
+         * @param entry    Cache entry of the file.
+         */
+        void send_cached_file(server& http, const request& request, const std::string& filepath, std::shared_ptr<const file_cache_entry>&& entry);
+
+        /**
+         * @brief                 Checks whether an `Accept-Encoding` header value accepts a content coding.
+         * @param accept_encoding `Accept-Encoding` header value.
+         * @param encoding        Content coding.
+         */
+        static bool is_encoding_accepted(const std::string& accept_encoding, const char* encoding);
+
+        /**
+         * @brief               Checks whether an `If-None-Match` header value matches an entity tag.
+         * @param if_none_match `If-None-Match` header value.
+         * @param etag          Entity tag (quoted).
+         */
+        static bool is_etag_matched(const std::string& if_none_match, const std::string& etag);
+
+        /**
+         * @brief         Sends a region of a file as the body of a response.
+         * @param http    A reference to `http::server` whose response headers have been sent.
+         * @param file_fd Descriptor of the file.
+         * @param begin   Offset of the region in the file.
+         * @param size    Size of the region.
+         */
+        void send_file_body(server& http, int file_fd, std::size_t begin, std::size_t size);
 
     protected:
         /**
@@ -399,6 +1086,16 @@ namespace abc { namespace net { namespace http {
          */
         endpoint_config _config;
 
+        /**
+         * @brief Cache of static files.
+         */
+        file_cache _file_cache;
+
+        /**
+         * @brief REST routes.
+         */
+        router _router;
+
         /**
          * @brief The `std::promise` that is returned by `start_async()`, which gets signaled when shutdown is requested.
          */
@@ -413,6 +1110,41 @@ namespace abc { namespace net { namespace http {
          * @brief Flag that gets set when `POST /shutdown` is received.
          */
         std::atomic_bool _is_shutdown_requested;
+
+        /**
+         * @brief Guards `_accept_queue`, `_idle_connections`, and `_is_stopping`.
+         */
+        std::mutex _queue_mutex;
+
+        /**
+         * @brief Signaled when a connection is queued, or when the workers should stop.
+         */
+        std::condition_variable _queue_not_empty;
+
+        /**
+         * @brief Signaled when a connection is taken off the queue.
+         */
+        std::condition_variable _queue_not_full;
+
+        /**
+         * @brief Accepted connections waiting for a worker.
+         */
+        std::deque<connection_entry> _accept_queue;
+
+        /**
+         * @brief Kept-alive connections waiting for their next request, by descriptor.
+         */
+        std::map<socket::fd_t, connection_entry> _idle_connections;
+
+        /**
+         * @brief The epoll instance of the event loop.
+         */
+        int _epoll_fd;
+
+        /**
+         * @brief Flag that tells the workers to exit.
+         */
+        bool _is_stopping;
     };
 
 
@@ -30,6 +30,7 @@ SOFTWARE.
 #include <ostream>
 #include <string>
 #include <map>
+#include <vector>
 
 #include "../../root/util.h"
 #include "../../stream/i/stream.i.h"
@@ -93,13 +94,15 @@ namespace abc { namespace net { namespace http {
 
 
     /**
-     * @brief Request (minus the body). 
+     * @brief   Request (minus the body). 
+     * @details `target` is the request target as received, i.e. not URL-decoded. It is set by `request_reader`, and is ignored by `request_writer`.
      */
     struct request
         : public common {
 
         std::string    method;
         http::resource resource;
+        std::string    target;
     };
 
 
@@ -117,6 +120,92 @@ namespace abc { namespace net { namespace http {
     // --------------------------------------------------------------
 
 
+    /**
+     * @brief Non-owning reference to a sequence of chars in a buffer. 
+     */
+    struct span {
+        span() noexcept = default;
+        span(const char* data, std::size_t size) noexcept;
+
+        const char* data = nullptr;
+        std::size_t size = 0;
+
+        /**
+         * @brief Returns an owning copy of the chars.
+         */
+        std::string to_string() const;
+
+        /**
+         * @brief       Compares the chars to a 0-terminated string case-insensitively.
+         * @param chars 0-terminated string.
+         */
+        bool equals_i(const char* chars) const noexcept;
+    };
+
+
+    /**
+     * @brief Header name and value, referenced in place. 
+     */
+    struct header_span {
+        span name;
+        span value;
+    };
+
+
+    /**
+     * @brief Maximum number of headers in a `request_head`. 
+     */
+    constexpr std::size_t max_request_head_headers = 64;
+
+
+    /**
+     * @brief   Request line and headers, referenced in place.
+     * @details The spans point into the buffer that was parsed, and are only valid as long as that buffer is.
+     */
+    struct request_head {
+        span        method;
+        span        target;
+        span        protocol;
+        header_span headers[max_request_head_headers];
+        std::size_t header_count = 0;
+
+        /**
+         * @brief Headers beyond `max_request_head_headers`. Only a head made by `util::make_request_head()` may have any.
+         */
+        std::vector<header_span> more_headers;
+
+        /**
+         * @brief Number of bytes through the empty line that ends the headers.
+         */
+        std::size_t size = 0;
+
+        /**
+         * @brief      Finds the value of the first header with the given name (case-insensitive).
+         * @param name Header name.
+         * @return     Pointer to the value, or `nullptr` if there is no such header.
+         */
+        const span* find_header(const char* name) const noexcept;
+
+        /**
+         * @brief Returns the path part of the target, i.e. up to the first '?' or '#'. It is not URL-decoded.
+         */
+        span path() const noexcept;
+    };
+
+
+    /**
+     * @brief Result of parsing a request head in place. 
+     */
+    enum class head_status : std::uint8_t {
+        complete    = 0,
+        incomplete  = 1,
+        unsupported = 2,
+    };
+
+
+    // --------------------------------------------------------------
+
+
     /**
      * @brief Internal. http semantic state. 
      */
@@ -209,11 +298,30 @@ namespace abc { namespace net { namespace http {
         /**
          * @brief         Reads a chunk of a body from the http stream.
          * @details       The whole request/response must have been read before this method is called.
+         *                If the headers specify `Transfer-Encoding: chunked`, the body is decoded, and a single call never returns bytes from more than one chunk.
          * @param max_len Maximum length of the chunk.
          * @return        The chunk. Empty when there is no more to read.
          */
         std::string get_body(std::size_t max_len);
 
+        /**
+         * @brief Returns `true` after the last chunk of a chunked body has been read.
+         */
+        bool is_body_complete() const;
+
+    protected:
+        /**
+         * @brief         Sets up the reading of the body according to the headers of the message.
+         * @param headers The headers.
+         */
+        void reset_body(const headers& headers);
+
+        /**
+         * @brief            Sets up the reading of the body.
+         * @param is_chunked Whether the body is chunked.
+         */
+        void reset_body(bool is_chunked) noexcept;
+
     public:
         /**
          * @brief   Reads headers from the http stream.
@@ -295,6 +403,16 @@ namespace abc { namespace net { namespace http {
          */
         std::string get_chars(ascii::predicate_t&& predicate, std::size_t estimated_len, std::size_t max_len = size::strlen);
 
+        /**
+         * @brief               Reads a sequence of chars that belong to any of the given classes.
+         * @details             Consumes whole runs of buffered chars at a time.
+         * @param cls           Classes of chars.
+         * @param estimated_len Estimated capacity to reserve in the output string to prevent unnecessary reallocations.
+         * @param max_len       Maximum length of the chunk.
+         * @return              The sequence.
+         */
+        std::string get_chars(ascii::char_class_t cls, std::size_t estimated_len, std::size_t max_len = size::strlen);
+
         /**
          * @brief  Gets the next char from the stream and moves forward.
          * @return The next char.
@@ -325,6 +443,14 @@ namespace abc { namespace net { namespace http {
          */
         std::size_t skip_chars(ascii::predicate_t&& predicate);
 
+        /**
+         * @brief     Skips a sequence of chars that belong to any of the given classes.
+         * @details   Consumes whole runs of buffered chars at a time.
+         * @param cls Classes of chars.
+         * @return    The count of chars read.
+         */
+        std::size_t skip_chars(ascii::char_class_t cls);
+
         /**
          * @brief        Set the gcount and the next expected item for this input stream.
          * @param gcount gcount.
@@ -332,6 +458,34 @@ namespace abc { namespace net { namespace http {
          */
         void set_gstate(std::size_t gcount, http::item next);
 
+        /**
+         * @brief         Reads from the current chunk of a chunked body. Reads the next chunk size if needed.
+         * @param max_len Maximum length to read.
+         * @return        The bytes read. Empty after the last chunk.
+         */
+        std::string get_chunked_body(std::size_t max_len);
+
+        /**
+         * @brief  Reads a chunk size line, and skips any chunk extensions.
+         * @return The chunk size.
+         */
+        std::size_t get_chunk_size();
+
+        /**
+         * @brief Skips the trailer fields after the last chunk.
+         */
+        void skip_trailers();
+
+    private:
+        /**
+         * @brief Whether the body is chunked.
+         */
+        bool _is_chunked = false;
+
+        /**
+         * @brief Bytes left to read from the current chunk.
+         */
+        std::size_t _chunk_remaining = 0;
     };
 
 
@@ -373,11 +527,18 @@ namespace abc { namespace net { namespace http {
         /**
          * @brief          Writes a body to the http stream.
          * @details        The whole request/response must have been written before this method is called.
+         *                 If the headers specify `Transfer-Encoding: chunked`, each call writes a chunk.
          * @param body     Body.
          * @param body_len Body length. Optional.
          */
         void put_body(const char* body, std::size_t body_len = size::strlen);
 
+        /**
+         * @brief   Ends the body.
+         * @details If the body is chunked, writes the last chunk. Otherwise, only updates the state.
+         */
+        void end_body();
+
     public:
         /**
          * @brief         Writes headers and headers end to the http stream.
@@ -504,6 +665,12 @@ namespace abc { namespace net { namespace http {
          * @param next The next expected item.
          */
         void set_pstate(http::item next);
+
+    private:
+        /**
+         * @brief Whether the body is chunked.
+         */
+        bool _is_chunked = false;
     };
 
 
@@ -566,6 +733,13 @@ namespace abc { namespace net { namespace http {
          */
         resource get_resource();
 
+        /**
+         * @brief              Reads an http resource from the http stream.
+         * @param raw_resource Set to the resource as received, i.e. not URL-decoded.
+         * @return             The resource.
+         */
+        resource get_resource(std::string& raw_resource);
+
         /**
          * @brief   Reads an http protocol from the http stream.
          * @return  The protocol.
@@ -626,6 +800,21 @@ namespace abc { namespace net { namespace http {
          */
         request get_request();
 
+        /**
+         * @brief      Makes a request from a head that has been parsed in place by `util::parse_request_head()`, and positions this reader at the body.
+         * @details    The head's bytes must be consumed from the streambuf separately.
+         * @param head A reference to the parsed `request_head`.
+         * @return     The request.
+         */
+        request get_request(const request_head& head);
+
+        /**
+         * @brief      Positions this reader at the body of a request whose head has been parsed in place by `util::parse_request_head()`, without making a `request`.
+         * @details    The head's bytes must be consumed from the streambuf separately.
+         * @param head A reference to the parsed `request_head`.
+         */
+        void start_body(const request_head& head);
+
         /**
          * @brief         Reads a chunk of a body from the http stream.
          * @param max_len Maximum length of the chunk.
@@ -633,6 +822,11 @@ namespace abc { namespace net { namespace http {
          */
         std::string get_body(std::size_t max_len);
 
+        /**
+         * @brief Returns `true` after the last chunk of a chunked body has been read.
+         */
+        bool is_body_complete() const;
+
     public:
         /**
          * @brief Returns the underlying streambuf.
@@ -772,6 +966,11 @@ namespace abc { namespace net { namespace http {
          */
         void put_body(const char* body, std::size_t body_len = size::strlen);
 
+        /**
+         * @brief Ends the body. Required when the body is chunked.
+         */
+        void end_body();
+
     public:
         /**
          * @brief Returns the underlying streambuf.
@@ -899,6 +1098,11 @@ namespace abc { namespace net { namespace http {
          */
         std::string get_body(std::size_t max_len);
 
+        /**
+         * @brief Returns `true` after the last chunk of a chunked body has been read.
+         */
+        bool is_body_complete() const;
+
     public:
         /**
          * @brief Returns the underlying streambuf.
@@ -1030,6 +1234,11 @@ namespace abc { namespace net { namespace http {
          */
         void put_body(const char* body, std::size_t body_len = size::strlen);
 
+        /**
+         * @brief Ends the body. Required when the body is chunked.
+         */
+        void end_body();
+
     public:
         /**
          * @brief Returns the underlying streambuf.
@@ -1115,6 +1324,181 @@ namespace abc { namespace net { namespace http {
          * @brief URL-decodes the given character sequence.
          */
         static std::string url_decode(const char* chars, std::size_t chars_len = size::strlen);
+
+        /**
+         * @brief Checks whether the headers specify a chunked body, i.e. whether the last `Transfer-Encoding` coding is `chunked`.
+         */
+        static bool is_chunked(const headers& headers);
+
+        /**
+         * @brief Checks whether a parsed request head specifies a chunked body.
+         */
+        static bool is_chunked(const request_head& head) noexcept;
+
+        /**
+         * @brief                   Checks whether a `Transfer-Encoding` header value ends with the `chunked` coding.
+         * @param transfer_encoding `Transfer-Encoding` header value.
+         */
+        static bool is_chunked(const span& transfer_encoding) noexcept;
+
+        /**
+         * @brief           Checks whether a comma-separated header value contains an item that satisfies a predicate.
+         * @tparam Predicate Callable as `bool(const char* item, std::size_t item_len)`. Items are trimmed.
+         * @param list      Header value.
+         * @param predicate Predicate.
+         */
+        template <typename Predicate>
+        static bool any_list_item(const std::string& list, Predicate&& predicate);
+
+        /**
+         * @brief           Checks whether a comma-separated header value, referenced in place, contains an item that satisfies a predicate.
+         * @tparam Predicate Callable as `bool(const char* item, std::size_t item_len)`. Items are trimmed.
+         * @param list      Header value.
+         * @param predicate Predicate.
+         */
+        template <typename Predicate>
+        static bool any_list_item(const span& list, Predicate&& predicate);
+
+        /**
+         * @brief        Parses a request line and headers in place, without allocating.
+         * @details      Lines are found with `std::memchr()`, which is vectorized by the C library.
+         *               Only the common form is supported - single spaces in the request line, CR LF line ends, and no obsolete line folding.
+         *               Anything else, including malformed input, is reported as `head_status::unsupported`, and should be read with `request_reader::get_request()`.
+         * @param buffer Buffer that starts with a request.
+         * @param size   Number of bytes in the buffer.
+         * @param head   Set to spans into `buffer`.
+         * @return       `head_status::complete`, or `head_status::incomplete` if the buffer ends before the empty line that ends the headers.
+         */
+        static head_status parse_request_head(const char* buffer, std::size_t size, request_head& head) noexcept;
+
+        /**
+         * @brief         Makes a head over a request that has been read with `request_reader::get_request()`.
+         * @details       Used when a head cannot be parsed in place, but its handler expects a `request_head`.
+         * @param request A reference to the request. It must outlive `head`.
+         * @param head    Set to spans into `request`. `size` is set to 0, because nothing is left to be skipped.
+         */
+        static void make_request_head(const request& request, request_head& head);
+    };
+
+
+    // --------------------------------------------------------------
+
+
+    /**
+     * @brief          `std::streambuf` that writes a body through an http writer.
+     * @details        Allows a body to be streamed, e.g. from `json::writer`, with bounded memory.
+     *                 If the body is chunked, each full buffer is written as a chunk.
+     *                 `end_body()` must be called after the last byte has been put.
+     * @tparam Writer  `request_writer`, `response_writer`, or a class derived from them.
+     */
+    template <typename Writer>
+    class body_ostreambuf
+        : public std::streambuf {
+
+        using base = std::streambuf;
+
+    public:
+        /**
+         * @brief             Constructor.
+         * @param writer      Writer whose headers have been written.
+         * @param buffer_size Size of the buffer. Must be positive.
+         */
+        body_ostreambuf(Writer* writer, std::size_t buffer_size = size::k4);
+
+        /**
+         * @brief Deleted.
+         */
+        body_ostreambuf(const body_ostreambuf& other) = delete;
+
+        /**
+         * @brief Destructor. Writes the bytes left in the buffer. Does not end the body.
+         */
+        virtual ~body_ostreambuf() noexcept;
+
+    public:
+        /**
+         * @brief Writes the bytes left in the buffer, and ends the body.
+         */
+        void end_body();
+
+    protected:
+        /**
+         * @brief    Handler that writes the buffer.
+         * @param ch Byte to be put after the buffer has been written.
+         * @return   `ch`
+         */
+        virtual int_type overflow(int_type ch) override;
+
+        /**
+         * @brief  Writes the buffer.
+         * @return `0` = success. `-1` = error.
+         */
+        virtual int sync() override;
+
+    private:
+        /**
+         * @brief The writer passed in to the constructor.
+         */
+        Writer* _writer;
+
+        /**
+         * @brief Buffer. Backs the put area.
+         */
+        std::vector<char> _put_buffer;
+    };
+
+
+    // --------------------------------------------------------------
+
+
+    /**
+     * @brief          `std::streambuf` that reads a body through an http reader.
+     * @details        Allows a body to be streamed, e.g. into `json::reader`, with bounded memory.
+     *                 A chunked body is decoded, and reading stops at its end.
+     *                 Any other body is read through the end of the stream.
+     * @tparam Reader  `request_reader`, `response_reader`, or a class derived from them.
+     */
+    template <typename Reader>
+    class body_istreambuf
+        : public std::streambuf {
+
+        using base = std::streambuf;
+
+    public:
+        /**
+         * @brief             Constructor.
+         * @param reader      Reader whose headers have been read.
+         * @param buffer_size Size of the buffer. Must be positive.
+         */
+        body_istreambuf(Reader* reader, std::size_t buffer_size = size::k4);
+
+        /**
+         * @brief Deleted.
+         */
+        body_istreambuf(const body_istreambuf& other) = delete;
+
+    protected:
+        /**
+         * @brief  Handler that reads the next block of the body into the buffer.
+         * @return The first byte read.
+         */
+        virtual int_type underflow() override;
+
+    private:
+        /**
+         * @brief The reader passed in to the constructor.
+         */
+        Reader* _reader;
+
+        /**
+         * @brief Maximum number of bytes read at once.
+         */
+        std::size_t _buffer_size;
+
+        /**
+         * @brief Buffer. Backs the get area.
+         */
+        std::string _get_buffer;
     };
 
 } } }
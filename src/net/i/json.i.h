@@ -514,6 +514,13 @@ namespace abc { namespace net { namespace json {
          */
         literal::string get_chars(ascii::predicate_t&& predicate);
 
+        /**
+         * @brief     Reads a sequence of chars from the stream that belong to any of the given classes.
+         * @details   Consumes whole runs of buffered chars at a time.
+         * @param cls Classes of chars.
+         */
+        literal::string get_chars(ascii::char_class_t cls);
+
         /**
          * @brief  Skips a sequence of spaces from the stream.
          * @return Number of chars skipped.
@@ -527,6 +534,14 @@ namespace abc { namespace net { namespace json {
          */
         std::size_t skip_chars(ascii::predicate_t&& predicate);
 
+        /**
+         * @brief     Skips a sequence of chars from the stream that belong to any of the given classes.
+         * @details   Consumes whole runs of buffered chars at a time.
+         * @param cls Classes of chars.
+         * @return    Number of chars skipped.
+         */
+        std::size_t skip_chars(ascii::char_class_t cls);
+
         /**
          * @brief Reads a char from the stream.
          */
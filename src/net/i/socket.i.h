@@ -28,12 +28,14 @@ SOFTWARE.
 #include <memory>
 #include <cstdint>
 #include <streambuf>
+#include <vector>
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <netdb.h>
 #include <unistd.h>
 
+#include "../../root/size.h"
 #include "../../diag/i/diag_ready.i.h"
 
 
@@ -88,6 +90,17 @@ namespace abc { namespace net {
         };
 
         using backlog_size_t = int;
+
+
+        /**
+         * @brief Default size of the receive buffer and of the send buffer of a `tcp_client_socket_streambuf`.
+         */
+        constexpr std::size_t stream_buffer_size = size::k16;
+
+        /**
+         * @brief Size of the buffer used to send files over sockets that cannot use `sendfile()`.
+         */
+        constexpr std::size_t file_buffer_size = size::k64;
     }
 
 
@@ -161,6 +174,12 @@ namespace abc { namespace net {
          */
         void bind(const char* host, const char* port);
 
+        /**
+         * @brief             Switches the socket between blocking and non-blocking mode.
+         * @param is_blocking `true` = blocking. `false` = non-blocking.
+         */
+        void set_blocking(bool is_blocking);
+
     protected:
         /**
          * @brief Opens the socket.
@@ -456,6 +475,22 @@ namespace abc { namespace net {
          * @return        The number of bytes received. `0` = error.
          */
         virtual std::size_t receive(void* buffer, std::size_t size);
+
+        /**
+         * @brief   Returns the number of bytes that can be received without reading from the descriptor.
+         * @details Such bytes do not make the descriptor readable, so they must be checked before waiting on it.
+         */
+        virtual std::size_t pending_receive_size() const;
+
+        /**
+         * @brief         Sends a region of a file into the socket.
+         * @details       The bytes are copied from the file to the socket by the kernel, i.e. `sendfile()`.
+         * @param file_fd Descriptor of a file open for reading.
+         * @param offset  Offset of the region in the file.
+         * @param size    Size of the region.
+         * @return        The number of bytes sent. Less than `size` = error.
+         */
+        virtual std::size_t send_file(int file_fd, std::uint64_t offset, std::size_t size);
     };
 
 
@@ -516,6 +551,23 @@ namespace abc { namespace net {
          */
         virtual std::unique_ptr<tcp_client_socket> accept() const;
 
+        /**
+         * @brief    Creates a `tcp_client_socket` instance for a connection obtained from `try_accept_fd()`.
+         * @details  Completes any handshake that the protocol requires. Thus, it may block.
+         * @param fd The fd of the new connection. The returned instance takes ownership of it.
+         * @return   New `tcp_client_socket` instance for the connection.
+         */
+        virtual std::unique_ptr<tcp_client_socket> accept(socket::fd_t fd) const;
+
+        /**
+         * @brief              Accepts a pending connection without any handshake.
+         * @details            Does not block if the socket is non-blocking. See `set_blocking()`.
+         * @param is_exhausted Set to `true` if the connection could not be accepted because the process or the system ran out of descriptors or buffers.
+         *                     The connection stays pending, so the caller should back off before trying again.
+         * @return             The fd of the new connection, or `socket::fd::invalid` if there is no pending connection or `is_exhausted` is set.
+         */
+        socket::fd_t try_accept_fd(bool& is_exhausted) const;
+
     protected:
         /**
          * @brief  Blocks until a client tries to connect.
@@ -529,7 +581,9 @@ namespace abc { namespace net {
 
 
     /**
-     * @brief `std::streambuf` specialization that is backed by a socket.
+     * @brief   `std::streambuf` specialization that is backed by a socket.
+     * @details Bytes are received and sent in blocks through a receive buffer and a send buffer.
+     *          The send buffer is sent when it gets full, when the stream is flushed, and before blocking on a receive.
      */
     class tcp_client_socket_streambuf
         : public std::streambuf
@@ -546,6 +600,15 @@ namespace abc { namespace net {
          */
         tcp_client_socket_streambuf(tcp_client_socket* socket, diag::log_ostream* log = nullptr);
 
+        /**
+         * @brief                     Constructor.
+         * @param socket              `tcp_client_socket` pointer.
+         * @param receive_buffer_size Size of the receive buffer. Must be positive.
+         * @param send_buffer_size    Size of the send buffer. Must be positive.
+         * @param log                 `diag::log_ostream` pointer. May be `nullptr`.
+         */
+        tcp_client_socket_streambuf(tcp_client_socket* socket, std::size_t receive_buffer_size, std::size_t send_buffer_size, diag::log_ostream* log = nullptr);
+
         /**
          * @brief Move constructor.
          */
@@ -556,32 +619,98 @@ namespace abc { namespace net {
          */
         tcp_client_socket_streambuf(const tcp_client_socket_streambuf& other) = delete;
 
+        /**
+         * @brief Destructor. Sends the bytes left in the send buffer.
+         */
+        virtual ~tcp_client_socket_streambuf() noexcept;
+
     public:
         /**
          * @brief  Flushes.
          */
         void flush();
 
+        /**
+         * @brief Returns the total number of bytes that have been got from this streambuf.
+         */
+        std::size_t total_get_count() const;
+
+        /**
+         * @brief         Sends the bytes that have been put, and then sends a region of a file directly into the socket.
+         * @param file_fd Descriptor of a file open for reading.
+         * @param offset  Offset of the region in the file.
+         * @param size    Size of the region.
+         * @return        The number of bytes of the region sent. Less than `size` = error.
+         */
+        std::size_t send_file(int file_fd, std::uint64_t offset, std::size_t size);
+
+        /**
+         * @brief      Returns the bytes that have been received but not got yet, without receiving more. Allows them to be parsed in place.
+         * @param size Set to the number of bytes.
+         * @return     Pointer to the first byte. Valid until the next get or receive.
+         */
+        const char* peek_received(std::size_t& size) const;
+
+        /**
+         * @brief   Receives more bytes after the ones that have not been got yet.
+         * @details The bytes that have not been got are moved to the front of the receive buffer first.
+         * @return  The number of bytes received. `0` = the receive buffer is full, or the connection has been closed.
+         */
+        std::size_t receive_more();
+
+        /**
+         * @brief       Skips bytes that have been received but not got yet.
+         * @param count Number of bytes. Must not exceed the size returned by `peek_received()`.
+         */
+        void skip_received(std::size_t count);
+
     protected:
         /**
-         * @brief  Handler that reads a byte from the socket.
-         * @return The byte received.
+         * @brief  Handler that receives a block of bytes from the socket into the receive buffer.
+         * @return The first byte received.
          */
         virtual int_type underflow() override;
 
         /**
-         * @brief    Handler that sends a byte to the socket.
-         * @param ch Byte to be sent.
+         * @brief    Handler that sends the send buffer to the socket.
+         * @param ch Byte to be put after the send buffer has been sent.
          * @return   `ch`
          */
         virtual int_type overflow(int_type ch) override;
 
         /**
-         * @brief  Flushes.
-         * @return `0`
+         * @brief  Sends the send buffer to the socket.
+         * @return `0` = success. `-1` = error.
          */
         virtual int sync() override;
 
+        /**
+         * @brief        Gets multiple bytes at once.
+         * @details      Blocks larger than the receive buffer are received directly into `s`.
+         * @param s      Destination buffer.
+         * @param count  Number of bytes to get.
+         * @return       The number of bytes copied to `s`.
+         */
+        virtual std::streamsize xsgetn(char_type* s, std::streamsize count) override;
+
+        /**
+         * @brief        Puts multiple bytes at once.
+         * @details      Blocks larger than the send buffer are sent directly from `s`.
+         * @param s      Source buffer.
+         * @param count  Number of bytes to put.
+         * @return       The number of bytes consumed from `s`.
+         */
+        virtual std::streamsize xsputn(const char_type* s, std::streamsize count) override;
+
+    private:
+        /**
+         * @brief        Sends all the bytes from the given buffer. Retries after partial sends.
+         * @param buffer Data buffer.
+         * @param size   Buffer size.
+         * @return       `true` = success. `false` = error.
+         */
+        bool send_all(const char* buffer, std::size_t size);
+
     private:
         /**
          * @brief The `tcp_client_socket` pointer passed in to the constructor.
@@ -589,14 +718,19 @@ namespace abc { namespace net {
         tcp_client_socket* _socket;
 
         /**
-         * @brief Cached char received.
+         * @brief Receive buffer. Backs the get area.
+         */
+        std::vector<char> _get_buffer;
+
+        /**
+         * @brief Send buffer. Backs the put area.
          */
-        char _get_ch;
+        std::vector<char> _put_buffer;
 
         /**
-         * @brief Cached char to be sent.
+         * @brief Total number of bytes received from the socket.
          */
-        char _put_ch;
+        std::size_t _total_received_count;
     };
 
 } }
@@ -323,22 +323,22 @@ namespace abc { namespace net { namespace json {
         , _expect_property(false) {
 
         constexpr const char* suborigin = "state()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1093d, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1093d, "Begin:");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1093e, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1093e, "End:");
     }
 
 
     inline void state::reset() noexcept {
         constexpr const char* suborigin = "reset()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1093f, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1093f, "Begin:");
 
         _expect_property = false;
         while (!_nest_stack.empty()) {
             _nest_stack.pop();
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10940, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10940, "End:");
     }
 
 
@@ -359,7 +359,7 @@ namespace abc { namespace net { namespace json {
 
     inline void state::set_expect_property(bool expect) {
         constexpr const char* suborigin = "set_expect_property()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10941, "Begin: expect=%u", expect);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10941, "Begin: expect=%u", expect);
 
         diag_base::expect(suborigin, !expect || (!_nest_stack.empty() && _nest_stack.top() == nest_type::object), 0x10942, "expect");
 
@@ -367,29 +367,29 @@ namespace abc { namespace net { namespace json {
 
         diag_base::ensure(suborigin, !_expect_property || (!_nest_stack.empty() && _nest_stack.top() == nest_type::object), 0x10943, "_expect_property");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10944, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10944, "End:");
     }
 
 
     inline void state::nest(nest_type type) {
         constexpr const char* suborigin = "nest()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10945, "Begin: type=%u", type);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10945, "Begin: type=%u", type);
 
         _nest_stack.push(type);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10946, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10946, "End:");
     }
 
 
     inline void state::unnest(nest_type type) {
         constexpr const char* suborigin = "unnest()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10947, "Begin: type=%u", type);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10947, "Begin: type=%u", type);
 
         diag_base::expect(suborigin, !_nest_stack.empty() && _nest_stack.top() == type, 0x10948, "type");
 
         _nest_stack.pop();
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10949, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10949, "End:");
     }
 
 
@@ -401,9 +401,9 @@ namespace abc { namespace net { namespace json {
         , state_base(origin, log) {
 
         constexpr const char* suborigin = "istream()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1094a, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1094a, "Begin:");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1094b, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1094b, "End:");
     }
 
 
@@ -420,7 +420,7 @@ namespace abc { namespace net { namespace json {
 
     inline void istream::skip_value() {
         constexpr const char* suborigin = "skip_value()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1094c, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1094c, "Begin:");
 
         std::size_t nest_stack_size = state_base::nest_stack().size();
         do {
@@ -428,13 +428,13 @@ namespace abc { namespace net { namespace json {
         }
         while (state_base::nest_stack().size() > nest_stack_size);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1094d, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1094d, "End:");
     }
 
 
     inline token istream::get_token() {
         constexpr const char* suborigin = "get_token()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1094e, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1094e, "Begin:");
 
         token tok;
         bool trail_comma = true;
@@ -540,7 +540,7 @@ namespace abc { namespace net { namespace json {
 
         base::set_gcount(tok.string.length());
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10956, "End: tok.type=%u, tok.string='%s'", tok.type, tok.string.c_str());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10956, "End: tok.type=%u, tok.string='%s'", tok.type, tok.string.c_str());
 
         return tok;
     }
@@ -564,7 +564,7 @@ namespace abc { namespace net { namespace json {
 
     inline literal::string istream::get_string() {
         constexpr const char* suborigin = "get_string()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10957, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10957, "Begin:");
 
         literal::string str;
 
@@ -573,7 +573,7 @@ namespace abc { namespace net { namespace json {
             base::get();
 
             for (;;) {
-                str += get_chars(ascii::json::is_string_content);
+                str += get_chars(ascii::char_class::json_string_content);
 
                 ch = peek_char();
                 if (ch == '"') {
@@ -586,7 +586,7 @@ namespace abc { namespace net { namespace json {
             }
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10958, "End: str='%s'", str.c_str());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10958, "End: str='%s'", str.c_str());
 
         return str;
     }
@@ -594,7 +594,7 @@ namespace abc { namespace net { namespace json {
 
     inline literal::string istream::get_number() {
         constexpr const char* suborigin = "get_number()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10959, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10959, "Begin:");
 
         literal::string str;
 
@@ -624,7 +624,7 @@ namespace abc { namespace net { namespace json {
             str += get_digits();
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1095a, "End: str='%s'", str.c_str());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1095a, "End: str='%s'", str.c_str());
 
         return str;
     }
@@ -632,7 +632,7 @@ namespace abc { namespace net { namespace json {
 
     inline literal::string istream::get_literal(const char* literal) {
         constexpr const char* suborigin = "get_literal()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1095b, "Begin: literal='%s'", literal);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1095b, "Begin: literal='%s'", literal);
 
         literal::string str;
 
@@ -643,7 +643,7 @@ namespace abc { namespace net { namespace json {
             str += ch;
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1095d, "End: str='%s'", str.c_str());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1095d, "End: str='%s'", str.c_str());
 
         return str;
     }
@@ -651,7 +651,7 @@ namespace abc { namespace net { namespace json {
 
     inline char istream::get_escaped_char() {
         constexpr const char* suborigin = "get_escaped_char()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1095e, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1095e, "Begin:");
 
         char ch = peek_char();
         expect_char(ch, '\\', true, suborigin, 0x1095f);
@@ -698,7 +698,7 @@ namespace abc { namespace net { namespace json {
             }
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10962, "End: ch='%c' (0x%2.2x)", ch, ch);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10962, "End: ch='%c' (0x%2.2x)", ch, ch);
 
         return ch;
     }
@@ -716,12 +716,12 @@ namespace abc { namespace net { namespace json {
 
 
     inline literal::string istream::get_hex() {
-        return get_chars(ascii::is_hex);
+        return get_chars(ascii::char_class::hex);
     }
 
 
     inline literal::string istream::get_digits() {
-        return get_chars(ascii::is_digit);
+        return get_chars(ascii::char_class::digit);
     }
 
 
@@ -736,8 +736,29 @@ namespace abc { namespace net { namespace json {
     }
 
 
+    inline literal::string istream::get_chars(ascii::char_class_t cls) {
+        literal::string str;
+
+        while (base::is_good()) {
+            if (base::get_buffered(str, cls, size::strlen) > 0) {
+                continue;
+            }
+
+            // The get area is empty, or the next char is not in the class.
+            // peek_char() refills the get area. A char at a time is also the fallback for unbuffered streambufs.
+            if (!ascii::is_class(peek_char(), cls) || !base::is_good()) {
+                break;
+            }
+
+            str += base::get();
+        }
+
+        return str;
+    }
+
+
     inline std::size_t istream::skip_spaces() {
-        return skip_chars(ascii::json::is_space);
+        return skip_chars(ascii::char_class::json_space);
     }
 
 
@@ -751,6 +772,28 @@ namespace abc { namespace net { namespace json {
 
         return gcount;
     }
+
+
+    inline std::size_t istream::skip_chars(ascii::char_class_t cls) {
+        std::size_t gcount = 0;
+
+        while (base::is_good()) {
+            std::size_t skipped = base::skip_buffered(cls, size::strlen);
+            if (skipped > 0) {
+                gcount += skipped;
+                continue;
+            }
+
+            if (!ascii::is_class(peek_char(), cls) || !base::is_good()) {
+                break;
+            }
+
+            base::get();
+            gcount++;
+        }
+
+        return gcount;
+    }
     
     
     inline char istream::get_char() {
@@ -783,9 +826,9 @@ namespace abc { namespace net { namespace json {
         : base(origin, sb, log) {
 
         constexpr const char* suborigin = "reader()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10963, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10963, "Begin:");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10964, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10964, "End:");
     }
 
 
@@ -801,13 +844,13 @@ namespace abc { namespace net { namespace json {
 
     inline value reader::get_value() {
         constexpr const char* suborigin = "get_value()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10965, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10965, "Begin:");
 
         token token = base::get_token();
 
         value value = get_value_from_token(std::move(token));
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10966, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10966, "End:");
 
         return value;
     }
@@ -815,7 +858,7 @@ namespace abc { namespace net { namespace json {
 
     inline value reader::get_value_from_token(token&& token) {
         constexpr const char* suborigin = "get_value_from_token()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10967, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10967, "Begin:");
 
         switch (token.type) {
             case token_type::null:
@@ -841,7 +884,7 @@ namespace abc { namespace net { namespace json {
                 diag_base::template throw_exception<diag::input_error>(suborigin, 0x10968, "Unexpected token_type=%u", token.type);
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10969, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10969, "End:");
 
         return value(base::log());
     }
@@ -849,7 +892,7 @@ namespace abc { namespace net { namespace json {
 
     inline literal::array reader::get_array() {
         constexpr const char* suborigin = "get_array()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1096a, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1096a, "Begin:");
 
         literal::array array;
 
@@ -866,7 +909,7 @@ namespace abc { namespace net { namespace json {
             token = base::get_token();
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1096c, "End: size=%zu", array.size());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1096c, "End: size=%zu", array.size());
 
         return array;
     }
@@ -874,7 +917,7 @@ namespace abc { namespace net { namespace json {
 
     inline literal::object reader::get_object() {
         constexpr const char* suborigin = "get_object()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1096d, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1096d, "Begin:");
 
         literal::object object;
 
@@ -896,7 +939,7 @@ namespace abc { namespace net { namespace json {
             token = base::get_token();
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10970, "End: size=%zu", object.size());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10970, "End: size=%zu", object.size());
 
         return object;
     }
@@ -911,9 +954,9 @@ namespace abc { namespace net { namespace json {
         , _skip_comma(false) {
 
         constexpr const char* suborigin = "ostream()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10971, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10971, "Begin:");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10972, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10972, "End:");
     }
 
 
@@ -931,7 +974,7 @@ namespace abc { namespace net { namespace json {
 
     inline void ostream::put_token(const token& token) {
         constexpr const char* suborigin = "put_token()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10115, "Begin: token.type=0x%2.2x", token.type);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10115, "Begin: token.type=0x%2.2x", token.type);
 
         switch (token.type)
         {
@@ -977,23 +1020,23 @@ namespace abc { namespace net { namespace json {
             break;
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10117, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10117, "End:");
     }
 
 
     inline void ostream::put_null() {
         constexpr const char* suborigin = "put_null()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10973, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10973, "Begin:");
 
         std::size_t pcount = put_literal("null", 4);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10974, "End: pcount=%zu", pcount);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10974, "End: pcount=%zu", pcount);
     }
 
 
     inline void ostream::put_boolean(literal::boolean b) {
         constexpr const char* suborigin = "put_boolean()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10975, "Begin: b=%d", b);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10975, "Begin: b=%d", b);
 
         std::size_t pcount = 0;
         if (b) {
@@ -1003,26 +1046,26 @@ namespace abc { namespace net { namespace json {
             pcount = put_literal("false", 5);
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10976, "End: pcount=%zu", pcount);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10976, "End: pcount=%zu", pcount);
     }
 
 
     inline void ostream::put_number(literal::number n) {
         constexpr const char* suborigin = "put_number()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10977, "Begin: n=%.16lg", n);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10977, "Begin: n=%.16lg", n);
 
         char literal[19 + 6 + 1];
         std::size_t size = std::snprintf(literal, sizeof(literal), "%.16lg", n);
 
         std::size_t pcount = put_literal(literal, size);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10978, "End: pcount=%zu", pcount);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10978, "End: pcount=%zu", pcount);
     }
 
 
     inline void ostream::put_string(const literal::string& s) {
         constexpr const char* suborigin = "put_string()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10979, "Begin: s='%s'", s.c_str());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10979, "Begin: s='%s'", s.c_str());
 
         put_literal_precond();
 
@@ -1033,13 +1076,13 @@ namespace abc { namespace net { namespace json {
 
         put_literal_postcond();
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1097a, "End: pcount=%zu", pcount);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1097a, "End: pcount=%zu", pcount);
     }
 
 
     inline void ostream::put_property(const literal::string& name) {
         constexpr const char* suborigin = "put_property()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1097b, "Begin: name='%s'", name.c_str());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1097b, "Begin: name='%s'", name.c_str());
 
         if (state_base::nest_stack().empty() || state_base::nest_stack().top() != nest_type::object || !state_base::expect_property()) {
             base::set_bad();
@@ -1059,13 +1102,13 @@ namespace abc { namespace net { namespace json {
         _skip_comma = true;
         state_base::set_expect_property(false);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1097d, "End: pcount=%zu", pcount);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1097d, "End: pcount=%zu", pcount);
     }
 
 
     inline void ostream::put_begin_array() {
         constexpr const char* suborigin = "put_begin_array()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1097e, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1097e, "Begin:");
 
         put_literal_precond();
 
@@ -1074,13 +1117,13 @@ namespace abc { namespace net { namespace json {
         state_base::nest_stack().push(nest_type::array);
         _skip_comma = true;
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1097f, "End: pcount=%zu", pcount);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1097f, "End: pcount=%zu", pcount);
     }
 
 
     inline void ostream::put_end_array() {
         constexpr const char* suborigin = "put_end_array()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10980, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10980, "Begin:");
 
         if (state_base::nest_stack().empty() || state_base::nest_stack().top() != nest_type::array) {
             base::set_bad();
@@ -1093,13 +1136,13 @@ namespace abc { namespace net { namespace json {
         state_base::nest_stack().pop();
         put_literal_postcond();
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10982, "End: pcount=%zu", pcount);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10982, "End: pcount=%zu", pcount);
     }
 
 
     inline void ostream::put_begin_object() {
         constexpr const char* suborigin = "put_begin_object()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10983, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10983, "Begin:");
 
         put_literal_precond();
 
@@ -1109,13 +1152,13 @@ namespace abc { namespace net { namespace json {
         state_base::set_expect_property(true);
         _skip_comma = true;
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10984, "End: pcount=%zu", pcount);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10984, "End: pcount=%zu", pcount);
     }
 
 
     inline void ostream::put_end_object() {
         constexpr const char* suborigin = "put_end_object()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10985, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10985, "Begin:");
 
         if (state_base::nest_stack().empty() || state_base::nest_stack().top() != nest_type::object) {
             base::set_bad();
@@ -1128,7 +1171,7 @@ namespace abc { namespace net { namespace json {
         state_base::nest_stack().pop();
         put_literal_postcond();
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10987, "End: pcount=%zu", pcount);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10987, "End: pcount=%zu", pcount);
     }
 
 
@@ -1154,7 +1197,7 @@ namespace abc { namespace net { namespace json {
 
     inline std::size_t ostream::put_literal(const char* chars, std::size_t chars_len) {
         constexpr const char* suborigin = "put_literal()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10988, "Begin: chars='%s'", chars);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10988, "Begin: chars='%s'", chars);
 
         put_literal_precond();
 
@@ -1162,7 +1205,7 @@ namespace abc { namespace net { namespace json {
 
         put_literal_postcond();
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10989, "End: pcount=%zu", pcount);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10989, "End: pcount=%zu", pcount);
 
         return pcount;
     }
@@ -1170,7 +1213,7 @@ namespace abc { namespace net { namespace json {
 
     inline void ostream::put_literal_precond() {
         constexpr const char* suborigin = "put_literal_precond()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1098a, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1098a, "Begin:");
 
         if (!state_base::nest_stack().empty() && state_base::nest_stack().top() == nest_type::object && state_base::expect_property()) {
             base::set_bad();
@@ -1182,13 +1225,13 @@ namespace abc { namespace net { namespace json {
             put_chars(",", 1);
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1098c, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1098c, "End:");
     }
 
 
     inline void ostream::put_literal_postcond() {
         constexpr const char* suborigin = "put_literal_postcond()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1098d, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1098d, "Begin:");
 
         _skip_comma = false;
 
@@ -1196,13 +1239,13 @@ namespace abc { namespace net { namespace json {
             state_base::set_expect_property(true);
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1098e, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1098e, "End:");
     }
 
 
     inline std::size_t ostream::put_chars(const char* chars, std::size_t chars_len) {
         constexpr const char* suborigin = "put_chars()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10121, "Begin: chars='%s'", chars);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10121, "Begin: chars='%s'", chars);
 
         std::size_t pcount = 0;
 
@@ -1214,7 +1257,7 @@ namespace abc { namespace net { namespace json {
             base::put(chars[pcount++]);
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10122, "End: pcount=%zu", pcount);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10122, "End: pcount=%zu", pcount);
 
         return pcount;
     }
@@ -1237,9 +1280,9 @@ namespace abc { namespace net { namespace json {
         : base(origin, sb, log) {
 
         constexpr const char* suborigin = "writer()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1098f, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1098f, "Begin:");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10990, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10990, "End:");
     }
 
 
@@ -1255,7 +1298,7 @@ namespace abc { namespace net { namespace json {
 
     inline void writer::put_value(const value& value) {
         constexpr const char* suborigin = "put_value()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10991, "Begin: type=%u", value.type());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10991, "Begin: type=%u", value.type());
 
         switch (value.type()) {
             case value_type::null:
@@ -1288,13 +1331,13 @@ namespace abc { namespace net { namespace json {
 
         base::flush();
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10993, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10993, "End:");
     }
 
 
     inline void writer::put_array(const literal::array& array) {
         constexpr const char* suborigin = "put_array()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10994, "Begin: size=%zu", array.size());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10994, "Begin: size=%zu", array.size());
 
         base::put_begin_array();
 
@@ -1306,13 +1349,13 @@ namespace abc { namespace net { namespace json {
 
         base::flush();
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10995, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10995, "End:");
     }
 
 
     inline void writer::put_object(const literal::object& object) {
         constexpr const char* suborigin = "put_object()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10996, "Begin: size=%zu", object.size());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10996, "Begin: size=%zu", object.size());
 
         base::put_begin_object();
 
@@ -1325,7 +1368,7 @@ namespace abc { namespace net { namespace json {
 
         base::flush();
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10997, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10997, "End:");
     }
 
 
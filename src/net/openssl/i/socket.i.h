@@ -101,6 +101,21 @@ namespace abc { namespace net { namespace openssl {
          */
         virtual std::size_t receive(void* buffer, std::size_t size) override;
 
+        /**
+         * @brief Returns the number of decrypted bytes that OpenSSL has buffered.
+         */
+        virtual std::size_t pending_receive_size() const override;
+
+        /**
+         * @brief         Sends a region of a file into the socket.
+         * @details       The bytes must be encrypted, so they are read into a buffer of `socket::file_buffer_size` bytes, and sent from there.
+         * @param file_fd Descriptor of a file open for reading.
+         * @param offset  Offset of the region in the file.
+         * @param size    Size of the region.
+         * @return        The number of bytes sent. Less than `size` = error.
+         */
+        virtual std::size_t send_file(int file_fd, std::uint64_t offset, std::size_t size) override;
+
     protected:
         friend tcp_server_socket;
 
@@ -183,6 +198,13 @@ namespace abc { namespace net { namespace openssl {
          */
         virtual std::unique_ptr<net::tcp_client_socket> accept() const override;
 
+        /**
+         * @brief    Creates an `openssl::tcp_client_socket` instance for a connection obtained from `try_accept_fd()`, and completes the TLS handshake.
+         * @param fd The fd of the new connection. The returned instance takes ownership of it.
+         * @return   New `openssl::tcp_client_socket` instance for the connection.
+         */
+        virtual std::unique_ptr<net::tcp_client_socket> accept(socket::fd_t fd) const override;
+
     private:
         /**
          * @brief Callback passed to `SSL_CTX_set_default_passwd_cb()`.
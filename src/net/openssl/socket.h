@@ -25,8 +25,12 @@ SOFTWARE.
 
 #pragma once
 
+#include <algorithm>
+#include <cerrno>
 #include <cstring>
 #include <memory>
+#include <vector>
+#include <unistd.h>
 
 #include "../socket.h"
 #include "i/socket.i.h"
@@ -39,7 +43,7 @@ namespace abc { namespace net { namespace openssl {
         , _verify_server(verify_server) {
 
         constexpr const char* suborigin = "tcp_client_socket()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10763, "Begin: verify_server=%d", verify_server);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10763, "Begin: verify_server=%d", verify_server);
 
         const SSL_METHOD *method = TLS_client_method();
         diag_base::require(suborigin, method != nullptr, 0x10764, "::TLS_client_method()");
@@ -52,7 +56,7 @@ namespace abc { namespace net { namespace openssl {
         _ssl = SSL_new(_ctx);
         diag_base::require(suborigin, _ssl != nullptr, 0x10766, "::SSL_new()");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10767, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10767, "End:");
     }
 
 
@@ -63,13 +67,13 @@ namespace abc { namespace net { namespace openssl {
         , _ssl(other._ssl) {
 
         constexpr const char* suborigin = "tcp_client_socket()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10768, "Begin: _verify_server=%d, _ctx=%p, _ssl=%p", _verify_server, _ctx, _ssl);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10768, "Begin: _verify_server=%d, _ctx=%p, _ssl=%p", _verify_server, _ctx, _ssl);
 
         other._verify_server = true;
         other._ctx = nullptr;
         other._ssl = nullptr;
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10769, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10769, "End:");
     }
 
 
@@ -78,7 +82,7 @@ namespace abc { namespace net { namespace openssl {
         , _verify_server(verify_server) {
 
         constexpr const char* suborigin = "tcp_client_socket()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1076a, "Begin: _verify_server=%d, ctx=%p", _verify_server, ctx);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1076a, "Begin: _verify_server=%d, ctx=%p", _verify_server, ctx);
 
         diag_base::expect(suborigin, ctx != nullptr, 0x10998, "ctx != nullptr");
 
@@ -88,13 +92,13 @@ namespace abc { namespace net { namespace openssl {
         int stat = SSL_set_fd(_ssl, fd);
         diag_base::require(suborigin, stat > 0, 0x1076c, "::SSL_set_fd()");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1076d, "End: _ssl=%p", _ssl);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1076d, "End: _ssl=%p", _ssl);
     }
 
 
     inline tcp_client_socket::~tcp_client_socket() noexcept {
         constexpr const char* suborigin = "~tcp_client_socket()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1076e, "Begin: _ssl=%p, _ctx=%p", _ssl, _ctx);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1076e, "Begin: _ssl=%p, _ctx=%p", _ssl, _ctx);
 
         if (_ssl != nullptr) {
             SSL_shutdown(_ssl);
@@ -107,13 +111,13 @@ namespace abc { namespace net { namespace openssl {
             _ctx = nullptr;
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1076f, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1076f, "End:");
     }
 
 
     inline void tcp_client_socket::connect(const char* host, const char* port) {
         constexpr const char* suborigin = "connect()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10770, "Begin: host='%s', port='%s'", host, port);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10770, "Begin: host='%s', port='%s'", host, port);
 
         diag_base::expect(suborigin, host != nullptr, 0x10999, "host != nullptr");
         diag_base::expect(suborigin, port != nullptr, 0x1099a, "host != nullptr");
@@ -121,24 +125,24 @@ namespace abc { namespace net { namespace openssl {
         base::connect(host, port);
         connect_handshake();
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10771, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10771, "End:");
     }
 
 
     inline void tcp_client_socket::connect(const socket::address& address) {
         constexpr const char* suborigin = "connect()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10772, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10772, "Begin:");
 
         base::connect(address);
         connect_handshake();
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10773, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10773, "End:");
     }
 
 
     inline std::size_t tcp_client_socket::send(const void* buffer, std::size_t size) {
         constexpr const char* suborigin = "send()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10774, "Begin: size=%zu", size);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10774, "Begin: size=%zu", size);
 
         diag_base::expect(suborigin, base::is_open(), 0x10775, "is_open");
         diag_base::expect(suborigin, _ssl != nullptr, 0x10776, "_ssl != nullptr");
@@ -146,17 +150,17 @@ namespace abc { namespace net { namespace openssl {
         int sent_size = SSL_write(_ssl, buffer, (int)size);
 
         if (sent_size < 0) {
-            diag_base::put_any(suborigin, diag::severity::important, 0x10777, "sent_size=%l", (long)sent_size);
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::important, 0x10777, "sent_size=%l", (long)sent_size);
 
             sent_size = 0;
         }
         else if ((std::size_t)sent_size < size) {
-            diag_base::put_any(suborigin, diag::severity::important, 0x10778, "sent_size=%l", (long)sent_size);
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::important, 0x10778, "sent_size=%l", (long)sent_size);
         }
 
         diag_base::put_binary(suborigin, diag::severity::verbose, 0x10779, buffer, size);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1077a, "End: size=%zu, sent_size=%l", size, sent_size);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1077a, "End: size=%zu, sent_size=%l", size, sent_size);
 
         return sent_size;
     }
@@ -164,7 +168,7 @@ namespace abc { namespace net { namespace openssl {
 
     inline std::size_t tcp_client_socket::receive(void* buffer, std::size_t size) {
         constexpr const char* suborigin = "send()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1077b, "Begin: size=%zu", size);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1077b, "Begin: size=%zu", size);
 
         diag_base::expect(suborigin, base::is_open(), 0x1077c, "is_open");
         diag_base::expect(suborigin, _ssl != nullptr, 0x1077d, "_ssl != nullptr");
@@ -172,25 +176,70 @@ namespace abc { namespace net { namespace openssl {
         int received_size = SSL_read(_ssl, buffer, (int)size);
 
         if (received_size < 0) {
-            diag_base::put_any(suborigin, diag::severity::important, 0x1077e, "sent_size=%l", (long)received_size);
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::important, 0x1077e, "sent_size=%l", (long)received_size);
 
             received_size = 0;
         }
         else if ((std::size_t)received_size < size) {
-            diag_base::put_any(suborigin, diag::severity::important, 0x1077f, "sent_size=%l", (long)received_size);
+            // Receiving less than a full buffer is normal for a stream.
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x1077f, "received_size=%ld", (long)received_size);
         }
 
-        diag_base::put_binary(suborigin, diag::severity::verbose, 0x10780, buffer, size);
+        diag_base::put_binary(suborigin, diag::severity::verbose, 0x10780, buffer, received_size);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10781, "End: size=%zu, received_size=%l", size, received_size);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10781, "End: size=%zu, received_size=%l", size, received_size);
 
         return received_size;
     }
 
 
+    inline std::size_t tcp_client_socket::pending_receive_size() const {
+        if (_ssl == nullptr) {
+            return 0;
+        }
+
+        int pending_size = SSL_pending(_ssl);
+        return pending_size > 0 ? static_cast<std::size_t>(pending_size) : 0;
+    }
+
+
+    inline std::size_t tcp_client_socket::send_file(int file_fd, std::uint64_t offset, std::size_t size) {
+        constexpr const char* suborigin = "send_file()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e7f, "Begin: file_fd=%d, offset=%llu, size=%zu", file_fd, (unsigned long long)offset, size);
+
+        std::vector<char> buffer(std::min(size, socket::file_buffer_size));
+        std::size_t sent_size = 0;
+
+        while (sent_size < size) {
+            std::size_t read_size = std::min(size - sent_size, buffer.size());
+            ssize_t chunk_size = ::pread(file_fd, buffer.data(), read_size, static_cast<off_t>(offset + sent_size));
+
+            if (chunk_size < 0 && errno == EINTR) {
+                continue;
+            }
+
+            if (chunk_size <= 0) {
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::important, 0x10e80, "::pread() chunk_size=%ld, errno=%d", (long)chunk_size, errno);
+                break;
+            }
+
+            // SSL_write() sends all or nothing.
+            if (send(buffer.data(), static_cast<std::size_t>(chunk_size)) != static_cast<std::size_t>(chunk_size)) {
+                break;
+            }
+
+            sent_size += static_cast<std::size_t>(chunk_size);
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e81, "End: size=%zu, sent_size=%zu", size, sent_size);
+
+        return sent_size;
+    }
+
+
     inline void tcp_client_socket::connect_handshake() {
         constexpr const char* suborigin = "connect_handshake()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10782, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10782, "Begin:");
 
         diag_base::expect(suborigin, base::is_open(), 0x10783, "is_open");
         diag_base::expect(suborigin, _ssl != nullptr, 0x10784, "_ssl != nullptr");
@@ -198,18 +247,18 @@ namespace abc { namespace net { namespace openssl {
         int stat = SSL_set_fd(_ssl, base::fd());
         diag_base::require(suborigin, stat > 0, 0x10785, "::SSL_set_fd()");
 
-        diag_base::put_any(suborigin, diag::severity::important, 0x10786, "Before ::SSL_connect()");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::important, 0x10786, "Before ::SSL_connect()");
         int ret = SSL_connect(_ssl);
-        diag_base::put_any(suborigin, diag::severity::important, 0x10787, "After ::SSL_connect() ret=%d", ret);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::important, 0x10787, "After ::SSL_connect() ret=%d", ret);
 
         if (ret != 1) {
             int err = SSL_get_error(_ssl, ret);
-            diag_base::put_any(suborigin, diag::severity::important, 0x10788, "err=%d", err);
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::important, 0x10788, "err=%d", err);
 
             diag_base::require(suborigin, false, 0x10789, "::SSL_connect()");
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1078a, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1078a, "End:");
     }
 
 
@@ -221,7 +270,7 @@ namespace abc { namespace net { namespace openssl {
         , _verify_client(verify_client) {
 
         constexpr const char* suborigin = "tcp_server_socket()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1078b, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1078b, "Begin:");
 
         diag_base::expect(suborigin, cert_file_path != nullptr, 0x1099b, "is_open");
         diag_base::expect(suborigin, pkey_file_path != nullptr, 0x1099c, "is_open");
@@ -246,7 +295,7 @@ namespace abc { namespace net { namespace openssl {
         stat = SSL_CTX_use_PrivateKey_file(_ctx, pkey_file_path, SSL_FILETYPE_PEM);
         diag_base::require(suborigin, stat > 0, 0x10790, "::SSL_CTX_use_certificate_file()");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10791, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10791, "End:");
     }
 
 
@@ -257,34 +306,40 @@ namespace abc { namespace net { namespace openssl {
         , _ctx(other._ctx) {
 
         constexpr const char* suborigin = "tcp_server_socket()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10792, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10792, "Begin:");
 
         other._verify_client = false;
         other._ctx = nullptr;
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10793, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10793, "End:");
     }
 
 
     inline tcp_server_socket::~tcp_server_socket() noexcept {
         constexpr const char* suborigin = "~tcp_server_socket()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10794, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10794, "Begin:");
 
         if (_ctx != nullptr) {
             SSL_CTX_free(_ctx);
             _ctx = nullptr;
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10795, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10795, "End:");
     }
 
 
     inline std::unique_ptr<net::tcp_client_socket> tcp_server_socket::accept() const {
+        socket::fd_t fd = base::accept_fd();
+
+        return accept(fd);
+    }
+
+
+    inline std::unique_ptr<net::tcp_client_socket> tcp_server_socket::accept(socket::fd_t fd) const {
         constexpr const char* suborigin = "accept()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1099e, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1099e, "Begin:");
 
-        socket::fd_t fd = base::accept_fd();
-        diag_base::put_any(suborigin, diag::severity::optional, 0x1099f, "fd=%d", (int)fd);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x1099f, "fd=%d", (int)fd);
 
         const bool verify_server = false; // This value doesn't matter.
         std::unique_ptr<tcp_client_socket> openssl_client(new tcp_client_socket(fd, _ctx, verify_server, base::family(), diag_base::log()));
@@ -292,7 +347,7 @@ namespace abc { namespace net { namespace openssl {
         int stat = SSL_accept(openssl_client->_ssl);
         diag_base::require(suborigin, stat > 0, 0x10796, "::SSL_accept()");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x109a0, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x109a0, "End:");
 
         return openssl_client;
     }
@@ -25,9 +25,14 @@ SOFTWARE.
 
 #pragma once
 
+#include <algorithm>
 #include <stdexcept>
 #include <memory>
 #include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/sendfile.h>
 
 #include "../diag/diag_ready.h"
 #include "i/socket.i.h"
@@ -48,9 +53,9 @@ namespace abc { namespace net {
         , _fd(fd) {
 
         constexpr const char* suborigin = "basic_socket()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x109a1, "Begin: fd=%d, kind=%d, family=%d, protocol=%d", (int)fd, (int)kind, (int)family);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x109a1, "Begin: fd=%d, kind=%d, family=%d, protocol=%d", (int)fd, (int)kind, (int)family);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10006, "End: %s, %s", _kind == socket::kind::stream ? "tcp" : "udp", _family == socket::family::ipv4 ? "ipv4" : "ipv6");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10006, "End: %s, %s", _kind == socket::kind::stream ? "tcp" : "udp", _family == socket::family::ipv4 ? "ipv4" : "ipv6");
     }
 
 
@@ -62,21 +67,21 @@ namespace abc { namespace net {
         , _fd(other._fd) {
 
         constexpr const char* suborigin = "basic_socket()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x109a2, "Begin: fd=%d, kind=%d, family=%d, protocol=%d", (int)other._fd, (int)other._kind, (int)other._family);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x109a2, "Begin: fd=%d, kind=%d, family=%d, protocol=%d", (int)other._fd, (int)other._kind, (int)other._family);
 
         other._fd = socket::fd::invalid;
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10007, "End: %s, %s", _kind == socket::kind::stream ? "tcp" : "udp", _family == socket::family::ipv4 ? "ipv4" : "ipv6");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10007, "End: %s, %s", _kind == socket::kind::stream ? "tcp" : "udp", _family == socket::family::ipv4 ? "ipv4" : "ipv6");
     }
 
 
     inline basic_socket::~basic_socket() noexcept {
         constexpr const char* suborigin = "~basic_socket()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x109a3, "Begin: %s, %s", _kind == socket::kind::stream ? "tcp" : "udp", _family == socket::family::ipv4 ? "ipv4" : "ipv6");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x109a3, "Begin: %s, %s", _kind == socket::kind::stream ? "tcp" : "udp", _family == socket::family::ipv4 ? "ipv4" : "ipv6");
 
         close();
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x109a4, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x109a4, "End:");
     }
 
 
@@ -87,10 +92,10 @@ namespace abc { namespace net {
 
     inline void basic_socket::close() noexcept {
         constexpr const char* suborigin = "close()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x109a5, "Begin: fd=%d", _fd);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x109a5, "Begin: fd=%d", _fd);
 
         if (is_open()) {
-            diag_base::put_any(suborigin, diag::severity::optional, 0x10009, "Closing");
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10009, "Closing");
 
             ::shutdown(_fd, SHUT_RDWR);
             ::close(_fd);
@@ -98,13 +103,13 @@ namespace abc { namespace net {
             _fd = socket::fd::invalid;
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x109a6, "End: fd=%d", _fd);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x109a6, "End: fd=%d", _fd);
     }
 
 
     inline void basic_socket::open() {
         constexpr const char* suborigin = "open()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1000a, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1000a, "Begin:");
 
         close();
 
@@ -112,7 +117,7 @@ namespace abc { namespace net {
 
         diag_base::ensure(suborigin, is_open(), 0x1000b, "is_open");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1000c, "End: fd=%d", _fd);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1000c, "End: fd=%d", _fd);
     }
 
 
@@ -142,7 +147,7 @@ namespace abc { namespace net {
         const char* const tt_str = tt == socket::tie::bind ? "bind" : "connect";
 
         constexpr const char* suborigin = "tie(host, port)";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1000d, "Begin: %s(host, port)", tt_str);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1000d, "Begin: %s(host, port)", tt_str);
 
         diag_base::expect(suborigin, !is_open() || tt == socket::tie::connect, 0x1000e, "is_open");
 
@@ -164,7 +169,7 @@ namespace abc { namespace net {
         }
 
         if (hostList == nullptr) {
-            diag_base::put_any(suborigin, diag::severity::important, 0x10798, "%s(host, port), ::getaddrinfo() nullptr", tt_str);
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::important, 0x10798, "%s(host, port), ::getaddrinfo() nullptr", tt_str);
         }
 
         bool is_done = false;
@@ -187,7 +192,7 @@ namespace abc { namespace net {
             diag_base::require(suborigin, false, 0x1000d, "is_done");
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1000d, "End: %s", tt_str);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1000d, "End: %s", tt_str);
     }
 
 
@@ -195,7 +200,7 @@ namespace abc { namespace net {
         const char* const tt_str = tt == socket::tie::bind ? "bind" : "connect";
 
         constexpr const char* suborigin = "tie(socket::address)";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x109a7, "Begin: %s(socket::address)", tt_str);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x109a7, "Begin: %s(socket::address)", tt_str);
 
         diag_base::expect(suborigin, !is_open() || tt == socket::tie::connect, 0x10012, "!is_open");
 
@@ -208,7 +213,7 @@ namespace abc { namespace net {
 
         diag_base::ensure(suborigin, is_open(), 0x109a8, "is_open");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x109a9, "End: %s(socket::address)", tt_str);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x109a9, "End: %s(socket::address)", tt_str);
     }
 
 
@@ -216,7 +221,7 @@ namespace abc { namespace net {
         const char* const tt_str = tt == socket::tie::bind ? "bind" : "connect";
 
         constexpr const char* suborigin = "try_tie(sockaddr)";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x109aa, "Begin: %s(sockaddr)", tt_str);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x109aa, "Begin: %s(sockaddr)", tt_str);
 
         diag_base::expect(suborigin, is_open(), 0x10014, "is_open");
 
@@ -240,7 +245,7 @@ namespace abc { namespace net {
 
         diag_base::put_binary(suborigin, diag::severity::verbose, 0x1079b, addr.sa_data, addr_len);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1079c, "End: %s(sockaddr), err=%d", tt_str, err);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1079c, "End: %s(sockaddr), err=%d", tt_str, err);
 
         return err;
     }
@@ -275,6 +280,24 @@ namespace abc { namespace net {
     }
 
 
+    inline void basic_socket::set_blocking(bool is_blocking) {
+        constexpr const char* suborigin = "set_blocking()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e37, "Begin: is_blocking=%d", is_blocking);
+
+        diag_base::expect(suborigin, is_open(), 0x10e38, "is_open");
+
+        int flags = ::fcntl(_fd, F_GETFL, 0);
+        diag_base::require(suborigin, flags != -1, 0x10e39, "::fcntl(F_GETFL) errno=%d", errno);
+
+        flags = is_blocking ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK);
+
+        int err = ::fcntl(_fd, F_SETFL, flags);
+        diag_base::require(suborigin, err != -1, 0x10e3a, "::fcntl(F_SETFL) errno=%d", errno);
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e3b, "End:");
+    }
+
+
     inline socket::fd_t basic_socket::fd() const noexcept {
         return _fd;
     }
@@ -305,7 +328,7 @@ namespace abc { namespace net {
 
     inline std::size_t client_socket::send(const void* buffer, std::size_t size, const socket::address* address) {
         constexpr const char* suborigin = "send()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x109ab, "Begin: size=%zu", size);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x109ab, "Begin: size=%zu", size);
 
         diag_base::expect(suborigin, base::is_open(), 0x10017, "is_open");
         diag_base::expect(suborigin, address == nullptr || base::kind() == socket::kind::dgram, 0x10018, "!address || dgram");
@@ -321,17 +344,17 @@ namespace abc { namespace net {
         }
 
         if (sent_size < 0) {
-            diag_base::put_any(suborigin, diag::severity::important, 0x1043f, "sent_size=%ld", (long)sent_size);
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::important, 0x1043f, "sent_size=%ld", (long)sent_size);
 
             sent_size = 0;
         }
         else if ((std::size_t)sent_size < size) {
-            diag_base::put_any(suborigin, diag::severity::important, 0x10440, "sent_size=%ld", (long)sent_size);
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::important, 0x10440, "sent_size=%ld", (long)sent_size);
         }
 
         diag_base::put_binary(suborigin, diag::severity::verbose, 0x10066, buffer, size);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x109ac, "End: size=%zu, sent_size=%ld", size, (long)sent_size);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x109ac, "End: size=%zu, sent_size=%ld", size, (long)sent_size);
 
         return sent_size;
     }
@@ -339,7 +362,7 @@ namespace abc { namespace net {
 
     inline std::size_t client_socket::receive(void* buffer, std::size_t size, socket::address* address) {
         constexpr const char* suborigin = "receive()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x109ad, "Begin: size=%zu", size);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x109ad, "Begin: size=%zu", size);
 
         diag_base::expect(suborigin, base::is_open(), 0x1001d, "is_open");
         diag_base::expect(suborigin, address == nullptr || base::kind() == socket::kind::dgram, 0x1001e, "!address || dgram");
@@ -355,17 +378,18 @@ namespace abc { namespace net {
         }
 
         if (received_size < 0) {
-            diag_base::put_any(suborigin, diag::severity::important, 0x10441, "received_size=%ld", (long)received_size);
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::important, 0x10441, "received_size=%ld", (long)received_size);
 
             received_size = 0;
         }
         else if ((std::size_t)received_size < size) {
-            diag_base::put_any(suborigin, diag::severity::important, 0x10442, "size=%zu, received_size=%ld", size, (long)received_size);
+            // Receiving less than a full buffer is normal for a stream.
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10442, "size=%zu, received_size=%ld", size, (long)received_size);
         }
 
-        diag_base::put_binary(suborigin, diag::severity::verbose, 0x10067, buffer, size);
+        diag_base::put_binary(suborigin, diag::severity::verbose, 0x10067, buffer, received_size);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x109ae, "End: size=%zu, received_size=%ld", size, (long)received_size);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x109ae, "End: size=%zu, received_size=%ld", size, (long)received_size);
 
         return received_size;
     }
@@ -417,6 +441,42 @@ namespace abc { namespace net {
     }
 
 
+    inline std::size_t tcp_client_socket::pending_receive_size() const {
+        return 0;
+    }
+
+
+    inline std::size_t tcp_client_socket::send_file(int file_fd, std::uint64_t offset, std::size_t size) {
+        constexpr const char* suborigin = "send_file()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e7b, "Begin: file_fd=%d, offset=%llu, size=%zu", file_fd, (unsigned long long)offset, size);
+
+        diag_base::expect(suborigin, base::is_open(), 0x10e7c, "is_open");
+
+        off_t file_offset = static_cast<off_t>(offset);
+        std::size_t sent_size = 0;
+
+        // sendfile() may send less than requested, e.g. when interrupted.
+        while (sent_size < size) {
+            ssize_t chunk_size = ::sendfile(base::fd(), file_fd, &file_offset, size - sent_size);
+
+            if (chunk_size < 0 && errno == EINTR) {
+                continue;
+            }
+
+            if (chunk_size <= 0) {
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::important, 0x10e7d, "::sendfile() chunk_size=%ld, errno=%d", (long)chunk_size, errno);
+                break;
+            }
+
+            sent_size += static_cast<std::size_t>(chunk_size);
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e7e, "End: size=%zu, sent_size=%zu", size, sent_size);
+
+        return sent_size;
+    }
+
+
     // --------------------------------------------------------------
 
 
@@ -432,32 +492,64 @@ namespace abc { namespace net {
 
     inline void tcp_server_socket::listen(socket::backlog_size_t backlog_size) {
         constexpr const char* suborigin = "listen()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10022, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10022, "Begin:");
 
         diag_base::expect(suborigin, base::is_open(), 0x109af, "is_open");
 
         socket::error_t err = ::listen(base::fd(), backlog_size);
         diag_base::require(suborigin, err == socket::error::none, 0x109b0, "::listen() err=%d", err);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10024, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10024, "End:");
     }
 
 
     inline std::unique_ptr<tcp_client_socket> tcp_server_socket::accept() const {
         socket::fd_t fd = accept_fd();
 
+        return accept(fd);
+    }
+
+
+    inline std::unique_ptr<tcp_client_socket> tcp_server_socket::accept(socket::fd_t fd) const {
         return std::unique_ptr<tcp_client_socket>(new tcp_client_socket("abc::net::tcp_server_socket", fd, base::family(), base::log()));
     }
 
 
+    inline socket::fd_t tcp_server_socket::try_accept_fd(bool& is_exhausted) const {
+        constexpr const char* suborigin = "try_accept_fd()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e3c, "Begin:");
+
+        is_exhausted = false;
+
+        socket::fd_t fd = ::accept(base::fd(), nullptr, nullptr);
+        if (fd == socket::fd::invalid) {
+            int accept_errno = errno;
+
+            // Running out of descriptors or buffers is temporary. The connection stays in the backlog.
+            if (accept_errno == EMFILE || accept_errno == ENFILE || accept_errno == ENOBUFS || accept_errno == ENOMEM) {
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::warning, 0x10fc9, "Out of resources: ::accept() errno=%d", accept_errno);
+                is_exhausted = true;
+            }
+            else {
+                // The connection may have been reset by the client before it was accepted.
+                diag_base::require(suborigin, accept_errno == EAGAIN || accept_errno == EWOULDBLOCK || accept_errno == ECONNABORTED || accept_errno == EINTR, 0x10e3d, "::accept() errno=%d", accept_errno);
+            }
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e3e, "End: fd=%d", fd);
+
+        return fd;
+    }
+
+
     inline socket::fd_t tcp_server_socket::accept_fd() const {
         constexpr const char* suborigin = "accept_fd()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10025, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10025, "Begin:");
 
         socket::fd_t fd = ::accept(base::fd(), nullptr, nullptr);
         diag_base::require(suborigin, fd != socket::fd::invalid, 0x10026, "::accept() fd=%d", fd);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10027, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10027, "End:");
 
         return fd;
     }
@@ -467,19 +559,30 @@ namespace abc { namespace net {
 
 
     inline tcp_client_socket_streambuf::tcp_client_socket_streambuf(tcp_client_socket* socket, diag::log_ostream* log)
+        : tcp_client_socket_streambuf(socket, socket::stream_buffer_size, socket::stream_buffer_size, log) {
+    }
+
+
+    inline tcp_client_socket_streambuf::tcp_client_socket_streambuf(tcp_client_socket* socket, std::size_t receive_buffer_size, std::size_t send_buffer_size, diag::log_ostream* log)
         : base()
         , diag_base("abc::net::tcp_client_socket_streambuf", log)
-        , _socket(socket) {
+        , _socket(socket)
+        , _total_received_count(0) {
 
         constexpr const char* suborigin = "tcp_client_socket_streambuf()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x109b1, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x109b1, "Begin: receive_buffer_size=%zu, send_buffer_size=%zu", receive_buffer_size, send_buffer_size);
 
         diag_base::expect(suborigin, socket != nullptr, 0x10068, "socket");
+        diag_base::expect(suborigin, receive_buffer_size > 0, 0x10e31, "receive_buffer_size > 0");
+        diag_base::expect(suborigin, send_buffer_size > 0, 0x10e32, "send_buffer_size > 0");
 
-        setg(&_get_ch, &_get_ch, &_get_ch);
-        setp(&_put_ch, &_put_ch + 1);
+        _get_buffer.resize(receive_buffer_size);
+        _put_buffer.resize(send_buffer_size);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x109b2, "End:");
+        setg(_get_buffer.data(), _get_buffer.data(), _get_buffer.data());
+        setp(_put_buffer.data(), _put_buffer.data() + _put_buffer.size());
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x109b2, "End:");
     }
 
 
@@ -487,20 +590,39 @@ namespace abc { namespace net {
         : base()
         , diag_base(std::move(other))
         , _socket(std::move(other._socket))
-        , _get_ch(other._get_ch)
-        , _put_ch(other._put_ch) {
+        , _total_received_count(other._total_received_count) {
 
         constexpr const char* suborigin = "tcp_client_socket_streambuf()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x109b3, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x109b3, "Begin:");
+
+        // Bytes that have been received but not read, and bytes that have been put but not sent, move along with the buffers.
+        std::size_t get_pos = other.gptr() - other.eback();
+        std::size_t get_end = other.egptr() - other.eback();
+        std::size_t put_pos = other.pptr() - other.pbase();
 
-        setg(&_get_ch, &_get_ch, &_get_ch);
-        setp(&_put_ch, &_put_ch + 1);
+        _get_buffer = std::move(other._get_buffer);
+        _put_buffer = std::move(other._put_buffer);
+
+        setg(_get_buffer.data(), _get_buffer.data() + get_pos, _get_buffer.data() + get_end);
+        setp(_put_buffer.data(), _put_buffer.data() + _put_buffer.size());
+        pbump(static_cast<int>(put_pos));
 
         other._socket = nullptr;
         other.setg(nullptr, nullptr, nullptr);
         other.setp(nullptr, nullptr);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x109b4, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x109b4, "End:");
+    }
+
+
+    inline tcp_client_socket_streambuf::~tcp_client_socket_streambuf() noexcept {
+        if (_socket != nullptr) {
+            try {
+                (void)sync();
+            }
+            catch (...) {
+            }
+        }
     }
 
 
@@ -509,33 +631,176 @@ namespace abc { namespace net {
     }
 
 
+    inline std::size_t tcp_client_socket_streambuf::total_get_count() const {
+        // Bytes that are still in the get area have been received but not got.
+        return _total_received_count - (egptr() - gptr());
+    }
+
+
+    inline std::size_t tcp_client_socket_streambuf::send_file(int file_fd, std::uint64_t offset, std::size_t size) {
+        // The file must follow what has been put so far.
+        if (sync() != 0) {
+            return 0;
+        }
+
+        return _socket->send_file(file_fd, offset, size);
+    }
+
+
+    inline const char* tcp_client_socket_streambuf::peek_received(std::size_t& size) const {
+        size = egptr() - gptr();
+        return gptr();
+    }
+
+
+    inline std::size_t tcp_client_socket_streambuf::receive_more() {
+        // The peer may be waiting for what has been put so far before it sends anything.
+        if (sync() != 0) {
+            return 0;
+        }
+
+        std::size_t available_size = egptr() - gptr();
+        if (gptr() != _get_buffer.data()) {
+            std::memmove(_get_buffer.data(), gptr(), available_size);
+            setg(_get_buffer.data(), _get_buffer.data(), _get_buffer.data() + available_size);
+        }
+
+        if (available_size == _get_buffer.size()) {
+            return 0;
+        }
+
+        std::size_t received_size = _socket->receive(_get_buffer.data() + available_size, _get_buffer.size() - available_size);
+        setg(_get_buffer.data(), _get_buffer.data(), _get_buffer.data() + available_size + received_size);
+        _total_received_count += received_size;
+
+        return received_size;
+    }
+
+
+    inline void tcp_client_socket_streambuf::skip_received(std::size_t count) {
+        gbump(static_cast<int>(std::min(count, static_cast<std::size_t>(egptr() - gptr()))));
+    }
+
+
     inline std::streambuf::int_type tcp_client_socket_streambuf::underflow() {
-        _socket->receive(&_get_ch, sizeof(char));
+        if (gptr() < egptr()) {
+            return traits_type::to_int_type(*gptr());
+        }
 
-        setg(&_get_ch, &_get_ch, &_get_ch + 1);
+        // The peer may be waiting for what has been put so far before it sends anything.
+        if (sync() != 0) {
+            return traits_type::eof();
+        }
+
+        std::size_t received_size = _socket->receive(_get_buffer.data(), _get_buffer.size());
+        setg(_get_buffer.data(), _get_buffer.data(), _get_buffer.data() + received_size);
+        _total_received_count += received_size;
+
+        if (received_size == 0) {
+            return traits_type::eof();
+        }
 
-        return _get_ch;
+        return traits_type::to_int_type(*gptr());
     }
 
 
     inline std::streambuf::int_type tcp_client_socket_streambuf::overflow(std::streambuf::int_type ch) {
-        _socket->send(&_put_ch, sizeof(char));
-        _socket->send(&ch, sizeof(char));
+        if (sync() != 0) {
+            return traits_type::eof();
+        }
 
-        setp(&_put_ch, &_put_ch + 1);
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
 
-        return ch;
+        return traits_type::not_eof(ch);
     }
 
 
     inline int tcp_client_socket_streambuf::sync() {
-        if (pptr() != &_put_ch) {
-            _socket->send(&_put_ch, sizeof(char));
+        std::size_t size = pptr() - pbase();
+        bool is_sent = size == 0 || send_all(pbase(), size);
+
+        setp(_put_buffer.data(), _put_buffer.data() + _put_buffer.size());
+
+        return is_sent ? 0 : -1;
+    }
+
+
+    inline std::streamsize tcp_client_socket_streambuf::xsgetn(char_type* s, std::streamsize count) {
+        std::streamsize got_count = 0;
+
+        while (got_count < count) {
+            std::streamsize available_count = egptr() - gptr();
+
+            if (available_count > 0) {
+                std::streamsize copy_count = std::min(available_count, count - got_count);
+                std::memmove(s + got_count, gptr(), copy_count);
+                gbump(static_cast<int>(copy_count));
+                got_count += copy_count;
+            }
+            else if (count - got_count >= static_cast<std::streamsize>(_get_buffer.size())) {
+                // Large blocks skip the receive buffer.
+                if (sync() != 0) {
+                    break;
+                }
+
+                std::size_t received_size = _socket->receive(s + got_count, count - got_count);
+                if (received_size == 0) {
+                    break;
+                }
+
+                got_count += received_size;
+                _total_received_count += received_size;
+            }
+            else if (traits_type::eq_int_type(underflow(), traits_type::eof())) {
+                break;
+            }
         }
 
-        setp(&_put_ch, &_put_ch + 1);
+        return got_count;
+    }
 
-        return 0;
+
+    inline std::streamsize tcp_client_socket_streambuf::xsputn(const char_type* s, std::streamsize count) {
+        std::streamsize available_count = epptr() - pptr();
+
+        if (count <= available_count) {
+            std::memmove(pptr(), s, count);
+            pbump(static_cast<int>(count));
+
+            return count;
+        }
+
+        if (sync() != 0) {
+            return 0;
+        }
+
+        if (count >= static_cast<std::streamsize>(_put_buffer.size())) {
+            // Large blocks skip the send buffer.
+            return send_all(s, count) ? count : 0;
+        }
+
+        std::memmove(pptr(), s, count);
+        pbump(static_cast<int>(count));
+
+        return count;
+    }
+
+
+    inline bool tcp_client_socket_streambuf::send_all(const char* buffer, std::size_t size) {
+        while (size > 0) {
+            std::size_t sent_size = _socket->send(buffer, size);
+            if (sent_size == 0) {
+                return false;
+            }
+
+            buffer += sent_size;
+            size -= sent_size;
+        }
+
+        return true;
     }
 
 } }
@@ -25,8 +25,18 @@ SOFTWARE.
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #include "size.h"
 
 
@@ -42,6 +52,141 @@ namespace abc {
         using predicate_t = bool (*) (char);
 
 
+        /**
+         * @brief Bit mask of character classes.
+         */
+        using char_class_t = std::uint16_t;
+
+
+        /**
+         * @brief Character classes. Masks that combine several classes match a char that belongs to any of them.
+         */
+        namespace char_class {
+            constexpr char_class_t digit               = 0x0001;
+            constexpr char_class_t hex                 = 0x0002;
+            constexpr char_class_t upperalpha          = 0x0004;
+            constexpr char_class_t loweralpha          = 0x0008;
+            constexpr char_class_t space               = 0x0010;
+            constexpr char_class_t control             = 0x0020;
+            constexpr char_class_t stdprint            = 0x0040;
+            constexpr char_class_t abcprint            = 0x0080;
+            constexpr char_class_t http_separator      = 0x0100;
+            constexpr char_class_t http_token          = 0x0200;
+            constexpr char_class_t http_url_safe       = 0x0400;
+            constexpr char_class_t json_space          = 0x0800;
+            constexpr char_class_t json_string_content = 0x1000;
+            constexpr char_class_t any                 = 0x2000;
+
+            constexpr char_class_t alpha               = upperalpha | loweralpha;
+            constexpr char_class_t abcprint_or_space   = abcprint | space;
+        }
+
+
+        /**
+         * @brief    Internal. Checks whether a char code is an http separator.
+         * @param ch Char code, 0 - 255.
+         */
+        constexpr bool is_http_separator_code(unsigned ch) noexcept {
+            return ch == ' ' || ch == '\t' ||
+                ch == '(' || ch == ')' || ch == '<' || ch == '>' || ch == '[' || ch == ']' || ch == '{' || ch == '}' ||
+                ch == '@' || ch == ',' || ch == ';' || ch == ':' || ch == '\\' || ch == '/' || ch == '"' || ch == '?' || ch == '=';
+        }
+
+
+        /**
+         * @brief    Internal. Classifies a char code at compile time. The `is_...()` predicates below look up the result in a table.
+         * @param ch Char code, 0 - 255.
+         */
+        constexpr char_class_t classify(unsigned ch) noexcept {
+            return static_cast<char_class_t>(
+                  ('0' <= ch && ch <= '9' ? char_class::digit : 0)
+                | (('0' <= ch && ch <= '9') || ('A' <= ch && ch <= 'F') || ('a' <= ch && ch <= 'f') ? char_class::hex : 0)
+                | ('A' <= ch && ch <= 'Z' ? char_class::upperalpha : 0)
+                | ('a' <= ch && ch <= 'z' ? char_class::loweralpha : 0)
+                | (ch == ' ' || ch == '\t' ? char_class::space : 0)
+                | (ch <= 0x1f || ch == 0x7f ? char_class::control : 0)
+                | (0x20 <= ch && ch <= 0x7e ? char_class::stdprint : 0)
+                | (0x21 <= ch && ch <= 0x7e ? char_class::abcprint : 0)
+                | (is_http_separator_code(ch) ? char_class::http_separator : 0)
+                | (0x21 <= ch && ch <= 0x7e && !is_http_separator_code(ch) ? char_class::http_token : 0)
+                | (('0' <= ch && ch <= '9') || ('A' <= ch && ch <= 'Z') || ('a' <= ch && ch <= 'z')
+                    || ch == '-' || ch == '.' || ch == '_' || ch == '~' || ch == '/' || ch == ':' || ch == '@' ? char_class::http_url_safe : 0)
+                | (ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n' ? char_class::json_space : 0)
+                | (ch != '"' && ch != '\\' ? char_class::json_string_content : 0)
+                | char_class::any);
+        }
+
+
+        /**
+         * @brief Internal. Table of the classes of all 256 char codes.
+         */
+        struct char_class_table {
+            char_class_t entries[256];
+        };
+
+
+        /**
+         * @brief Internal. Compile-time list of char codes.
+         */
+        template <unsigned... Codes>
+        struct char_codes {
+        };
+
+
+        /**
+         * @brief Internal. Makes the compile-time list of char codes `0` through `Count - 1`.
+         */
+        template <unsigned Count, unsigned... Codes>
+        struct make_char_codes
+            : make_char_codes<Count - 1, Count - 1, Codes...> {
+        };
+
+
+        template <unsigned... Codes>
+        struct make_char_codes<0, Codes...>
+            : char_codes<Codes...> {
+        };
+
+
+        template <unsigned... Codes>
+        constexpr char_class_table make_char_class_table(char_codes<Codes...>) noexcept {
+            return char_class_table{ { classify(Codes)... } };
+        }
+
+
+        /**
+         * @brief   Internal. Holder of the `char_class_table` instance.
+         * @details A class template, so that the table could be defined in this header.
+         */
+        template <typename T = void>
+        struct char_class_tables {
+            static constexpr char_class_table table = make_char_class_table(make_char_codes<256>());
+        };
+
+
+        template <typename T>
+        constexpr char_class_table char_class_tables<T>::table;
+
+
+        /**
+         * @brief Returns the classes of a char.
+         */
+        inline char_class_t get_char_class(char ch) noexcept {
+            return char_class_tables<>::table.entries[static_cast<unsigned char>(ch)];
+        }
+
+
+        /**
+         * @brief Checks whether a char belongs to any of the given classes.
+         */
+        inline bool is_class(char ch, char_class_t cls) noexcept {
+            return (get_char_class(ch) & cls) != 0;
+        }
+
+
+        // --------------------------------------------------------------
+
+
         inline bool is_between(char ch, char low, char high) noexcept {
             return low <= ch && ch <= high;
         }
@@ -53,27 +198,27 @@ namespace abc {
 
 
         inline bool is_digit(char ch) noexcept {
-            return is_between(ch, '0', '9');
+            return is_class(ch, char_class::digit);
         }
 
 
         inline bool is_hex(char ch) noexcept {
-            return is_digit(ch) || is_between(ch, 'A', 'F') || is_between(ch, 'a', 'f');
+            return is_class(ch, char_class::hex);
         }
 
 
         inline bool is_upperalpha(char ch) noexcept {
-            return is_between(ch, 'A', 'Z');
+            return is_class(ch, char_class::upperalpha);
         }
 
 
         inline bool is_loweralpha(char ch) noexcept {
-            return is_between(ch, 'a', 'z');
+            return is_class(ch, char_class::loweralpha);
         }
 
 
         inline bool is_alpha(char ch) noexcept {
-            return is_upperalpha(ch) || is_loweralpha(ch);
+            return is_class(ch, char_class::alpha);
         }
 
 
@@ -88,27 +233,27 @@ namespace abc {
 
 
         inline bool is_space(char ch) noexcept {
-            return ch == ' ' || ch == '\t';
+            return is_class(ch, char_class::space);
         }
 
 
         inline bool is_control(char ch) noexcept {
-            return is_between(ch, 0x00, 0x1f) || ch == 0x7f;
+            return is_class(ch, char_class::control);
         }
 
 
         inline bool is_stdprint(char ch) noexcept {
-            return is_between(ch, 0x20, 0x7e);
+            return is_class(ch, char_class::stdprint);
         }
 
 
         inline bool is_abcprint(char ch) noexcept {
-            return is_between(ch, 0x21, 0x7e);
+            return is_class(ch, char_class::abcprint);
         }
 
 
         inline bool is_abcprint_or_space(char ch) noexcept {
-            return is_abcprint(ch) || is_space(ch);
+            return is_class(ch, char_class::abcprint_or_space);
         }
 
 
@@ -225,15 +370,12 @@ namespace abc {
 
         namespace http {
             inline bool is_separator(char ch) noexcept {
-                return
-                    is_space(ch) ||
-                    ch == '(' || ch == ')' || ch == '<' || ch == '>' || ch == '[' || ch == ']' ||  ch == '{' || ch == '}' ||
-                    ch == '@' || ch == ',' || ch == ';' || ch == ':' || ch == '\\' || ch == '/' || ch == '"' || ch == '?' || ch == '=';
+                return is_class(ch, char_class::http_separator);
             }
 
 
             inline bool is_token(char ch) noexcept {
-                return is_abcprint(ch) && !is_separator(ch);
+                return is_class(ch, char_class::http_token);
             }
 
 
@@ -243,10 +385,7 @@ namespace abc {
                 //   - Section 3.3. Path
                 //   - Section 3.4. Query
                 //   - Section 3.5. Fragment
-                return
-                    is_alpha(ch) || is_digit(ch) ||
-                    ch == '-' || ch == '.' || ch == '_' || ch == '~' ||
-                    ch == '/' || ch == ':' || ch == '@';
+                return is_class(ch, char_class::http_url_safe);
             }
         }
 
@@ -258,14 +397,187 @@ namespace abc {
 
 
             inline bool is_space(char ch) noexcept {
-                return ascii::is_space(ch) || ch == '\r' || ch == '\n';
+                return is_class(ch, char_class::json_space);
             }
 
 
             inline bool is_string_content(char ch) noexcept {
-                return is_valid(ch) && ch != '"' && ch != '\\';
+                return is_class(ch, char_class::json_string_content);
             }
         }
+
+
+        // --------------------------------------------------------------
+
+
+        /**
+         * @brief       Internal. Returns the length of the longest prefix of chars that are between `low` and `high`, or are equal to `also`.
+         * @details     Scans 32 or 16 chars at a time with AVX2, SSE2, or NEON.
+         * @param chars Chars.
+         * @param size  Number of chars.
+         * @param low   Lowest matching char. Must be between `0x01` and `high`.
+         * @param high  Highest matching char. Must be less than `0x7f`.
+         * @param also  Another matching char.
+         */
+        inline std::size_t scan_between(const char* chars, std::size_t size, char low, char high, char also) noexcept {
+            std::size_t i = 0;
+
+#if defined(__AVX2__)
+            const __m256i low_1 = _mm256_set1_epi8(static_cast<char>(low - 1));
+            const __m256i high_1 = _mm256_set1_epi8(static_cast<char>(high + 1));
+            const __m256i also_1 = _mm256_set1_epi8(also);
+
+            for (; i + 32 <= size; i += 32) {
+                // Chars 0x80 - 0xff are negative, so they are less than low.
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(chars + i));
+                __m256i match = _mm256_and_si256(_mm256_cmpgt_epi8(v, low_1), _mm256_cmpgt_epi8(high_1, v));
+                match = _mm256_or_si256(match, _mm256_cmpeq_epi8(v, also_1));
+
+                std::uint32_t mismatch = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(match));
+                if (mismatch != 0) {
+                    return i + __builtin_ctz(mismatch);
+                }
+            }
+#elif defined(__SSE2__)
+            const __m128i low_1 = _mm_set1_epi8(static_cast<char>(low - 1));
+            const __m128i high_1 = _mm_set1_epi8(static_cast<char>(high + 1));
+            const __m128i also_1 = _mm_set1_epi8(also);
+
+            for (; i + 16 <= size; i += 16) {
+                // Chars 0x80 - 0xff are negative, so they are less than low.
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chars + i));
+                __m128i match = _mm_and_si128(_mm_cmpgt_epi8(v, low_1), _mm_cmplt_epi8(v, high_1));
+                match = _mm_or_si128(match, _mm_cmpeq_epi8(v, also_1));
+
+                std::uint32_t mismatch = ~static_cast<std::uint32_t>(_mm_movemask_epi8(match)) & 0xffff;
+                if (mismatch != 0) {
+                    return i + __builtin_ctz(mismatch);
+                }
+            }
+#elif defined(__ARM_NEON)
+            const uint8x16_t low_1 = vdupq_n_u8(static_cast<std::uint8_t>(low));
+            const uint8x16_t high_1 = vdupq_n_u8(static_cast<std::uint8_t>(high));
+            const uint8x16_t also_1 = vdupq_n_u8(static_cast<std::uint8_t>(also));
+
+            for (; i + 16 <= size; i += 16) {
+                uint8x16_t v = vld1q_u8(reinterpret_cast<const std::uint8_t*>(chars + i));
+                uint8x16_t match = vandq_u8(vcgeq_u8(v, low_1), vcleq_u8(v, high_1));
+                match = vorrq_u8(match, vceqq_u8(v, also_1));
+
+                // Narrow each byte of the mask to 4 bits.
+                std::uint64_t mismatch = ~vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(match), 4)), 0);
+                if (mismatch != 0) {
+                    return i + (__builtin_ctzll(mismatch) >> 2);
+                }
+            }
+#endif
+
+            for (; i < size && ((low <= chars[i] && chars[i] <= high) || chars[i] == also); i++) {
+            }
+
+            return i;
+        }
+
+
+        /**
+         * @brief       Internal. Returns the length of the longest prefix of chars that are different from both `ch1` and `ch2`.
+         * @details     Scans 32 or 16 chars at a time with AVX2, SSE2, or NEON.
+         * @param chars Chars.
+         * @param size  Number of chars.
+         * @param ch1   Char to stop at.
+         * @param ch2   Another char to stop at.
+         */
+        inline std::size_t scan_except(const char* chars, std::size_t size, char ch1, char ch2) noexcept {
+            std::size_t i = 0;
+
+#if defined(__AVX2__)
+            const __m256i ch1_1 = _mm256_set1_epi8(ch1);
+            const __m256i ch2_1 = _mm256_set1_epi8(ch2);
+
+            for (; i + 32 <= size; i += 32) {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(chars + i));
+                __m256i stop = _mm256_or_si256(_mm256_cmpeq_epi8(v, ch1_1), _mm256_cmpeq_epi8(v, ch2_1));
+
+                std::uint32_t stop_mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(stop));
+                if (stop_mask != 0) {
+                    return i + __builtin_ctz(stop_mask);
+                }
+            }
+#elif defined(__SSE2__)
+            const __m128i ch1_1 = _mm_set1_epi8(ch1);
+            const __m128i ch2_1 = _mm_set1_epi8(ch2);
+
+            for (; i + 16 <= size; i += 16) {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chars + i));
+                __m128i stop = _mm_or_si128(_mm_cmpeq_epi8(v, ch1_1), _mm_cmpeq_epi8(v, ch2_1));
+
+                std::uint32_t stop_mask = static_cast<std::uint32_t>(_mm_movemask_epi8(stop));
+                if (stop_mask != 0) {
+                    return i + __builtin_ctz(stop_mask);
+                }
+            }
+#elif defined(__ARM_NEON)
+            const uint8x16_t ch1_1 = vdupq_n_u8(static_cast<std::uint8_t>(ch1));
+            const uint8x16_t ch2_1 = vdupq_n_u8(static_cast<std::uint8_t>(ch2));
+
+            for (; i + 16 <= size; i += 16) {
+                uint8x16_t v = vld1q_u8(reinterpret_cast<const std::uint8_t*>(chars + i));
+                uint8x16_t stop = vorrq_u8(vceqq_u8(v, ch1_1), vceqq_u8(v, ch2_1));
+
+                // Narrow each byte of the mask to 4 bits.
+                std::uint64_t stop_mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(stop), 4)), 0);
+                if (stop_mask != 0) {
+                    return i + (__builtin_ctzll(stop_mask) >> 2);
+                }
+            }
+#endif
+
+            for (; i < size && chars[i] != ch1 && chars[i] != ch2; i++) {
+            }
+
+            return i;
+        }
+
+
+        /**
+         * @brief       Returns the length of the longest prefix of chars that belong to any of the given classes.
+         * @details     Classes that are ranges of chars, e.g. `abcprint`, `abcprint_or_space`, `digit`, and `json_string_content`, are scanned with SIMD instructions.
+         *              Other classes are looked up in the table one char at a time.
+         * @param chars Chars.
+         * @param size  Number of chars.
+         * @param cls   Classes.
+         */
+        inline std::size_t scan_while(const char* chars, std::size_t size, char_class_t cls) noexcept {
+            switch (cls) {
+            case char_class::any:
+                return size;
+
+            case char_class::digit:
+                return scan_between(chars, size, '0', '9', '0');
+
+            case char_class::stdprint:
+                return scan_between(chars, size, 0x20, 0x7e, 0x20);
+
+            case char_class::abcprint:
+                return scan_between(chars, size, 0x21, 0x7e, 0x21);
+
+            case char_class::abcprint_or_space:
+                return scan_between(chars, size, 0x20, 0x7e, '\t');
+
+            case char_class::json_string_content:
+                return scan_except(chars, size, '"', '\\');
+
+            default:
+                break;
+            }
+
+            std::size_t i = 0;
+            while (i < size && is_class(chars[i], cls)) {
+                i++;
+            }
+
+            return i;
+        }
     }
 
 }
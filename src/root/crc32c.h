@@ -0,0 +1,182 @@
+/*
+MIT License
+
+Copyright (c) 2018-2026 Zlatko Michailov 
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+// The intrinsics are usable from functions that target SSE4.2 even when the translation unit doesn't.
+#include <nmmintrin.h>
+#define __ABC__CRC32C_SSE42
+#elif defined(__ARM_FEATURE_CRC32) && defined(__aarch64__)
+#include <arm_acle.h>
+#define __ABC__CRC32C_ARM
+#endif
+
+
+namespace abc {
+
+    /**
+     * @brief Lookup table for the software CRC32C (Castagnoli) implementation.
+     */
+    struct crc32c_table {
+        crc32c_table() noexcept {
+            constexpr std::uint32_t poly = 0x82f63b78; // Reflected Castagnoli polynomial.
+
+            for (std::uint32_t i = 0; i < 256; i++) {
+                std::uint32_t crc = i;
+
+                for (int b = 0; b < 8; b++) {
+                    crc = (crc & 1) != 0 ? (crc >> 1) ^ poly : crc >> 1;
+                }
+
+                entries[i] = crc;
+            }
+        }
+
+        std::uint32_t entries[256];
+    };
+
+
+    // --------------------------------------------------------------
+
+
+    /**
+     * @brief       Updates a (pre-inverted) CRC32C state with a buffer using a lookup table.
+     * @param crc   CRC32C state.
+     * @param bytes Pointer to the buffer.
+     * @param size  Size of the buffer in bytes.
+     * @return      The updated state.
+     */
+    inline std::uint32_t crc32c_update_table(std::uint32_t crc, const std::uint8_t* bytes, std::size_t size) noexcept {
+        static const crc32c_table table;
+
+        for (; size > 0; size--, bytes++) {
+            crc = table.entries[(crc ^ *bytes) & 0xff] ^ (crc >> 8);
+        }
+
+        return crc;
+    }
+
+
+#if defined(__ABC__CRC32C_SSE42)
+    /**
+     * @brief       Updates a (pre-inverted) CRC32C state with a buffer using the SSE4.2 CRC32 instruction.
+     * @details     Must only be called when `has_crc32c_sse42()` returns `true`.
+     * @param crc   CRC32C state.
+     * @param bytes Pointer to the buffer.
+     * @param size  Size of the buffer in bytes.
+     * @return      The updated state.
+     */
+    __attribute__((target("sse4.2")))
+    inline std::uint32_t crc32c_update_sse42(std::uint32_t crc, const std::uint8_t* bytes, std::size_t size) noexcept {
+        for (; size >= sizeof(std::uint64_t); size -= sizeof(std::uint64_t), bytes += sizeof(std::uint64_t)) {
+            std::uint64_t chunk;
+            std::memcpy(&chunk, bytes, sizeof(chunk));
+            crc = static_cast<std::uint32_t>(_mm_crc32_u64(crc, chunk));
+        }
+
+        for (; size > 0; size--, bytes++) {
+            crc = _mm_crc32_u8(crc, *bytes);
+        }
+
+        return crc;
+    }
+
+
+    /**
+     * @brief Returns whether the CPU supports SSE4.2. The CPU is only queried once.
+     */
+    inline bool has_crc32c_sse42() noexcept {
+#if defined(__SSE4_2__)
+        return true;
+#else
+        static const bool has = [] () noexcept -> bool {
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse4.2") != 0;
+        }();
+
+        return has;
+#endif
+    }
+#endif
+
+
+#if defined(__ABC__CRC32C_ARM)
+    /**
+     * @brief       Updates a (pre-inverted) CRC32C state with a buffer using the ARMv8 CRC32 instructions.
+     * @param crc   CRC32C state.
+     * @param bytes Pointer to the buffer.
+     * @param size  Size of the buffer in bytes.
+     * @return      The updated state.
+     */
+    inline std::uint32_t crc32c_update_arm(std::uint32_t crc, const std::uint8_t* bytes, std::size_t size) noexcept {
+        for (; size >= sizeof(std::uint64_t); size -= sizeof(std::uint64_t), bytes += sizeof(std::uint64_t)) {
+            std::uint64_t chunk;
+            std::memcpy(&chunk, bytes, sizeof(chunk));
+            crc = __crc32cd(crc, chunk);
+        }
+
+        for (; size > 0; size--, bytes++) {
+            crc = __crc32cb(crc, *bytes);
+        }
+
+        return crc;
+    }
+#endif
+
+
+    // --------------------------------------------------------------
+
+
+    /**
+     * @brief      Computes the CRC32C (Castagnoli) checksum of a buffer.
+     * @details    On x86-64, uses the SSE4.2 CRC32 instruction when the CPU supports it, which is checked at run time.
+     *             On ARM, uses the ARMv8 CRC32 instructions when the target supports them, which is checked at compile time.
+     *             Otherwise, uses a lookup table.
+     * @param data Pointer to the buffer.
+     * @param size Size of the buffer in bytes.
+     * @param crc  Checksum of preceding data, if the buffer is a continuation.
+     * @return     The checksum.
+     */
+    inline std::uint32_t crc32c(const void* data, std::size_t size, std::uint32_t crc = 0) noexcept {
+        const std::uint8_t* bytes = reinterpret_cast<const std::uint8_t*>(data);
+
+#if defined(__ABC__CRC32C_SSE42)
+        if (has_crc32c_sse42()) {
+            return ~crc32c_update_sse42(~crc, bytes, size);
+        }
+#elif defined(__ABC__CRC32C_ARM)
+        return ~crc32c_update_arm(~crc, bytes, size);
+#endif
+
+        return ~crc32c_update_table(~crc, bytes, size);
+    }
+
+}
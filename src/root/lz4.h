@@ -0,0 +1,307 @@
+/*
+MIT License
+
+Copyright (c) 2018-2026 Zlatko Michailov 
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+
+namespace abc {
+
+    /**
+     * @brief Minimum match length of the LZ4 block format.
+     */
+    constexpr std::size_t lz4_min_match = 4;
+
+    /**
+     * @brief Number of trailing bytes that are always emitted as literals.
+     */
+    constexpr std::size_t lz4_last_literals = 5;
+
+    /**
+     * @brief A match may not start within this many bytes from the end of the input.
+     */
+    constexpr std::size_t lz4_match_limit = 12;
+
+    /**
+     * @brief Maximum distance of a match.
+     */
+    constexpr std::size_t lz4_max_offset = 65535;
+
+    /**
+     * @brief Number of bits of the hash used by the compressor to find matches.
+     */
+    constexpr unsigned lz4_hash_bits = 12;
+
+
+    // --------------------------------------------------------------
+
+
+    /**
+     * @brief          Returns the maximum compressed size of an input of the given size.
+     * @param src_size Input size in bytes.
+     */
+    inline constexpr std::size_t lz4_compress_bound(std::size_t src_size) noexcept {
+        return src_size + src_size / 255 + 16;
+    }
+
+
+    /**
+     * @brief              Writes a length that exceeds a token nibble as a sequence of 255's followed by the remainder.
+     * @param len          Length remaining after subtracting `15`.
+     * @param dst          Output position.
+     * @param dst_end      End of the output buffer.
+     * @return             The new output position, or `nullptr` if the output buffer is too small.
+     */
+    inline std::uint8_t* lz4_put_length(std::size_t len, std::uint8_t* dst, std::uint8_t* dst_end) noexcept {
+        for (; len >= 255; len -= 255) {
+            if (dst == dst_end) {
+                return nullptr;
+            }
+
+            *dst++ = 255;
+        }
+
+        if (dst == dst_end) {
+            return nullptr;
+        }
+
+        *dst++ = static_cast<std::uint8_t>(len);
+
+        return dst;
+    }
+
+
+    /**
+     * @brief           Writes one LZ4 sequence - a token, literals, and optionally a match.
+     * @param lit       Pointer to the first literal.
+     * @param lit_len   Number of literals.
+     * @param offset    Match offset, or `0` for the last sequence, which has no match.
+     * @param match_len Match length, including `lz4_min_match`.
+     * @param dst       Output position.
+     * @param dst_end   End of the output buffer.
+     * @return          The new output position, or `nullptr` if the output buffer is too small.
+     */
+    inline std::uint8_t* lz4_put_sequence(const std::uint8_t* lit, std::size_t lit_len, std::size_t offset, std::size_t match_len, std::uint8_t* dst, std::uint8_t* dst_end) noexcept {
+        if (dst == dst_end) {
+            return nullptr;
+        }
+
+        std::uint8_t* token = dst++;
+        *token = static_cast<std::uint8_t>((lit_len < 15 ? lit_len : 15) << 4);
+
+        if (lit_len >= 15 && (dst = lz4_put_length(lit_len - 15, dst, dst_end)) == nullptr) {
+            return nullptr;
+        }
+
+        if (static_cast<std::size_t>(dst_end - dst) < lit_len) {
+            return nullptr;
+        }
+
+        std::memcpy(dst, lit, lit_len);
+        dst += lit_len;
+
+        if (offset != 0) {
+            if (dst_end - dst < 2) {
+                return nullptr;
+            }
+
+            *dst++ = static_cast<std::uint8_t>(offset & 0xff);
+            *dst++ = static_cast<std::uint8_t>(offset >> 8);
+
+            std::size_t len = match_len - lz4_min_match;
+            *token |= static_cast<std::uint8_t>(len < 15 ? len : 15);
+
+            if (len >= 15 && (dst = lz4_put_length(len - 15, dst, dst_end)) == nullptr) {
+                return nullptr;
+            }
+        }
+
+        return dst;
+    }
+
+
+    /**
+     * @brief              Compresses a buffer into the LZ4 block format.
+     * @details            A greedy, single-probe compressor. It favors speed and simplicity over ratio.
+     *                     The output can be decompressed by any LZ4 block decompressor.
+     * @param src          Pointer to the input.
+     * @param src_size     Input size in bytes.
+     * @param dst          Pointer to the output buffer.
+     * @param dst_capacity Size of the output buffer in bytes.
+     * @return             The compressed size, or `0` if the output does not fit in `dst_capacity`.
+     */
+    inline std::size_t lz4_compress(const void* src, std::size_t src_size, void* dst, std::size_t dst_capacity) noexcept {
+        const std::uint8_t* src_begin = reinterpret_cast<const std::uint8_t*>(src);
+        const std::uint8_t* src_end = src_begin + src_size;
+        std::uint8_t* dst_begin = reinterpret_cast<std::uint8_t*>(dst);
+        std::uint8_t* dst_end = dst_begin + dst_capacity;
+        std::uint8_t* op = dst_begin;
+
+        const std::uint8_t* anchor = src_begin;
+
+        if (src_size > lz4_match_limit) {
+            const std::uint8_t* ip = src_begin;
+            const std::uint8_t* match_start_limit = src_end - lz4_match_limit;
+            const std::uint8_t* match_end_limit = src_end - lz4_last_literals;
+
+            // Positions + 1 of the last occurrence of each hash. 0 = none.
+            std::uint32_t table[1 << lz4_hash_bits] = { };
+
+            while (ip < match_start_limit) {
+                std::uint32_t seq;
+                std::memcpy(&seq, ip, sizeof(seq));
+                std::uint32_t hash = (seq * 2654435761U) >> (32 - lz4_hash_bits);
+
+                std::uint32_t ref = table[hash];
+                table[hash] = static_cast<std::uint32_t>(ip - src_begin + 1);
+
+                // The match pointer may only be formed once there is a match, because src_begin - 1 is out of bounds.
+                if (ref == 0) {
+                    ip++;
+                    continue;
+                }
+
+                const std::uint8_t* match = src_begin + ref - 1;
+                if (static_cast<std::size_t>(ip - match) > lz4_max_offset || std::memcmp(match, ip, lz4_min_match) != 0) {
+                    ip++;
+                    continue;
+                }
+
+                std::size_t match_len = lz4_min_match;
+                while (ip + match_len < match_end_limit && ip[match_len] == match[match_len]) {
+                    match_len++;
+                }
+
+                op = lz4_put_sequence(anchor, ip - anchor, ip - match, match_len, op, dst_end);
+                if (op == nullptr) {
+                    return 0;
+                }
+
+                ip += match_len;
+                anchor = ip;
+            }
+        }
+
+        op = lz4_put_sequence(anchor, src_end - anchor, 0, 0, op, dst_end);
+        if (op == nullptr) {
+            return 0;
+        }
+
+        return op - dst_begin;
+    }
+
+
+    /**
+     * @brief              Decompresses a buffer in the LZ4 block format.
+     * @details            Validates every length and offset, so corrupt input cannot write outside the output buffer.
+     * @param src          Pointer to the compressed input.
+     * @param src_size     Compressed size in bytes.
+     * @param dst          Pointer to the output buffer.
+     * @param dst_capacity Size of the output buffer in bytes.
+     * @return             The decompressed size, or `0` if the input is corrupt or the output does not fit in `dst_capacity`.
+     */
+    inline std::size_t lz4_decompress(const void* src, std::size_t src_size, void* dst, std::size_t dst_capacity) noexcept {
+        const std::uint8_t* ip = reinterpret_cast<const std::uint8_t*>(src);
+        const std::uint8_t* src_end = ip + src_size;
+        std::uint8_t* dst_begin = reinterpret_cast<std::uint8_t*>(dst);
+        std::uint8_t* dst_end = dst_begin + dst_capacity;
+        std::uint8_t* op = dst_begin;
+
+        while (ip < src_end) {
+            std::uint8_t token = *ip++;
+
+            std::size_t lit_len = token >> 4;
+            if (lit_len == 15) {
+                std::uint8_t b;
+                do {
+                    if (ip == src_end) {
+                        return 0;
+                    }
+
+                    b = *ip++;
+                    lit_len += b;
+                }
+                while (b == 255);
+            }
+
+            if (static_cast<std::size_t>(src_end - ip) < lit_len || static_cast<std::size_t>(dst_end - op) < lit_len) {
+                return 0;
+            }
+
+            std::memcpy(op, ip, lit_len);
+            ip += lit_len;
+            op += lit_len;
+
+            // The last sequence has no match.
+            if (ip == src_end) {
+                break;
+            }
+
+            if (src_end - ip < 2) {
+                return 0;
+            }
+
+            std::size_t offset = ip[0] | (ip[1] << 8);
+            ip += 2;
+
+            if (offset == 0 || offset > static_cast<std::size_t>(op - dst_begin)) {
+                return 0;
+            }
+
+            std::size_t match_len = token & 0x0f;
+            if (match_len == 15) {
+                std::uint8_t b;
+                do {
+                    if (ip == src_end) {
+                        return 0;
+                    }
+
+                    b = *ip++;
+                    match_len += b;
+                }
+                while (b == 255);
+            }
+            match_len += lz4_min_match;
+
+            if (static_cast<std::size_t>(dst_end - op) < match_len) {
+                return 0;
+            }
+
+            // The match may overlap the output, so copy byte by byte.
+            const std::uint8_t* match = op - offset;
+            for (std::size_t i = 0; i < match_len; i++) {
+                op[i] = match[i];
+            }
+            op += match_len;
+        }
+
+        return op - dst_begin;
+    }
+
+}
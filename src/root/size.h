@@ -54,6 +54,9 @@ namespace abc {
         constexpr std::size_t k16  = 16 * k1;
         constexpr std::size_t k32  = 32 * k1;
         constexpr std::size_t k64  = 64 * k1;
+
+        constexpr std::size_t m1   = k1 * k1;
+        constexpr std::size_t m2   =  2 * m1;
     }
 
 }
@@ -108,9 +108,14 @@ namespace abc {
         std::va_list vlist_copy;
         va_copy(vlist_copy, vlist);
         int cap = std::vsnprintf(nullptr, 0, format, vlist_copy);
-        str.reserve(cap + 1);
+        va_end(vlist_copy);
 
-        std::vsnprintf(const_cast<char*>(str.data()), str.capacity(), format, vlist);
+        if (cap > 0) {
+            // Room for the terminating '\0', which vsnprintf always writes.
+            str.resize(cap + 1);
+            std::vsnprintf(&str[0], str.size(), format, vlist);
+            str.resize(cap);
+        }
 
         return str;
     }
@@ -25,10 +25,14 @@ SOFTWARE.
 
 #pragma once
 
+#include <cstddef>
+#include <string>
 #include <streambuf>
 #include <istream>
 #include <ostream>
 
+#include "../../root/ascii.h"
+
 
 namespace abc { namespace stream {
 
@@ -144,6 +148,33 @@ namespace abc { namespace stream {
     // --------------------------------------------------------------
 
 
+    /**
+     * @brief   Internal. Exposes the get area of any `std::streambuf`, so that the buffered chars could be scanned in place.
+     * @details The protected members are reached through pointers to members of this derived class, which are valid for any `std::streambuf`.
+     */
+    struct streambuf_get_area
+        : public std::streambuf {
+
+        /**
+         * @brief       Returns the range of buffered chars that have not been got yet.
+         * @param sb    `std::streambuf` pointer.
+         * @param begin Set to the first char.
+         * @param end   Set to the position after the last char.
+         */
+        static void get(std::streambuf* sb, const char*& begin, const char*& end);
+
+        /**
+         * @brief       Consumes buffered chars.
+         * @param sb    `std::streambuf` pointer.
+         * @param count Number of chars. Must not exceed the number of buffered chars.
+         */
+        static void consume(std::streambuf* sb, std::size_t count);
+    };
+
+
+    // --------------------------------------------------------------
+
+
     /**
      * @brief Common input stream functionality.
      */
@@ -181,6 +212,26 @@ namespace abc { namespace stream {
          */
         void reset();
 
+        /**
+         * @brief         Appends the chars of the given classes that are already in the get area of the streambuf, and consumes them.
+         * @details       Never reads from the underlying source, so it stops at the end of the get area as well as at the first char outside the classes.
+         *                Call `peek()` to refill the get area.
+         * @param chars   String to append to.
+         * @param cls     Classes of chars.
+         * @param max_len Maximum number of chars to consume.
+         * @return        The number of chars consumed.
+         */
+        std::size_t get_buffered(std::string& chars, ascii::char_class_t cls, std::size_t max_len);
+
+        /**
+         * @brief         Consumes the chars of the given classes that are already in the get area of the streambuf.
+         * @details       Never reads from the underlying source, so it stops at the end of the get area as well as at the first char outside the classes.
+         * @param cls     Classes of chars.
+         * @param max_len Maximum number of chars to consume.
+         * @return        The number of chars consumed.
+         */
+        std::size_t skip_buffered(ascii::char_class_t cls, std::size_t max_len);
+
         /**
          * @brief        Sets the `gcount` to the specified value.
          * @param gcount New value.
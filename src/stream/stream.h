@@ -25,6 +25,8 @@ SOFTWARE.
 
 #pragma once
 
+#include <algorithm>
+
 #include "i/stream.i.h"
 
 
@@ -143,6 +145,20 @@ namespace abc { namespace stream {
     // --------------------------------------------------------------
 
 
+    inline void streambuf_get_area::get(std::streambuf* sb, const char*& begin, const char*& end) {
+        begin = (sb->*&streambuf_get_area::gptr)();
+        end = (sb->*&streambuf_get_area::egptr)();
+    }
+
+
+    inline void streambuf_get_area::consume(std::streambuf* sb, std::size_t count) {
+        (sb->*&streambuf_get_area::gbump)(static_cast<int>(count));
+    }
+
+
+    // --------------------------------------------------------------
+
+
     inline istream::istream(std::streambuf* sb)
         : base(sb)
         , _gcount(0) {
@@ -165,6 +181,31 @@ namespace abc { namespace stream {
     }
 
 
+    inline std::size_t istream::get_buffered(std::string& chars, ascii::char_class_t cls, std::size_t max_len) {
+        const char* begin = nullptr;
+        const char* end = nullptr;
+        streambuf_get_area::get(base::rdbuf(), begin, end);
+
+        std::size_t len = ascii::scan_while(begin, std::min(static_cast<std::size_t>(end - begin), max_len), cls);
+        chars.append(begin, len);
+        streambuf_get_area::consume(base::rdbuf(), len);
+
+        return len;
+    }
+
+
+    inline std::size_t istream::skip_buffered(ascii::char_class_t cls, std::size_t max_len) {
+        const char* begin = nullptr;
+        const char* end = nullptr;
+        streambuf_get_area::get(base::rdbuf(), begin, end);
+
+        std::size_t len = ascii::scan_while(begin, std::min(static_cast<std::size_t>(end - begin), max_len), cls);
+        streambuf_get_area::consume(base::rdbuf(), len);
+
+        return len;
+    }
+
+
     inline void istream::set_gcount(std::size_t gcount) noexcept {
         _gcount = gcount;
     }
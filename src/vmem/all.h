@@ -30,5 +30,11 @@ SOFTWARE.
 #include "linked.h"
 #include "container.h"
 #include "list.h"
+#include "log.h"
+#include "vector.h"
+#include "priority_queue.h"
 #include "map.h"
+#include "indexed_map.h"
 #include "string.h"
+#include "scrubber.h"
+#include "restorer.h"
@@ -87,6 +87,149 @@ namespace abc { namespace vmem {
     // --------------------------------------------------------------
 
 
+    inline bool container_page_index::is_built() const noexcept {
+        return _is_built;
+    }
+
+
+    inline void container_page_index::build(std::vector<page_pos_t>&& page_positions, std::vector<std::size_t>&& item_counts) {
+        _page_positions = std::move(page_positions);
+        _item_counts = std::move(item_counts);
+        rebuild();
+
+        _is_built = true;
+    }
+
+
+    inline void container_page_index::drop() noexcept {
+        _is_built = false;
+        _page_positions.clear();
+        _item_counts.clear();
+        _tree.clear();
+        _slots.clear();
+    }
+
+
+    inline void container_page_index::add(page_pos_t page_pos, std::ptrdiff_t delta) {
+        if (!_is_built) {
+            return;
+        }
+
+        std::unordered_map<page_pos_t, std::size_t>::const_iterator itr = _slots.find(page_pos);
+        if (itr == _slots.cend()) {
+            drop();
+            return;
+        }
+
+        // Unsigned arithmetic wraps around, so negative deltas work too.
+        _item_counts[itr->second] += static_cast<std::size_t>(delta);
+        for (std::size_t i = itr->second + 1; i < _tree.size(); i += i & (~i + 1)) {
+            _tree[i] += static_cast<std::size_t>(delta);
+        }
+    }
+
+
+    inline void container_page_index::insert_page_after(page_pos_t after_page_pos, page_pos_t page_pos) {
+        if (!_is_built) {
+            return;
+        }
+
+        std::size_t slot = _page_positions.size();
+
+        if (after_page_pos != page_pos_nil) {
+            std::unordered_map<page_pos_t, std::size_t>::const_iterator itr = _slots.find(after_page_pos);
+            if (itr == _slots.cend()) {
+                drop();
+                return;
+            }
+
+            slot = itr->second + 1;
+        }
+
+        _page_positions.insert(_page_positions.begin() + slot, page_pos);
+        _item_counts.insert(_item_counts.begin() + slot, 0);
+        rebuild();
+    }
+
+
+    inline void container_page_index::erase_page(page_pos_t page_pos) {
+        if (!_is_built) {
+            return;
+        }
+
+        std::unordered_map<page_pos_t, std::size_t>::const_iterator itr = _slots.find(page_pos);
+        if (itr == _slots.cend()) {
+            drop();
+            return;
+        }
+
+        std::size_t slot = itr->second;
+        _page_positions.erase(_page_positions.begin() + slot);
+        _item_counts.erase(_item_counts.begin() + slot);
+        rebuild();
+    }
+
+
+    inline page_pos_t container_page_index::find(std::size_t index, std::size_t& item_pos) const noexcept {
+        // Descend the tree - find the last slot whose preceding items are not more than the index.
+        std::size_t slot = 0;
+        std::size_t remaining = index;
+
+        std::size_t step = 1;
+        while (2 * step < _tree.size()) {
+            step *= 2;
+        }
+
+        for (; step > 0; step /= 2) {
+            if (slot + step < _tree.size() && _tree[slot + step] <= remaining) {
+                slot += step;
+                remaining -= _tree[slot];
+            }
+        }
+
+        item_pos = remaining;
+        return slot < _page_positions.size() ? _page_positions[slot] : page_pos_nil;
+    }
+
+
+    inline bool container_page_index::count_before(page_pos_t page_pos, std::size_t& count) const {
+        std::unordered_map<page_pos_t, std::size_t>::const_iterator itr = _slots.find(page_pos);
+        if (itr == _slots.cend()) {
+            return false;
+        }
+
+        count = 0;
+        for (std::size_t i = itr->second; i > 0; i -= i & (~i + 1)) {
+            count += _tree[i];
+        }
+
+        return true;
+    }
+
+
+    inline void container_page_index::rebuild() {
+        std::size_t page_count = _page_positions.size();
+
+        _tree.assign(page_count + 1, 0);
+        for (std::size_t i = 1; i <= page_count; i++) {
+            _tree[i] += _item_counts[i - 1];
+
+            std::size_t parent = i + (i & (~i + 1));
+            if (parent <= page_count) {
+                _tree[parent] += _tree[i];
+            }
+        }
+
+        _slots.clear();
+        for (std::size_t slot = 0; slot < page_count; slot++) {
+            _slots[_page_positions[slot]] = slot;
+        }
+    }
+
+
+    // --------------------------------------------------------------
+
+
     template <typename T, typename Header>
     inline constexpr const char* container<T, Header>::origin() noexcept {
         return "abc::vmem::container";
@@ -138,10 +281,12 @@ namespace abc { namespace vmem {
         , _state(state)
         , _balance_insert(balance_insert)
         , _balance_erase(balance_erase)
-        , _pool(pool) {
+        , _pool(pool)
+        , _page_index()
+        , _page_index_state() {
 
         constexpr const char* suborigin = "container()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10443, "Begin: state=%p', balance_insert=%x, balance_erase=%x, pool=%p", state, balance_insert, balance_erase, pool);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10443, "Begin: state=%p', balance_insert=%x, balance_erase=%x, pool=%p", state, balance_insert, balance_erase, pool);
 
         diag_base::expect(suborigin, state != nullptr, 0x10444, "state != nullptr");
         diag_base::expect(suborigin, pool != nullptr, 0x10445, "pool != nullptr");
@@ -155,7 +300,7 @@ namespace abc { namespace vmem {
 
         diag_base::ensure(suborigin, _state->item_size == sizeof(T), 0x10448, "state != nullptr");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10449, "End: front_page_pos=0x%llx, back_page_pos=0x%llx", (unsigned long long)_state->front_page_pos, (unsigned long long)_state->back_page_pos);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10449, "End: front_page_pos=0x%llx, back_page_pos=0x%llx", (unsigned long long)_state->front_page_pos, (unsigned long long)_state->back_page_pos);
     }
 
 
@@ -319,7 +464,7 @@ namespace abc { namespace vmem {
     template <typename T, typename Header>
     inline typename container<T, Header>::result2 container<T, Header>::insert2(const_iterator itr, const_reference item) {
         constexpr const char* suborigin = "insert2()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1044c, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x, itr.edge=%u", (unsigned long long)itr.page_pos(), (unsigned)itr.item_pos(), itr.edge());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1044c, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x, itr.edge=%u", (unsigned long long)itr.page_pos(), (unsigned)itr.item_pos(), itr.edge());
 
         diag_base::expect(suborigin, itr.page_pos() != page_pos_nil || (itr.item_pos() == item_pos_nil && empty()), 0x1044a, "itr.page_pos() != page_pos_nil || (itr.item_pos() == item_pos_nil && empty()");
         diag_base::expect(suborigin, itr.item_pos() != item_pos_nil || (itr.page_pos() == _state->back_page_pos && itr.edge() == iterator_edge::end), 0x1044b, "itr.item_pos() != item_pos_nil && (itr.page_pos() == _state->back_page_pos && itr.edge() == iterator_edge::end)");
@@ -327,6 +472,8 @@ namespace abc { namespace vmem {
         // Copy the item to a local variable to make sure the reference is valid and copyable before we change any page.
         T item_copy(item);
 
+        begin_change();
+
         // Insert without changing the state.
         result2 result = insert_nostate(itr, item_copy);
         diag_base::expect(suborigin, result.iterator.can_deref(), 0x109de, "result.iterator.can_deref()");
@@ -347,9 +494,11 @@ namespace abc { namespace vmem {
         // Update the total item count.
         _state->total_item_count++;
 
+        end_change();
+
         diag_base::ensure(suborigin, result.iterator.can_deref(), 0x109df, "result.iterator.can_deref()");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1044d, "End: result.iterator.page_pos=0x%llx, result.iterator.item_pos=0x%x, result.iterator.edge=%u, result.page_pos=0x%llx, total_item_count=%zu",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1044d, "End: result.iterator.page_pos=0x%llx, result.iterator.item_pos=0x%x, result.iterator.edge=%u, result.page_pos=0x%llx, total_item_count=%zu",
                 (unsigned long long)result.iterator.page_pos(), result.iterator.item_pos(), result.iterator.edge(), (unsigned long long)result.page_leads[0].page_pos, (std::size_t)_state->total_item_count);
 
         return result;
@@ -366,7 +515,7 @@ namespace abc { namespace vmem {
     template <typename InputItr>
     inline typename container<T, Header>::iterator container<T, Header>::insert(const_iterator itr, InputItr first, InputItr last) {
         constexpr const char* suborigin = "insert(first, last)";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x109e0, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x, itr.edge=%u", (unsigned long long)itr.page_pos(), (unsigned)itr.item_pos(), itr.edge());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x109e0, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x, itr.edge=%u", (unsigned long long)itr.page_pos(), (unsigned)itr.item_pos(), itr.edge());
 
         iterator ret(itr);
 
@@ -375,7 +524,7 @@ namespace abc { namespace vmem {
             diag_base::ensure(suborigin, tmp_itr.can_deref(), 0x1044e, "tmp_itr.can_deref()");
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x109e1, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x109e1, "End:");
 
         return ret;
     }
@@ -384,7 +533,7 @@ namespace abc { namespace vmem {
     template <typename T, typename Header>
     inline typename container<T, Header>::result2 container<T, Header>::insert_nostate(const_iterator itr, const_reference item) {
         constexpr const char* suborigin = "insert_nostate";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1044f, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x, itr.edge=%u", (unsigned long long)itr.page_pos(), itr.item_pos(), itr.edge());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1044f, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x, itr.edge=%u", (unsigned long long)itr.page_pos(), itr.item_pos(), itr.edge());
 
         result2 result;
 
@@ -397,7 +546,7 @@ namespace abc { namespace vmem {
 
         diag_base::ensure(suborigin, result.iterator.can_deref(), 0x109e2, "result.iterator.can_deref()");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10450, "End: result.iterator.page_pos=0x%llx, result.iterator.item_pos=0x%x, result.iterator.edge=%u, result.page_pos=0x%llx",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10450, "End: result.iterator.page_pos=0x%llx, result.iterator.item_pos=0x%x, result.iterator.edge=%u, result.page_pos=0x%llx",
                 (unsigned long long)result.iterator.page_pos(), result.iterator.item_pos(), result.iterator.edge(), (unsigned long long)result.page_leads[0].page_pos);
 
         return result;
@@ -407,7 +556,7 @@ namespace abc { namespace vmem {
     template <typename T, typename Header>
     inline typename container<T, Header>::result2 container<T, Header>::insert_empty(const_reference item) {
         constexpr const char* suborigin = "insert_empty";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10451, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10451, "Begin:");
 
         vmem::page new_page(nullptr);
         vmem::container_page<T, Header>* new_container_page = nullptr;
@@ -421,7 +570,7 @@ namespace abc { namespace vmem {
         result2 result = insert_with_capacity(itr, item, new_container_page);
         diag_base::expect(suborigin, result.iterator.can_deref(), 0x109e6, "result.iterator.can_deref()");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10452, "End: result.iterator.page_pos=0x%llx, result.iterator.item_pos=0x%x, result.page_pos=0x%llx",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10452, "End: result.iterator.page_pos=0x%llx, result.iterator.item_pos=0x%x, result.page_pos=0x%llx",
                 (unsigned long long)result.iterator.page_pos(), result.iterator.item_pos(), (unsigned long long)result.page_leads[0].page_pos);
 
         return result;
@@ -431,7 +580,7 @@ namespace abc { namespace vmem {
     template <typename T, typename Header>
     inline typename container<T, Header>::result2 container<T, Header>::insert_nonempty(const_iterator itr, const_reference item) {
         constexpr const char* suborigin = "insert_nonempty";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10453, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x", (unsigned long long)itr.page_pos(), itr.item_pos());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10453, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x", (unsigned long long)itr.page_pos(), itr.item_pos());
 
         result2 result;
 
@@ -440,7 +589,7 @@ namespace abc { namespace vmem {
         diag_base::expect(suborigin, page.ptr() != nullptr, 0x10454, "page.ptr() != nullptr");
 
         vmem::container_page<T, Header>* container_page = reinterpret_cast<vmem::container_page<T, Header>*>(page.ptr());
-        diag_base::put_any(suborigin, diag::severity::verbose, 0x10455, "item_count=%u, page_capacity=%zu", container_page->item_count, (std::size_t)page_capacity());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::verbose, 0x10455, "item_count=%u, page_capacity=%zu", container_page->item_count, (std::size_t)page_capacity());
 
         if (container_page->item_count == page_capacity()) {
             // The page has no capacity.
@@ -453,7 +602,7 @@ namespace abc { namespace vmem {
 
         diag_base::ensure(suborigin, result.iterator.can_deref(), 0x109e8, "result.iterator.can_deref()");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10456, "End: result.iterator.page_pos=0x%llx, result.iterator.item_pos=0x%x, result.page_pos=0x%llx",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10456, "End: result.iterator.page_pos=0x%llx, result.iterator.item_pos=0x%x, result.page_pos=0x%llx",
                 (unsigned long long)result.iterator.page_pos(), result.iterator.item_pos(), (unsigned long long)result.page_leads[0].page_pos);
 
         return result;
@@ -463,7 +612,7 @@ namespace abc { namespace vmem {
     template <typename T, typename Header>
     inline typename container<T, Header>::result2 container<T, Header>::insert_with_overflow(const_iterator itr, const_reference item, container_page<T, Header>* container_page) {
         constexpr const char* suborigin = "insert_with_overflow";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10457, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x", (unsigned long long)itr.page_pos(), itr.item_pos());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10457, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x", (unsigned long long)itr.page_pos(), itr.item_pos());
 
         // Check whether we should balance before we do anything.
         bool should_balance = should_balance_insert(itr, container_page);
@@ -516,7 +665,7 @@ namespace abc { namespace vmem {
 
         diag_base::ensure(suborigin, result.iterator.can_deref(), 0x109ec, "result.iterator.can_deref()");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10458, "End: result.iterator.page_pos=0x%llx, result.iterator.item_pos=0x%x, result.page_pos=0x%llx",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10458, "End: result.iterator.page_pos=0x%llx, result.iterator.item_pos=0x%x, result.page_pos=0x%llx",
                 (unsigned long long)result.iterator.page_pos(), result.iterator.item_pos(), (unsigned long long)result.page_leads[0].page_pos);
 
         return result;
@@ -526,7 +675,7 @@ namespace abc { namespace vmem {
     template <typename T, typename Header>
     inline typename container<T, Header>::result2 container<T, Header>::insert_with_capacity(const_iterator itr, const_reference item, vmem::container_page<T, Header>* container_page) {
         constexpr const char* suborigin = "insert_with_overflow";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10459, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x", (unsigned long long)itr.page_pos(), itr.item_pos());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10459, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x", (unsigned long long)itr.page_pos(), itr.item_pos());
 
         result2 result;
         result.iterator = iterator(this, itr.page_pos(), itr.item_pos() != item_pos_nil ? itr.item_pos() : container_page->item_count, iterator_edge::none, diag_base::log());
@@ -558,12 +707,13 @@ namespace abc { namespace vmem {
 
         // Insert the item.
         ++container_page->item_count;
+        _page_index.add(result.iterator.page_pos(), 1);
         std::memmove(&container_page->items[result.iterator.item_pos()], &item, sizeof(T));
         diag_base::put_binary(suborigin, diag::severity::debug, 0x1045a, &container_page->items[result.iterator.item_pos()], std::min(sizeof(T), (std::size_t)16));
 
         diag_base::ensure(suborigin, result.iterator.can_deref(), 0x109ed, "result.iterator.can_deref()");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10459, "End: result.iterator.page_pos=0x%llx, result.iterator.item_pos=0x%x",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10459, "End: result.iterator.page_pos=0x%llx, result.iterator.item_pos=0x%x",
                 (unsigned long long)result.iterator.page_pos(), result.iterator.item_pos());
 
         return result;
@@ -573,7 +723,7 @@ namespace abc { namespace vmem {
     template <typename T, typename Header>
     inline void container<T, Header>::balance_split(page_pos_t page_pos, vmem::container_page<T, Header>* container_page, page_pos_t new_page_pos, vmem::container_page<T, Header>* new_container_page) {
         constexpr const char* suborigin = "balance_split";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1045c, "Begin: page_pos=0x%llx, new_page_pos=0x%llx", (unsigned long long)page_pos, (unsigned long long)new_page_pos);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1045c, "Begin: page_pos=0x%llx, new_page_pos=0x%llx", (unsigned long long)page_pos, (unsigned long long)new_page_pos);
 
         constexpr std::size_t new_page_item_count = page_capacity() / 2;
         constexpr std::size_t page_item_count = page_capacity() - new_page_item_count;
@@ -582,7 +732,10 @@ namespace abc { namespace vmem {
         new_container_page->item_count = new_page_item_count;
         container_page->item_count = page_item_count;
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1045d, "End: page_pos=0x%llx, item_count=%u, new_page_pos=0x%llx, new_item_count=%u",
+        _page_index.add(page_pos, -static_cast<std::ptrdiff_t>(new_page_item_count));
+        _page_index.add(new_page_pos, static_cast<std::ptrdiff_t>(new_page_item_count));
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1045d, "End: page_pos=0x%llx, item_count=%u, new_page_pos=0x%llx, new_item_count=%u",
                 (unsigned long long)page_pos, (unsigned)container_page->item_count, (unsigned long long)new_page_pos, (unsigned)new_container_page->item_count);
     }
 
@@ -590,7 +743,7 @@ namespace abc { namespace vmem {
     template <typename T, typename Header>
     inline void container<T, Header>::insert_page_after(page_pos_t after_page_pos, vmem::page& new_page, vmem::container_page<T, Header>*& new_container_page) {
         constexpr const char* suborigin = "insert_page_after";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1045e, "Begin: after_page_pos=0x%llx", (unsigned long long)after_page_pos);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1045e, "Begin: after_page_pos=0x%llx", (unsigned long long)after_page_pos);
 
         vmem::page new_page_local(_pool, diag_base::log());
         diag_base::expect(suborigin, new_page_local.ptr() != nullptr, 0x1045f, "new_page_local.ptr() != nullptr");
@@ -609,6 +762,8 @@ namespace abc { namespace vmem {
         linked_iterator new_itr = linked.insert(itr, new_page_local.pos());
         diag_base::expect(suborigin, new_itr != linked.end(), 0x109ee, "new_itr != linked.end()");
 
+        _page_index.insert_page_after(after_page_pos, new_page_local.pos());
+
         new_page = std::move(new_page_local);
         new_container_page = new_container_page_local;
 
@@ -616,7 +771,7 @@ namespace abc { namespace vmem {
         diag_base::ensure(suborigin, new_page.ptr() != nullptr, 0x109f0, "new_page.ptr() != nullptr");
         diag_base::ensure(suborigin, new_container_page_local == new_page.ptr(), 0x109f1, "new_container_page_local == new_page.ptr()");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10460, "End: after_page_pos=0x%llx, new_page_pos=0x%llx", (unsigned long long)after_page_pos, (unsigned long long)new_page.pos());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10460, "End: after_page_pos=0x%llx, new_page_pos=0x%llx", (unsigned long long)after_page_pos, (unsigned long long)new_page.pos());
     }
 
 
@@ -644,18 +799,22 @@ namespace abc { namespace vmem {
     template <typename T, typename Header>
     inline typename container<T, Header>::result2 container<T, Header>::erase2(const_iterator itr) {
         constexpr const char* suborigin = "erase2";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10462, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x, itr.edge=%u, total_item_count=%zu",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10462, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x, itr.edge=%u, total_item_count=%zu",
                 (unsigned long long)itr.page_pos(), (unsigned)itr.item_pos(), itr.edge(), (std::size_t)_state->total_item_count);
 
         diag_base::expect(suborigin, itr.can_deref(), 0x10461, "itr.can_deref()");
 
+        begin_change();
+
         result2 result = erase_nostate(itr);
         diag_base::expect(suborigin, result.iterator.is_valid(this), 0x109f2, "result.iterator.is_valid(this)");
 
         // Update the total item count.
         _state->total_item_count--;
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10463, "End: result.iterator.page_pos=0x%llx, result.iterator.item_pos=0x%x, result.iterator.edge=%u, total_item_count=%zu",
+        end_change();
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10463, "End: result.iterator.page_pos=0x%llx, result.iterator.item_pos=0x%x, result.iterator.edge=%u, total_item_count=%zu",
                 (unsigned long long)result.iterator.page_pos(), (unsigned)result.iterator.item_pos(), result.iterator.edge(), (std::size_t)_state->total_item_count);
 
         return result;
@@ -671,7 +830,7 @@ namespace abc { namespace vmem {
     template <typename T, typename Header>
     inline typename container<T, Header>::iterator container<T, Header>::erase(const_iterator first, const_iterator last) {
         constexpr const char* suborigin = "erase(first, last)";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x109f3, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x109f3, "Begin:");
 
         iterator itr = first;
 
@@ -679,7 +838,7 @@ namespace abc { namespace vmem {
             itr = erase(itr);
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x109f4, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x109f4, "End:");
 
         return itr;
     }
@@ -688,7 +847,7 @@ namespace abc { namespace vmem {
     template <typename T, typename Header>
     inline typename container<T, Header>::result2 container<T, Header>::erase_nostate(const_iterator itr) {
         constexpr const char* suborigin = "erase_nostate";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10465, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x, itr.edge=%u",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10465, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x, itr.edge=%u",
                 (unsigned long long)itr.page_pos(), (unsigned)itr.item_pos(), itr.edge());
 
         diag_base::expect(suborigin, itr.can_deref(), 0x109f5, "itr.can_deref()");
@@ -700,7 +859,7 @@ namespace abc { namespace vmem {
         diag_base::expect(suborigin, page.ptr() != nullptr, 0x10466, "page.ptr() != nullptr");
 
         vmem::container_page<T, Header>* container_page = reinterpret_cast<vmem::container_page<T, Header>*>(page.ptr());
-        diag_base::put_any(suborigin, diag::severity::verbose, 0x109f7, "item_count=%u, page_capacity=%zu", container_page->item_count, (std::size_t)page_capacity());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::verbose, 0x109f7, "item_count=%u, page_capacity=%zu", container_page->item_count, (std::size_t)page_capacity());
 
         if (container_page->item_count > 1) {
             bool should_balance = should_balance_erase(container_page, itr.item_pos());
@@ -723,7 +882,7 @@ namespace abc { namespace vmem {
         }
         else {
             // Erasing the only item on a page means erasing the page.
-            diag_base::put_any(suborigin, diag::severity::optional, 0x10467, "Erase from one");
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10467, "Erase from one");
 
             if (container_page->next_page_pos != page_pos_nil) {
                 result.iterator = iterator(this, container_page->next_page_pos, 0, iterator_edge::none, diag_base::log());
@@ -744,7 +903,7 @@ namespace abc { namespace vmem {
 
         diag_base::ensure(suborigin, result.iterator.is_valid(this), 0x109f8, "result.iterator.is_valid(this)");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10468, "End: result.iterator.page_pos=0x%llx, result.iterator.item_pos=0x%x, result.iterator.edge=%u",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10468, "End: result.iterator.page_pos=0x%llx, result.iterator.item_pos=0x%x, result.iterator.edge=%u",
                 (unsigned long long)result.iterator.page_pos(), (unsigned)result.iterator.item_pos(), result.iterator.edge());
 
         return result;
@@ -754,7 +913,7 @@ namespace abc { namespace vmem {
     template <typename T, typename Header>
     inline typename container<T, Header>::result2 container<T, Header>::erase_from_many(const_iterator itr, vmem::container_page<T, Header>* container_page) {
         constexpr const char* suborigin = "erase_from_many";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10469, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x, itr.edge=%u",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10469, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x, itr.edge=%u",
                 (unsigned long long)itr.page_pos(), (unsigned)itr.item_pos(), itr.edge());
 
         diag_base::expect(suborigin, itr.can_deref(), 0x109f9, "itr.can_deref()");
@@ -772,7 +931,7 @@ namespace abc { namespace vmem {
             }
 
             // To delete an item before the last one, pull up the remaining elements.
-            diag_base::put_any(suborigin, diag::severity::optional, 0x1046a, "Middle: itr.item_pos=0x%x, item_count=%u", (unsigned)itr.item_pos(), (unsigned)container_page->item_count);
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x1046a, "Middle: itr.item_pos=0x%x, item_count=%u", (unsigned)itr.item_pos(), (unsigned)container_page->item_count);
 
             std::size_t move_item_count = container_page->item_count - itr.item_pos() - 1;
             std::memmove(&container_page->items[itr.item_pos()], &container_page->items[itr.item_pos() + 1], move_item_count * sizeof(T));
@@ -781,7 +940,7 @@ namespace abc { namespace vmem {
         }
         else {
             // To delete the last (back) item on a page, there is nothing to do.
-            diag_base::put_any(suborigin, diag::severity::optional, 0x1046b, "Last: itr.item_pos=0x%x, item_count=%u", (unsigned)itr.item_pos(), (unsigned)container_page->item_count);
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x1046b, "Last: itr.item_pos=0x%x, item_count=%u", (unsigned)itr.item_pos(), (unsigned)container_page->item_count);
 
             // If we are deleting the last item on a page, the next item is item 0 on the next page or end().
             if (container_page->next_page_pos != page_pos_nil) {
@@ -794,10 +953,11 @@ namespace abc { namespace vmem {
 
         // The main part of deleting an item from a page is decrementing the count.
         container_page->item_count--;
+        _page_index.add(itr.page_pos(), -1);
 
         diag_base::ensure(suborigin, result.iterator.is_valid(this), 0x109fa, "result.iterator.is_valid(this)");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1046c, "End: result.iterator.page_pos=0x%llx, result.iterator.item_pos=0x%x, result.iterator.edge=%u",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1046c, "End: result.iterator.page_pos=0x%llx, result.iterator.item_pos=0x%x, result.iterator.edge=%u",
                 (unsigned long long)result.iterator.page_pos(), (unsigned)result.iterator.item_pos(), result.iterator.edge());
 
         return result;
@@ -807,7 +967,7 @@ namespace abc { namespace vmem {
     template <typename T, typename Header>
     inline typename container<T, Header>::result2 container<T, Header>::balance_merge(const_iterator itr, vmem::page& page, vmem::container_page<T, Header>* container_page) {
         constexpr const char* suborigin = "balance_merge";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1046d, "Begin: page_pos=0x%llx", (unsigned long long)page.pos());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1046d, "Begin: page_pos=0x%llx", (unsigned long long)page.pos());
 
         result2 result;
         result.iterator = itr;
@@ -820,7 +980,7 @@ namespace abc { namespace vmem {
 
         diag_base::ensure(suborigin, result.iterator.is_valid(this), 0x109fb, "result.iterator.is_valid(this)");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1046e, "End: result.iterator.page_pos=0x%llx, result.iterator.item_pos=0x%x, result.iterator.edge=%u",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1046e, "End: result.iterator.page_pos=0x%llx, result.iterator.item_pos=0x%x, result.iterator.edge=%u",
                 (unsigned long long)result.iterator.page_pos(), (unsigned)result.iterator.item_pos(), result.iterator.edge());
 
         return result;
@@ -830,7 +990,7 @@ namespace abc { namespace vmem {
     template <typename T, typename Header>
     inline typename container<T, Header>::result2 container<T, Header>::balance_merge_next(const_iterator itr, vmem::page& page, vmem::container_page<T, Header>* container_page) {
         constexpr const char* suborigin = "balance_merge_next";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1046f, "Begin: page_pos=0x%llx", (unsigned long long)page.pos());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1046f, "Begin: page_pos=0x%llx", (unsigned long long)page.pos());
 
         result2 result;
         result.iterator = itr;
@@ -840,7 +1000,7 @@ namespace abc { namespace vmem {
         diag_base::expect(suborigin, next_page.ptr() != nullptr, 0x10470, "next_page.ptr() != nullptr");
 
         vmem::container_page<T, Header>* next_container_page = reinterpret_cast<vmem::container_page<T, Header>*>(next_page.ptr());
-        diag_base::put_any(suborigin, diag::severity::optional, 0x10471, "page_item_count=%u, next_page_pos=0x%llx, next_page_item_count=%u",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10471, "page_item_count=%u, next_page_pos=0x%llx, next_page_item_count=%u",
                 (unsigned)container_page->item_count, (unsigned long long)next_page.pos(), (unsigned)next_container_page->item_count);
 
         if (container_page->item_count + next_container_page->item_count <= page_capacity()) {
@@ -859,7 +1019,9 @@ namespace abc { namespace vmem {
             }
 
             // Update the item count on this page.
+            // The next page takes its own item count out of the page index when it is erased.
             container_page->item_count += next_container_page->item_count;
+            _page_index.add(page.pos(), static_cast<std::ptrdiff_t>(next_container_page->item_count));
 
             // Free the next page.
             erase_page(next_page);
@@ -868,7 +1030,7 @@ namespace abc { namespace vmem {
 
         diag_base::ensure(suborigin, result.iterator.is_valid(this), 0x109fd, "result.iterator.is_valid(this)");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10473, "End: result.iterator.page_pos=0x%llx, result.iterator.item_pos=0x%x, result.iterator.edge=%u",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10473, "End: result.iterator.page_pos=0x%llx, result.iterator.item_pos=0x%x, result.iterator.edge=%u",
                 (unsigned long long)result.iterator.page_pos(), (unsigned)result.iterator.item_pos(), result.iterator.edge());
 
         return result;
@@ -878,25 +1040,27 @@ namespace abc { namespace vmem {
     template <typename T, typename Header>
     inline void container<T, Header>::erase_page(vmem::page& page) {
         constexpr const char* suborigin = "erase_page";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10479, "Begin: page_pos=0x%llx", (unsigned long long)page.pos());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10479, "Begin: page_pos=0x%llx", (unsigned long long)page.pos());
 
         page_pos_t page_pos = page.pos();
         erase_page_pos(page_pos);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1047a, "End: page_pos=0x%llx", (unsigned long long)page_pos);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1047a, "End: page_pos=0x%llx", (unsigned long long)page_pos);
     }
 
 
     template <typename T, typename Header>
     inline void container<T, Header>::erase_page_pos(page_pos_t page_pos) {
         constexpr const char* suborigin = "erase_page_pos";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1047b, "Begin: page_pos=0x%llx", (unsigned long long)page_pos);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1047b, "Begin: page_pos=0x%llx", (unsigned long long)page_pos);
 
         vmem::linked linked(_state, _pool, diag_base::log());
         linked_iterator itr(&linked, page_pos, item_pos_nil, iterator_edge::none, diag_base::log());
         linked.erase(itr);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1047c, "End: page_pos=0x%llx", (unsigned long long)page_pos);
+        _page_index.erase_page(page_pos);
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1047c, "End: page_pos=0x%llx", (unsigned long long)page_pos);
     }
 
 
@@ -927,6 +1091,122 @@ namespace abc { namespace vmem {
         linked.clear();
 
         _state->total_item_count = 0;
+
+        _page_index.drop();
+    }
+
+
+    template <typename T, typename Header>
+    inline void container<T, Header>::compact() {
+        vmem::linked linked(_state, _pool, diag_base::log());
+        linked.compact();
+
+        // Pages have been relocated.
+        _page_index.drop();
+    }
+
+
+    // ..............................................................
+
+
+    template <typename T, typename Header>
+    inline typename container<T, Header>::reference container<T, Header>::operator [](std::size_t index) {
+        return iterator_at(index).deref();
+    }
+
+
+    template <typename T, typename Header>
+    inline typename container<T, Header>::const_reference container<T, Header>::operator [](std::size_t index) const {
+        return iterator_at(index).deref();
+    }
+
+
+    template <typename T, typename Header>
+    inline typename container<T, Header>::iterator container<T, Header>::iterator_at(std::size_t index) const {
+        constexpr const char* suborigin = "iterator_at()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10cbe, "Begin: index=%zu, size=%zu", index, size());
+
+        diag_base::expect(suborigin, index <= size(), 0x10cbf, "index <= size()");
+
+        iterator result = end_itr();
+
+        if (index < size()) {
+            sync_page_index();
+
+            std::size_t item_pos;
+            page_pos_t page_pos = _page_index.find(index, item_pos);
+            diag_base::ensure(suborigin, page_pos != page_pos_nil, 0x10ffe, "page_pos != page_pos_nil");
+
+            result = iterator(this, page_pos, static_cast<item_pos_t>(item_pos), iterator_edge::none, diag_base::log());
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10cc0, "End: result.page_pos=0x%llx, result.item_pos=0x%x, result.edge=%u",
+                (unsigned long long)result.page_pos(), (unsigned)result.item_pos(), result.edge());
+
+        return result;
+    }
+
+
+    template <typename T, typename Header>
+    inline std::size_t container<T, Header>::index_of(const_iterator itr) const {
+        constexpr const char* suborigin = "index_of()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10cc1, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x, itr.edge=%u",
+                (unsigned long long)itr.page_pos(), (unsigned)itr.item_pos(), itr.edge());
+
+        diag_base::expect(suborigin, itr.is_valid(this), 0x10cc2, "itr.is_valid(this)");
+        diag_base::expect(suborigin, itr.is_end() || itr.can_deref(), 0x10cc3, "itr.is_end() || itr.can_deref()");
+
+        std::size_t result = size();
+
+        if (!itr.is_end()) {
+            sync_page_index();
+
+            std::size_t count_before;
+            bool is_indexed = _page_index.count_before(itr.page_pos(), count_before);
+            diag_base::ensure(suborigin, is_indexed, 0x10fff, "is_indexed");
+
+            result = count_before + itr.item_pos();
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10cc4, "End: result=%zu", result);
+
+        return result;
+    }
+
+
+    template <typename T, typename Header>
+    inline typename container<T, Header>::iterator container<T, Header>::advance(const_iterator itr, std::ptrdiff_t n) const {
+        constexpr const char* suborigin = "advance()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10cc5, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x, itr.edge=%u, n=%lld",
+                (unsigned long long)itr.page_pos(), (unsigned)itr.item_pos(), itr.edge(), (long long)n);
+
+        diag_base::expect(suborigin, itr.is_valid(this), 0x10cc6, "itr.is_valid(this)");
+
+        // rbegin() is right before index 0.
+        std::ptrdiff_t index = itr.is_rbegin() ? -1 : static_cast<std::ptrdiff_t>(index_of(itr));
+        index += n;
+
+        iterator result = end_itr();
+
+        if (index < 0) {
+            result = rbegin_itr();
+        }
+        else if (static_cast<std::size_t>(index) < size()) {
+            result = iterator_at(static_cast<std::size_t>(index));
+        }
+
+        diag_base::ensure(suborigin, result.is_valid(this), 0x10cc7, "result.is_valid(this)");
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10cc8, "End: result.page_pos=0x%llx, result.item_pos=0x%x, result.edge=%u",
+                (unsigned long long)result.page_pos(), (unsigned)result.item_pos(), result.edge());
+
+        return result;
+    }
+
+
+    template <typename T, typename Header>
+    inline std::ptrdiff_t container<T, Header>::distance(const_iterator first, const_iterator last) const {
+        return static_cast<std::ptrdiff_t>(index_of(last)) - static_cast<std::ptrdiff_t>(index_of(first));
     }
 
 
@@ -936,7 +1216,7 @@ namespace abc { namespace vmem {
     template <typename T, typename Header>
     inline typename container<T, Header>::iterator container<T, Header>::next(const iterator_state& itr) const {
         constexpr const char* suborigin = "next";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1047d, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x, itr.edge=%u",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1047d, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x, itr.edge=%u",
                 (unsigned long long)itr.page_pos(), (unsigned)itr.item_pos(), itr.edge());
 
         diag_base::expect(suborigin, itr.is_valid(this), 0x109fe, "itr.is_valid(this)");
@@ -953,7 +1233,7 @@ namespace abc { namespace vmem {
             diag_base::expect(suborigin, page.ptr() != nullptr, 0x1047e, "page.ptr() != nullptr");
 
             vmem::container_page<T, Header>* container_page = reinterpret_cast<vmem::container_page<T, Header>*>(page.ptr());
-            diag_base::put_any(suborigin, diag::severity::verbose, 0x10a01, "item_count=%u, page_capacity=%zu", container_page->item_count, (std::size_t)page_capacity());
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::verbose, 0x10a01, "item_count=%u, page_capacity=%zu", container_page->item_count, (std::size_t)page_capacity());
 
             if (itr.item_pos() < container_page->item_count - 1) {
                 result = iterator(this, itr.page_pos(), itr.item_pos() + 1, iterator_edge::none, diag_base::log());
@@ -968,7 +1248,7 @@ namespace abc { namespace vmem {
 
         diag_base::ensure(suborigin, result.is_valid(this), 0x10a02, "result.is_valid(this)");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1047f, "End: result.page_pos=0x%llx, result.item_pos=0x%x, result.edge=%u",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1047f, "End: result.page_pos=0x%llx, result.item_pos=0x%x, result.edge=%u",
                 (unsigned long long)result.page_pos(), (unsigned)result.item_pos(), result.edge());
 
         return result;
@@ -978,7 +1258,7 @@ namespace abc { namespace vmem {
     template <typename T, typename Header>
     inline typename container<T, Header>::iterator container<T, Header>::prev(const iterator_state& itr) const {
         constexpr const char* suborigin = "prev";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10480, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x, itr.edge=%u",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10480, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x, itr.edge=%u",
                 (unsigned long long)itr.page_pos(), (unsigned)itr.item_pos(), itr.edge());
 
         diag_base::expect(suborigin, itr.is_valid(this), 0x10a03, "itr.is_valid(this)");
@@ -995,7 +1275,7 @@ namespace abc { namespace vmem {
             diag_base::expect(suborigin, page.ptr() != nullptr, 0x10481, "page.ptr() != nullptr");
 
             vmem::container_page<T, Header>* container_page = reinterpret_cast<vmem::container_page<T, Header>*>(page.ptr());
-            diag_base::put_any(suborigin, diag::severity::verbose, 0x10a06, "item_count=%u, page_capacity=%zu", container_page->item_count, (std::size_t)page_capacity());
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::verbose, 0x10a06, "item_count=%u, page_capacity=%zu", container_page->item_count, (std::size_t)page_capacity());
 
             if (itr.item_pos() > 0) {
                 result = iterator(this, itr.page_pos(), itr.item_pos() - 1, iterator_edge::none, diag_base::log());
@@ -1008,7 +1288,7 @@ namespace abc { namespace vmem {
                     diag_base::expect(suborigin, page.ptr() != nullptr, 0x10482, "page.ptr() != nullptr");
 
                     vmem::container_page<T, Header>* prev_container_page = reinterpret_cast<vmem::container_page<T, Header>*>(prev_page.ptr());
-                    diag_base::put_any(suborigin, diag::severity::verbose, 0x10a08, "item_count=%u, page_capacity=%zu", prev_container_page->item_count, (std::size_t)page_capacity());
+                    ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::verbose, 0x10a08, "item_count=%u, page_capacity=%zu", prev_container_page->item_count, (std::size_t)page_capacity());
 
                     result = iterator(this, container_page->prev_page_pos, prev_container_page->item_count - 1, iterator_edge::none, diag_base::log());
                 }
@@ -1017,7 +1297,7 @@ namespace abc { namespace vmem {
 
         diag_base::ensure(suborigin, result.is_valid(this), 0x10a09, "result.is_valid(this)");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10483, "End: result.page_pos=0x%llx, result.item_pos=0x%x, result.edge=%u",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10483, "End: result.page_pos=0x%llx, result.item_pos=0x%x, result.edge=%u",
                 (unsigned long long)result.page_pos(), (unsigned)result.item_pos(), result.edge());
 
         return result;
@@ -1027,7 +1307,7 @@ namespace abc { namespace vmem {
     template <typename T, typename Header>
     inline typename container<T, Header>::pointer container<T, Header>::at(const iterator_state& itr) const {
         constexpr const char* suborigin = "at";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a0a, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x, itr.edge=%u",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a0a, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x, itr.edge=%u",
                 (unsigned long long)itr.page_pos(), (unsigned)itr.item_pos(), itr.edge());
 
         diag_base::expect(suborigin, itr.is_valid(this), 0x10a0b, "itr.is_valid(this)");
@@ -1039,7 +1319,7 @@ namespace abc { namespace vmem {
 
         pointer result(_pool, itr.page_pos(), byte_pos, diag_base::log());
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a0c, "End: result.page_pos=0x%llx, result.byte_pos=0x%x",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a0c, "End: result.page_pos=0x%llx, result.byte_pos=0x%x",
                 (unsigned long long)result.page_pos(), (unsigned)result.byte_pos());
 
         return result;
@@ -1049,7 +1329,7 @@ namespace abc { namespace vmem {
     template <typename T, typename Header>
     inline typename container<T, Header>::iterator container<T, Header>::begin_itr() const {
         constexpr const char* suborigin = "begin_itr";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a0d, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a0d, "Begin:");
 
         // If the container is empty, set to "end".
         iterator result(this, _state->back_page_pos, item_pos_nil, iterator_edge::end, diag_base::log());
@@ -1059,7 +1339,7 @@ namespace abc { namespace vmem {
             result = iterator(this, _state->front_page_pos, 0, iterator_edge::none, diag_base::log());
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10484, "End: result.page_pos=0x%llx, result.item_pos=0x%x, result.edge=%u",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10484, "End: result.page_pos=0x%llx, result.item_pos=0x%x, result.edge=%u",
                 (unsigned long long)result.page_pos(), (unsigned)result.item_pos(), result.edge());
 
         return result;
@@ -1069,12 +1349,12 @@ namespace abc { namespace vmem {
     template <typename T, typename Header>
     inline typename container<T, Header>::iterator container<T, Header>::end_itr() const {
         constexpr const char* suborigin = "end_itr";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a0e, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a0e, "Begin:");
 
         // Empty or not, set to "end".
         iterator result(this, _state->back_page_pos, item_pos_nil, iterator_edge::end, diag_base::log());
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10486, "End: result.page_pos=0x%llx, result.item_pos=0x%x, result.edge=%u",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10486, "End: result.page_pos=0x%llx, result.item_pos=0x%x, result.edge=%u",
                 (unsigned long long)result.page_pos(), (unsigned)result.item_pos(), result.edge());
 
         return result;
@@ -1084,7 +1364,7 @@ namespace abc { namespace vmem {
     template <typename T, typename Header>
     inline typename container<T, Header>::reverse_iterator container<T, Header>::rend_itr() const {
         constexpr const char* suborigin = "rend_itr";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a0f, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a0f, "Begin:");
 
         // If the container is empty, set to "rbegin".
         iterator result(this, _state->front_page_pos, item_pos_nil, iterator_edge::rbegin, diag_base::log());
@@ -1096,12 +1376,12 @@ namespace abc { namespace vmem {
             diag_base::expect(suborigin, back_page.ptr() != nullptr, 0x10487, "back_page.ptr() != nullptr");
 
             vmem::container_page<T, Header>* back_container_page = reinterpret_cast<vmem::container_page<T, Header>*>(back_page.ptr());
-            diag_base::put_any(suborigin, diag::severity::verbose, 0x10a11, "item_count=%u, page_capacity=%zu", back_container_page->item_count, (std::size_t)page_capacity());
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::verbose, 0x10a11, "item_count=%u, page_capacity=%zu", back_container_page->item_count, (std::size_t)page_capacity());
 
             result = iterator(this, _state->back_page_pos, back_container_page->item_count - 1, iterator_edge::none, diag_base::log());
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10488, "End: result.page_pos=0x%llx, result.item_pos=0x%x, result.edge=%u",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10488, "End: result.page_pos=0x%llx, result.item_pos=0x%x, result.edge=%u",
                 (unsigned long long)result.page_pos(), (unsigned)result.item_pos(), result.edge());
 
         return result;
@@ -1111,18 +1391,113 @@ namespace abc { namespace vmem {
     template <typename T, typename Header>
     inline typename container<T, Header>::reverse_iterator container<T, Header>::rbegin_itr() const {
         constexpr const char* suborigin = "rbegin_itr";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a12, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a12, "Begin:");
 
         // Empty or not, set to "rbegin".
         iterator result(this, _state->front_page_pos, item_pos_nil, iterator_edge::rbegin, diag_base::log());
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10488, "End: result.page_pos=0x%llx, result.item_pos=0x%x, result.edge=%u",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10488, "End: result.page_pos=0x%llx, result.item_pos=0x%x, result.edge=%u",
                 (unsigned long long)result.page_pos(), (unsigned)result.item_pos(), result.edge());
 
         return result;
     }
 
 
+    template <typename T, typename Header>
+    inline item_pos_t container<T, Header>::page_item_count(page_pos_t page_pos, page_pos_t& prev_page_pos, page_pos_t& next_page_pos) const {
+        constexpr const char* suborigin = "page_item_count()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10cc9, "Begin: page_pos=0x%llx", (unsigned long long)page_pos);
+
+        vmem::page page(_pool, page_pos, diag_base::log());
+        diag_base::expect(suborigin, page.pos() == page_pos, 0x10cca, "page.pos() == page_pos");
+        diag_base::expect(suborigin, page.ptr() != nullptr, 0x10ccb, "page.ptr() != nullptr");
+
+        const vmem::container_page<T, Header>* container_page = reinterpret_cast<const vmem::container_page<T, Header>*>(page.ptr());
+        prev_page_pos = container_page->prev_page_pos;
+        next_page_pos = container_page->next_page_pos;
+        item_pos_t item_count = container_page->item_count;
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10ccc, "End: item_count=%u, prev_page_pos=0x%llx, next_page_pos=0x%llx",
+                (unsigned)item_count, (unsigned long long)prev_page_pos, (unsigned long long)next_page_pos);
+
+        return item_count;
+    }
+
+
+    // ..............................................................
+
+
+    template <typename T, typename Header>
+    inline void container<T, Header>::sync_page_index() const {
+        constexpr const char* suborigin = "sync_page_index()";
+
+        if (_page_index.is_built() && is_page_index_current()) {
+            return;
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x11000, "Begin: total_item_count=%zu", (std::size_t)_state->total_item_count);
+
+        // Walk the page headers once.
+        std::vector<page_pos_t> page_positions;
+        std::vector<std::size_t> item_counts;
+        std::size_t total_item_count = 0;
+
+        for (page_pos_t page_pos = _state->front_page_pos; page_pos != page_pos_nil; ) {
+            page_pos_t prev_page_pos;
+            page_pos_t next_page_pos;
+            item_pos_t item_count = page_item_count(page_pos, prev_page_pos, next_page_pos);
+
+            page_positions.push_back(page_pos);
+            item_counts.push_back(item_count);
+            total_item_count += item_count;
+
+            page_pos = next_page_pos;
+        }
+
+        diag_base::ensure(suborigin, total_item_count == size(), 0x11001, "total_item_count == size()");
+
+        _page_index.build(std::move(page_positions), std::move(item_counts));
+        stamp_page_index();
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x11002, "End: total_item_count=%zu", total_item_count);
+    }
+
+
+    template <typename T, typename Header>
+    inline bool container<T, Header>::is_page_index_current() const noexcept {
+        return _page_index_state.front_page_pos == _state->front_page_pos
+            && _page_index_state.back_page_pos == _state->back_page_pos
+            && _page_index_state.total_item_count == _state->total_item_count;
+    }
+
+
+    template <typename T, typename Header>
+    inline void container<T, Header>::stamp_page_index() const noexcept {
+        _page_index_state.front_page_pos = _state->front_page_pos;
+        _page_index_state.back_page_pos = _state->back_page_pos;
+        _page_index_state.total_item_count = _state->total_item_count;
+    }
+
+
+    template <typename T, typename Header>
+    inline void container<T, Header>::begin_change() {
+        if (_page_index.is_built() && !is_page_index_current()) {
+            _page_index.drop();
+        }
+
+        // Until end_change(), the index doesn't match any state, so that it gets rebuilt if the change fails midway.
+        _page_index_state.total_item_count = static_cast<std::size_t>(-1);
+    }
+
+
+    template <typename T, typename Header>
+    inline void container<T, Header>::end_change() {
+        if (_page_index.is_built()) {
+            stamp_page_index();
+        }
+    }
+
+
     // --------------------------------------------------------------
 
 } }
@@ -39,12 +39,14 @@ namespace abc { namespace vmem {
     using count_t    = std::uint32_t;
 
 
-    constexpr std::size_t page_size             = size::k4;
-    constexpr page_pos_t  page_pos_root         = 0;
-    constexpr page_pos_t  page_pos_start        = 1;
-    constexpr page_pos_t  page_pos_nil          = static_cast<page_pos_t>(ULLONG_MAX);
-    constexpr item_pos_t  item_pos_nil          = static_cast<item_pos_t>(USHRT_MAX);
-    constexpr std::size_t min_mapped_page_count = 3;
+    constexpr std::size_t page_size              = size::k4;
+    constexpr page_pos_t  page_pos_root          = 0;
+    constexpr page_pos_t  page_pos_start         = 1;
+    constexpr page_pos_t  page_pos_nil           = static_cast<page_pos_t>(ULLONG_MAX);
+    constexpr item_pos_t  item_pos_nil           = static_cast<item_pos_t>(USHRT_MAX);
+    constexpr std::size_t min_mapped_page_count  = 3;
+    constexpr std::size_t huge_extent_size       = size::m2;
+    constexpr page_pos_t  huge_extent_page_count = huge_extent_size / page_size;
 
 
     // --------------------------------------------------------------
@@ -61,6 +63,16 @@ namespace abc { namespace vmem {
     };
 
 
+    /**
+     * @brief   Information about a mapped extent of `huge_extent_page_count` pages.
+     * @details Only used when `pool_config::use_huge_pages` is set.
+     */
+    struct mapped_extent {
+        void*      ptr;
+        count_t    page_count;
+    };
+
+
     // --------------------------------------------------------------
 
 } }
@@ -25,6 +25,9 @@ SOFTWARE.
 
 #pragma once
 
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
 
 #include "../../root/size.h"
 #include "../../diag/i/diag_ready.i.h"
@@ -220,6 +223,116 @@ namespace abc { namespace vmem {
     // --------------------------------------------------------------
 
 
+    /**
+     * @brief   In-memory index of the item counts of the pages of a container in chain order.
+     * @details Finds the page of an item by its positional index, and counts the items before a page, in O(log(page count)) without mapping any page.
+     *          Changing the item count of a page costs O(log(page count)).
+     *          Inserting or erasing a page costs O(page count) in memory, which is amortized over the items that fill a page.
+     */
+    class container_page_index {
+    public:
+        /**
+         * @brief Constructor. The index is not built.
+         */
+        container_page_index() = default;
+
+        /**
+         * @brief Move constructor.
+         */
+        container_page_index(container_page_index&& other) noexcept = default;
+
+        /**
+         * @brief Copy constructor.
+         */
+        container_page_index(const container_page_index& other) = default;
+
+    public:
+        /**
+         * @brief Returns `true` if the index has been built, and has not been dropped since.
+         */
+        bool        is_built() const noexcept;
+
+        /**
+         * @brief                Builds the index.
+         * @param page_positions Page positions in chain order.
+         * @param item_counts    Item counts of the pages.
+         */
+        void        build(std::vector<page_pos_t>&& page_positions, std::vector<std::size_t>&& item_counts);
+
+        /**
+         * @brief Drops the index, so that it has to be built again.
+         */
+        void        drop() noexcept;
+
+        /**
+         * @brief          Changes the item count of a page.
+         * @details        If the page is not indexed, the index is dropped.
+         * @param page_pos Page position.
+         * @param delta    Item count change. May be negative.
+         */
+        void        add(page_pos_t page_pos, std::ptrdiff_t delta);
+
+        /**
+         * @brief                Adds an empty page.
+         * @details              If the preceding page is not indexed, the index is dropped.
+         * @param after_page_pos Position of the preceding page. `page_pos_nil` = the page is appended.
+         * @param page_pos       Page position.
+         */
+        void        insert_page_after(page_pos_t after_page_pos, page_pos_t page_pos);
+
+        /**
+         * @brief          Removes a page together with its item count.
+         * @details        If the page is not indexed, the index is dropped.
+         * @param page_pos Page position.
+         */
+        void        erase_page(page_pos_t page_pos);
+
+        /**
+         * @brief          Finds the page that contains the item with a given positional index.
+         * @param index    Zero-based index of the item. Must be less than the total item count.
+         * @param item_pos Receives the position of the item on the page.
+         * @return         Page position.
+         */
+        page_pos_t  find(std::size_t index, std::size_t& item_pos) const noexcept;
+
+        /**
+         * @brief          Returns the number of items on the pages before a given page.
+         * @param page_pos Page position.
+         * @param count    Receives the number of items.
+         * @return         `false` = the page is not indexed.
+         */
+        bool        count_before(page_pos_t page_pos, std::size_t& count) const;
+
+    private:
+        /**
+         * @brief Rebuilds the tree and the page slots from the page positions and the item counts.
+         */
+        void        rebuild();
+
+    private:
+        bool                                          _is_built = false;
+
+        /**
+         * @brief Page positions and item counts in chain order.
+         */
+        std::vector<page_pos_t>                       _page_positions;
+        std::vector<std::size_t>                      _item_counts;
+
+        /**
+         * @brief Fenwick tree of the item counts. 1-based.
+         */
+        std::vector<std::size_t>                      _tree;
+
+        /**
+         * @brief Zero-based slot of each page position.
+         */
+        std::unordered_map<page_pos_t, std::size_t>   _slots;
+    };
+
+
+    // --------------------------------------------------------------
+
+
     /**
      * @brief         Sequence of items laid out over a `linked` (doubly linked list of pages).
      * @details       Items are densely stored at the beginning of each page. Any page may not be full.
@@ -401,6 +514,57 @@ namespace abc { namespace vmem {
          */
         void clear();
 
+        /**
+         * @brief   Relocates the pages to the lowest free positions in the pool. See `linked::compact()`.
+         * @details Invalidates all iterators.
+         */
+        void compact();
+
+    // Positional access
+    public:
+        /**
+         * @brief       Returns a reference to the item at the given index.
+         * @param index Zero-based index of the item. Must be less than `size()`.
+         */
+        reference               operator [](std::size_t index);
+
+        /**
+         * @brief       Returns a const reference to the item at the given index.
+         * @param index Zero-based index of the item. Must be less than `size()`.
+         */
+        const_reference         operator [](std::size_t index) const;
+
+        /**
+         * @brief       Returns an iterator referencing the item at the given index.
+         * @details     Finds the page through the counted page index in O(log(page count)) without mapping any page.
+         *              The index is built on first use by walking the page headers once. See `sync_page_index()`.
+         * @param index Zero-based index of the item. `size()` returns `end()`.
+         */
+        iterator                iterator_at(std::size_t index) const;
+
+        /**
+         * @brief     Returns the zero-based index of the item referenced by the given iterator.
+         * @details   Counts the items before the iterator's page through the counted page index.
+         * @param itr Iterator.
+         * @return    `size()` for `end()`.
+         */
+        std::size_t             index_of(const_iterator itr) const;
+
+        /**
+         * @brief       Returns an iterator that is `n` items away from the given one.
+         * @details     Goes through the counted page index. Advancing past either edge returns `end()` or `rbegin()`.
+         * @param itr   Iterator.
+         * @param n     Number of items to advance. May be negative.
+         */
+        iterator                advance(const_iterator itr, std::ptrdiff_t n) const;
+
+        /**
+         * @brief       Returns the number of items between two iterators.
+         * @param first Begin iterator.
+         * @param last  End iterator.
+         */
+        std::ptrdiff_t          distance(const_iterator first, const_iterator last) const;
+
     // insert() helpers
     private:
         /**
@@ -564,11 +728,54 @@ namespace abc { namespace vmem {
          */
         reverse_iterator rbegin_itr() const;
 
+        /**
+         * @brief               Returns the number of items on a page.
+         * @param page_pos      Page position.
+         * @param prev_page_pos Receives the position of the previous page.
+         * @param next_page_pos Receives the position of the next page.
+         */
+        item_pos_t page_item_count(page_pos_t page_pos, page_pos_t& prev_page_pos, page_pos_t& next_page_pos) const;
+
+    // Counted page index
+    private:
+        /**
+         * @brief   Builds the counted page index, unless it is up to date with the state.
+         * @details The index is only built for positional access. Once built, it is kept up to date on insert, erase, and balance made through this instance.
+         *          Changes made through other instances over the same state are detected when they change the item count or the end pages, and make the index to be rebuilt.
+         */
+        void sync_page_index() const;
+
+        /**
+         * @brief Returns `true` if the state is the same as when the counted page index was last updated.
+         */
+        bool is_page_index_current() const noexcept;
+
+        /**
+         * @brief Records the state that the counted page index reflects.
+         */
+        void stamp_page_index() const noexcept;
+
+        /**
+         * @brief Drops the counted page index if the state has been changed through another instance. Called before a change.
+         */
+        void begin_change();
+
+        /**
+         * @brief Keeps the counted page index current after a change.
+         */
+        void end_change();
+
     private:
         container_state* _state;
         page_balance     _balance_insert;
         page_balance     _balance_erase;
         vmem::pool*      _pool;
+
+        /**
+         * @brief Counted page index, and the state it reflects.
+         */
+        mutable container_page_index _page_index;
+        mutable container_state      _page_index_state;
     };
 
 
@@ -0,0 +1,392 @@
+/*
+MIT License
+
+Copyright (c) 2018-2026 Zlatko Michailov 
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "map.i.h"
+
+
+namespace abc { namespace vmem {
+
+    /**
+     * @brief           Lexicographic comparison of index keys - first by index key, then by primary key.
+     * @tparam IndexKey Index key type.
+     * @tparam Key      Primary key type.
+     */
+    template <typename IndexKey, typename Key>
+    bool operator <(const map_index_key<IndexKey, Key>& left, const map_index_key<IndexKey, Key>& right) noexcept;
+
+    template <typename IndexKey, typename Key>
+    bool operator <=(const map_index_key<IndexKey, Key>& left, const map_index_key<IndexKey, Key>& right) noexcept;
+
+    template <typename IndexKey, typename Key>
+    bool operator >(const map_index_key<IndexKey, Key>& left, const map_index_key<IndexKey, Key>& right) noexcept;
+
+    template <typename IndexKey, typename Key>
+    bool operator >=(const map_index_key<IndexKey, Key>& left, const map_index_key<IndexKey, Key>& right) noexcept;
+
+    template <typename IndexKey, typename Key>
+    bool operator ==(const map_index_key<IndexKey, Key>& left, const map_index_key<IndexKey, Key>& right) noexcept;
+
+    template <typename IndexKey, typename Key>
+    bool operator !=(const map_index_key<IndexKey, Key>& left, const map_index_key<IndexKey, Key>& right) noexcept;
+
+
+    // --------------------------------------------------------------
+
+
+    /**
+     * @brief      Base of all secondary indexes over a map. Used by `indexed_map` to maintain its indexes.
+     * @tparam Key Primary key type.
+     * @tparam T   Value type.
+     */
+    template <typename Key, typename T>
+    class map_index_base {
+    public:
+        /**
+         * @brief Destructor.
+         */
+        virtual ~map_index_base() noexcept = default;
+
+    public:
+        /**
+         * @brief      Adds an entry for an item that has been inserted into the map.
+         * @param item Map item.
+         */
+        virtual void insert(const map_value<Key, T>& item) = 0;
+
+        /**
+         * @brief      Removes the entry of an item that has been erased from the map.
+         * @param item Map item.
+         */
+        virtual void erase(const map_value<Key, T>& item) = 0;
+
+        /**
+         * @brief Removes all entries.
+         */
+        virtual void clear() = 0;
+
+        /**
+         * @brief Returns `true` if the index has no entries.
+         */
+        virtual bool empty() const noexcept = 0;
+
+        /**
+         * @brief Relocates the pages of the index to the lowest free positions in the pool. See `map::compact()`.
+         */
+        virtual void compact() = 0;
+    };
+
+
+    // --------------------------------------------------------------
+
+
+    /**
+     * @brief           Secondary index over a map.
+     * @details         A map from `map_index_key` to nothing. The index key is computed from each map item by an extractor.
+     *                  The entries are ordered by index key, so range queries are iterations between `lower_bound()` and `upper_bound()`.
+     * @tparam Key      Primary key type.
+     * @tparam T        Value type.
+     * @tparam IndexKey Index key type.
+     */
+    template <typename Key, typename T, typename IndexKey>
+    class map_index
+        : public map_index_base<Key, T>
+        , protected diag::diag_ready<const char*> {
+
+        using diag_base = diag::diag_ready<const char*>;
+
+    private:
+        static constexpr const char* origin() noexcept;
+
+    public:
+        using index_key_type = map_index_key<IndexKey, Key>;
+        using index_map      = map<index_key_type, novalue>;
+        using const_iterator = typename index_map::const_iterator;
+        using const_range    = typename index_map::const_range;
+        using extractor_type = std::function<IndexKey(const Key&, const T&)>;
+
+    public:
+        /**
+         * @brief           Constructor.
+         * @param state     Pointer to a `map_state` instance for the index.
+         * @param extractor Function that computes the index key of a map item.
+         * @param pool      Pointer to a `pool` instance.
+         * @param log       Pointer to a `log_ostream` instance.
+         */
+        map_index(map_state* state, extractor_type&& extractor, vmem::pool* pool, diag::log_ostream* log = nullptr);
+
+        /**
+         * @brief Deleted.
+         */
+        map_index(map_index&& other) = delete;
+
+        /**
+         * @brief Deleted.
+         */
+        map_index(const map_index& other) = delete;
+
+    public:
+        const_iterator begin() const noexcept;
+        const_iterator cbegin() const noexcept;
+
+        const_iterator end() const noexcept;
+        const_iterator cend() const noexcept;
+
+        bool           empty() const noexcept override;
+        std::size_t    size() const noexcept;
+
+        /**
+         * @brief           Returns an iterator to the first entry whose index key is not less than a given one.
+         * @param index_key Index key.
+         */
+        const_iterator lower_bound(const IndexKey& index_key) const;
+
+        /**
+         * @brief           Returns an iterator to the first entry whose index key is greater than a given one.
+         * @param index_key Index key.
+         */
+        const_iterator upper_bound(const IndexKey& index_key) const;
+
+        /**
+         * @brief       Returns the range of entries whose index keys are in [`first`, `last`).
+         * @param first Lower bound (inclusive).
+         * @param last  Upper bound (exclusive).
+         */
+        const_range find_range(const IndexKey& first, const IndexKey& last) const;
+
+        /**
+         * @brief           Returns the number of entries with a given index key.
+         * @param index_key Index key.
+         */
+        std::size_t count(const IndexKey& index_key) const;
+
+    public:
+        void insert(const map_value<Key, T>& item) override;
+        void erase(const map_value<Key, T>& item) override;
+        void clear() override;
+        void compact() override;
+
+    private:
+        /**
+         * @brief      Returns the index entry key of a map item.
+         * @param item Map item.
+         */
+        index_key_type make_key(const map_value<Key, T>& item) const;
+
+    private:
+        index_map      _map;
+        extractor_type _extractor;
+    };
+
+
+    // --------------------------------------------------------------
+
+
+    /**
+     * @brief      Map that maintains its secondary indexes on insert and erase.
+     * @details    Indexes are registered with `add_index()` each time the map is constructed.
+     *             Only the operations that keep the indexes in sync are exposed - items are read through const iterators and pointers.
+     *             To change an item, erase it, and insert it again.
+     * @tparam Key Primary key type.
+     * @tparam T   Value type.
+     */
+    template <typename Key, typename T>
+    class indexed_map
+        : protected map<Key, T> {
+
+        using base      = map<Key, T>;
+        using diag_base = diag::diag_ready<const char*>;
+
+    public:
+        using typename base::key_type;
+        using typename base::mapped_type;
+        using typename base::value_type;
+        using typename base::const_pointer;
+        using typename base::const_reference;
+        using typename base::const_iterator;
+        using typename base::const_reverse_iterator;
+        using typename base::const_range;
+        using const_iterator_bool = std::pair<const_iterator, bool>;
+
+    public:
+        /**
+         * @brief       Constructor.
+         * @param state Pointer to a `map_state` instance.
+         * @param pool  Pointer to a `pool` instance.
+         * @param log   Pointer to a `log_ostream` instance.
+         */
+        indexed_map(map_state* state, vmem::pool* pool, diag::log_ostream* log = nullptr);
+
+        /**
+         * @brief Move constructor.
+         */
+        indexed_map(indexed_map<Key, T>&& other) noexcept = default;
+
+        /**
+         * @brief Deleted.
+         */
+        indexed_map(const indexed_map<Key, T>& other) = delete;
+
+    public:
+        /**
+         * @brief           Registers a secondary index.
+         * @details         If the index is empty while the map is not, the index is built from the existing items.
+         * @tparam IndexKey Index key type.
+         * @param state     Pointer to a `map_state` instance for the index.
+         * @param extractor Function that computes the index key of a map item.
+         * @return          Pointer to the index, which is owned by this map.
+         */
+        template <typename IndexKey>
+        map_index<Key, T, IndexKey>* add_index(map_state* state, std::function<IndexKey(const Key&, const T&)>&& extractor);
+
+    public:
+        const_iterator         begin() const noexcept;
+        const_iterator         cbegin() const noexcept;
+
+        const_iterator         end() const noexcept;
+        const_iterator         cend() const noexcept;
+
+        const_reverse_iterator rend() const noexcept;
+        const_reverse_iterator crend() const noexcept;
+
+        const_reverse_iterator rbegin() const noexcept;
+        const_reverse_iterator crbegin() const noexcept;
+
+        bool                   empty() const noexcept;
+        std::size_t            size() const noexcept;
+
+    public:
+        /**
+         * @brief      Inserts an item, and adds its entries to all indexes.
+         * @details    If an item with the same key exists, the insert is not performed.
+         * @param item Item.
+         * @return     `const_iterator_bool`
+         */
+        const_iterator_bool insert(const_reference item);
+
+        /**
+         * @brief           Inserts a sequence of items.
+         * @tparam InputItr Source iterator type.
+         * @param first     Begin source iterator.
+         * @param last      End source iterator.
+         */
+        template <typename InputItr>
+        void insert(InputItr first, InputItr last);
+
+        /**
+         * @brief     Erases an item, and removes its entries from all indexes.
+         * @details   The item is found only once.
+         * @param key Key of the item to be erased.
+         * @return    `1` = the item was erased; `0` = the item was not erased.
+         */
+        std::size_t erase(const Key& key);
+
+        /**
+         * @brief           Erases a sequence of items.
+         * @tparam InputItr Source iterator type.
+         * @param first     Begin source iterator.
+         * @param last      End source iterator.
+         */
+        template <typename InputItr>
+        void erase(InputItr first, InputItr last);
+
+        /**
+         * @brief Erases all items, and clears all indexes.
+         */
+        void clear();
+
+        /**
+         * @brief   Relocates the pages of the map and of all indexes to the lowest free positions in the pool. See `map::compact()`.
+         * @details Index entries reference items by primary key, not by page position, so they stay valid.
+         */
+        void compact();
+
+    public:
+        /**
+         * @brief     Finds an item by key.
+         * @param key Key.
+         * @return    `const_iterator` 
+         */
+        const_iterator find(const Key& key) const;
+
+        /**
+         * @brief     Returns an iterator to the first item whose key is not less than a given one.
+         * @param key Key.
+         * @return    `const_iterator` 
+         */
+        const_iterator lower_bound(const Key& key) const;
+
+        /**
+         * @brief     Returns an iterator to the first item whose key is greater than a given one.
+         * @param key Key.
+         * @return    `const_iterator` 
+         */
+        const_iterator upper_bound(const Key& key) const;
+
+        /**
+         * @brief     Returns the range of items with a given key - empty or a single item.
+         * @param key Key.
+         * @return    `const_range` 
+         */
+        const_range equal_range(const Key& key) const;
+
+        /**
+         * @brief       Returns the range of items whose keys are in [`first`, `last`).
+         * @param first Lower bound (inclusive).
+         * @param last  Upper bound (exclusive).
+         * @return      `const_range` 
+         */
+        const_range find_range(const Key& first, const Key& last) const;
+
+        /**
+         * @brief     Checks if an item with a key exists.
+         * @param key Key.
+         * @return    `true` = exists; `false` = does not exist. 
+         */
+        bool contains(const Key& key) const;
+
+        /**
+         * @brief     Finds an item by key, and dereferences it.
+         * @param key Key.
+         * @return    `const_pointer` 
+         */
+        const_pointer operator [](const Key& key) const;
+
+    private:
+        vmem::pool*                                          _pool;
+        std::vector<std::unique_ptr<map_index_base<Key, T>>> _indexes;
+    };
+
+
+    // --------------------------------------------------------------
+
+} }
@@ -44,6 +44,13 @@ namespace abc { namespace vmem {
     };
 
 
+    /**
+     * @brief Empty struct to represent no map value.
+     */
+    struct novalue {
+    };
+
+
     // ..............................................................
 
 
@@ -128,6 +135,85 @@ namespace abc { namespace vmem {
     };
 
 
+    /**
+     * @brief           Key of a secondary index over a map.
+     * @details         The primary key makes the index key unique.
+     * @tparam IndexKey Index key type.
+     * @tparam Key      Primary key type.
+     */
+    template <typename IndexKey, typename Key>
+    struct map_index_key {
+        IndexKey index_key = { };
+        Key      key       = { };
+    };
+
+
+    // ..............................................................
+
+
+    /**
+     * @brief Header of a log page.
+     */
+    struct log_page_header {
+        std::uint64_t first_seq = 0;
+    };
+
+
+    /**
+     * @brief    Log page.
+     * @details  Same as `container_page` with a `log_page_header`.
+     * @tparam T Item type.
+     */
+    template <typename T>
+    struct log_page
+        : public container_page<T, log_page_header> {
+    };
+
+
+    /**
+     * @brief Header of a vector page.
+     */
+    struct vector_page_header {
+        std::size_t page_index = 0;
+    };
+
+
+    /**
+     * @brief    Vector page.
+     * @details  Same as `container_page` with a `vector_page_header`.
+     * @tparam T Item type.
+     */
+    template <typename T>
+    struct vector_page
+        : public container_page<T, vector_page_header> {
+    };
+
+
+    /**
+     * @brief Header of a priority queue page.
+     */
+    struct priority_queue_page_header {
+        page_pos_t parent_page_pos = page_pos_nil;
+        item_pos_t parent_slot     = 0;
+        item_pos_t item_count      = 0;
+    };
+
+
+    /**
+     * @brief           Priority queue page.
+     * @details         The items form a binary sub-heap. The virtual children of the bottom items are the roots of the child pages.
+     * @tparam T        Item type.
+     * @tparam Capacity Maximum number of items on the page.
+     */
+    template <typename T, std::size_t Capacity>
+    struct priority_queue_page
+        : public priority_queue_page_header {
+
+        page_pos_t child_page_pos[Capacity + 1] = { };
+        T          items[Capacity]              = { };
+    };
+
+
     // ..............................................................
 
 
@@ -181,6 +267,42 @@ namespace abc { namespace vmem {
     };
 
 
+    /**
+     * @brief   Vector state.
+     * @details Consists of a container of items, and a stack of page index levels.
+     */
+    struct vector_state {
+        container_state items;
+        stack_state     page_levels;
+    };
+
+
+    /**
+     * @brief   Log state.
+     * @details Includes a `linked_state` at the beginning.
+     */
+    struct log_state
+        : public linked_state {
+
+        item_pos_t    item_size = 0;
+        std::uint64_t front_seq = 0;
+        std::uint64_t next_seq  = 0;
+    };
+
+
+    /**
+     * @brief   Priority queue state.
+     * @details The pages form a complete tree. `last_page_pos` is the position of the last page in breadth-first order.
+     */
+    struct priority_queue_state {
+        page_pos_t  root_page_pos    = page_pos_nil;
+        page_pos_t  last_page_pos    = page_pos_nil;
+        std::size_t page_count       = 0;
+        std::size_t total_item_count = 0;
+        item_pos_t  item_size        = 0;
+    };
+
+
     /**
      * @brief   String state.
      * @details Same as `list_state`.
@@ -205,6 +327,35 @@ namespace abc { namespace vmem {
     };
 
 
+    // ..............................................................
+
+
+    /**
+     * @brief   Header of a record in the cold page side file.
+     * @details The header is followed by `data_size` bytes of LZ4-compressed page contents.
+     *          A record is only current while the page's slot in the pool file is a hole.
+     *          A record with `data_size == 0` marks that the page is no longer cold. Such records are no longer written, but are still honored.
+     */
+    struct cold_page_header {
+        page_pos_t page_pos  = page_pos_nil;
+        item_pos_t data_size = 0;
+    };
+
+
+    // ..............................................................
+
+
+    /**
+     * @brief   Header of an incremental backup stream.
+     * @details The header is followed by `record_count` records. Each record is a `page_pos_t` followed by `page_size` bytes of page contents.
+     */
+    struct backup_increment_header {
+        const char signature[10] = "abc::vinc";
+        page_pos_t page_count    = 0;
+        page_pos_t record_count  = 0;
+    };
+
+
     #pragma pack(pop)
 
 
@@ -174,6 +174,14 @@ namespace abc { namespace vmem {
          */
         void clear();
 
+        /**
+         * @brief   Relocates the pages to the lowest positions in the pool that are free or its own, in chain order, so that the chain becomes as contiguous as possible.
+         * @details Page contents are moved verbatim. Only the links and the state are fixed.
+         *          Must not be called on chains whose pages are referenced from elsewhere, e.g. the levels of a `map` - see `map::compact()`.
+         *          Invalidates all iterators.
+         */
+        void compact();
+
         /**
          * @brief       Links the other linked list at the end of this one.
          * @param other Other linked list. Its state is reset after this.
@@ -0,0 +1,204 @@
+/*
+MIT License
+
+Copyright (c) 2018-2026 Zlatko Michailov 
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#pragma once
+
+#include <deque>
+
+#include "../../diag/i/diag_ready.i.h"
+#include "layout.i.h"
+#include "page.i.h"
+#include "pool.i.h"
+
+
+namespace abc { namespace vmem {
+
+    /**
+     * @brief Log sequence number.
+     */
+    using seq_t = std::uint64_t;
+
+
+    // --------------------------------------------------------------
+
+
+    /**
+     * @brief    Append-only log.
+     * @details  Items are densely stored on linked pages - all pages except the back page are full.
+     *           Each item is addressed by a sequence number that never changes.
+     *           The back page is kept locked, so appending doesn't map any page until the back page gets full.
+     *           Since pages are dense, the page of an item is found arithmetically from its sequence number through an in-memory index of page positions.
+     *           Retention is done by truncating whole pages from the front.
+     * @tparam T Item type. Must be trivially copyable.
+     */
+    template <typename T>
+    class log
+        : protected diag::diag_ready<const char*> {
+
+        using diag_base = diag::diag_ready<const char*>;
+        using log_page  = vmem::log_page<T>;
+
+    private:
+        static constexpr const char* origin() noexcept;
+
+    public:
+        using value_type      = T;
+        using const_reference = const T&;
+
+    public:
+        /**
+         * @brief Returns the byte position on each page where items start.
+         */
+        static constexpr std::size_t items_pos() noexcept;
+
+        /**
+         * @brief Returns the maximum number of items that could be stored on a page.
+         */
+        static constexpr std::size_t page_capacity() noexcept;
+
+        /**
+         * @brief Returns `true` if the given state is uninitialized; `false` if it is initialized.
+         */
+        static constexpr bool is_uninit(const log_state* state) noexcept;
+
+    public:
+        /**
+         * @brief       Constructor.
+         * @param state Pointer to a `log_state` instance.
+         * @param pool  Pointer to a `pool` instance.
+         * @param log   Pointer to a `log_ostream` instance.
+         */
+        log(log_state* state, vmem::pool* pool, diag::log_ostream* log = nullptr);
+
+        /**
+         * @brief Move constructor.
+         */
+        log(log<T>&& other) noexcept = default;
+
+        /**
+         * @brief Copy constructor.
+         */
+        log(const log<T>& other) noexcept = default;
+
+    public:
+        /**
+         * @brief Returns `true` if the log has no items.
+         */
+        bool empty() const noexcept;
+
+        /**
+         * @brief Returns the number of items in the log.
+         */
+        std::size_t size() const noexcept;
+
+        /**
+         * @brief Returns the sequence number of the front item.
+         */
+        seq_t front_seq() const noexcept;
+
+        /**
+         * @brief Returns the sequence number that will be assigned to the next appended item.
+         */
+        seq_t next_seq() const noexcept;
+
+    public:
+        /**
+         * @brief      Appends an item.
+         * @param item Item to append.
+         * @return     The sequence number of the item.
+         */
+        seq_t push_back(const_reference item);
+
+        /**
+         * @brief     Returns a copy of the item with the given sequence number.
+         * @details   The sequence number must be in [`front_seq()`, `next_seq()`).
+         *            Maps only the page that contains the item.
+         * @param seq Sequence number.
+         */
+        T at(seq_t seq) const;
+
+        /**
+         * @brief       Copies consecutive items starting from a given sequence number.
+         * @param seq   Sequence number of the first item to copy. Must be in [`front_seq()`, `next_seq()`].
+         * @param items Out. Buffer to copy to.
+         * @param count Maximum number of items to copy.
+         * @return      The number of items copied.
+         */
+        std::size_t read(seq_t seq, T* items, std::size_t count) const;
+
+        /**
+         * @brief     Frees all front pages whose items all have sequence numbers less than `seq`.
+         * @details   Only whole pages are freed. Thus, `front_seq()` may remain less than `seq`.
+         * @param seq Sequence number of the first item to retain.
+         */
+        void truncate_front(seq_t seq);
+
+        /**
+         * @brief   Frees all pages.
+         * @details Sequence numbers are not reused.
+         */
+        void clear();
+
+    private:
+        /**
+         * @brief       Locks the back page, if it is not locked yet.
+         * @return      Pointer to the back page's contents, or `nullptr` if the log has no pages.
+         */
+        log_page* lock_back_page() const;
+
+        /**
+         * @brief     Returns the position of the page that contains the item with the given sequence number.
+         * @param seq Sequence number.
+         */
+        page_pos_t page_pos_of(seq_t seq) const;
+
+        /**
+         * @brief   Brings the page position index up to date with the state.
+         * @details Another instance over the same state may have appended, truncated, or cleared pages.
+         *          Only the pages that have been appended since the last update are walked.
+         */
+        void sync_page_positions() const;
+
+    private:
+        log_state*         _state;
+        vmem::pool*        _pool;
+        mutable vmem::page _back_page;
+
+        /**
+         * @brief Positions of the pages from the front to the back. Page `i` holds the items from `_page_positions_front_seq + i * page_capacity()`.
+         */
+        mutable std::deque<page_pos_t> _page_positions;
+
+        /**
+         * @brief Sequence number of the first item on the front page in `_page_positions`.
+         */
+        mutable seq_t _page_positions_front_seq;
+    };
+
+
+    // --------------------------------------------------------------
+
+} }
@@ -66,6 +66,12 @@ namespace abc { namespace vmem {
          * @brief Copy constructor.
          */
         map_key_level(const map_key_level<Key>& other) noexcept = default;
+
+    private:
+        /**
+         * @brief Not applicable. The keys on the parent level reference the pages of this level. See `map::compact()`.
+         */
+        using base::compact;
     };
 
 
@@ -136,6 +142,12 @@ namespace abc { namespace vmem {
          * @brief Copy constructor.
          */
         map_value_level(const map_value_level<Key, T>& other) noexcept = default;
+
+    private:
+        /**
+         * @brief Not applicable. The keys on the lowest key level reference the pages of this level. See `map::compact()`.
+         */
+        using base::compact;
     };
 
 
@@ -264,6 +276,46 @@ namespace abc { namespace vmem {
     // --------------------------------------------------------------
 
 
+    /**
+     * @brief           Bounded range of map items - [`begin()`, `end()`).
+     * @details         Both ends are positioned upfront. Iteration stops by comparing positions,
+     *                  so no page beyond the upper bound is touched.
+     * @tparam Iterator Map iterator type.
+     */
+    template <typename Iterator>
+    class map_range {
+    public:
+        /**
+         * @brief       Constructor.
+         * @param begin Iterator to the first item in the range.
+         * @param end   Iterator past the last item in the range.
+         */
+        map_range(Iterator&& begin, Iterator&& end) noexcept;
+
+        /**
+         * @brief Move constructor.
+         */
+        map_range(map_range&& other) noexcept = default;
+
+        /**
+         * @brief Copy constructor.
+         */
+        map_range(const map_range& other) = default;
+
+    public:
+        Iterator begin() const noexcept;
+        Iterator end() const noexcept;
+        bool     empty() const noexcept;
+
+    private:
+        Iterator _begin;
+        Iterator _end;
+    };
+
+
+    // --------------------------------------------------------------
+
+
     /**
      * @brief      Map implemented as a B-tree.
      * @tparam Key Key type.
@@ -294,6 +346,8 @@ namespace abc { namespace vmem {
         using result2                  = map_result2<Key, T>;
         using find_result2             = map_find_result2<Key, T>;
         using iterator_bool            = std::pair<map_iterator<Key, T>, bool>;
+        using range                    = map_range<iterator>;
+        using const_range              = map_range<const_iterator>;
 
     private:
         using path_reverse_iterator    = typename stack<page_pos_t>::reverse_iterator;
@@ -435,7 +489,13 @@ namespace abc { namespace vmem {
         template <typename InputItr>
         void erase(InputItr first, InputItr last);
 
-    private:
+        /**
+         * @brief   Relocates the pages of each level to the lowest free positions in the pool, and fixes the keys that reference them. See `linked::compact()`.
+         * @details Invalidates all iterators.
+         */
+        void compact();
+
+    protected:
         /**
          * @brief             Unconditionally erases an item at the `find_result2` path.
          * @param find_result Find result.
@@ -443,6 +503,15 @@ namespace abc { namespace vmem {
          */
         std::size_t erase2(find_result2&& find_result);
 
+    // compact() helpers
+    private:
+        /**
+         * @brief                Points the keys on a key level to the pages on the level below, in order.
+         * @param key_page_pos   Position of the front page on the key level.
+         * @param child_page_pos Position of the front page on the level below.
+         */
+        void fix_child_page_positions(page_pos_t key_page_pos, page_pos_t child_page_pos);
+
     // update_key_levels() helpers
     private:
         /**
@@ -492,12 +561,13 @@ namespace abc { namespace vmem {
 
     public:
         /**
-         * @brief     Finds an item by key.
-         * @details   Suitable for use in more complex operations like insert and delete.
-         * @param key Key.
-         * @return    `find_result2` 
+         * @brief            Finds an item by key.
+         * @details          Suitable for use in more complex operations like insert and delete.
+         * @param key        Key.
+         * @param track_path When `false`, the path is not recorded, so that no temporary pages are allocated. Plain lookups don't need it.
+         * @return           `find_result2` 
          */
-        find_result2 find2(const Key& key);
+        find_result2 find2(const Key& key, bool track_path = true);
 
         /**
          * @brief     Finds an item by key.
@@ -515,6 +585,68 @@ namespace abc { namespace vmem {
          */
         const_iterator find(const Key& key) const;
 
+        /**
+         * @brief     Returns an iterator to the first item whose key is not less than a given one.
+         * @details   Descends the key levels once.
+         * @param key Key.
+         * @return    `iterator` 
+         */
+        iterator lower_bound(const Key& key);
+
+        /**
+         * @brief     Returns an iterator to the first item whose key is not less than a given one.
+         * @details   Descends the key levels once.
+         * @param key Key.
+         * @return    `const_iterator` 
+         */
+        const_iterator lower_bound(const Key& key) const;
+
+        /**
+         * @brief     Returns an iterator to the first item whose key is greater than a given one.
+         * @details   Descends the key levels once.
+         * @param key Key.
+         * @return    `iterator` 
+         */
+        iterator upper_bound(const Key& key);
+
+        /**
+         * @brief     Returns an iterator to the first item whose key is greater than a given one.
+         * @details   Descends the key levels once.
+         * @param key Key.
+         * @return    `const_iterator` 
+         */
+        const_iterator upper_bound(const Key& key) const;
+
+        /**
+         * @brief     Returns the range of items with a given key - empty or a single item.
+         * @param key Key.
+         * @return    `range` 
+         */
+        range equal_range(const Key& key);
+
+        /**
+         * @brief     Returns the range of items with a given key - empty or a single item.
+         * @param key Key.
+         * @return    `const_range` 
+         */
+        const_range equal_range(const Key& key) const;
+
+        /**
+         * @brief       Returns the range of items whose keys are in [`first`, `last`).
+         * @param first Lower bound (inclusive).
+         * @param last  Upper bound (exclusive).
+         * @return      `range` 
+         */
+        range find_range(const Key& first, const Key& last);
+
+        /**
+         * @brief       Returns the range of items whose keys are in [`first`, `last`).
+         * @param first Lower bound (inclusive).
+         * @param last  Upper bound (exclusive).
+         * @return      `const_range` 
+         */
+        const_range find_range(const Key& first, const Key& last) const;
+
         /**
          * @brief     Checks if an item with a key exists.
          * @param key Key.
@@ -25,7 +25,13 @@ SOFTWARE.
 
 #pragma once
 
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <set>
 #include <unordered_map>
+#include <vector>
+#include <sys/types.h>
 
 #include "../../root/size.h"
 #include "../../diag/i/diag_ready.i.h"
@@ -34,6 +40,25 @@ SOFTWARE.
 
 namespace abc { namespace vmem {
 
+    /**
+     * @brief Combination of `pool_option` flags.
+     */
+    using pool_options_t = std::uint32_t;
+
+    /**
+     * @brief `pool` options. See the `pool_config` properties of the same names.
+     */
+    namespace pool_option {
+        constexpr pool_options_t none                         = static_cast<pool_options_t>(0);
+        constexpr pool_options_t sync_pages_on_unlock         = static_cast<pool_options_t>(1 << 0);
+        constexpr pool_options_t sync_locked_pages_on_destroy = static_cast<pool_options_t>(1 << 1);
+        constexpr pool_options_t verify_page_checksums        = static_cast<pool_options_t>(1 << 2);
+        constexpr pool_options_t compress_cold_pages          = static_cast<pool_options_t>(1 << 3);
+        constexpr pool_options_t use_huge_pages               = static_cast<pool_options_t>(1 << 4);
+        constexpr pool_options_t read_only                    = static_cast<pool_options_t>(1 << 5);
+    }
+
+
     /**
      * @brief `pool` settings.
      */
@@ -48,6 +73,15 @@ namespace abc { namespace vmem {
          */
         pool_config(const char* file_path, std::size_t max_mapped_page_count = size::max, bool sync_pages_on_unlock = false, bool sync_locked_pages_on_destroy = false);
 
+        /**
+         * @brief                       Constructor. Properties can only be set at construction.
+         * @param file_path             Path to the pool file.
+         * @param max_mapped_page_count Maximum number of mapped pages at the same time.
+         * @param options               Combination of `pool_option` flags, e.g. `pool_option::verify_page_checksums | pool_option::read_only`.
+         * @param log_stats_interval    Number of page operations between logging the stats. `0` = only when the mapping capacity is first reached. Default: `1024`.
+         */
+        pool_config(const char* file_path, std::size_t max_mapped_page_count, pool_options_t options, std::size_t log_stats_interval = size::k1);
+
         /**
          * @brief Path to the pool file.
          */
@@ -70,12 +104,184 @@ namespace abc { namespace vmem {
          * @details Having locked pages when the pool is destroyed is a program error. Either way could lead to a loss of data integrity.
          */
         const bool sync_locked_pages_on_destroy;
+
+        /**
+         * @brief   When `true`, a CRC32C checksum of each page is stored in a side file, `<file_path>.crc`, when the page gets unmapped.
+         *          The checksum is verified when the page gets mapped again.
+         * @details While a page is mapped, its stored checksum is `0`, i.e. unknown, so that a `scrubber` would skip it.
+         *          Pages that were mapped when the process crashed are not verified.
+         */
+        const bool verify_page_checksums;
+
+        /**
+         * @brief   When `true`, a cold page that gets unmapped is compressed with LZ4, and is appended to a side file, `<file_path>.cold`.
+         *          The page's slot in the pool file is then punched out, so it no longer takes disk space.
+         *          The page is decompressed back into its slot when it gets mapped again.
+         * @details A page is cold when it has not been locked more times than the average unlocked page while it was mapped.
+         *          A page that has not changed since it was decompressed is punched out again without being compressed.
+         *          A record is only current while the page's slot in the pool file is a hole. So decompressing a page writes nothing to the side file.
+         *          Trades CPU for disk footprint and read bandwidth. Pages that do not compress below `cold_page_max_data_size` stay in the pool file.
+         *          The side file is append-only. It is rewritten when most of it is stale, and by `pool::compact()`.
+         *          Records are synced, and the slots are punched out, in batches of `cold_page_punch_batch_size` pages, as well as when the side file gets rewritten,
+         *          and when the pool is destroyed. Until then, a slot keeps the page's contents, so nothing is lost if the process crashes.
+         *          An existing side file is always honored, even when this setting is `false`.
+         */
+        const bool compress_cold_pages;
+
+        /**
+         * @brief   When `true`, the pool file is mapped in 2 MB-aligned extents of `huge_extent_page_count` pages, which are advised as `MADV_HUGEPAGE`.
+         *          An extent stays mapped while any of its pages is mapped. `max_mapped_page_count` still limits the pages, not the extents.
+         * @details Reduces TLB misses on random access over large pools.
+         *          Whether the kernel backs the extents with huge pages depends on the file system and on the transparent huge page settings -
+         *          see `pool::huge_page_byte_count()`.
+         */
+        const bool use_huge_pages;
+
+        /**
+         * @brief   Number of page operations - lock, unlock, map, unmap - between logging the stats.
+         * @details Stats are also logged whenever the mapping capacity is reached. `0` means only then.
+         *          `1` logs on every page operation, which multiplies the cost of page access when a verbose log is attached.
+         */
+        const std::size_t log_stats_interval;
+
+        /**
+         * @brief   When `true`, the pool file is opened `O_RDONLY`, and pages are mapped `PROT_READ` and `MAP_SHARED`,
+         *          so that multiple processes can share one physical copy of the pages through the page cache.
+         * @details The pool file must already be initialized. Pages cannot be allocated or freed, and the side files are not modified.
+         *          Only const container methods may be used - writing to a page faults.
+         *          Cold pages - see `compress_cold_pages` - are decompressed into private pages, which are not shared.
+         */
+        const bool read_only;
+    };
+
+
+    /**
+     * @brief           Returns the path to the side file where page checksums are stored.
+     * @param file_path Path to the pool file.
+     */
+    std::string checksum_file_path(const std::string& file_path);
+
+
+    // --------------------------------------------------------------
+
+
+    /**
+     * @brief Maximum compressed size of a cold page. Pages that do not compress below it are not worth the extra I/O.
+     */
+    constexpr item_pos_t cold_page_max_data_size = page_size - page_size / 4;
+
+
+    /**
+     * @brief Minimum stale size of the cold page side file before it gets rewritten.
+     */
+    constexpr off_t cold_page_stale_size_min = 256 * page_size;
+
+
+    /**
+     * @brief Number of compressed pages whose records are synced with a single `fdatasync()` before their slots are punched out.
+     */
+    constexpr std::size_t cold_page_punch_batch_size = 64;
+
+
+    /**
+     * @brief Location of a cold page's compressed contents in the cold page side file.
+     */
+    struct cold_page_slot {
+        off_t         data_off;
+        item_pos_t    data_size;
+
+        /**
+         * @brief Checksum of the page as it was decompressed from this slot, or `0` if it has not been since the slot was written.
+         */
+        std::uint32_t page_checksum;
     };
 
 
+    /**
+     * @brief Index of the cold page side file.
+     */
+    using cold_page_index = std::unordered_map<page_pos_t, cold_page_slot>;
+
+
+    /**
+     * @brief           Returns the path to the side file where cold pages are stored.
+     * @param file_path Path to the pool file.
+     */
+    std::string cold_file_path(const std::string& file_path);
+
+
+    /**
+     * @brief         Scans the cold page side file, and builds its index.
+     * @details       Later records override earlier ones. The scan stops at the first incomplete record.
+     * @param cold_fd Descriptor of the cold page side file.
+     * @param index   Index to populate.
+     * @return        The offset right after the last complete record.
+     */
+    off_t read_cold_page_index(int cold_fd, cold_page_index& index);
+
+
+    /**
+     * @brief         Reads and decompresses a cold page.
+     * @param cold_fd Descriptor of the cold page side file.
+     * @param slot    Location of the page's compressed contents.
+     * @param page    Buffer of `page_size` bytes.
+     * @return        `true` if the page has been restored in full.
+     */
+    bool read_cold_page(int cold_fd, const cold_page_slot& slot, void* page) noexcept;
+
+
+    /**
+     * @brief          Checks whether a page's slot in the pool file is a hole, i.e. whether the page's cold record, if any, is current.
+     * @details        Once a page has been decompressed into its slot, the slot has data, and the pool file takes precedence over the cold record.
+     * @param fd       Descriptor of the pool file.
+     * @param page_pos Page position.
+     */
+    bool is_page_hole(int fd, page_pos_t page_pos) noexcept;
+
+
+    // --------------------------------------------------------------
+
+
+    /**
+     * @brief Number of pages that a backup reads and writes at once.
+     */
+    constexpr std::size_t backup_chunk_page_count = 64;
+
+
     // --------------------------------------------------------------
 
 
+    /**
+     * @brief Number of buckets of a `latency_histogram`.
+     */
+    constexpr std::size_t latency_bucket_count = 40;
+
+
+    /**
+     * @brief   Latency histogram with power-of-2 buckets.
+     * @details Bucket `i` counts the latencies in the range [2^i, 2^(i+1)) nanoseconds. Bucket `0` also counts `0`.
+     *          The last bucket counts everything above.
+     */
+    struct latency_histogram {
+        /**
+         * @brief    Adds a latency to the histogram.
+         * @param ns Latency in nanoseconds.
+         */
+        void record(std::uint64_t ns) noexcept;
+
+        /**
+         * @brief         Returns an upper bound of the given percentile in nanoseconds, or `0` if there are no samples.
+         * @param percent Percentile in the range (0, 100].
+         */
+        std::uint64_t percentile(double percent) const noexcept;
+
+        count_t       sample_count;
+        std::uint64_t total_ns;
+        std::uint64_t max_ns;
+        count_t       buckets[latency_bucket_count];
+    };
+
+
     /**
      * @brief Pool performance stats.
      */
@@ -90,6 +296,34 @@ namespace abc { namespace vmem {
         count_t unlocked_page_keep_count;
 
         count_t free_capacity_count;
+
+        count_t     mapped_extent_count;
+        std::size_t huge_page_byte_count;
+
+        /**
+         * @brief Number of pages unmapped to free up mapping capacity.
+         */
+        count_t eviction_count;
+
+        /**
+         * @brief Number of `msync()` calls.
+         */
+        count_t msync_count;
+
+        /**
+         * @brief Number of bytes the pool file has grown by since the pool was opened.
+         */
+        std::uint64_t grown_byte_count;
+
+        /**
+         * @brief Latency of mapping a page that is not mapped, excluding freeing up capacity.
+         */
+        latency_histogram map_in_latency;
+
+        /**
+         * @brief Latency of freeing up mapping capacity.
+         */
+        latency_histogram eviction_latency;
     };
 
 
@@ -111,6 +345,7 @@ namespace abc { namespace vmem {
 
         using diag_base = diag::diag_ready<const char*>;
         using mapped_page_container = std::unordered_map<page_pos_t, mapped_page>;
+        using mapped_extent_container = std::unordered_map<page_pos_t, mapped_extent>;
 
     private:
         static constexpr const char* origin() noexcept;
@@ -148,6 +383,49 @@ namespace abc { namespace vmem {
     public:
         const pool_config& config() const noexcept;
 
+        /**
+         * @brief   Returns a snapshot of the performance stats.
+         * @details Collecting the stats doesn't log. `huge_page_byte_count` is only refreshed by `huge_page_byte_count()`.
+         */
+        pool_stats stats() const noexcept;
+
+        /**
+         * @brief   Returns the trailing free pages to the file system, and truncates the pool file.
+         * @details To maximize the effect, relocate live chains first - see `linked::compact()`.
+         *          The trailing free pages must not be locked.
+         * @return  The number of pages released.
+         */
+        std::size_t compact();
+
+        /**
+         * @brief   Returns the number of bytes of the mapped extents that the kernel currently backs with huge pages.
+         * @details Only applicable when `use_huge_pages` is set. Reads `/proc/self/smaps`, so it should not be called on a hot path.
+         *          The result is also stored in `pool_stats::huge_page_byte_count`.
+         */
+        std::size_t huge_page_byte_count();
+
+        /**
+         * @brief             Writes a consistent copy of the pool to a stream.
+         * @details           Must be called on the thread that uses the pool, so that no page changes while the backup is being taken.
+         *                    Mapped pages are copied from memory, and cold pages are decompressed. Thus, the copy includes changes that have not been synced yet.
+         *                    A full backup is an image of the pool file that can be opened as a pool. The checksum and cold page side files are not part of it.
+         *                    An incremental backup contains only the pages that have been locked since, or were locked during, the previous backup taken by this instance,
+         *                    or all pages if there has been no previous backup. It is applied to a copy of the previous backup with `restorer::apply_increment()`.
+         * @param stream      Output stream.
+         * @param incremental When `true`, an incremental backup is written. Otherwise, a full backup is written.
+         * @return            The number of pages written.
+         */
+        std::size_t backup(std::ostream& stream, bool incremental = false);
+
+        /**
+         * @brief             Writes a consistent copy of the pool to a file.
+         * @details           Same as `backup(std::ostream&)`.
+         * @param file_path   Path to the backup file. The file is overwritten.
+         * @param incremental When `true`, an incremental backup is written. Otherwise, a full backup is written.
+         * @return            The number of pages written.
+         */
+        std::size_t backup_to(const char* file_path, bool incremental = false);
+
     private:
         friend page;
 
@@ -191,6 +469,12 @@ namespace abc { namespace vmem {
          */
         void clear_linked(linked& linked);
 
+        /**
+         * @brief        Relocates the pages of the `linked` struct to the lowest positions that are free or its own, in chain order.
+         * @param linked A `linked` instance.
+         */
+        void compact_linked(linked& linked);
+
 
     // Constructor helpers
     private:
@@ -252,8 +536,125 @@ namespace abc { namespace vmem {
         page_pos_t create_page();
 
 
+    // compact() helpers
+    private:
+        /**
+         * @brief  Walks the pool's list of free pages, and returns their positions.
+         */
+        std::set<page_pos_t> get_free_page_positions();
+
+        /**
+         * @brief          Unlinks a specific page from the pool's list of free pages.
+         * @param page_pos Page position.
+         */
+        void remove_free_page_pos(page_pos_t page_pos);
+
+        /**
+         * @brief              Copies a linked page to a new position, and relinks its neighbors.
+         * @param state        Pointer to the `linked_state` of the chain.
+         * @param page_pos     Current page position.
+         * @param new_page_pos New page position.
+         * @return             The position of the next page on the chain.
+         */
+        page_pos_t move_linked_page(linked_state* state, page_pos_t page_pos, page_pos_t new_page_pos);
+
+        /**
+         * @brief                     Moves a linked page to a free position, and frees its current position.
+         * @param state               Pointer to the `linked_state` of the chain.
+         * @param page_pos            Current page position.
+         * @param new_page_pos        New page position. Must be free.
+         * @param free_page_positions Positions of the free pages. Kept in sync with the list of free pages.
+         */
+        void relocate_linked_page(linked_state* state, page_pos_t page_pos, page_pos_t new_page_pos, std::set<page_pos_t>& free_page_positions);
+
+
+    // Checksum helpers
+    private:
+        /**
+         * @brief Opens the side file where page checksums are stored.
+         */
+        void open_checksums();
+
+        /**
+         * @brief          Reads the stored checksum of a page.
+         * @param page_pos Page position.
+         * @return         The stored checksum, or `0` if unknown.
+         */
+        std::uint32_t read_page_checksum(page_pos_t page_pos);
+
+        /**
+         * @brief          Stores the checksum of a page.
+         * @param page_pos Page position.
+         * @param checksum Checksum. `0` means unknown.
+         */
+        void write_page_checksum(page_pos_t page_pos, std::uint32_t checksum);
+
+        /**
+         * @brief          Verifies the stored checksum of a freshly mapped page, and then marks the checksum as unknown.
+         * @param page_pos Page position.
+         * @param ptr      Pointer to the mapped page.
+         * @return         `true` if the checksum matches or is unknown; `false` if the page is corrupt.
+         */
+        bool verify_page_checksum(page_pos_t page_pos, const void* ptr);
+
+
+    // Cold page helpers
+    private:
+        /**
+         * @brief   Opens the side file where cold pages are stored, and reads its index.
+         * @details Creates the side file only if `compress_cold_pages` is set.
+         */
+        void open_cold_pages();
+
+        /**
+         * @brief             Checks whether a mapped page is cold, i.e. whether it has not been locked more times than the average unlocked page.
+         * @param mapped_page Mapped page.
+         */
+        bool is_cold_page(const mapped_page& mapped_page) const noexcept;
+
+        /**
+         * @brief          Compresses a page that is about to be unmapped, and appends it to the cold page side file.
+         * @param page_pos Page position.
+         * @param ptr      Pointer to the mapped page.
+         * @return         `true` if the page has been stored, and its slot in the pool file can be punched out.
+         */
+        bool compress_page(page_pos_t page_pos, const void* ptr);
+
+        /**
+         * @brief          Releases the disk space of a page's slot in the pool file.
+         * @param page_pos Page position.
+         */
+        void punch_page(page_pos_t page_pos);
+
+        /**
+         * @brief Syncs the cold page side file, and punches out the slots of the pages that are pending.
+         */
+        void punch_pending_pages();
+
+        /**
+         * @brief          Restores a freshly mapped page from the cold page side file, if the page is cold.
+         * @details        The cold record is kept, so that the page can be punched out again without being compressed if it doesn't change.
+         * @param page_pos Page position.
+         * @param ptr      Pointer to the mapped page.
+         * @return         `true` if the page is not cold or has been restored; `false` if the stored contents are corrupt.
+         */
+        bool decompress_page(page_pos_t page_pos, void* ptr);
+
+        /**
+         * @brief            Rewrites the cold page side file with only the pages that are still cold and within the pool file.
+         * @details          Records of mapped pages are kept while `compress_cold_pages` is set.
+         * @param page_count Number of pages in the pool file.
+         */
+        void compact_cold_pages(page_pos_t page_count);
+
+
     // lock_page() / unlock_page() helpers
     private:
+        /**
+         * @brief Returns the memory protection of mapped pages.
+         */
+        int page_protection() const noexcept;
+
         /**
          * @brief          Ensures a page is mapped in memory
          * @details        If the page is already mapped, it simply returns a pointer to the entry.
@@ -270,16 +671,47 @@ namespace abc { namespace vmem {
          */
         mapped_page_container::iterator unmap_page(const mapped_page_container::iterator& mapped_page_itr);
 
+        /**
+         * @brief          Maps the OS page(s) of a vmem page.
+         * @details        When `use_huge_pages` is set, maps the page's extent, if it is not mapped yet, and returns a pointer within the extent.
+         * @param page_pos Page position.
+         * @return         Pointer to the first byte of the page.
+         */
+        void* map_page_ptr(page_pos_t page_pos);
+
+        /**
+         * @brief          Unmaps the OS page(s) of a vmem page.
+         * @details        When `use_huge_pages` is set, unmaps the page's extent once none of its pages is mapped.
+         * @param page_pos Page position.
+         * @param ptr      Pointer to the first byte of the page.
+         */
+        void unmap_page_ptr(page_pos_t page_pos, void* ptr);
+
         /**
          * @brief Ensures that `_mapped_page_count` is less than `_max_mapped_page_count`, so that a new page can be mapped.
          */
         void ensure_mapping_capacity();
 
+        /**
+         * @brief Logs performance stats once every `log_stats_interval` calls.
+         */
+        void log_stats_sampled() noexcept;
+
         /**
          * @brief Logs performance stats.
          */
         void log_stats() noexcept;
 
+    private:
+        /**
+         * @brief          Copies consecutive pages into a buffer.
+         * @details        The pages are read from the pool file at once. Then mapped pages and cold pages are copied over.
+         * @param page_pos Position of the first page.
+         * @param count    Number of pages.
+         * @param buffer   Buffer of `count * page_size` bytes.
+         */
+        void copy_pages(page_pos_t page_pos, std::size_t count, std::uint8_t* buffer);
+
     private:
         /**
          * @brief The config settings passed in to the constructor.
@@ -296,15 +728,70 @@ namespace abc { namespace vmem {
          */
         int _fd;
 
+        /**
+         * @brief Descriptor of the checksum side file, if `verify_page_checksums` is set.
+         */
+        int _crc_fd;
+
+        /**
+         * @brief Descriptor of the cold page side file, if it exists.
+         */
+        int _cold_fd;
+
+        /**
+         * @brief End of the last complete record in the cold page side file.
+         */
+        off_t _cold_end;
+
+        /**
+         * @brief Index of the cold pages.
+         */
+        cold_page_index _cold_index;
+
+        /**
+         * @brief Number of bytes in the cold page side file taken by the records in the index. The rest is stale.
+         */
+        off_t _cold_live_size;
+
+        /**
+         * @brief Unmapped pages whose records have been appended to the cold page side file, but whose slots have not been punched out yet.
+         */
+        std::vector<page_pos_t> _pending_punch_pages;
+
         /**
          * @brief Mapped page container.
          */
         mapped_page_container _mapped_pages;
 
+        /**
+         * @brief Mapped extent container, keyed by the position of the extent's first page.
+         */
+        mapped_extent_container _mapped_extents;
+
         /**
          * @brief Perf stats.
          */
         pool_stats _stats;
+
+        /**
+         * @brief Number of page operations since the stats were last logged.
+         */
+        std::size_t _log_stats_op_count;
+
+        /**
+         * @brief Whether the mapping capacity has been reached, and the stats have been logged for that. Reset when capacity is freed other than by eviction.
+         */
+        bool _is_at_capacity;
+
+        /**
+         * @brief Pages that have been locked since the last backup, indexed by page position.
+         */
+        std::vector<bool> _dirty_pages;
+
+        /**
+         * @brief Whether a backup has been taken by this instance.
+         */
+        bool _has_backup;
     };
 
 
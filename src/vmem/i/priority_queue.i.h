@@ -0,0 +1,184 @@
+/*
+MIT License
+
+Copyright (c) 2018-2026 Zlatko Michailov 
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#pragma once
+
+#include <functional>
+
+#include "../../diag/i/diag_ready.i.h"
+#include "layout.i.h"
+#include "pool.i.h"
+
+
+namespace abc { namespace vmem {
+
+    /**
+     * @brief    Returns the maximum number of items that could be stored on a priority queue page.
+     * @tparam T Item type.
+     */
+    template <typename T>
+    constexpr std::size_t priority_queue_page_capacity() noexcept;
+
+
+    // --------------------------------------------------------------
+
+
+    /**
+     * @brief       Priority queue - a heap that keeps the least item on top.
+     * @details     Pages form a complete tree in breadth-first order. Each page holds a binary sub-heap,
+     *              and the virtual children of its bottom items are the roots of its child pages.
+     *              Thus, `push()` and `pop()` touch only a few pages even for large queues.
+     * @tparam T    Item type. Must be trivially copyable.
+     * @tparam Less Comparison. The least item is on top.
+     */
+    template <typename T, typename Less = std::less<T>>
+    class priority_queue
+        : protected diag::diag_ready<const char*> {
+
+        using diag_base = diag::diag_ready<const char*>;
+        using heap_page = priority_queue_page<T, priority_queue_page_capacity<T>()>;
+
+    private:
+        static constexpr const char* origin() noexcept;
+
+    public:
+        using value_type      = T;
+        using const_reference = const T&;
+
+    public:
+        /**
+         * @brief Returns the maximum number of items that could be stored on a page.
+         */
+        static constexpr std::size_t page_capacity() noexcept;
+
+        /**
+         * @brief Returns the maximum number of child pages a page could have.
+         */
+        static constexpr std::size_t page_child_count() noexcept;
+
+        /**
+         * @brief Returns `true` if the given state is uninitialized; `false` if it is initialized.
+         */
+        static constexpr bool is_uninit(const priority_queue_state* state) noexcept;
+
+    public:
+        /**
+         * @brief       Constructor.
+         * @param state Pointer to a `priority_queue_state` instance.
+         * @param pool  Pointer to a `pool` instance.
+         * @param log   Pointer to a `log_ostream` instance.
+         */
+        priority_queue(priority_queue_state* state, vmem::pool* pool, diag::log_ostream* log = nullptr);
+
+        /**
+         * @brief Move constructor.
+         */
+        priority_queue(priority_queue<T, Less>&& other) noexcept = default;
+
+        /**
+         * @brief Copy constructor.
+         */
+        priority_queue(const priority_queue<T, Less>& other) noexcept = default;
+
+    public:
+        /**
+         * @brief Returns `true` if the queue has no items.
+         */
+        bool empty() const noexcept;
+
+        /**
+         * @brief Returns the number of items in the queue.
+         */
+        std::size_t size() const noexcept;
+
+        /**
+         * @brief   Returns a copy of the least item.
+         * @details The queue must not be empty.
+         */
+        T top() const;
+
+        /**
+         * @brief      Inserts an item.
+         * @param item Item to insert.
+         */
+        void push(const_reference item);
+
+        /**
+         * @brief   Removes the least item.
+         * @details The queue must not be empty.
+         */
+        void pop();
+
+        /**
+         * @brief Removes all items, and frees all pages.
+         */
+        void clear();
+
+    private:
+        /**
+         * @brief       Allocates a new page, and links it as the last page.
+         * @param page  Out. The new page.
+         * @return      Pointer to the new page's contents.
+         */
+        heap_page* push_page(vmem::page& page);
+
+        /**
+         * @brief       Unlinks and frees the last page, which must be empty.
+         * @param page  The last page.
+         */
+        void pop_page(vmem::page& page);
+
+        /**
+         * @brief       Returns the position of a page given its breadth-first index.
+         * @details     Walks down from the root page.
+         * @param index Breadth-first index of the page.
+         */
+        page_pos_t page_pos_at(std::size_t index) const;
+
+        /**
+         * @brief          Moves an item up until its parent is not greater.
+         * @param page_pos Position of the page of the item.
+         * @param item_pos Position of the item on the page.
+         */
+        void sift_up(page_pos_t page_pos, std::size_t item_pos);
+
+        /**
+         * @brief          Moves an item down until none of its children is less.
+         * @param page_pos Position of the page of the item.
+         * @param item_pos Position of the item on the page.
+         */
+        void sift_down(page_pos_t page_pos, std::size_t item_pos);
+
+    private:
+        priority_queue_state* _state;
+        vmem::pool*           _pool;
+        Less                  _less;
+    };
+
+
+    // --------------------------------------------------------------
+
+} }
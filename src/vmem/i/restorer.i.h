@@ -0,0 +1,87 @@
+/*
+MIT License
+
+Copyright (c) 2018-2026 Zlatko Michailov 
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#pragma once
+
+#include <istream>
+#include <string>
+
+#include "../../diag/i/diag_ready.i.h"
+#include "layout.i.h"
+#include "pool.i.h"
+
+
+namespace abc { namespace vmem {
+
+    /**
+     * @brief   Restores pool files from backups taken by `pool::backup()`.
+     * @details Writes the pool file directly - not through a `pool` instance. The pool file must not be open by a pool.
+     */
+    class restorer
+        : protected diag::diag_ready<const char*> {
+
+        using diag_base = diag::diag_ready<const char*>;
+
+    private:
+        static constexpr const char* origin() noexcept;
+
+    public:
+        /**
+         * @brief           Constructor.
+         * @param file_path Path to the pool file to restore.
+         * @param log       Pointer to a `log_ostream` instance.
+         */
+        restorer(const char* file_path, diag::log_ostream* log = nullptr);
+
+        /**
+         * @brief Deleted.
+         */
+        restorer(restorer&& other) = delete;
+
+        /**
+         * @brief Deleted.
+         */
+        restorer(const restorer& other) = delete;
+
+    public:
+        /**
+         * @brief        Applies an incremental backup.
+         * @details      The pool file must be a restored copy of the backup that preceded the incremental one.
+         *               The pool file is resized to the page count of the incremental backup.
+         *               The checksum and cold page side files, if any, become stale, and should be deleted.
+         * @param stream Input stream with an incremental backup.
+         * @return       The number of pages written.
+         */
+        std::size_t apply_increment(std::istream& stream);
+
+    private:
+        std::string _file_path;
+    };
+
+
+    // --------------------------------------------------------------
+
+} }
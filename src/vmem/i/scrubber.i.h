@@ -0,0 +1,182 @@
+/*
+MIT License
+
+Copyright (c) 2018-2026 Zlatko Michailov 
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../../diag/i/diag_ready.i.h"
+#include "layout.i.h"
+#include "pool.i.h"
+
+
+namespace abc { namespace vmem {
+
+    /**
+     * @brief   Background scrubber of a pool file.
+     * @details Reads the pool file directly - not through a `pool` instance - so it can run on its own thread next to a live pool.
+     *          On each pass, verifies the root page, the page checksums (see `pool_config::verify_page_checksums`), and the links of the free page list.
+     *          The links of container page chains are verified too, for the chains whose `linked_state` locations have been added through `add_linked_state()`.
+     *          The scrubber can't discover those locations on its own, because container states live in pages owned by the app.
+     *          Problems are reported through the log as warnings. Chains that are being modified while they are scrubbed may be reported as false positives.
+     */
+    class scrubber
+        : protected diag::diag_ready<const char*> {
+
+        using diag_base = diag::diag_ready<const char*>;
+
+    private:
+        static constexpr const char* origin() noexcept;
+
+    public:
+        /**
+         * @brief            Constructor.
+         * @param file_path  Path to the pool file.
+         * @param page_pause Pause after each page, which keeps the scrubber at a low priority. Default: none.
+         * @param pass_pause Pause between passes when running on a background thread. Default: 1 minute.
+         * @param log        Pointer to a `log_ostream` instance.
+         */
+        scrubber(const char* file_path, std::chrono::microseconds page_pause = std::chrono::microseconds(0), std::chrono::milliseconds pass_pause = std::chrono::milliseconds(60000), diag::log_ostream* log = nullptr);
+
+        /**
+         * @brief Deleted.
+         */
+        scrubber(scrubber&& other) = delete;
+
+        /**
+         * @brief Deleted.
+         */
+        scrubber(const scrubber& other) = delete;
+
+        /**
+         * @brief Destructor. Stops the background thread, if started.
+         */
+        ~scrubber() noexcept;
+
+    public:
+        /**
+         * @brief          Adds the location of a `linked_state`, e.g. the state of a container, whose page chain should be verified on each pass.
+         * @details        Must be called before `start()`.
+         * @param page_pos Position of the page that contains the `linked_state`.
+         * @param item_pos Byte offset of the `linked_state` within the page.
+         */
+        void add_linked_state(page_pos_t page_pos, item_pos_t item_pos);
+
+        /**
+         * @brief  Runs a single pass on the calling thread.
+         * @return The number of problems found.
+         */
+        std::size_t scrub();
+
+        /**
+         * @brief Starts running passes on a background thread.
+         */
+        void start();
+
+        /**
+         * @brief Stops the background thread, and waits for it to exit.
+         */
+        void stop() noexcept;
+
+    private:
+        /**
+         * @brief           Verifies the root page.
+         * @param root_page Root page as read from the pool file.
+         * @return          The number of problems found.
+         */
+        std::size_t scrub_root_page(const root_page& root_page);
+
+        /**
+         * @brief            Verifies the checksums of all pages that are not currently mapped.
+         * @param fd         Descriptor of the pool file.
+         * @param page_count Number of pages in the pool file.
+         * @return           The number of problems found.
+         */
+        std::size_t scrub_page_checksums(int fd, page_pos_t page_count);
+
+        /**
+         * @brief            Verifies the links of the container page chains whose `linked_state` locations have been added.
+         * @param fd         Descriptor of the pool file.
+         * @param page_count Number of pages in the pool file.
+         * @return           The number of problems found.
+         */
+        std::size_t scrub_linked_states(int fd, page_pos_t page_count);
+
+        /**
+         * @brief              Verifies the links of a page chain - the free page list or the pages of a container.
+         * @param fd           Descriptor of the pool file.
+         * @param page_count   Number of pages in the pool file.
+         * @param linked_state State of the chain.
+         * @return             The number of problems found.
+         */
+        std::size_t scrub_linked(int fd, page_pos_t page_count, const linked_state& linked_state);
+
+        /**
+         * @brief          Reads a page from the pool file, or from the cold page side file if the page is cold.
+         * @param fd       Descriptor of the pool file.
+         * @param page_pos Page position.
+         * @param buffer   Buffer of at least `page_size` bytes.
+         * @return         `true` if the whole page has been read.
+         */
+        bool read_page(int fd, page_pos_t page_pos, void* buffer) const noexcept;
+
+        /**
+         * @brief Returns `true` if the background thread should exit. Otherwise, waits for the given duration and returns `false`.
+         */
+        template <typename Duration>
+        bool wait_for_stop(Duration duration);
+
+        /**
+         * @brief Background thread function.
+         */
+        static void thread_func(scrubber* this_ptr) noexcept;
+
+    private:
+        std::string                _file_path;
+        std::chrono::microseconds  _page_pause;
+        std::chrono::milliseconds  _pass_pause;
+
+        std::thread                _thread;
+        std::mutex                 _stop_mutex;
+        std::condition_variable    _stop_condition;
+        bool                       _stop_requested;
+
+        int                        _cold_fd;
+        cold_page_index            _cold_index;
+
+        std::vector<std::pair<page_pos_t, item_pos_t>> _linked_state_locations;
+    };
+
+
+    // --------------------------------------------------------------
+
+} }
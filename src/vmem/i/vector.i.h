@@ -0,0 +1,216 @@
+/*
+MIT License
+
+Copyright (c) 2018-2026 Zlatko Michailov 
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#pragma once
+
+#include "container.i.h"
+#include "list.i.h"
+
+
+namespace abc { namespace vmem {
+
+    /**
+     * @brief    Vector iterator.
+     * @tparam T Item type.
+     */
+    template <typename T>
+    using vector_iterator = container_iterator<T, vector_page_header>;
+
+
+    /**
+     * @brief    Vector const iterator.
+     * @tparam T Item type.
+     */
+    template <typename T>
+    using vector_const_iterator = container_const_iterator<T, vector_page_header>;
+
+
+    // --------------------------------------------------------------
+
+
+    /**
+     * @brief    Dense sequence of items with positional access in O(log n).
+     * @details  Items are only inserted and erased at the end. Thus, all pages except the back page are full, and each page has a fixed index.
+     *           The positions of the pages are kept on a stack of page index levels - a level has the positions of the pages on the level below.
+     *           The top level has a single page. So an item is reached by locking one page per level.
+     * @tparam T Item type.
+     */
+    template <typename T>
+    class vector
+        : protected container<T, vector_page_header> {
+
+        using base = container<T, vector_page_header>;
+        using diag_base = diag::diag_ready<const char*>;
+        using vector_page = vmem::vector_page<T>;
+        using page_level = stack<page_pos_t>;
+        using page_level_stack = stack<stack_state>;
+        using page_level_stack_iterator = typename stack<stack_state>::iterator;
+
+        static constexpr page_balance balance_insert = page_balance::none;
+        static constexpr page_balance balance_erase  = page_balance::none;
+
+    public:
+        using value_type             = typename base::value_type;
+        using pointer                = typename base::pointer;
+        using const_pointer          = typename base::const_pointer;
+        using reference              = typename base::reference;
+        using const_reference        = typename base::const_reference;
+        using iterator               = typename base::iterator;
+        using const_iterator         = typename base::const_iterator;
+        using reverse_iterator       = typename base::reverse_iterator;
+        using const_reverse_iterator = typename base::const_reverse_iterator;
+
+    public:
+        using base::items_pos;
+        using base::max_item_size;
+        using base::page_capacity;
+
+    public:
+        /**
+         * @brief       Constructor.
+         * @param state Pointer to a `vector_state` instance.
+         * @param pool  Pointer to a `pool` instance.
+         * @param log   Pointer to a `log_ostream` instance.
+         */
+        vector(vector_state* state, vmem::pool* pool, diag::log_ostream* log = nullptr);
+
+        /**
+         * @brief Move constructor.
+         */
+        vector(vector<T>&& other) noexcept = default;
+
+        /**
+         * @brief Copy constructor.
+         */
+        vector(const vector<T>& other) noexcept = default;
+
+    public:
+        using base::begin;
+        using base::cbegin;
+        using base::end;
+        using base::cend;
+        using base::rend;
+        using base::crend;
+        using base::rbegin;
+        using base::crbegin;
+
+    public:
+        using base::empty;
+        using base::size;
+        using base::frontptr;
+        using base::front;
+        using base::backptr;
+        using base::back;
+
+        /**
+         * @brief      Copies an item after the back. A new page may be linked, and indexed.
+         * @param item Item.
+         */
+        void push_back(const_reference item);
+
+        /**
+         * @brief Removes the back item. A page may be unlinked, and removed from the index.
+         */
+        void pop_back();
+
+        /**
+         * @brief Erases all items and all page index levels.
+         */
+        void clear();
+
+    // Positional access
+    public:
+        /**
+         * @brief       Returns a reference to the item at the given index.
+         * @param index Zero-based index of the item. Must be less than `size()`.
+         */
+        reference               operator [](std::size_t index);
+
+        /**
+         * @brief       Returns a const reference to the item at the given index.
+         * @param index Zero-based index of the item. Must be less than `size()`.
+         */
+        const_reference         operator [](std::size_t index) const;
+
+        /**
+         * @brief       Returns an iterator referencing the item at the given index.
+         * @details     Locks one page per page index level.
+         * @param index Zero-based index of the item. `size()` returns `end()`.
+         */
+        iterator                iterator_at(std::size_t index) const;
+
+        /**
+         * @brief     Returns the zero-based index of the item referenced by the given iterator.
+         * @details   Only locks the iterator's page.
+         * @param itr Iterator.
+         * @return    `size()` for `end()`.
+         */
+        std::size_t             index_of(const_iterator itr) const;
+
+        /**
+         * @brief       Returns an iterator that is `n` items away from the given one.
+         * @details     Advancing past either edge returns `end()` or `rbegin()`.
+         * @param itr   Iterator.
+         * @param n     Number of items to advance. May be negative.
+         */
+        iterator                advance(const_iterator itr, std::ptrdiff_t n) const;
+
+        /**
+         * @brief       Returns the number of items between two iterators.
+         * @param first Begin iterator.
+         * @param last  End iterator.
+         */
+        std::ptrdiff_t          distance(const_iterator first, const_iterator last) const;
+
+    // Page index helpers
+    private:
+        /**
+         * @brief            Returns the position of the page with the given index.
+         * @param page_index Zero-based index of the page.
+         */
+        page_pos_t page_pos_at(std::size_t page_index) const;
+
+        /**
+         * @brief          Adds a new back page to the page index levels.
+         * @param page_pos Position of the new back page.
+         */
+        void push_back_page(page_pos_t page_pos);
+
+        /**
+         * @brief Removes the unlinked back page from the page index levels.
+         */
+        void pop_back_page();
+
+    private:
+        vector_state*            _state;
+        vmem::pool*              _pool;
+        page_level_stack         _page_levels;
+    };
+
+
+    // --------------------------------------------------------------
+
+} }
@@ -0,0 +1,462 @@
+/*
+MIT License
+
+Copyright (c) 2018-2026 Zlatko Michailov 
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#pragma once
+
+#include "map.h"
+#include "i/indexed_map.i.h"
+
+
+namespace abc { namespace vmem {
+
+    template <typename IndexKey, typename Key>
+    inline bool operator <(const map_index_key<IndexKey, Key>& left, const map_index_key<IndexKey, Key>& right) noexcept {
+        return left.index_key < right.index_key
+            || (left.index_key == right.index_key && left.key < right.key);
+    }
+
+
+    template <typename IndexKey, typename Key>
+    inline bool operator <=(const map_index_key<IndexKey, Key>& left, const map_index_key<IndexKey, Key>& right) noexcept {
+        return !(right < left);
+    }
+
+
+    template <typename IndexKey, typename Key>
+    inline bool operator >(const map_index_key<IndexKey, Key>& left, const map_index_key<IndexKey, Key>& right) noexcept {
+        return right < left;
+    }
+
+
+    template <typename IndexKey, typename Key>
+    inline bool operator >=(const map_index_key<IndexKey, Key>& left, const map_index_key<IndexKey, Key>& right) noexcept {
+        return !(left < right);
+    }
+
+
+    template <typename IndexKey, typename Key>
+    inline bool operator ==(const map_index_key<IndexKey, Key>& left, const map_index_key<IndexKey, Key>& right) noexcept {
+        return left.index_key == right.index_key && left.key == right.key;
+    }
+
+
+    template <typename IndexKey, typename Key>
+    inline bool operator !=(const map_index_key<IndexKey, Key>& left, const map_index_key<IndexKey, Key>& right) noexcept {
+        return !(left == right);
+    }
+
+
+    // --------------------------------------------------------------
+
+
+    template <typename Key, typename T, typename IndexKey>
+    inline constexpr const char* map_index<Key, T, IndexKey>::origin() noexcept {
+        return "abc::vmem::map_index";
+    }
+
+
+    template <typename Key, typename T, typename IndexKey>
+    inline map_index<Key, T, IndexKey>::map_index(map_state* state, extractor_type&& extractor, vmem::pool* pool, diag::log_ostream* log)
+        : diag_base(abc::copy(origin()), log)
+        , _map(state, pool, log)
+        , _extractor(std::move(extractor)) {
+
+        constexpr const char* suborigin = "map_index()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10de1, "Begin: state=%p, pool=%p", state, pool);
+
+        diag_base::expect(suborigin, static_cast<bool>(_extractor), 0x10de2, "static_cast<bool>(_extractor)");
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10de3, "End: size=%zu", _map.size());
+    }
+
+
+    template <typename Key, typename T, typename IndexKey>
+    inline typename map_index<Key, T, IndexKey>::const_iterator map_index<Key, T, IndexKey>::begin() const noexcept {
+        return _map.cbegin();
+    }
+
+
+    template <typename Key, typename T, typename IndexKey>
+    inline typename map_index<Key, T, IndexKey>::const_iterator map_index<Key, T, IndexKey>::cbegin() const noexcept {
+        return _map.cbegin();
+    }
+
+
+    template <typename Key, typename T, typename IndexKey>
+    inline typename map_index<Key, T, IndexKey>::const_iterator map_index<Key, T, IndexKey>::end() const noexcept {
+        return _map.cend();
+    }
+
+
+    template <typename Key, typename T, typename IndexKey>
+    inline typename map_index<Key, T, IndexKey>::const_iterator map_index<Key, T, IndexKey>::cend() const noexcept {
+        return _map.cend();
+    }
+
+
+    template <typename Key, typename T, typename IndexKey>
+    inline bool map_index<Key, T, IndexKey>::empty() const noexcept {
+        return _map.empty();
+    }
+
+
+    template <typename Key, typename T, typename IndexKey>
+    inline std::size_t map_index<Key, T, IndexKey>::size() const noexcept {
+        return _map.size();
+    }
+
+
+    template <typename Key, typename T, typename IndexKey>
+    inline typename map_index<Key, T, IndexKey>::const_iterator map_index<Key, T, IndexKey>::lower_bound(const IndexKey& index_key) const {
+        index_key_type first_key;
+        first_key.index_key = index_key;
+
+        const_iterator itr = _map.lower_bound(first_key);
+
+        // A value-initialized primary key may not be the least one. Step back over the entries with the same index key.
+        while (itr != _map.cbegin()) {
+            const_iterator prev_itr = itr;
+            prev_itr--;
+
+            if (prev_itr->key.index_key < index_key) {
+                break;
+            }
+
+            itr = prev_itr;
+        }
+
+        return itr;
+    }
+
+
+    template <typename Key, typename T, typename IndexKey>
+    inline typename map_index<Key, T, IndexKey>::const_iterator map_index<Key, T, IndexKey>::upper_bound(const IndexKey& index_key) const {
+        const_iterator itr = lower_bound(index_key);
+        while (itr != _map.cend() && itr->key.index_key == index_key) {
+            itr++;
+        }
+
+        return itr;
+    }
+
+
+    template <typename Key, typename T, typename IndexKey>
+    inline typename map_index<Key, T, IndexKey>::const_range map_index<Key, T, IndexKey>::find_range(const IndexKey& first, const IndexKey& last) const {
+        return const_range(lower_bound(first), lower_bound(last));
+    }
+
+
+    template <typename Key, typename T, typename IndexKey>
+    inline std::size_t map_index<Key, T, IndexKey>::count(const IndexKey& index_key) const {
+        std::size_t result = 0;
+
+        const_iterator last = upper_bound(index_key);
+        for (const_iterator itr = lower_bound(index_key); itr != last; itr++) {
+            result++;
+        }
+
+        return result;
+    }
+
+
+    template <typename Key, typename T, typename IndexKey>
+    inline void map_index<Key, T, IndexKey>::insert(const map_value<Key, T>& item) {
+        constexpr const char* suborigin = "insert()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10de4, "Begin:");
+
+        map_value<index_key_type, novalue> entry;
+        entry.key = make_key(item);
+
+        bool inserted = _map.insert(entry).second;
+        diag_base::ensure(suborigin, inserted, 0x10de5, "inserted");
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10de6, "End: size=%zu", _map.size());
+    }
+
+
+    template <typename Key, typename T, typename IndexKey>
+    inline void map_index<Key, T, IndexKey>::erase(const map_value<Key, T>& item) {
+        constexpr const char* suborigin = "erase()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10de7, "Begin:");
+
+        std::size_t erased = _map.erase(make_key(item));
+        diag_base::ensure(suborigin, erased == 1, 0x10de8, "erased == 1");
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10de9, "End: size=%zu", _map.size());
+    }
+
+
+    template <typename Key, typename T, typename IndexKey>
+    inline void map_index<Key, T, IndexKey>::clear() {
+        _map.clear();
+    }
+
+
+    template <typename Key, typename T, typename IndexKey>
+    inline void map_index<Key, T, IndexKey>::compact() {
+        _map.compact();
+    }
+
+
+    template <typename Key, typename T, typename IndexKey>
+    inline typename map_index<Key, T, IndexKey>::index_key_type map_index<Key, T, IndexKey>::make_key(const map_value<Key, T>& item) const {
+        index_key_type key;
+        key.index_key = _extractor(item.key, item.value);
+        key.key = item.key;
+
+        return key;
+    }
+
+
+    // --------------------------------------------------------------
+
+
+    template <typename Key, typename T>
+    inline indexed_map<Key, T>::indexed_map(map_state* state, vmem::pool* pool, diag::log_ostream* log)
+        : base(state, pool, log)
+        , _pool(pool) {
+    }
+
+
+    template <typename Key, typename T>
+    template <typename IndexKey>
+    inline map_index<Key, T, IndexKey>* indexed_map<Key, T>::add_index(map_state* state, std::function<IndexKey(const Key&, const T&)>&& extractor) {
+        constexpr const char* suborigin = "add_index()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10dea, "Begin: state=%p, index_count=%zu", state, _indexes.size());
+
+        map_index<Key, T, IndexKey>* index = new map_index<Key, T, IndexKey>(state, std::move(extractor), _pool, diag_base::log());
+        _indexes.emplace_back(index);
+
+        // Build the index from the existing items.
+        if (index->empty() && !base::empty()) {
+            for (typename base::const_iterator itr = base::cbegin(); itr != base::cend(); itr++) {
+                index->insert(*itr);
+            }
+        }
+
+        diag_base::ensure(suborigin, index->size() == base::size(), 0x10deb, "index->size() == base::size()");
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10dec, "End: index_count=%zu", _indexes.size());
+
+        return index;
+    }
+
+
+    template <typename Key, typename T>
+    inline typename indexed_map<Key, T>::const_iterator indexed_map<Key, T>::begin() const noexcept {
+        return base::cbegin();
+    }
+
+
+    template <typename Key, typename T>
+    inline typename indexed_map<Key, T>::const_iterator indexed_map<Key, T>::cbegin() const noexcept {
+        return base::cbegin();
+    }
+
+
+    template <typename Key, typename T>
+    inline typename indexed_map<Key, T>::const_iterator indexed_map<Key, T>::end() const noexcept {
+        return base::cend();
+    }
+
+
+    template <typename Key, typename T>
+    inline typename indexed_map<Key, T>::const_iterator indexed_map<Key, T>::cend() const noexcept {
+        return base::cend();
+    }
+
+
+    template <typename Key, typename T>
+    inline typename indexed_map<Key, T>::const_reverse_iterator indexed_map<Key, T>::rend() const noexcept {
+        return base::crend();
+    }
+
+
+    template <typename Key, typename T>
+    inline typename indexed_map<Key, T>::const_reverse_iterator indexed_map<Key, T>::crend() const noexcept {
+        return base::crend();
+    }
+
+
+    template <typename Key, typename T>
+    inline typename indexed_map<Key, T>::const_reverse_iterator indexed_map<Key, T>::rbegin() const noexcept {
+        return base::crbegin();
+    }
+
+
+    template <typename Key, typename T>
+    inline typename indexed_map<Key, T>::const_reverse_iterator indexed_map<Key, T>::crbegin() const noexcept {
+        return base::crbegin();
+    }
+
+
+    template <typename Key, typename T>
+    inline bool indexed_map<Key, T>::empty() const noexcept {
+        return base::empty();
+    }
+
+
+    template <typename Key, typename T>
+    inline std::size_t indexed_map<Key, T>::size() const noexcept {
+        return base::size();
+    }
+
+
+    template <typename Key, typename T>
+    inline typename indexed_map<Key, T>::const_iterator_bool indexed_map<Key, T>::insert(const_reference item) {
+        constexpr const char* suborigin = "insert()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10ded, "Begin:");
+
+        typename base::result2 result = base::insert2(item);
+
+        if (result.ok) {
+            for (std::unique_ptr<map_index_base<Key, T>>& index : _indexes) {
+                index->insert(item);
+            }
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10dee, "End: ok=%d", result.ok);
+
+        return const_iterator_bool(const_iterator(result.iterator), result.ok);
+    }
+
+
+    template <typename Key, typename T>
+    template <typename InputItr>
+    inline void indexed_map<Key, T>::insert(InputItr first, InputItr last) {
+        for (InputItr item_itr = first; item_itr != last; item_itr++) {
+            insert(*item_itr);
+        }
+    }
+
+
+    template <typename Key, typename T>
+    inline std::size_t indexed_map<Key, T>::erase(const Key& key) {
+        constexpr const char* suborigin = "erase()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10def, "Begin:");
+
+        std::size_t result = 0;
+
+        typename base::find_result2 find_result = base::find2(key);
+
+        if (find_result.ok) {
+            // Copy the item before it is erased, so the index entries can be erased too.
+            typename base::value_type item = *find_result.iterator;
+
+            result = base::erase2(std::move(find_result));
+
+            if (result > 0) {
+                for (std::unique_ptr<map_index_base<Key, T>>& index : _indexes) {
+                    index->erase(item);
+                }
+            }
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10df0, "End: result=%zu", result);
+
+        return result;
+    }
+
+
+    template <typename Key, typename T>
+    template <typename InputItr>
+    inline void indexed_map<Key, T>::erase(InputItr first, InputItr last) {
+        for (InputItr item_itr = first; item_itr != last; item_itr++) {
+            erase(*item_itr);
+        }
+    }
+
+
+    template <typename Key, typename T>
+    inline void indexed_map<Key, T>::clear() {
+        base::clear();
+
+        for (std::unique_ptr<map_index_base<Key, T>>& index : _indexes) {
+            index->clear();
+        }
+    }
+
+
+    template <typename Key, typename T>
+    inline void indexed_map<Key, T>::compact() {
+        constexpr const char* suborigin = "compact()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10fef, "Begin: index_count=%zu", _indexes.size());
+
+        base::compact();
+
+        for (std::unique_ptr<map_index_base<Key, T>>& index : _indexes) {
+            index->compact();
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10ff0, "End:");
+    }
+
+
+    template <typename Key, typename T>
+    inline typename indexed_map<Key, T>::const_iterator indexed_map<Key, T>::find(const Key& key) const {
+        return base::find(key);
+    }
+
+
+    template <typename Key, typename T>
+    inline typename indexed_map<Key, T>::const_iterator indexed_map<Key, T>::lower_bound(const Key& key) const {
+        return base::lower_bound(key);
+    }
+
+
+    template <typename Key, typename T>
+    inline typename indexed_map<Key, T>::const_iterator indexed_map<Key, T>::upper_bound(const Key& key) const {
+        return base::upper_bound(key);
+    }
+
+
+    template <typename Key, typename T>
+    inline typename indexed_map<Key, T>::const_range indexed_map<Key, T>::equal_range(const Key& key) const {
+        return base::equal_range(key);
+    }
+
+
+    template <typename Key, typename T>
+    inline typename indexed_map<Key, T>::const_range indexed_map<Key, T>::find_range(const Key& first, const Key& last) const {
+        return base::find_range(first, last);
+    }
+
+
+    template <typename Key, typename T>
+    inline bool indexed_map<Key, T>::contains(const Key& key) const {
+        return base::contains(key);
+    }
+
+
+    template <typename Key, typename T>
+    inline typename indexed_map<Key, T>::const_pointer indexed_map<Key, T>::operator [](const Key& key) const {
+        return base::operator[](key);
+    }
+
+
+    // --------------------------------------------------------------
+
+} }
@@ -49,9 +49,9 @@ namespace abc { namespace vmem {
         , _edge(edge) {
 
         constexpr const char* suborigin = "basic_iterator_state()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10604, "Begin: _page_pos=0x%llx, _item_pos=0x%x", (unsigned long long)_page_pos, (unsigned)_item_pos);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10604, "Begin: _page_pos=0x%llx, _item_pos=0x%x", (unsigned long long)_page_pos, (unsigned)_item_pos);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a13, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a13, "End:");
     }
 
 
@@ -64,7 +64,7 @@ namespace abc { namespace vmem {
     template <typename Container>
     inline bool basic_iterator_state<Container>::operator ==(const basic_iterator_state<Container>& other) const noexcept {
         constexpr const char* suborigin = "operator ==()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10605, "Begin: _page_pos=0x%llx, _item_pos=0x%x, _edge=%u, other._page_pos=0x%llx, other._item_pos=0x%x, other._edge=%u",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10605, "Begin: _page_pos=0x%llx, _item_pos=0x%x, _edge=%u, other._page_pos=0x%llx, other._item_pos=0x%x, other._edge=%u",
             (unsigned long long)_page_pos, (unsigned)_item_pos, (unsigned)_edge, (unsigned long long)other._page_pos, (unsigned)other._item_pos, (unsigned)other._edge);
 
         bool are_equal = _container == other._container
@@ -72,7 +72,7 @@ namespace abc { namespace vmem {
             && _item_pos == other._item_pos
             && _edge == other._edge;
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a14, "End: are_equal=%d", are_equal);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a14, "End: are_equal=%d", are_equal);
 
         return are_equal;
     }
@@ -181,13 +181,13 @@ namespace abc { namespace vmem {
     template <typename Base, typename Container, typename T>
     inline basic_iterator<Base, Container, T>& basic_iterator<Base, Container, T>::operator ++() noexcept {
         constexpr const char* suborigin = "operator ++()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x107ae, "Begin: _page_pos=0x%llx, _item_pos=0x%x, _edge=%u", (unsigned long long)base::_page_pos, (unsigned)base::_item_pos, (unsigned)base::_edge);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x107ae, "Begin: _page_pos=0x%llx, _item_pos=0x%x, _edge=%u", (unsigned long long)base::_page_pos, (unsigned)base::_item_pos, (unsigned)base::_edge);
 
         if (Base::is_valid()) {
             *this = Base::_container->next(*this);
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a15, "End: _page_pos=0x%llx, _item_pos=0x%x, _edge=%u", (unsigned long long)base::_page_pos, (unsigned)base::_item_pos, (unsigned)base::_edge);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a15, "End: _page_pos=0x%llx, _item_pos=0x%x, _edge=%u", (unsigned long long)base::_page_pos, (unsigned)base::_item_pos, (unsigned)base::_edge);
 
         return *this;
     }
@@ -196,7 +196,7 @@ namespace abc { namespace vmem {
     template <typename Base, typename Container, typename T>
     inline basic_iterator<Base, Container, T> basic_iterator<Base, Container, T>::operator ++(int) noexcept {
         constexpr const char* suborigin = "operator ++(int)";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x107af, "Begin: _page_pos=0x%llx, _item_pos=0x%x, _edge=%u", (unsigned long long)base::_page_pos, (unsigned)base::_item_pos, (unsigned)base::_edge);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x107af, "Begin: _page_pos=0x%llx, _item_pos=0x%x, _edge=%u", (unsigned long long)base::_page_pos, (unsigned)base::_item_pos, (unsigned)base::_edge);
 
         basic_iterator<Base, Container, T> thisCopy = *this;
 
@@ -204,7 +204,7 @@ namespace abc { namespace vmem {
             *this = Base::_container->next(*this);
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a16, "End: _page_pos=0x%llx, _item_pos=0x%x, _edge=%u", (unsigned long long)base::_page_pos, (unsigned)base::_item_pos, (unsigned)base::_edge);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a16, "End: _page_pos=0x%llx, _item_pos=0x%x, _edge=%u", (unsigned long long)base::_page_pos, (unsigned)base::_item_pos, (unsigned)base::_edge);
 
         return thisCopy;
     }
@@ -213,13 +213,13 @@ namespace abc { namespace vmem {
     template <typename Base, typename Container, typename T>
     inline basic_iterator<Base, Container, T>& basic_iterator<Base, Container, T>::operator --() noexcept {
         constexpr const char* suborigin = "operator --()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x107b0, "Begin: _page_pos=0x%llx, _item_pos=0x%x, _edge=%u", (unsigned long long)base::_page_pos, (unsigned)base::_item_pos, (unsigned)base::_edge);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x107b0, "Begin: _page_pos=0x%llx, _item_pos=0x%x, _edge=%u", (unsigned long long)base::_page_pos, (unsigned)base::_item_pos, (unsigned)base::_edge);
 
         if (Base::is_valid()) {
             *this = Base::_container->prev(*this);
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a17, "End: _page_pos=0x%llx, _item_pos=0x%x, _edge=%u", (unsigned long long)base::_page_pos, (unsigned)base::_item_pos, (unsigned)base::_edge);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a17, "End: _page_pos=0x%llx, _item_pos=0x%x, _edge=%u", (unsigned long long)base::_page_pos, (unsigned)base::_item_pos, (unsigned)base::_edge);
 
         return *this;
     }
@@ -228,7 +228,7 @@ namespace abc { namespace vmem {
     template <typename Base, typename Container, typename T>
     inline basic_iterator<Base, Container, T> basic_iterator<Base, Container, T>::operator --(int) noexcept {
         constexpr const char* suborigin = "operator --(int)";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x107b1, "Begin: _page_pos=0x%llx, _item_pos=0x%x, _edge=%u", (unsigned long long)base::_page_pos, (unsigned)base::_item_pos, (unsigned)base::_edge);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x107b1, "Begin: _page_pos=0x%llx, _item_pos=0x%x, _edge=%u", (unsigned long long)base::_page_pos, (unsigned)base::_item_pos, (unsigned)base::_edge);
 
         basic_iterator<Base, Container, T> thisCopy = *this;
 
@@ -236,7 +236,7 @@ namespace abc { namespace vmem {
             *this = Base::_container->prev(*this);
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a18, "End: _page_pos=0x%llx, _item_pos=0x%x, _edge=%u", (unsigned long long)base::_page_pos, (unsigned)base::_item_pos, (unsigned)base::_edge);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a18, "End: _page_pos=0x%llx, _item_pos=0x%x, _edge=%u", (unsigned long long)base::_page_pos, (unsigned)base::_item_pos, (unsigned)base::_edge);
 
         return thisCopy;
     }
@@ -280,12 +280,12 @@ namespace abc { namespace vmem {
     template <typename Base, typename Container, typename T>
     inline T& basic_iterator<Base, Container, T>::deref() const {
         constexpr const char* suborigin = "deref()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a19, "Begin: _page_pos=0x%llx, _item_pos=0x%x, _edge=%u", (unsigned long long)base::_page_pos, (unsigned)base::_item_pos, (unsigned)base::_edge);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a19, "Begin: _page_pos=0x%llx, _item_pos=0x%x, _edge=%u", (unsigned long long)base::_page_pos, (unsigned)base::_item_pos, (unsigned)base::_edge);
 
         pointer p = ptr();
         diag_base::expect(suborigin, p != nullptr, 0x10606, "p != nullptr");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x107b2, "End: page_pos=0x%llx, byte_pos=0x%x", (unsigned long long)p.page_pos(), (unsigned)p.byte_pos());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x107b2, "End: page_pos=0x%llx, byte_pos=0x%x", (unsigned long long)p.page_pos(), (unsigned)p.byte_pos());
 
         return *p;
     }
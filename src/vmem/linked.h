@@ -67,7 +67,7 @@ namespace abc { namespace vmem {
         , _is_free_pages(is_free_pages) {
 
         constexpr const char* suborigin = "linked()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1048a, "Begin: _state=%p, _pool=%p", _state, _pool);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1048a, "Begin: _state=%p, _pool=%p", _state, _pool);
 
         diag_base::expect(suborigin, _state != nullptr, 0x1048b, "_state != nullptr");
         diag_base::expect(suborigin, _pool != nullptr, 0x1048c, "_pool != nullptr");
@@ -77,7 +77,7 @@ namespace abc { namespace vmem {
             _state->back_page_pos = page_pos_nil;
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a1a, "End: front_page_pos=0x%llx, back_page_pos=0x%llx", 
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a1a, "End: front_page_pos=0x%llx, back_page_pos=0x%llx", 
                 (unsigned long long)_state->front_page_pos, (unsigned long long)_state->back_page_pos);
     }
 
@@ -198,7 +198,7 @@ namespace abc { namespace vmem {
 
     inline typename linked::iterator linked::insert(const_iterator itr, const_reference page_pos) {
         constexpr const char* suborigin = "insert()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10490, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x, page_pos=0x%llx",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10490, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x, page_pos=0x%llx",
             (unsigned long long)itr.page_pos(), (unsigned)itr.item_pos(), (unsigned long long)page_pos);
 
         diag_base::expect(suborigin, itr.item_pos() == item_pos_nil, 0x1048e, "itr.item_pos() == item_pos_nil");
@@ -220,7 +220,7 @@ namespace abc { namespace vmem {
             _state->back_page_pos = page_pos;
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10491, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10491, "End:");
 
         return result;
     }
@@ -228,7 +228,7 @@ namespace abc { namespace vmem {
 
     inline void linked::insert_nostate(const_iterator itr, const_reference page_pos, page_pos_t back_page_pos) {
         constexpr const char* suborigin = "insert_nostate()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10492, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x, page_pos=0x%llx",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10492, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x, page_pos=0x%llx",
             (unsigned long long)itr.page_pos(), (unsigned)itr.item_pos(), (unsigned long long)page_pos);
 
         diag_base::expect(suborigin, page_pos != page_pos_nil, 0x10a1b, "page_pos != page_pos_nil");
@@ -289,7 +289,7 @@ namespace abc { namespace vmem {
             }
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10497, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10497, "End:");
     }
 
 
@@ -298,7 +298,7 @@ namespace abc { namespace vmem {
 
     inline typename linked::iterator linked::erase(const_iterator itr) {
         constexpr const char* suborigin = "erase()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10499, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x", (unsigned long long)itr.page_pos(), (unsigned)itr.item_pos());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10499, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x", (unsigned long long)itr.page_pos(), (unsigned)itr.item_pos());
 
         diag_base::expect(suborigin, itr.item_pos() == item_pos_nil, 0x10a1f, "itr.item_pos() == item_pos_nil");
         diag_base::expect(suborigin, itr.page_pos() != page_pos_nil && itr.edge() == iterator_edge::none, 0x10498, "itr.page_pos() != page_pos_nil && itr.edge() == iterator_edge::none");
@@ -319,7 +319,7 @@ namespace abc { namespace vmem {
             _state->back_page_pos = back_page_pos;
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1049a, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1049a, "End:");
 
         return result;
     }
@@ -327,7 +327,7 @@ namespace abc { namespace vmem {
 
     inline void linked::erase_nostate(const_iterator itr, page_pos_t& back_page_pos) {
         constexpr const char* suborigin = "erase()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1049b, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x", (unsigned long long)itr.page_pos(), (unsigned)itr.item_pos());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1049b, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x", (unsigned long long)itr.page_pos(), (unsigned)itr.item_pos());
 
         diag_base::expect(suborigin, itr.page_pos() != page_pos_nil, 0x10a20, "itr.page_pos() != page_pos_nil");
 
@@ -365,7 +365,7 @@ namespace abc { namespace vmem {
             page.free();
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1049f, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1049f, "End:");
     }
 
 
@@ -380,6 +380,11 @@ namespace abc { namespace vmem {
     }
 
 
+    inline void linked::compact() {
+        _pool->compact_linked(*this);
+    }
+
+
     // ..............................................................
 
 
@@ -390,7 +395,7 @@ namespace abc { namespace vmem {
 
     inline void linked::splice(linked&& other) {
         constexpr const char* suborigin = "splice()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x104a1, "Begin: front_page_pos=0x%llx, back_page_pos=0x%llx, other.front_page_pos=0x%llx, other.back_page_pos=0x%llx",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x104a1, "Begin: front_page_pos=0x%llx, back_page_pos=0x%llx, other.front_page_pos=0x%llx, other.back_page_pos=0x%llx",
                 (unsigned long long)_state->front_page_pos, (unsigned long long)_state->back_page_pos, (unsigned long long)other._state->front_page_pos, (unsigned long long)other._state->back_page_pos);
 
         diag_base::expect(suborigin, _state != other._state, 0x104a0, "_state != other._state");
@@ -434,7 +439,7 @@ namespace abc { namespace vmem {
             other._state->back_page_pos = page_pos_nil;
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x104a4, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x104a4, "End:");
     }
 
 
@@ -443,7 +448,7 @@ namespace abc { namespace vmem {
 
     inline typename linked::iterator linked::next(const iterator_state& itr) const {
         constexpr const char* suborigin = "next()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x104a5, "Begin: itr.page_pos=0x%llx, itr.edge=%u, itr.item_pos=0x%x",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x104a5, "Begin: itr.page_pos=0x%llx, itr.edge=%u, itr.item_pos=0x%x",
             (unsigned long long)itr.page_pos(), (unsigned)itr.edge(), (unsigned)itr.item_pos());
 
         diag_base::expect(suborigin, itr.item_pos() == item_pos_nil, 0x10a23, "itr.item_pos() == item_pos_nil");
@@ -469,7 +474,7 @@ namespace abc { namespace vmem {
             result = iterator(this, linked_page->next_page_pos, item_pos_nil, edge, diag_base::log());
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x104a7, "End: result.page_pos=0x%llx, result.edge=%u", (unsigned long long)result.page_pos(), (unsigned)result.edge());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x104a7, "End: result.page_pos=0x%llx, result.edge=%u", (unsigned long long)result.page_pos(), (unsigned)result.edge());
 
         return result;
     }
@@ -477,7 +482,7 @@ namespace abc { namespace vmem {
 
     inline typename linked::iterator linked::prev(const iterator_state& itr) const {
         constexpr const char* suborigin = "next()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x104a8, "Begin: itr.page_pos=0x%llx, itr.edge=%u, itr.item_pos=0x%x",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x104a8, "Begin: itr.page_pos=0x%llx, itr.edge=%u, itr.item_pos=0x%x",
             (unsigned long long)itr.page_pos(), (unsigned)itr.edge(), (unsigned)itr.item_pos());
 
         diag_base::expect(suborigin, itr.item_pos() == item_pos_nil, 0x10a24, "itr.item_pos() == item_pos_nil");
@@ -503,7 +508,7 @@ namespace abc { namespace vmem {
             result = iterator(this, linked_page->prev_page_pos, item_pos_nil, edge, diag_base::log());
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x104aa, "End: result.page_pos=0x%llx, result.edge=%u", (unsigned long long)result.page_pos(), (unsigned)result.edge());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x104aa, "End: result.page_pos=0x%llx, result.edge=%u", (unsigned long long)result.page_pos(), (unsigned)result.edge());
 
         return result;
     }
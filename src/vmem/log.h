@@ -0,0 +1,375 @@
+/*
+MIT License
+
+Copyright (c) 2018-2026 Zlatko Michailov 
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#pragma once
+
+#include <cstring>
+
+#include "../diag/diag_ready.h"
+#include "page.h"
+#include "linked.h"
+#include "i/log.i.h"
+
+
+namespace abc { namespace vmem {
+
+    template <typename T>
+    inline constexpr const char* log<T>::origin() noexcept {
+        return "abc::vmem::log";
+    }
+
+
+    template <typename T>
+    inline constexpr std::size_t log<T>::items_pos() noexcept {
+        return sizeof(log_page) - sizeof(T);
+    }
+
+
+    template <typename T>
+    inline constexpr std::size_t log<T>::page_capacity() noexcept {
+        return (page_size - items_pos()) / sizeof(T);
+    }
+
+
+    template <typename T>
+    inline constexpr bool log<T>::is_uninit(const log_state* state) noexcept {
+        return
+            // nil
+            (
+                state != nullptr
+                && state->front_page_pos == page_pos_nil
+                && state->back_page_pos == page_pos_nil
+                && state->item_size == 0
+            )
+            ||
+            // zero
+            (
+                state != nullptr
+                && state->front_page_pos == 0
+                && state->back_page_pos == 0
+                && state->item_size == 0
+            );
+    }
+
+
+    template <typename T>
+    inline log<T>::log(log_state* state, vmem::pool* pool, diag::log_ostream* log)
+        : diag_base(abc::copy(origin()), log)
+        , _state(state)
+        , _pool(pool)
+        , _back_page(nullptr)
+        , _page_positions{ }
+        , _page_positions_front_seq(0) {
+
+        constexpr const char* suborigin = "log()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10db5, "Begin: state=%p, pool=%p", state, pool);
+
+        diag_base::expect(suborigin, state != nullptr, 0x10db6, "state != nullptr");
+        diag_base::expect(suborigin, pool != nullptr, 0x10db7, "pool != nullptr");
+        diag_base::expect(suborigin, page_capacity() > 0, 0x10db8, "page_capacity() > 0");
+
+        if (is_uninit(state)) {
+            _state->front_page_pos = page_pos_nil;
+            _state->back_page_pos = page_pos_nil;
+            _state->item_size = sizeof(T);
+            _state->front_seq = 0;
+            _state->next_seq = 0;
+        }
+
+        diag_base::ensure(suborigin, _state->item_size == sizeof(T), 0x10db9, "_state->item_size == sizeof(T)");
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10dba, "End: front_seq=%llu, next_seq=%llu",
+            (unsigned long long)_state->front_seq, (unsigned long long)_state->next_seq);
+    }
+
+
+    template <typename T>
+    inline bool log<T>::empty() const noexcept {
+        return _state->front_seq == _state->next_seq;
+    }
+
+
+    template <typename T>
+    inline std::size_t log<T>::size() const noexcept {
+        return static_cast<std::size_t>(_state->next_seq - _state->front_seq);
+    }
+
+
+    template <typename T>
+    inline seq_t log<T>::front_seq() const noexcept {
+        return _state->front_seq;
+    }
+
+
+    template <typename T>
+    inline seq_t log<T>::next_seq() const noexcept {
+        return _state->next_seq;
+    }
+
+
+    // ..............................................................
+
+
+    template <typename T>
+    inline seq_t log<T>::push_back(const_reference item) {
+        constexpr const char* suborigin = "push_back()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10dbb, "Begin: next_seq=%llu", (unsigned long long)_state->next_seq);
+
+        log_page* back_page = lock_back_page();
+
+        if (back_page == nullptr || back_page->item_count == page_capacity()) {
+            vmem::page new_page(_pool, diag_base::log());
+            diag_base::expect(suborigin, new_page.ptr() != nullptr, 0x10dbc, "new_page.ptr() != nullptr");
+
+            back_page = reinterpret_cast<log_page*>(new_page.ptr());
+            back_page->header.first_seq = _state->next_seq;
+            back_page->item_count = 0;
+
+            // Keep the page position index up to date only if it is up to date at the back. Otherwise, it gets synced on the next lookup.
+            bool is_indexed = _page_positions.empty() ? _state->back_page_pos == page_pos_nil : _page_positions.back() == _state->back_page_pos;
+
+            vmem::linked linked(_state, _pool, diag_base::log());
+            linked.push_back(new_page.pos());
+
+            if (is_indexed) {
+                if (_page_positions.empty()) {
+                    _page_positions_front_seq = back_page->header.first_seq;
+                }
+                _page_positions.push_back(new_page.pos());
+            }
+
+            _back_page = std::move(new_page);
+        }
+
+        seq_t seq = _state->next_seq++;
+        std::memmove(&back_page->items[back_page->item_count++], &item, sizeof(T));
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10dbd, "End: seq=%llu", (unsigned long long)seq);
+
+        return seq;
+    }
+
+
+    template <typename T>
+    inline T log<T>::at(seq_t seq) const {
+        constexpr const char* suborigin = "at()";
+        diag_base::expect(suborigin, _state->front_seq <= seq && seq < _state->next_seq, 0x10dbe, "_state->front_seq <= seq && seq < _state->next_seq");
+
+        T item { };
+        std::size_t count = read(seq, &item, 1);
+        diag_base::ensure(suborigin, count == 1, 0x10dbf, "count == 1");
+
+        return item;
+    }
+
+
+    template <typename T>
+    inline std::size_t log<T>::read(seq_t seq, T* items, std::size_t count) const {
+        constexpr const char* suborigin = "read()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10dc0, "Begin: seq=%llu, count=%zu", (unsigned long long)seq, count);
+
+        diag_base::expect(suborigin, _state->front_seq <= seq && seq <= _state->next_seq, 0x10dc1, "_state->front_seq <= seq && seq <= _state->next_seq");
+        diag_base::expect(suborigin, items != nullptr || count == 0, 0x10dc2, "items != nullptr || count == 0");
+
+        std::size_t read_count = 0;
+
+        if (seq < _state->next_seq && count > 0) {
+            page_pos_t page_pos = page_pos_of(seq);
+
+            while (page_pos != page_pos_nil && read_count < count) {
+                vmem::page page(_pool, page_pos, diag_base::log());
+                diag_base::expect(suborigin, page.ptr() != nullptr, 0x10dc3, "page.ptr() != nullptr");
+
+                const log_page* lpage = reinterpret_cast<const log_page*>(page.ptr());
+                std::size_t item_pos = static_cast<std::size_t>(seq - lpage->header.first_seq);
+                std::size_t page_count = lpage->item_count - item_pos;
+                if (page_count > count - read_count) {
+                    page_count = count - read_count;
+                }
+
+                std::memmove(items + read_count, &lpage->items[item_pos], page_count * sizeof(T));
+                read_count += page_count;
+                seq += page_count;
+
+                page_pos = lpage->next_page_pos;
+            }
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10dc4, "End: read_count=%zu", read_count);
+
+        return read_count;
+    }
+
+
+    template <typename T>
+    inline void log<T>::truncate_front(seq_t seq) {
+        constexpr const char* suborigin = "truncate_front()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10dc5, "Begin: seq=%llu, front_seq=%llu", (unsigned long long)seq, (unsigned long long)_state->front_seq);
+
+        // Unlock the back page - it may get freed, and truncation needs the mapping capacity.
+        // It will get locked again on the next push_back().
+        _back_page = vmem::page(nullptr);
+
+        vmem::linked linked(_state, _pool, diag_base::log());
+
+        while (_state->front_page_pos != page_pos_nil) {
+            page_pos_t page_pos = _state->front_page_pos;
+            seq_t first_seq;
+            seq_t end_seq;
+            {
+                vmem::page page(_pool, page_pos, diag_base::log());
+                diag_base::expect(suborigin, page.ptr() != nullptr, 0x10dc6, "page.ptr() != nullptr");
+
+                const log_page* front_page = reinterpret_cast<const log_page*>(page.ptr());
+                first_seq = front_page->header.first_seq;
+                end_seq = first_seq + front_page->item_count;
+            }
+
+            if (end_seq > seq) {
+                _state->front_seq = first_seq;
+                break;
+            }
+
+            // Unlink the page before locking it again to free it, so that no more than two pages are locked here.
+            linked.pop_front();
+
+            vmem::page page(_pool, page_pos, diag_base::log());
+            page.free();
+
+            _state->front_seq = end_seq;
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10dc7, "End: front_seq=%llu", (unsigned long long)_state->front_seq);
+    }
+
+
+    template <typename T>
+    inline void log<T>::clear() {
+        constexpr const char* suborigin = "clear()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10dc8, "Begin: front_seq=%llu, next_seq=%llu", (unsigned long long)_state->front_seq, (unsigned long long)_state->next_seq);
+
+        _back_page = vmem::page(nullptr);
+
+        vmem::linked linked(_state, _pool, diag_base::log());
+        linked.clear();
+
+        _state->front_seq = _state->next_seq;
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10dc9, "End:");
+    }
+
+
+    // ..............................................................
+
+
+    template <typename T>
+    inline typename log<T>::log_page* log<T>::lock_back_page() const {
+        if (_state->back_page_pos == page_pos_nil) {
+            _back_page = vmem::page(nullptr);
+            return nullptr;
+        }
+
+        // Another instance over the same state may have appended a page.
+        if (_back_page.ptr() == nullptr || _back_page.pos() != _state->back_page_pos) {
+            _back_page = vmem::page(nullptr);
+            _back_page = vmem::page(_pool, _state->back_page_pos, diag_base::log());
+        }
+
+        return reinterpret_cast<log_page*>(_back_page.ptr());
+    }
+
+
+    template <typename T>
+    inline page_pos_t log<T>::page_pos_of(seq_t seq) const {
+        constexpr const char* suborigin = "page_pos_of()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10dca, "Begin: seq=%llu", (unsigned long long)seq);
+
+        sync_page_positions();
+
+        // All pages except the back page are full.
+        diag_base::expect(suborigin, _page_positions_front_seq <= seq, 0x10dcb, "_page_positions_front_seq <= seq");
+        std::size_t page_index = static_cast<std::size_t>((seq - _page_positions_front_seq) / page_capacity());
+        diag_base::ensure(suborigin, page_index < _page_positions.size(), 0x10dcd, "page_index < _page_positions.size()");
+
+        page_pos_t page_pos = _page_positions[page_index];
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10dce, "End: page_pos=0x%llx", (unsigned long long)page_pos);
+
+        return page_pos;
+    }
+
+
+    template <typename T>
+    inline void log<T>::sync_page_positions() const {
+        constexpr const char* suborigin = "sync_page_positions()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10fe4, "Begin: page_count=%zu", _page_positions.size());
+
+        if (_state->front_page_pos == page_pos_nil) {
+            _page_positions.clear();
+        }
+        else {
+            // Drop the pages that have been truncated from the front. Anything else, e.g. a clear, invalidates the index.
+            if (!_page_positions.empty() && _page_positions_front_seq != _state->front_seq) {
+                seq_t truncated_seq_count = _state->front_seq - _page_positions_front_seq;
+                std::size_t truncated_page_count = static_cast<std::size_t>(truncated_seq_count / page_capacity());
+
+                if (_state->front_seq > _page_positions_front_seq && truncated_seq_count % page_capacity() == 0 && truncated_page_count < _page_positions.size()) {
+                    _page_positions.erase(_page_positions.begin(), _page_positions.begin() + truncated_page_count);
+                    _page_positions_front_seq = _state->front_seq;
+                }
+                else {
+                    _page_positions.clear();
+                }
+            }
+
+            if (!_page_positions.empty() && _page_positions.front() != _state->front_page_pos) {
+                _page_positions.clear();
+            }
+
+            if (_page_positions.empty()) {
+                _page_positions.push_back(_state->front_page_pos);
+                _page_positions_front_seq = _state->front_seq;
+            }
+
+            // Walk the pages that have been appended.
+            while (_page_positions.back() != _state->back_page_pos) {
+                vmem::page page(_pool, _page_positions.back(), diag_base::log());
+                diag_base::expect(suborigin, page.ptr() != nullptr, 0x10dcc, "page.ptr() != nullptr");
+
+                page_pos_t next_page_pos = reinterpret_cast<const log_page*>(page.ptr())->next_page_pos;
+                diag_base::ensure(suborigin, next_page_pos != page_pos_nil, 0x10fe5, "next_page_pos != page_pos_nil");
+
+                _page_positions.push_back(next_page_pos);
+            }
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10fe6, "End: page_count=%zu, front_seq=%llu", _page_positions.size(), (unsigned long long)_page_positions_front_seq);
+    }
+
+
+    // --------------------------------------------------------------
+
+} }
@@ -80,6 +80,34 @@ namespace abc { namespace vmem {
     // --------------------------------------------------------------
 
 
+    template <typename Iterator>
+    inline map_range<Iterator>::map_range(Iterator&& begin, Iterator&& end) noexcept
+        : _begin(std::move(begin))
+        , _end(std::move(end)) {
+    }
+
+
+    template <typename Iterator>
+    inline Iterator map_range<Iterator>::begin() const noexcept {
+        return _begin;
+    }
+
+
+    template <typename Iterator>
+    inline Iterator map_range<Iterator>::end() const noexcept {
+        return _end;
+    }
+
+
+    template <typename Iterator>
+    inline bool map_range<Iterator>::empty() const noexcept {
+        return _begin == _end;
+    }
+
+
+    // --------------------------------------------------------------
+
+
     template <typename Key, typename T>
     inline constexpr const char* map<Key, T>::origin() noexcept {
         return "abc::vmem::map";
@@ -131,7 +159,7 @@ namespace abc { namespace vmem {
         , _values(&state->values, pool, log) {
 
         constexpr const char* suborigin = "map()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1050a, "Begin: state=%p', balance_insert=%x, balance_erase=%x, pool=%p", state, pool);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1050a, "Begin: state=%p', balance_insert=%x, balance_erase=%x, pool=%p", state, pool);
 
         diag_base::expect(suborigin, state != nullptr, 0x1050b, "state != nullptr");
         diag_base::expect(suborigin, pool != nullptr, 0x1050c, "pool != nullptr");
@@ -143,7 +171,7 @@ namespace abc { namespace vmem {
         diag_base::expect(suborigin, _state->keys.item_size == sizeof(container_state), 0x10511, "_state->keys.item_size == sizeof(container_state)");
         diag_base::expect(suborigin, _state->values.item_size == sizeof(map_value<Key, T>), 0x10512, "_state->values.item_size == sizeof(map_value<Key, T>)");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10513, "End: keys.front_page_pos=0x%llx, keys.back_page_pos=0x%llx,  values.front_page_pos=0x%llx, values.back_page_pos=0x%llx", 
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10513, "End: keys.front_page_pos=0x%llx, keys.back_page_pos=0x%llx,  values.front_page_pos=0x%llx, values.back_page_pos=0x%llx", 
                 (unsigned long long)_state->keys.front_page_pos, (unsigned long long)_state->keys.back_page_pos, (unsigned long long)_state->values.front_page_pos, (unsigned long long)_state->values.back_page_pos);
     }
 
@@ -239,18 +267,18 @@ namespace abc { namespace vmem {
     template <typename Key, typename T>
     inline typename map<Key, T>::result2 map<Key, T>::insert2(const_reference item) {
         constexpr const char* suborigin = "insert2(item)";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10514, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10514, "Begin:");
 
         find_result2 find_result = find2(item.key);
         result2 result(nullptr);
 
         if (!find_result.ok) {
-            diag_base::put_any(suborigin, diag::severity::optional, 0x10515, "Not found. Inserting.");
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10515, "Not found. Inserting.");
 
             result = insert2(std::move(find_result), item);
         }
         else {
-            diag_base::put_any(suborigin, diag::severity::optional, 0x10516, "Found. Bailing.");
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10516, "Found. Bailing.");
 
             result.iterator = find_result.iterator;
             result.ok = false;
@@ -258,7 +286,7 @@ namespace abc { namespace vmem {
 
         diag_base::ensure(suborigin, result.iterator.can_deref(), 0x10a27, "result.iterator.can_deref()");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10517, "End: result.ok=%d, result.iterator.page_pos=0x%llx, result.iterator.item_pos=0x%x, result.iterator.edge=%u",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10517, "End: result.ok=%d, result.iterator.page_pos=0x%llx, result.iterator.item_pos=0x%x, result.iterator.edge=%u",
                 result.ok, (unsigned long long)result.iterator.page_pos(), (unsigned)result.iterator.item_pos(), result.iterator.edge());
 
         return result;
@@ -277,21 +305,21 @@ namespace abc { namespace vmem {
     template <typename InputItr>
     inline void map<Key, T>::insert(InputItr first, InputItr last) {
         constexpr const char* suborigin = "insert(first, last)";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a28, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a28, "Begin:");
 
         for (InputItr item_itr = first; item_itr != last; item_itr++) {
             bool inserted = insert(*item_itr).second;
             diag_base::ensure(suborigin, !inserted, 0x10518, "!inserted");
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a29, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a29, "End:");
     }
 
 
     template <typename Key, typename T>
     inline typename map<Key, T>::result2 map<Key, T>::insert2(find_result2&& find_result, const_reference item) noexcept {
         constexpr const char* suborigin = "insert2(find_result, item)";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10519, "Begin: find_result.iterator.page_pos=0x%llx, find_result.iterator.item_pos=0x%x, find_result.iterator.edge=%d",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10519, "Begin: find_result.iterator.page_pos=0x%llx, find_result.iterator.item_pos=0x%x, find_result.iterator.edge=%d",
                 (unsigned long long)find_result.iterator.page_pos(), (unsigned)find_result.iterator.item_pos(), find_result.iterator.edge());
 
         diag_base::expect(suborigin, find_result.iterator.is_valid(this), 0x10a2a, "find_result.iterator.is_valid(this)");
@@ -308,7 +336,7 @@ namespace abc { namespace vmem {
         diag_base::expect(suborigin, result.iterator.is_valid(this), 0x10a2f, "result.iterator.is_valid(this)");
         diag_base::expect(suborigin, result.iterator.can_deref(), 0x10a30, "result.iterator.can_deref()");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1051a, "End: result.iterator.page_pos=0x%llx, result.iterator.item_pos=0x%x, result.iterator.edge=%d",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1051a, "End: result.iterator.page_pos=0x%llx, result.iterator.item_pos=0x%x, result.iterator.edge=%d",
                 (unsigned long long)result.iterator.page_pos(), (unsigned)result.iterator.item_pos(), result.iterator.edge());
 
         return result;
@@ -321,20 +349,20 @@ namespace abc { namespace vmem {
     template <typename Key, typename T>
     inline std::size_t map<Key, T>::erase(const Key& key) {
         constexpr const char* suborigin = "erase(key)";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1051b, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1051b, "Begin:");
 
         std::size_t result = 0;
 
         find_result2 find_result = find2(key);
 
         if (find_result.ok) {
-            diag_base::put_any(suborigin, diag::severity::optional, 0x1051c, "Found. iterator.page_pos=0x%llx, iterator.item_pos=0x%x, iterator.edge=%d",
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x1051c, "Found. iterator.page_pos=0x%llx, iterator.item_pos=0x%x, iterator.edge=%d",
                     (long long)find_result.iterator.page_pos(), find_result.iterator.item_pos(), find_result.iterator.edge());
 
             result = erase2(std::move(find_result));
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1051d, "End: result=%zu", result);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1051d, "End: result=%zu", result);
 
         return result;
     }
@@ -344,22 +372,85 @@ namespace abc { namespace vmem {
     template <typename InputItr>
     inline void map<Key, T>::erase(InputItr first, InputItr last) {
         constexpr const char* suborigin = "erase(first, last)";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a31, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a31, "Begin:");
 
         for (InputItr item_itr = first; item_itr != last; item_itr++) {
             std::size_t result = erase(*item_itr);
 
-            diag_base::put_any(suborigin, diag::severity::optional, 0x10a32, "result=%zu", result);
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10a32, "result=%zu", result);
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a33, "End:");
+    }
+
+
+    template <typename Key, typename T>
+    inline void map<Key, T>::compact() {
+        constexpr const char* suborigin = "compact()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f79, "Begin: key_level_count=%zu", _key_stack.size());
+
+        // The key level states are items on the key stack. Nothing references its pages.
+        _key_stack.compact();
+
+        {
+            vmem::linked values_linked(&_state->values, _pool, diag_base::log());
+            values_linked.compact();
+        }
+
+        // Go up the key levels. Each level references the pages of the level below, which have already been relocated.
+        page_pos_t child_page_pos = _state->values.front_page_pos;
+
+        for (key_level_stack_iterator key_stack_itr = _key_stack.begin(); key_stack_itr != _key_stack.end(); key_stack_itr++) {
+            // IMPORTANT: Save the ptr instance to keep the page locked.
+            vmem::ptr<container_state> key_level_state_ptr = key_stack_itr.operator->();
+
+            vmem::linked keys_linked(key_level_state_ptr.operator->(), _pool, diag_base::log());
+            keys_linked.compact();
+
+            fix_child_page_positions(key_level_state_ptr->front_page_pos, child_page_pos);
+            child_page_pos = key_level_state_ptr->front_page_pos;
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a33, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f7a, "End:");
+    }
+
+
+    template <typename Key, typename T>
+    inline void map<Key, T>::fix_child_page_positions(page_pos_t key_page_pos, page_pos_t child_page_pos) {
+        constexpr const char* suborigin = "fix_child_page_positions()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f7b, "Begin: key_page_pos=0x%llx, child_page_pos=0x%llx", (unsigned long long)key_page_pos, (unsigned long long)child_page_pos);
+
+        // Each page on the level below has exactly one key, and the keys are in the same order as the pages.
+        while (key_page_pos != page_pos_nil) {
+            vmem::page key_page(_pool, key_page_pos, diag_base::log());
+            diag_base::expect(suborigin, key_page.ptr() != nullptr, 0x10f7c, "key_page.ptr() != nullptr");
+
+            map_key_page<Key>* key_container_page = reinterpret_cast<map_key_page<Key>*>(key_page.ptr());
+
+            for (item_pos_t i = 0; i < key_container_page->item_count; i++) {
+                diag_base::expect(suborigin, child_page_pos != page_pos_nil, 0x10f7d, "child_page_pos != page_pos_nil");
+
+                key_container_page->items[i].page_pos = child_page_pos;
+
+                vmem::page child_page(_pool, child_page_pos, diag_base::log());
+                diag_base::expect(suborigin, child_page.ptr() != nullptr, 0x10f7e, "child_page.ptr() != nullptr");
+
+                child_page_pos = reinterpret_cast<linked_page*>(child_page.ptr())->next_page_pos;
+            }
+
+            key_page_pos = key_container_page->next_page_pos;
+        }
+
+        diag_base::expect(suborigin, child_page_pos == page_pos_nil, 0x10f7f, "child_page_pos == page_pos_nil");
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f80, "End:");
     }
 
 
     template <typename Key, typename T>
     inline std::size_t map<Key, T>::erase2(find_result2&& find_result) {
         constexpr const char* suborigin = "erase(find_result2)";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1051e, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1051e, "Begin:");
 
         diag_base::expect(suborigin, find_result.iterator.is_valid(this), 0x10a34, "find_result.iterator.is_valid(this)");
         diag_base::expect(suborigin, find_result.iterator.can_deref(), 0x10a35, "find_result.iterator.can_deref()");
@@ -373,7 +464,7 @@ namespace abc { namespace vmem {
         result2 result = update_key_levels(std::move(find_result), std::move(values_result));
         diag_base::expect(suborigin, result.iterator.is_valid(this), 0x10a37, "result.iterator.is_valid(this)");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1051f, "End: values_itr.page_pos=0x%llx, values_itr.item_pos=0x%x, values_itr.edge=%d",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1051f, "End: values_itr.page_pos=0x%llx, values_itr.item_pos=0x%x, values_itr.edge=%d",
                 (unsigned long long)values_itr.page_pos(), (unsigned)values_itr.item_pos(), values_itr.edge());
 
         return 1;
@@ -386,7 +477,7 @@ namespace abc { namespace vmem {
     template <typename Key, typename T>
     inline typename map<Key, T>::result2 map<Key, T>::update_key_levels(find_result2&& find_result, value_level_result2&& values_result) {
         constexpr const char* suborigin = "update_key_levels";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10520, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10520, "Begin:");
 
         bool should_update_key_levels = _state->values.front_page_pos != _state->values.back_page_pos || _key_stack.size() > 0;
 
@@ -564,14 +655,14 @@ namespace abc { namespace vmem {
                 }
             }
 
-            diag_base::put_any(suborigin, diag::severity::optional, 0x10523, "key_stack.size=%zu", _key_stack.size());
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10523, "key_stack.size=%zu", _key_stack.size());
         }
 
         result2 result(nullptr);
         result.iterator = iterator(this, values_result.iterator.page_pos(), values_result.iterator.item_pos(), values_result.iterator.edge(), diag_base::log());
         result.ok = true;
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10524, "End: ok=%d, iterator.page_pos=0x%llx, iterator.item_pos=0x%x, iterator.edge=%d",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10524, "End: ok=%d, iterator.page_pos=0x%llx, iterator.item_pos=0x%x, iterator.edge=%d",
                 result.ok, (unsigned long long)result.iterator.page_pos(), (unsigned)result.iterator.item_pos(), result.iterator.edge());
 
         return result;
@@ -581,7 +672,7 @@ namespace abc { namespace vmem {
     template <typename Key, typename T>
     inline item_pos_t map<Key, T>::key_item_pos(page_pos_t key_page_pos, const Key& key) {
         constexpr const char* suborigin = "key_item_pos(page_pos)";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10525, "Begin: key_page_pos=0x%llx, key=0x%llx...", (unsigned long long)key_page_pos, *(unsigned long long*)&key);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10525, "Begin: key_page_pos=0x%llx, key=0x%llx...", (unsigned long long)key_page_pos, *(unsigned long long*)&key);
 
         vmem::page page(_pool, key_page_pos, diag_base::log());
         diag_base::expect(suborigin, page.pos() == key_page_pos, 0x10a41, "page.pos() == key_page_pos");
@@ -590,7 +681,7 @@ namespace abc { namespace vmem {
         map_key_page<Key>* key_page = reinterpret_cast<map_key_page<Key>*>(page.ptr());
         item_pos_t item_pos = key_item_pos(key_page, key);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10528, "End: item_pos=0x%x", (unsigned)item_pos);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10528, "End: item_pos=0x%x", (unsigned)item_pos);
 
         return item_pos;
     }
@@ -599,19 +690,19 @@ namespace abc { namespace vmem {
     template <typename Key, typename T>
     inline item_pos_t map<Key, T>::key_item_pos(map_key_page<Key>* key_page, const Key& key) {
         constexpr const char* suborigin = "key_item_pos(key_page)";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a42, "Begin: key_page=%p, key=0x%llx...", key_page, *(unsigned long long*)&key);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a42, "Begin: key_page=%p, key=0x%llx...", key_page, *(unsigned long long*)&key);
 
         diag_base::expect(suborigin, key_page != nullptr, 0x10a43, "key_page != nullptr");
 
         // Key page: when done, item_pos should reference the biggest key that is smaller or equal to key.
         item_pos_t item_pos = 0;
         for (item_pos_t i = 1; i < key_page->item_count && key_page->items[i].key <= key; i++) {
-            diag_base::put_any(suborigin, diag::severity::verbose, 0x10a44, "item[%u]=0x%llx..., key=0x%llx...", (unsigned)i, *(unsigned long long*)&key_page->items[i].key, *(unsigned long long*)&key);
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::verbose, 0x10a44, "item[%u]=0x%llx..., key=0x%llx...", (unsigned)i, *(unsigned long long*)&key_page->items[i].key, *(unsigned long long*)&key);
 
             item_pos = i;
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a45, "End: item_pos=0x%x", (unsigned)item_pos);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a45, "End: item_pos=0x%x", (unsigned)item_pos);
 
         return item_pos;
     }
@@ -623,7 +714,7 @@ namespace abc { namespace vmem {
     template <typename Key, typename T>
     inline void map<Key, T>::clear() {
         constexpr const char* suborigin = "clear";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a46, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a46, "Begin:");
 
         for (key_level_stack_iterator key_stack_itr = _key_stack.rend(); key_stack_itr != _key_stack.rbegin(); key_stack_itr--) {
             // IMPORTANT: Save the ptr instance to keep the page locked.
@@ -637,7 +728,7 @@ namespace abc { namespace vmem {
 
         _values.clear();
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a47, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a47, "End:");
     }
 
 
@@ -647,7 +738,7 @@ namespace abc { namespace vmem {
     template <typename Key, typename T>
     inline typename map<Key, T>::iterator map<Key, T>::next(const iterator_state& itr) const {
         constexpr const char* suborigin = "next";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10529, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x, itr.edge=%u",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10529, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x, itr.edge=%u",
                 (unsigned long long)itr.page_pos(), (unsigned)itr.item_pos(), itr.edge());
 
         diag_base::expect(suborigin, itr.is_valid(this), 0x10a48, "itr.is_valid(this)");
@@ -657,7 +748,7 @@ namespace abc { namespace vmem {
         values_itr++;
         iterator result = iterator(this, values_itr.page_pos(), values_itr.item_pos(), values_itr.edge(), diag_base::log());
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1052a, "End: result.page_pos=0x%llx, result.item_pos=0x%x, result.edge=%u",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1052a, "End: result.page_pos=0x%llx, result.item_pos=0x%x, result.edge=%u",
                 (unsigned long long)result.page_pos(), (unsigned)result.item_pos(), result.edge());
 
         return result;
@@ -667,7 +758,7 @@ namespace abc { namespace vmem {
     template <typename Key, typename T>
     inline typename map<Key, T>::iterator map<Key, T>::prev(const iterator_state& itr) const {
         constexpr const char* suborigin = "prev";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1052b, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x, itr.edge=%u",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1052b, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x, itr.edge=%u",
                 (unsigned long long)itr.page_pos(), (unsigned)itr.item_pos(), itr.edge());
 
         diag_base::expect(suborigin, itr.is_valid(this), 0x10a4a, "itr.is_valid(this)");
@@ -677,7 +768,7 @@ namespace abc { namespace vmem {
         values_itr--;
         iterator result = iterator(this, values_itr.page_pos(), values_itr.item_pos(), values_itr.edge(), diag_base::log());
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1052c, "End: result.page_pos=0x%llx, result.item_pos=0x%x, result.edge=%u",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1052c, "End: result.page_pos=0x%llx, result.item_pos=0x%x, result.edge=%u",
                 (unsigned long long)result.page_pos(), (unsigned)result.item_pos(), result.edge());
 
         return result;
@@ -685,9 +776,9 @@ namespace abc { namespace vmem {
 
 
     template <typename Key, typename T>
-    inline typename map<Key, T>::find_result2 map<Key, T>::find2(const Key& key) {
+    inline typename map<Key, T>::find_result2 map<Key, T>::find2(const Key& key, bool track_path) {
         constexpr const char* suborigin = "find2";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1052d, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1052d, "Begin:");
 
         page_pos_t page_pos = page_pos_nil;
         item_pos_t item_pos = item_pos_nil;
@@ -707,8 +798,10 @@ namespace abc { namespace vmem {
             diag_base::expect(suborigin, page_pos != page_pos_nil, 0x10a4d, "page_pos != page_pos_nil");
 
             // Push the root page into the path.
-            result.path.push_back(page_pos);
-            diag_base::put_any(suborigin, diag::severity::optional, 0x1052e, "Loop key levels=%zu, Add root page_pos=0x%llx", _key_stack.size(), (unsigned long long)page_pos);
+            if (track_path) {
+                result.path.push_back(page_pos);
+            }
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x1052e, "Loop key levels=%zu, Add root page_pos=0x%llx", _key_stack.size(), (unsigned long long)page_pos);
 
             // From the current/parent page, find the child page (on the next level).
             for (std::size_t level = 0; level < _key_stack.size(); level++) {
@@ -719,7 +812,7 @@ namespace abc { namespace vmem {
                 diag_base::expect(suborigin, page.ptr() != nullptr, 0x1052f, "page.ptr() != nullptr");
 
                 map_key_page<Key>* key_page = reinterpret_cast<map_key_page<Key>*>(page.ptr());
-                diag_base::put_any(suborigin, diag::severity::optional, 0x10530, "Examine key lev=%zu, page_pos=0x%llx", level, (unsigned long long)page.pos());
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10530, "Examine key lev=%zu, page_pos=0x%llx", level, (unsigned long long)page.pos());
 
                 // Find the key on the key page.
                 item_pos = key_item_pos(key_page, key);
@@ -727,19 +820,19 @@ namespace abc { namespace vmem {
 
                 // Child page pos.
                 page_pos = key_page->items[item_pos].page_pos;
-                diag_base::put_any(suborigin, diag::severity::optional, 0x10533, "Child page_pos=0x%llx", (unsigned long long)page_pos);
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10533, "Child page_pos=0x%llx", (unsigned long long)page_pos);
 
                 // The page on the leaf level is a value page. It should not be on the path. The pages from all other levels should be.
-                if (level != _key_stack.size() - 1) {
+                if (track_path && level != _key_stack.size() - 1) {
                     result.path.push_back(page_pos);
-                    diag_base::put_any(suborigin, diag::severity::optional, 0x10a51, "Push page_pos=0x%llx", (unsigned long long)page_pos);
+                    ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10a51, "Push page_pos=0x%llx", (unsigned long long)page_pos);
                 }
             }
         }
         else {
             // There are no key levels. There must be at most 1 value page.
             diag_base::expect(suborigin, _state->values.front_page_pos == _state->values.back_page_pos, 0x10a52, "_state->values.front_page_pos == _state->values.back_page_pos");
-            diag_base::put_any(suborigin, diag::severity::optional, 0x10534, "No key levels. value page_pos=0x%llx", (unsigned long long)_state->values.front_page_pos);
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10534, "No key levels. value page_pos=0x%llx", (unsigned long long)_state->values.front_page_pos);
             page_pos = _state->values.front_page_pos;
         }
 
@@ -757,7 +850,7 @@ namespace abc { namespace vmem {
             // Value page: when done, item_pos should reference the smallest key that is bigger or equal to key.
             item_pos = value_page->item_count;
             for (item_pos_t i = value_page->item_count - 1; /* 0 <= i && */ i < value_page->item_count && key <= value_page->items[i].key; i--) {
-                diag_base::put_any(suborigin, diag::severity::verbose, 0x10a55, "item[%u]=0x%llx..., key=0x%llx...", (unsigned)i, *(unsigned long long*)&value_page->items[i].key, *(unsigned long long*)&key);
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::verbose, 0x10a55, "item[%u]=0x%llx..., key=0x%llx...", (unsigned)i, *(unsigned long long*)&value_page->items[i].key, *(unsigned long long*)&key);
 
                 item_pos = i;
             }
@@ -768,7 +861,7 @@ namespace abc { namespace vmem {
 
             result.iterator = iterator(this, page_pos, item_pos, iterator_edge::none, diag_base::log());
 
-            diag_base::put_any(suborigin, diag::severity::optional, 0x10536, "Value item_pos=%u, is_found=%d", (unsigned)item_pos, is_found);
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10536, "Value item_pos=%u, is_found=%d", (unsigned)item_pos, is_found);
         }
         else {
             result.iterator = end_itr();
@@ -776,7 +869,7 @@ namespace abc { namespace vmem {
 
         result.ok = is_found;
 
-        diag_base::put_any(suborigin, diag::severity::optional, 0x10536, "End:  result.ok=%d, result.iterator.page_pos=0x%llx, result.iterator.item_pos=0x%x, result.iterator.edge=%u",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10536, "End:  result.ok=%d, result.iterator.page_pos=0x%llx, result.iterator.item_pos=0x%x, result.iterator.edge=%u",
                 result.ok, (unsigned long long)result.iterator.page_pos(), (unsigned)result.iterator.item_pos(), result.iterator.edge());
 
         return result;
@@ -785,14 +878,107 @@ namespace abc { namespace vmem {
 
     template <typename Key, typename T>
     inline typename map<Key, T>::iterator map<Key, T>::find(const Key& key) {
-        result2 result = find2(key);
+        result2 result = find2(key, false /*track_path*/);
         return result.ok ? result.iterator : end_itr();
     }
 
 
     template <typename Key, typename T>
     inline typename map<Key, T>::const_iterator map<Key, T>::find(const Key& key) const {
-        return const_cast<map<Key, T>>(this)->find(key);
+        return const_cast<map<Key, T>*>(this)->find(key);
+    }
+
+
+    template <typename Key, typename T>
+    inline typename map<Key, T>::iterator map<Key, T>::lower_bound(const Key& key) {
+        constexpr const char* suborigin = "lower_bound()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10dff, "Begin: key=0x%llx...", *(unsigned long long*)&key);
+
+        result2 result = find2(key, false /*track_path*/);
+        iterator itr = result.iterator;
+
+        // find2() may stop past the last item on the value page, when all the keys on that page are less than the given key.
+        // In that case, the lower bound is the first item on the next value page.
+        if (itr.page_pos() != page_pos_nil) {
+            vmem::page page(_pool, itr.page_pos(), diag_base::log());
+            diag_base::expect(suborigin, page.ptr() != nullptr, 0x10e00, "page.ptr() != nullptr");
+
+            map_value_page<Key, T>* value_page = reinterpret_cast<map_value_page<Key, T>*>(page.ptr());
+
+            if (itr.item_pos() >= value_page->item_count) {
+                itr = value_page->next_page_pos != page_pos_nil
+                    ? iterator(this, value_page->next_page_pos, 0, iterator_edge::none, diag_base::log())
+                    : end_itr();
+            }
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e01, "End: itr.page_pos=0x%llx, itr.item_pos=0x%x, itr.edge=%u",
+                (unsigned long long)itr.page_pos(), (unsigned)itr.item_pos(), itr.edge());
+
+        return itr;
+    }
+
+
+    template <typename Key, typename T>
+    inline typename map<Key, T>::const_iterator map<Key, T>::lower_bound(const Key& key) const {
+        return const_cast<map<Key, T>*>(this)->lower_bound(key);
+    }
+
+
+    template <typename Key, typename T>
+    inline typename map<Key, T>::iterator map<Key, T>::upper_bound(const Key& key) {
+        iterator itr = lower_bound(key);
+
+        // Keys are unique, so at most one item needs to be skipped.
+        if (itr.can_deref() && itr->key == key) {
+            itr++;
+        }
+
+        return itr;
+    }
+
+
+    template <typename Key, typename T>
+    inline typename map<Key, T>::const_iterator map<Key, T>::upper_bound(const Key& key) const {
+        return const_cast<map<Key, T>*>(this)->upper_bound(key);
+    }
+
+
+    template <typename Key, typename T>
+    inline typename map<Key, T>::range map<Key, T>::equal_range(const Key& key) {
+        iterator first = lower_bound(key);
+        iterator last = first;
+
+        if (last.can_deref() && last->key == key) {
+            last++;
+        }
+
+        return range(std::move(first), std::move(last));
+    }
+
+
+    template <typename Key, typename T>
+    inline typename map<Key, T>::const_range map<Key, T>::equal_range(const Key& key) const {
+        range result = const_cast<map<Key, T>*>(this)->equal_range(key);
+
+        return const_range(result.begin(), result.end());
+    }
+
+
+    template <typename Key, typename T>
+    inline typename map<Key, T>::range map<Key, T>::find_range(const Key& first, const Key& last) {
+        constexpr const char* suborigin = "find_range()";
+        diag_base::expect(suborigin, first <= last, 0x10e02, "first <= last");
+
+        return range(lower_bound(first), lower_bound(last));
+    }
+
+
+    template <typename Key, typename T>
+    inline typename map<Key, T>::const_range map<Key, T>::find_range(const Key& first, const Key& last) const {
+        range result = const_cast<map<Key, T>*>(this)->find_range(first, last);
+
+        return const_range(result.begin(), result.end());
     }
 
 
@@ -854,11 +1040,11 @@ namespace abc { namespace vmem {
     template <typename Key, typename T>
     inline typename map<Key, T>::iterator map<Key, T>::itr_from_values(const value_level_iterator& values_itr) const noexcept {
         constexpr const char* suborigin = "itr_from_values";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a56, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a56, "Begin:");
 
         iterator itr(this, values_itr.page_pos(), values_itr.item_pos(), values_itr.edge(), diag_base::log());
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10537, "End: page_pos=0x%llx, item_pos=0x%x, edge=%u",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10537, "End: page_pos=0x%llx, item_pos=0x%x, edge=%u",
                 (unsigned long long)itr.page_pos(), (unsigned)itr.item_pos(), itr.edge());
 
         return itr;
@@ -868,13 +1054,13 @@ namespace abc { namespace vmem {
     template <typename Key, typename T>
     inline void map<Key, T>::log_internals(std::function<std::string(const Key&)>&& format_key, diag::severity_t severity) {
         constexpr const char* suborigin = "log_internals";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a57, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a57, "Begin:");
 
         // Log key levels.
         if (!_key_stack.empty()) {
             std::size_t level = 0;
             for (typename key_level_stack::iterator key_stack_itr = _key_stack.rend(); key_stack_itr != _key_stack.rbegin(); key_stack_itr--, level++) {
-                diag_base::put_any(suborigin, severity, 0x10a58, "key level=%zu:", level);
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, severity, 0x10a58, "key level=%zu:", level);
 
                 // IMPORTANT: Save the ptr instance to keep the page locked.
                 vmem::ptr<container_state> key_level_state_ptr = key_stack_itr.operator->();
@@ -882,7 +1068,7 @@ namespace abc { namespace vmem {
                 map_key_level<Key> keys(key_level_state_ptr.operator->(), _pool, diag_base::log());
                 for (typename map_key_level<Key>::const_iterator keys_itr = keys.cbegin(); keys_itr != keys.cend(); keys_itr++) {
                     std::string key_str(format_key(keys_itr->key));
-                    diag_base::put_any(suborigin, severity, 0x10a59, "  [ page_pos=0x%llx : item_pos=0x%x ] key>='%s' -> page_pos=0x%llx", 
+                    ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, severity, 0x10a59, "  [ page_pos=0x%llx : item_pos=0x%x ] key>='%s' -> page_pos=0x%llx", 
                         (unsigned long long)keys_itr.page_pos(), (unsigned)keys_itr.item_pos(), key_str.c_str(), (unsigned long long)keys_itr->page_pos);
                 }
             }
@@ -890,16 +1076,16 @@ namespace abc { namespace vmem {
 
         // Log value level.
         {
-            diag_base::put_any(suborigin, severity, 0x10a5a, "value level:");
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, severity, 0x10a5a, "value level:");
 
             for (typename value_level_container::const_iterator values_itr = _values.cbegin(); values_itr != _values.cend(); values_itr++) {
                 std::string key_str(format_key(values_itr->key));
-                diag_base::put_any(suborigin, severity, 0x10a5b, "  [ page_pos=0x%llx : item_pos=0x%x ] key='%s'", 
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, severity, 0x10a5b, "  [ page_pos=0x%llx : item_pos=0x%x ] key='%s'", 
                     (unsigned long long)values_itr.page_pos(), (unsigned)values_itr.item_pos(), key_str.c_str());
             }
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a5c, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a5c, "End:");
     }
 
 } }
@@ -25,6 +25,10 @@ SOFTWARE.
 
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
 #include <sys/mman.h>
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -32,6 +36,8 @@ SOFTWARE.
 #include <unistd.h>
 
 #include "../root/util.h"
+#include "../root/crc32c.h"
+#include "../root/lz4.h"
 #include "../diag/diag_ready.h"
 #include "ptr.h"
 #include "linked.h"
@@ -56,24 +62,42 @@ namespace abc { namespace vmem {
         , _config(std::move(config))
         , _ready(false)
         , _fd(-1)
+        , _crc_fd(-1)
+        , _cold_fd(-1)
+        , _cold_end(0)
+        , _cold_index{ }
+        , _cold_live_size(0)
+        , _pending_punch_pages{ }
         , _mapped_pages{ }
-        , _stats{ } {
+        , _mapped_extents{ }
+        , _stats{ }
+        , _log_stats_op_count(0)
+        , _is_at_capacity(false)
+        , _dirty_pages{ }
+        , _has_backup(false) {
 
         constexpr const char* suborigin = "pool()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a7b, "Begin: file_path='%s', max_mapped_page_count=%zu", _config.file_path.c_str(), _config.max_mapped_page_count);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a7b, "Begin: file_path='%s', max_mapped_page_count=%zu", _config.file_path.c_str(), _config.max_mapped_page_count);
 
         diag_base::expect(suborigin, !_config.file_path.empty(), 0x10a7c, "!_config.file_path.empty()");
 
         bool is_init = open();
 
+        if (_config.verify_page_checksums) {
+            open_checksums();
+        }
+
+        open_cold_pages();
+
         if (!is_init) {
+            diag_base::expect(suborigin, !_config.read_only, 0x10d72, "!_config.read_only");
             init();
         }
 
         verify();
         diag_base::ensure(suborigin, _ready, 0x10a7d, "_ready");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10390, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10390, "End:");
     }
 
 
@@ -82,22 +106,35 @@ namespace abc { namespace vmem {
         , _config(std::move(other._config))
         , _ready(other._ready)
         , _fd(other._fd)
+        , _crc_fd(other._crc_fd)
+        , _cold_fd(other._cold_fd)
+        , _cold_end(other._cold_end)
+        , _cold_index(std::move(other._cold_index))
+        , _cold_live_size(other._cold_live_size)
+        , _pending_punch_pages(std::move(other._pending_punch_pages))
         , _mapped_pages(std::move(other._mapped_pages))
-        , _stats(std::move(other._stats)) {
+        , _mapped_extents(std::move(other._mapped_extents))
+        , _stats(std::move(other._stats))
+        , _log_stats_op_count(other._log_stats_op_count)
+        , _is_at_capacity(other._is_at_capacity)
+        , _dirty_pages(std::move(other._dirty_pages))
+        , _has_backup(other._has_backup) {
 
         constexpr const char* suborigin = "pool(move)";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a7e, "Begin: fd=%d, max_mapped_page_count=%zu", _fd, _config.max_mapped_page_count);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a7e, "Begin: fd=%d, max_mapped_page_count=%zu", _fd, _config.max_mapped_page_count);
 
         other._ready = false;
         other._fd = -1;
+        other._crc_fd = -1;
+        other._cold_fd = -1;
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a7f, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a7f, "End:");
     }
 
 
     inline pool::~pool() noexcept {
         constexpr const char* suborigin = "~pool()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a80, "Begin: fd=%d, max_mapped_page_count=%zu", _fd, _config.max_mapped_page_count);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a80, "Begin: fd=%d, max_mapped_page_count=%zu", _fd, _config.max_mapped_page_count);
 
         if (_ready) {
             if (_fd >= 0) {
@@ -106,18 +143,33 @@ namespace abc { namespace vmem {
                     unmap_page(_mapped_pages.begin());
                 }
 
-                diag_base::put_any(suborigin, diag::severity::optional, 0x10713, "Close file fd=%d", _fd);
+                if (!_pending_punch_pages.empty()) {
+                    punch_pending_pages();
+                }
+
+                if (_crc_fd >= 0) {
+                    ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10cfc, "Close checksum file fd=%d", _crc_fd);
+                    ::close(_crc_fd);
+                }
+
+                if (_cold_fd >= 0) {
+                    ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10d24, "Close cold page file fd=%d", _cold_fd);
+                    ::close(_cold_fd);
+                }
+
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10713, "Close file fd=%d", _fd);
                 ::close(_fd);
             }
             else {
-                diag_base::put_any(suborigin, diag::severity::optional, 0x10711, "No file - no unmapping.");
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10711, "No file - no unmapping.");
             }
         }
 
         _ready = false;
         _fd = -1;
+        _crc_fd = -1;
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a81, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a81, "End:");
     }
 
 
@@ -126,11 +178,81 @@ namespace abc { namespace vmem {
     }
 
 
+    inline pool_stats pool::stats() const noexcept {
+        return _stats;
+    }
+
+
+    inline std::size_t pool::compact() {
+        constexpr const char* suborigin = "compact()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10cdd, "Begin:");
+
+        diag_base::expect(suborigin, _ready, 0x10cde, "_ready");
+        diag_base::expect(suborigin, !_config.read_only, 0x10d73, "!_config.read_only");
+
+        page_pos_t file_size = ::lseek(_fd, 0, SEEK_END);
+        page_pos_t page_count = file_size / page_size;
+        page_pos_t new_page_count = page_count;
+
+        // Find the run of free pages at the tail of the file. Required pages are never free.
+        {
+            std::set<page_pos_t> free_page_positions = get_free_page_positions();
+
+            while (new_page_count > page_pos_start + 1 && free_page_positions.find(new_page_count - 1) != free_page_positions.end()) {
+                new_page_count--;
+            }
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10cdf, "page_count=%llu, new_page_count=%llu", (unsigned long long)page_count, (unsigned long long)new_page_count);
+
+        if (new_page_count < page_count) {
+            // Unlink the trailing pages from the list of free pages.
+            for (page_pos_t page_pos = new_page_count; page_pos < page_count; page_pos++) {
+                remove_free_page_pos(page_pos);
+            }
+
+            // Unmap the trailing pages.
+            mapped_page_container::iterator mapped_page_itr = _mapped_pages.begin();
+            while (mapped_page_itr != _mapped_pages.end()) {
+                if (mapped_page_itr->second.pos >= new_page_count) {
+                    diag_base::expect(suborigin, mapped_page_itr->second.lock_count == 0, 0x10ce0, "mapped_page_itr->second.lock_count == 0, page_pos=0x%llx", (unsigned long long)mapped_page_itr->second.pos);
+                    mapped_page_itr = unmap_page(mapped_page_itr);
+
+                    // Capacity has been freed other than by eviction.
+                    _is_at_capacity = false;
+                }
+                else {
+                    mapped_page_itr++;
+                }
+            }
+
+            int tr = ::ftruncate(_fd, static_cast<off_t>(new_page_count * page_size));
+            diag_base::ensure(suborigin, tr == 0, 0x10ce1, "tr == 0, errno=%d", errno);
+
+            if (_crc_fd >= 0) {
+                tr = ::ftruncate(_crc_fd, static_cast<off_t>(new_page_count * sizeof(std::uint32_t)));
+                diag_base::ensure(suborigin, tr == 0, 0x10cfd, "tr == 0, errno=%d", errno);
+            }
+        }
+
+        if (_cold_fd >= 0) {
+            compact_cold_pages(new_page_count);
+        }
+
+        std::size_t released_page_count = static_cast<std::size_t>(page_count - new_page_count);
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10ce2, "End: released_page_count=%zu", released_page_count);
+
+        return released_page_count;
+    }
+
+
     inline bool pool::open() {
         constexpr const char* suborigin = "open()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1037c, "Begin: file_path='%s'", _config.file_path.c_str());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1037c, "Begin: file_path='%s'", _config.file_path.c_str());
 
-        _fd = ::open(_config.file_path.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH);
+        int flags = _config.read_only ? O_RDONLY : O_CREAT | O_RDWR;
+        _fd = ::open(_config.file_path.c_str(), flags, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH);
         diag_base::ensure(suborigin, _fd >= 0, 0x1037e, "_fd >= 0, errno=%d", errno);
 
         page_pos_t file_size = ::lseek(_fd, 0, SEEK_END);
@@ -138,7 +260,7 @@ namespace abc { namespace vmem {
 
         bool is_init = (file_size / page_size >= 2);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x104ae, "End: is_init=%d, file_size=%llu", is_init, (unsigned long long)file_size);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x104ae, "End: is_init=%d, file_size=%llu", is_init, (unsigned long long)file_size);
 
         return is_init;
     }
@@ -146,7 +268,7 @@ namespace abc { namespace vmem {
 
     inline void pool::init() {
         constexpr const char* suborigin = "init()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a82, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a82, "Begin:");
 
         // IMPORTANT! Keep this order:
         // root  (0)
@@ -154,13 +276,13 @@ namespace abc { namespace vmem {
         create_root_page();
         create_start_page();
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a83, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a83, "End:");
     }
 
 
     inline void pool::create_root_page() {
         constexpr const char* suborigin = "create_root_page()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10381, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10381, "Begin:");
 
         vmem::page page(this, diag_base::log());
         diag_base::ensure(suborigin, page.ptr() != nullptr, 0x10382, "page.ptr() != nullptr");
@@ -170,45 +292,45 @@ namespace abc { namespace vmem {
         vmem::root_page root_page_layout;
         std::memmove(page.ptr(), &root_page_layout, sizeof(root_page_layout));
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10383, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10383, "Begin:");
     }
 
 
     inline void pool::create_start_page() {
         constexpr const char* suborigin = "create_start_page()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10384, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10384, "Begin:");
 
         vmem::page page(this, diag_base::log());
         diag_base::ensure(suborigin, page.ptr() != nullptr, 0x10385, "page.ptr() != nullptr");
 
         std::memset(page.ptr(), 0, page_size);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10386, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10386, "Begin:");
     }
 
 
     inline void pool::verify() {
         constexpr const char* suborigin = "verify()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a84, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a84, "Begin:");
 
         verify_root_page();
         verify_start_page();
 
         _ready = true;
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a85, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a85, "Begin:");
     }
 
 
     inline void pool::verify_root_page() {
         constexpr const char* suborigin = "verify_root_page()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10387, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10387, "Begin:");
 
         vmem::page page(this, page_pos_root, diag_base::log());
         diag_base::expect(suborigin, page.ptr() != nullptr, 0x10388, "page.ptr() != nullptr");
 
         vmem::root_page* root_page = reinterpret_cast<vmem::root_page*>(page.ptr());
-        diag_base::put_any(suborigin, diag::severity::debug, 0x10389, "Root page: pos=0x%llx, ptr=%p, version=%u, signature='%s', page_size=%u",
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::debug, 0x10389, "Root page: pos=0x%llx, ptr=%p, version=%u, signature='%s', page_size=%u",
                 (unsigned long long)page.pos(), page.ptr(), root_page->version, root_page->signature, (unsigned)root_page->page_size);
 
         vmem::root_page root_page_layout;
@@ -216,20 +338,20 @@ namespace abc { namespace vmem {
         diag_base::expect(suborigin, std::strcmp(root_page->signature, root_page_layout.signature) == 0, 0x1038b, "std::strcmp(root_page->signature, root_page_layout.signature) == 0");
         diag_base::expect(suborigin, root_page->page_size == page_size, 0x1038c, "root_page->page_size == page_size");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x104af, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x104af, "End:");
     }
 
 
     inline void pool::verify_start_page() {
         constexpr const char* suborigin = "verify_start_page()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1038d, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1038d, "Begin:");
 
         vmem::page page(this, page_pos_start, diag_base::log());
         diag_base::expect(suborigin, page.ptr() != nullptr, 0x1038e, "page.ptr() != nullptr");
 
-        diag_base::put_any(suborigin, diag::severity::debug, 0x1038f, "Start page: pos=0x%llx, ptr=%p", (unsigned long long)page.pos(), page.ptr());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::debug, 0x1038f, "Start page: pos=0x%llx, ptr=%p", (unsigned long long)page.pos(), page.ptr());
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x104b0, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x104b0, "End:");
     }
 
 
@@ -238,7 +360,9 @@ namespace abc { namespace vmem {
 
     inline page_pos_t pool::alloc_page() {
         constexpr const char* suborigin = "alloc_page()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10391, "Begin: ready=%d", _ready);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10391, "Begin: ready=%d", _ready);
+
+        diag_base::expect(suborigin, !_config.read_only, 0x10d74, "!_config.read_only");
 
         page_pos_t page_pos = pop_free_page_pos();
 
@@ -248,7 +372,7 @@ namespace abc { namespace vmem {
 
         diag_base::ensure(suborigin, page_pos != page_pos_nil, 0x10396, "page_pos != page_pos_nil");
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x104b1, "End: page_pos=0x%llx", (unsigned long long)page_pos);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x104b1, "End: page_pos=0x%llx", (unsigned long long)page_pos);
 
         return page_pos;
     }
@@ -256,19 +380,21 @@ namespace abc { namespace vmem {
 
     inline void pool::free_page(page_pos_t page_pos) {
         constexpr const char* suborigin = "free_page()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10399, "Begin: ready=%d, page_pos=0x%llx", _ready, (unsigned long long)page_pos);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10399, "Begin: ready=%d, page_pos=0x%llx", _ready, (unsigned long long)page_pos);
+
+        diag_base::expect(suborigin, !_config.read_only, 0x10d75, "!_config.read_only");
 
         if (page_pos != page_pos_nil && _ready) {
             push_free_page_pos(page_pos);
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x104b2, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x104b2, "End:");
     }
 
 
     inline page_pos_t pool::pop_free_page_pos() {
         constexpr const char* suborigin = "pop_free_page_pos()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x104b3, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x104b3, "Begin:");
 
         page_pos_t page_pos = page_pos_nil;
 
@@ -281,19 +407,19 @@ namespace abc { namespace vmem {
             vmem::linked free_pages_linked(&root_page->free_pages, this, diag_base::log(), true /*is_free_pages*/);
 
             if (!free_pages_linked.empty()) {
-                diag_base::put_any(suborigin, diag::severity::optional, 0x10393, "!empty");
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10393, "!empty");
 
                 page_pos = free_pages_linked.back();
                 free_pages_linked.pop_back();
 
-                diag_base::put_any(suborigin, diag::severity::optional, 0x10394, "page_pos=0x%llx", (unsigned long long)page_pos);
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10394, "page_pos=0x%llx", (unsigned long long)page_pos);
             }
         }
         else {
-            diag_base::put_any(suborigin, diag::severity::optional, 0x10a86, "!_ready");
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10a86, "!_ready");
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x104b4, "End: page_pos=0x%llx", (unsigned long long)page_pos);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x104b4, "End: page_pos=0x%llx", (unsigned long long)page_pos);
 
         return page_pos;
     }
@@ -301,7 +427,7 @@ namespace abc { namespace vmem {
 
     inline void pool::push_free_page_pos(page_pos_t page_pos) {
         constexpr const char* suborigin = "push_free_page_pos()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x104b5, "Begin: page_pos=0x%llx", (unsigned long long)page_pos);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x104b5, "Begin: page_pos=0x%llx", (unsigned long long)page_pos);
 
         if (_ready) {
             // Get the root page to get the free pages linked state.
@@ -314,26 +440,33 @@ namespace abc { namespace vmem {
             free_pages_linked.push_back(page_pos);
         }
         else {
-            diag_base::put_any(suborigin, diag::severity::optional, 0x10a87, "!_ready");
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10a87, "!_ready");
         }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x104b6, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x104b6, "End:");
     }
 
 
     inline page_pos_t pool::create_page() {
         constexpr const char* suborigin = "create_page()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x104b7, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x104b7, "Begin:");
 
         page_pos_t page_off = lseek(_fd, 0, SEEK_END);
         page_pos_t page_pos = page_off / page_size;
-        diag_base::put_any(suborigin, diag::severity::optional,  0x10397, "pos=0x%llx off=0x%llx", (unsigned long long)page_pos, (unsigned long long)page_off);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional,  0x10397, "pos=0x%llx off=0x%llx", (unsigned long long)page_pos, (unsigned long long)page_off);
 
         std::uint8_t blank_page[page_size] = { };
         ssize_t wb = write(_fd, blank_page, page_size);
         diag_base::ensure(suborigin, wb == page_size, 0x10398, "wb == page_size, wb=%ld, errno=%d", (long)wb, errno);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x104b8, "End: page_pos=0x%llx", (unsigned long long)page_pos);
+        _stats.grown_byte_count += page_size;
+
+        if (_crc_fd >= 0) {
+            // Discard any stale checksum from a truncated tail.
+            write_page_checksum(page_pos, 0);
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x104b8, "End: page_pos=0x%llx", (unsigned long long)page_pos);
 
         return page_pos;
     }
@@ -342,9 +475,112 @@ namespace abc { namespace vmem {
     // ..............................................................
 
 
+    inline std::set<page_pos_t> pool::get_free_page_positions() {
+        constexpr const char* suborigin = "get_free_page_positions()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10ce3, "Begin:");
+
+        std::set<page_pos_t> free_page_positions;
+
+        vmem::page page(this, page_pos_root, diag_base::log());
+        diag_base::expect(suborigin, page.ptr() != nullptr, 0x10ce4, "page.ptr() != nullptr");
+
+        vmem::root_page* root_page = reinterpret_cast<vmem::root_page*>(page.ptr());
+        vmem::linked free_pages_linked(&root_page->free_pages, this, diag_base::log(), true /*is_free_pages*/);
+
+        for (vmem::linked::const_iterator itr = free_pages_linked.cbegin(); itr != free_pages_linked.cend(); itr++) {
+            free_page_positions.insert(*itr);
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10ce5, "End: free_page_count=%zu", free_page_positions.size());
+
+        return free_page_positions;
+    }
+
+
+    inline void pool::remove_free_page_pos(page_pos_t page_pos) {
+        constexpr const char* suborigin = "remove_free_page_pos()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10ce6, "Begin: page_pos=0x%llx", (unsigned long long)page_pos);
+
+        vmem::page page(this, page_pos_root, diag_base::log());
+        diag_base::expect(suborigin, page.ptr() != nullptr, 0x10ce7, "page.ptr() != nullptr");
+
+        vmem::root_page* root_page = reinterpret_cast<vmem::root_page*>(page.ptr());
+        vmem::linked free_pages_linked(&root_page->free_pages, this, diag_base::log(), true /*is_free_pages*/);
+
+        free_pages_linked.erase(vmem::linked::const_iterator(&free_pages_linked, page_pos, item_pos_nil, iterator_edge::none, diag_base::log()));
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10ce8, "End:");
+    }
+
+
+    inline void pool::relocate_linked_page(linked_state* state, page_pos_t page_pos, page_pos_t new_page_pos, std::set<page_pos_t>& free_page_positions) {
+        constexpr const char* suborigin = "relocate_linked_page()";
+
+        // Take the new position off the list of free pages, move the page, and free its current position.
+        free_page_positions.erase(new_page_pos);
+        remove_free_page_pos(new_page_pos);
+
+        move_linked_page(state, page_pos, new_page_pos);
+
+        push_free_page_pos(page_pos);
+        free_page_positions.insert(page_pos);
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10cf0, "Moved page_pos=0x%llx -> 0x%llx", (unsigned long long)page_pos, (unsigned long long)new_page_pos);
+    }
+
+
+    inline page_pos_t pool::move_linked_page(linked_state* state, page_pos_t page_pos, page_pos_t new_page_pos) {
+        constexpr const char* suborigin = "move_linked_page()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10ce9, "Begin: page_pos=0x%llx, new_page_pos=0x%llx", (unsigned long long)page_pos, (unsigned long long)new_page_pos);
+
+        vmem::page page(this, page_pos, diag_base::log());
+        diag_base::expect(suborigin, page.ptr() != nullptr, 0x10cea, "page.ptr() != nullptr");
+
+        vmem::page new_page(this, new_page_pos, diag_base::log());
+        diag_base::expect(suborigin, new_page.ptr() != nullptr, 0x10ceb, "new_page.ptr() != nullptr");
+
+        // Copy the whole page, and fix its own position.
+        std::memmove(new_page.ptr(), page.ptr(), page_size);
+
+        vmem::linked_page* new_linked_page = reinterpret_cast<vmem::linked_page*>(new_page.ptr());
+        new_linked_page->page_pos = new_page_pos;
+
+        // Relink the prev page.
+        if (new_linked_page->prev_page_pos != page_pos_nil) {
+            vmem::page prev_page(this, new_linked_page->prev_page_pos, diag_base::log());
+            diag_base::expect(suborigin, prev_page.ptr() != nullptr, 0x10cec, "prev_page.ptr() != nullptr");
+
+            reinterpret_cast<vmem::linked_page*>(prev_page.ptr())->next_page_pos = new_page_pos;
+        }
+        else {
+            state->front_page_pos = new_page_pos;
+        }
+
+        // Relink the next page.
+        if (new_linked_page->next_page_pos != page_pos_nil) {
+            vmem::page next_page(this, new_linked_page->next_page_pos, diag_base::log());
+            diag_base::expect(suborigin, next_page.ptr() != nullptr, 0x10ced, "next_page.ptr() != nullptr");
+
+            reinterpret_cast<vmem::linked_page*>(next_page.ptr())->prev_page_pos = new_page_pos;
+        }
+        else {
+            state->back_page_pos = new_page_pos;
+        }
+
+        page_pos_t next_page_pos = new_linked_page->next_page_pos;
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10cee, "End: next_page_pos=0x%llx", (unsigned long long)next_page_pos);
+
+        return next_page_pos;
+    }
+
+
+    // ..............................................................
+
+
     inline void* pool::lock_page(page_pos_t page_pos) {
         constexpr const char* suborigin = "lock_page()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1039b, "Begin: page_pos=0x%llx", (unsigned long long)page_pos);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1039b, "Begin: page_pos=0x%llx", (unsigned long long)page_pos);
 
         vmem::mapped_page* mapped_page = map_page(page_pos);
         diag_base::ensure(suborigin, mapped_page != nullptr, 0x10a88, "mapped_page != nullptr");
@@ -361,9 +597,18 @@ namespace abc { namespace vmem {
         mapped_page->lock_count++;
         mapped_page->keep_count++;
 
-        log_stats();
+        // Any locked page may get changed.
+        if (!_config.read_only) {
+            if (_dirty_pages.size() <= page_pos) {
+                _dirty_pages.resize(page_pos + 1, false);
+            }
+
+            _dirty_pages[page_pos] = true;
+        }
+
+        log_stats_sampled();
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x1039b, "End: lock_count=%u", (unsigned)mapped_page->lock_count);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x1039b, "End: lock_count=%u", (unsigned)mapped_page->lock_count);
 
         return mapped_page->ptr;
     }
@@ -371,7 +616,7 @@ namespace abc { namespace vmem {
 
     inline void pool::unlock_page(page_pos_t page_pos) {
         constexpr const char* suborigin = "unlock_page()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x103aa, "Begin: page_pos=0x%llx", (unsigned long long)page_pos);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x103aa, "Begin: page_pos=0x%llx", (unsigned long long)page_pos);
 
         // The page must be mapped.
         mapped_page_container::iterator mapped_page_itr = _mapped_pages.find(page_pos);
@@ -391,20 +636,21 @@ namespace abc { namespace vmem {
 
             if (_config.sync_pages_on_unlock) {
                 // Sync the OS page.
+                _stats.msync_count++;
                 int sn = msync(mapped_page_itr->second.ptr, page_size, MS_ASYNC);
                 diag_base::ensure(suborigin, sn == 0, 0x103ab, "sn == 0, page_pos=0x%llx, ptr=%p, sn=%d, errno=%d", (unsigned long long)page_pos, mapped_page_itr->second.ptr, sn, errno);
             }
         }
 
-        log_stats();
+        log_stats_sampled();
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a8a, "End: lock_count=%u", (unsigned)mapped_page_itr->second.lock_count);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a8a, "End: lock_count=%u", (unsigned)mapped_page_itr->second.lock_count);
     }
 
 
     inline vmem::mapped_page* pool::map_page(page_pos_t page_pos) {
         constexpr const char* suborigin = "map_page()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a8b, "Begin: page_pos=0x%llx", (unsigned long long)page_pos);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a8b, "Begin: page_pos=0x%llx", (unsigned long long)page_pos);
 
         mapped_page_container::iterator mapped_page_itr = _mapped_pages.find(page_pos);
         if (mapped_page_itr != _mapped_pages.end()) {
@@ -419,10 +665,20 @@ namespace abc { namespace vmem {
             ensure_mapping_capacity();
             diag_base::expect(suborigin, _mapped_pages.size() < _config.max_mapped_page_count, 0x10a8c, "_mapped_pages.size() < _config.max_mapped_page_count, mapped_page_count=%zu, max_mapped_page_count=%zu", _mapped_pages.size(), _config.max_mapped_page_count);
 
+            std::chrono::steady_clock::time_point map_in_start = std::chrono::steady_clock::now();
+
             // Map the OS page.
-            off_t page_off = static_cast<off_t>(page_pos * vmem::page_size);
-            void* ptr = mmap(NULL, page_size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, page_off);
-            diag_base::ensure(suborigin, ptr != MAP_FAILED, 0x10a8d, "ptr != MAP_FAILED, ptr=%p, errno=%d", ptr, errno);
+            void* ptr = map_page_ptr(page_pos);
+
+            if (_cold_fd >= 0 && !decompress_page(page_pos, ptr)) {
+                unmap_page_ptr(page_pos, ptr);
+                diag_base::throw_exception<std::runtime_error>(suborigin, 0x10d25, "Cold page corrupt. page_pos=0x%llx", (unsigned long long)page_pos);
+            }
+
+            if (_crc_fd >= 0 && !verify_page_checksum(page_pos, ptr)) {
+                unmap_page_ptr(page_pos, ptr);
+                diag_base::throw_exception<std::runtime_error>(suborigin, 0x10cfe, "Page checksum mismatch. page_pos=0x%llx", (unsigned long long)page_pos);
+            }
 
             // Init a mapped_page entry.
             std::pair<page_pos_t, mapped_page> mapped_page_kvp { };
@@ -436,13 +692,15 @@ namespace abc { namespace vmem {
 
             // There is one more unlocked page in the container.
             _stats.unlocked_page_count++;
+
+            _stats.map_in_latency.record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - map_in_start).count());
         }
 
         diag_base::ensure(suborigin, mapped_page_itr != _mapped_pages.end(), 0x10a8f, "mapped_page_itr != _mapped_pages.end()");
 
-        log_stats();
+        log_stats_sampled();
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a90, "End: mapped_page=%p", &*mapped_page_itr);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a90, "End: mapped_page=%p", &*mapped_page_itr);
 
         return &mapped_page_itr->second;
     }
@@ -450,20 +708,61 @@ namespace abc { namespace vmem {
 
     inline pool::mapped_page_container::iterator pool::unmap_page(const mapped_page_container::iterator& mapped_page_itr) {
         constexpr const char* suborigin = "unmap_page()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x103a0, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x103a0, "Begin:");
 
         diag_base::expect(suborigin, mapped_page_itr != _mapped_pages.end(), 0x10a91, "mapped_page_itr != _mapped_pages.end()");
         diag_base::expect(suborigin, mapped_page_itr->second.ptr != nullptr, 0x10a92, "mapped_page_itr->second.ptr != nullptr");
 
-        if (!_config.sync_pages_on_unlock || (_config.sync_locked_pages_on_destroy && mapped_page_itr->second.lock_count > 0)) {
+        if (_config.read_only) {
+            // Nothing to sync or store.
+        }
+        else if (!_config.sync_pages_on_unlock || (_config.sync_locked_pages_on_destroy && mapped_page_itr->second.lock_count > 0)) {
             // Sync the OS page. 
+            _stats.msync_count++;
             int sn = msync(mapped_page_itr->second.ptr, page_size, MS_ASYNC);
             diag_base::ensure(suborigin, sn == 0, 0x10a93, "sn == 0, page_pos=0x%llx, ptr=%p, sn=%d, errno=%d", (unsigned long long)mapped_page_itr->second.pos, mapped_page_itr->second.ptr, sn, errno);
         }
 
+        bool is_punched = false;
+        if (!_config.read_only) {
+            cold_page_index::iterator slot_itr = _cold_index.find(mapped_page_itr->second.pos);
+
+            std::uint32_t checksum = 0;
+            if (_crc_fd >= 0 || slot_itr != _cold_index.end()) {
+                checksum = crc32c(mapped_page_itr->second.ptr, page_size);
+            }
+
+            if (_crc_fd >= 0) {
+                write_page_checksum(mapped_page_itr->second.pos, checksum);
+            }
+
+            if (_config.compress_cold_pages && !is_required_page(mapped_page_itr->second.pos) && is_cold_page(mapped_page_itr->second)) {
+                if (slot_itr != _cold_index.end() && slot_itr->second.page_checksum != 0 && slot_itr->second.page_checksum == checksum) {
+                    // The page hasn't changed since it was decompressed. Its record is still current.
+                    is_punched = true;
+                }
+                else {
+                    is_punched = compress_page(mapped_page_itr->second.pos, mapped_page_itr->second.ptr);
+                }
+            }
+
+            if (!is_punched) {
+                // The page stays in its slot, which makes its record, if any, stale.
+                slot_itr = _cold_index.find(mapped_page_itr->second.pos);
+                if (slot_itr != _cold_index.end()) {
+                    _cold_live_size -= static_cast<off_t>(sizeof(cold_page_header) + slot_itr->second.data_size);
+                    _cold_index.erase(slot_itr);
+                }
+            }
+        }
+
         // Unmap the OS page.
-        int um = munmap(mapped_page_itr->second.ptr, page_size);
-        diag_base::ensure(suborigin, um == 0, 0x10a94, "um == 0");
+        unmap_page_ptr(mapped_page_itr->second.pos, mapped_page_itr->second.ptr);
+
+        // The slot is punched out once the record is durable. Records are synced in batches.
+        if (is_punched) {
+            _pending_punch_pages.push_back(mapped_page_itr->second.pos);
+        }
 
         if (mapped_page_itr->second.lock_count > 0) {
             _stats.locked_page_keep_count -= mapped_page_itr->second.keep_count;
@@ -474,30 +773,309 @@ namespace abc { namespace vmem {
             _stats.unlocked_page_count--;
         }
 
-        diag_base::put_any(suborigin, diag::severity::optional, 0x10a95, "pos=0x%llx, ptr=%p", (unsigned long long)mapped_page_itr->second.pos, mapped_page_itr->second.ptr);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10a95, "pos=0x%llx, ptr=%p", (unsigned long long)mapped_page_itr->second.pos, mapped_page_itr->second.ptr);
 
         // Remove the mapped page entry from the container.
         mapped_page_container::iterator ret_itr = _mapped_pages.erase(mapped_page_itr);
 
-        log_stats();
+        if (_pending_punch_pages.size() >= cold_page_punch_batch_size) {
+            punch_pending_pages();
+        }
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x104c2, "End:");
+        log_stats_sampled();
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x104c2, "End:");
 
         return ret_itr;
     }
 
 
+    inline int pool::page_protection() const noexcept {
+        return _config.read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+    }
+
+
+    inline void* pool::map_page_ptr(page_pos_t page_pos) {
+        constexpr const char* suborigin = "map_page_ptr()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d50, "Begin: page_pos=0x%llx", (unsigned long long)page_pos);
+
+        void* ptr = nullptr;
+
+        if (!_config.use_huge_pages) {
+            off_t page_off = static_cast<off_t>(page_pos * vmem::page_size);
+            ptr = mmap(NULL, page_size, page_protection(), MAP_SHARED, _fd, page_off);
+            diag_base::ensure(suborigin, ptr != MAP_FAILED, 0x10a8d, "ptr != MAP_FAILED, ptr=%p, errno=%d", ptr, errno);
+        }
+        else {
+            page_pos_t extent_pos = page_pos - page_pos % huge_extent_page_count;
+
+            mapped_extent_container::iterator mapped_extent_itr = _mapped_extents.find(extent_pos);
+            if (mapped_extent_itr == _mapped_extents.end()) {
+                // Reserve twice the extent size, so that a 2 MB-aligned address can be found within.
+                void* reserved_ptr = mmap(NULL, 2 * huge_extent_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                diag_base::ensure(suborigin, reserved_ptr != MAP_FAILED, 0x10d51, "reserved_ptr != MAP_FAILED, errno=%d", errno);
+
+                std::uintptr_t reserved_addr = reinterpret_cast<std::uintptr_t>(reserved_ptr);
+                std::uintptr_t extent_addr = (reserved_addr + huge_extent_size - 1) & ~static_cast<std::uintptr_t>(huge_extent_size - 1);
+
+                // Release the slack before and after the extent.
+                if (extent_addr > reserved_addr) {
+                    munmap(reserved_ptr, extent_addr - reserved_addr);
+                }
+                munmap(reinterpret_cast<void*>(extent_addr + huge_extent_size), reserved_addr + huge_extent_size - extent_addr);
+
+                // Accessing the part of the extent beyond the end of the file is not allowed, but that part is never accessed.
+                off_t extent_off = static_cast<off_t>(extent_pos * vmem::page_size);
+                void* extent_ptr = mmap(reinterpret_cast<void*>(extent_addr), huge_extent_size, page_protection(), MAP_SHARED | MAP_FIXED, _fd, extent_off);
+                diag_base::ensure(suborigin, extent_ptr != MAP_FAILED, 0x10d52, "extent_ptr != MAP_FAILED, errno=%d", errno);
+
+#if defined(MADV_HUGEPAGE)
+                int ma = madvise(extent_ptr, huge_extent_size, MADV_HUGEPAGE);
+                if (ma != 0) {
+                    ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10d53, "madvise() failed: errno=%d", errno);
+                }
+#endif
+
+                std::pair<page_pos_t, mapped_extent> mapped_extent_kvp { };
+                mapped_extent_kvp.first = extent_pos;
+                mapped_extent_kvp.second.ptr = extent_ptr;
+
+                std::pair<mapped_extent_container::iterator, bool> inserted_mapped_extent = _mapped_extents.insert(std::move(mapped_extent_kvp));
+                diag_base::ensure(suborigin, inserted_mapped_extent.second, 0x10d54, "inserted_mapped_extent.second");
+                mapped_extent_itr = inserted_mapped_extent.first;
+
+                _stats.mapped_extent_count++;
+
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10d55, "Mapped extent: extent_pos=0x%llx, ptr=%p", (unsigned long long)extent_pos, extent_ptr);
+            }
+
+            mapped_extent_itr->second.page_count++;
+            ptr = reinterpret_cast<std::uint8_t*>(mapped_extent_itr->second.ptr) + (page_pos - extent_pos) * page_size;
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d56, "End: ptr=%p", ptr);
+
+        return ptr;
+    }
+
+
+    inline void pool::unmap_page_ptr(page_pos_t page_pos, void* ptr) {
+        constexpr const char* suborigin = "unmap_page_ptr()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d57, "Begin: page_pos=0x%llx, ptr=%p", (unsigned long long)page_pos, ptr);
+
+        if (!_config.use_huge_pages) {
+            int um = munmap(ptr, page_size);
+            diag_base::ensure(suborigin, um == 0, 0x10a94, "um == 0");
+        }
+        else {
+            page_pos_t extent_pos = page_pos - page_pos % huge_extent_page_count;
+
+            mapped_extent_container::iterator mapped_extent_itr = _mapped_extents.find(extent_pos);
+            diag_base::expect(suborigin, mapped_extent_itr != _mapped_extents.end(), 0x10d58, "mapped_extent_itr != _mapped_extents.end()");
+            diag_base::expect(suborigin, mapped_extent_itr->second.page_count > 0, 0x10d59, "mapped_extent_itr->second.page_count > 0");
+
+            if (--mapped_extent_itr->second.page_count == 0) {
+                int um = munmap(mapped_extent_itr->second.ptr, huge_extent_size);
+                diag_base::ensure(suborigin, um == 0, 0x10d5a, "um == 0, errno=%d", errno);
+
+                _mapped_extents.erase(mapped_extent_itr);
+                _stats.mapped_extent_count--;
+
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10d5b, "Unmapped extent: extent_pos=0x%llx", (unsigned long long)extent_pos);
+            }
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d5c, "End:");
+    }
+
+
+    inline std::size_t pool::huge_page_byte_count() {
+        constexpr const char* suborigin = "huge_page_byte_count()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d5d, "Begin: mapped_extent_count=%zu", _mapped_extents.size());
+
+        std::size_t byte_count = 0;
+
+        if (!_mapped_extents.empty()) {
+            std::set<std::uintptr_t> extent_addrs;
+            for (const mapped_extent_container::value_type& kvp : _mapped_extents) {
+                extent_addrs.insert(reinterpret_cast<std::uintptr_t>(kvp.second.ptr));
+            }
+
+            // The kernel may merge adjacent extents into a single area.
+            std::ifstream smaps("/proc/self/smaps");
+            std::string line;
+            bool is_extent_area = false;
+
+            while (std::getline(smaps, line)) {
+                unsigned long long area_begin;
+                unsigned long long area_end;
+                char field_name[64];
+                unsigned long long field_kb;
+
+                if (std::sscanf(line.c_str(), "%llx-%llx ", &area_begin, &area_end) == 2) {
+                    std::set<std::uintptr_t>::const_iterator extent_addr_itr = extent_addrs.lower_bound(static_cast<std::uintptr_t>(area_begin));
+                    is_extent_area = extent_addr_itr != extent_addrs.end() && *extent_addr_itr < area_end;
+                }
+                else if (is_extent_area && std::sscanf(line.c_str(), "%63[^:]: %llu kB", field_name, &field_kb) == 2) {
+                    if (std::strcmp(field_name, "AnonHugePages") == 0 || std::strcmp(field_name, "ShmemPmdMapped") == 0 || std::strcmp(field_name, "FilePmdMapped") == 0) {
+                        byte_count += static_cast<std::size_t>(field_kb * size::k1);
+                    }
+                }
+            }
+        }
+
+        _stats.huge_page_byte_count = byte_count;
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d5e, "End: byte_count=%zu", byte_count);
+
+        return byte_count;
+    }
+
+
+    // ..............................................................
+
+
+    inline std::size_t pool::backup(std::ostream& stream, bool incremental) {
+        constexpr const char* suborigin = "backup()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e11, "Begin: incremental=%d, has_backup=%d", incremental, _has_backup);
+
+        diag_base::expect(suborigin, _ready, 0x10e12, "_ready");
+
+        page_pos_t file_size = ::lseek(_fd, 0, SEEK_END);
+        page_pos_t page_count = file_size / page_size;
+
+        std::vector<std::uint8_t> buffer(backup_chunk_page_count * page_size);
+        std::size_t written_count = 0;
+
+        if (incremental) {
+            // Without a previous backup, there is no way to tell which pages have changed.
+            bool is_all = !_has_backup;
+
+            auto is_dirty = [this, is_all] (page_pos_t page_pos) -> bool {
+                return is_all || (page_pos < _dirty_pages.size() && _dirty_pages[page_pos]);
+            };
+
+            backup_increment_header header;
+            header.page_count = page_count;
+            for (page_pos_t page_pos = 0; page_pos < page_count; page_pos++) {
+                if (is_dirty(page_pos)) {
+                    header.record_count++;
+                }
+            }
+
+            stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+            for (page_pos_t page_pos = 0; page_pos < page_count && stream.good(); page_pos++) {
+                if (is_dirty(page_pos)) {
+                    copy_pages(page_pos, 1, buffer.data());
+
+                    stream.write(reinterpret_cast<const char*>(&page_pos), sizeof(page_pos));
+                    stream.write(reinterpret_cast<const char*>(buffer.data()), page_size);
+                    written_count++;
+                }
+            }
+        }
+        else {
+            // Copy whole chunks to keep the I/O sequential.
+            for (page_pos_t page_pos = 0; page_pos < page_count && stream.good(); page_pos += backup_chunk_page_count) {
+                std::size_t chunk_page_count = static_cast<std::size_t>(std::min<page_pos_t>(backup_chunk_page_count, page_count - page_pos));
+
+                copy_pages(page_pos, chunk_page_count, buffer.data());
+
+                stream.write(reinterpret_cast<const char*>(buffer.data()), chunk_page_count * page_size);
+                written_count += chunk_page_count;
+            }
+        }
+
+        stream.flush();
+        diag_base::ensure(suborigin, stream.good(), 0x10e13, "stream.good()");
+
+        // Pages that are still locked may be changed without being locked again, so they remain dirty.
+        // A read-only pool doesn't track dirty pages at all.
+        _dirty_pages.assign(_dirty_pages.size(), false);
+        if (!_config.read_only) {
+            for (const mapped_page_container::value_type& mapped_page_entry : _mapped_pages) {
+                if (mapped_page_entry.second.lock_count > 0) {
+                    if (_dirty_pages.size() <= mapped_page_entry.first) {
+                        _dirty_pages.resize(mapped_page_entry.first + 1, false);
+                    }
+
+                    _dirty_pages[mapped_page_entry.first] = true;
+                }
+            }
+        }
+        _has_backup = true;
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e14, "End: page_count=%llu, written_count=%zu", (unsigned long long)page_count, written_count);
+
+        return written_count;
+    }
+
+
+    inline std::size_t pool::backup_to(const char* file_path, bool incremental) {
+        constexpr const char* suborigin = "backup_to()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e15, "Begin: file_path='%s'", file_path);
+
+        diag_base::expect(suborigin, file_path != nullptr, 0x10e16, "file_path != nullptr");
+
+        std::ofstream stream(file_path, std::ios::binary | std::ios::trunc);
+        diag_base::ensure(suborigin, stream.is_open(), 0x10e17, "stream.is_open()");
+
+        std::size_t written_count = backup(stream, incremental);
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e18, "End: written_count=%zu", written_count);
+
+        return written_count;
+    }
+
+
+    inline void pool::copy_pages(page_pos_t page_pos, std::size_t count, std::uint8_t* buffer) {
+        constexpr const char* suborigin = "copy_pages()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e19, "Begin: page_pos=0x%llx, count=%zu", (unsigned long long)page_pos, count);
+
+        ssize_t rb = ::pread(_fd, buffer, count * page_size, static_cast<off_t>(page_pos * page_size));
+        diag_base::ensure(suborigin, rb == static_cast<ssize_t>(count * page_size), 0x10e1a, "rb == count * page_size, rb=%ld, errno=%d", (long)rb, errno);
+
+        for (std::size_t i = 0; i < count; i++) {
+            std::uint8_t* page_buffer = buffer + i * page_size;
+
+            // A mapped page may have changes that have not been synced.
+            mapped_page_container::const_iterator mapped_page_itr = _mapped_pages.find(page_pos + i);
+            if (mapped_page_itr != _mapped_pages.end()) {
+                std::memmove(page_buffer, mapped_page_itr->second.ptr, page_size);
+                continue;
+            }
+
+            // A cold page is a hole in the pool file. Once restored, its slot takes precedence over its record.
+            cold_page_index::const_iterator cold_itr = _cold_index.find(page_pos + i);
+            if (cold_itr != _cold_index.end() && is_page_hole(_fd, page_pos + i)) {
+                bool is_read = read_cold_page(_cold_fd, cold_itr->second, page_buffer);
+                diag_base::ensure(suborigin, is_read, 0x10e1b, "is_read, page_pos=0x%llx", (unsigned long long)(page_pos + i));
+            }
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e1c, "End:");
+    }
+
+
     inline void pool::ensure_mapping_capacity() {
         constexpr const char* suborigin = "ensure_mapping_capacity()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a96, "Begin: count=%zu, max_count=%zu", _mapped_pages.size(), _config.max_mapped_page_count);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a96, "Begin: count=%zu, max_count=%zu", _mapped_pages.size(), _config.max_mapped_page_count);
 
         diag_base::expect(suborigin, _mapped_pages.size() <= _config.max_mapped_page_count, 0x10a97, "_mapped_pages.size() <= _config.max_mapped_page_count, mapped_page_count=%zu, max_mapped_page_count=%zu", _mapped_pages.size(), _config.max_mapped_page_count);
 
         if (_mapped_pages.size() == _config.max_mapped_page_count) {
             _stats.free_capacity_count++;
 
-            diag_base::put_any(suborigin, diag::severity::verbose, 0x10a98, "Trying to free capacity.");
-            log_stats();
+            std::chrono::steady_clock::time_point eviction_start = std::chrono::steady_clock::now();
+
+            // Reaching the mapping capacity is worth logging the stats regardless of sampling, but only once -
+            // once there, the pool stays at capacity, and every map miss evicts.
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::verbose, 0x10a98, "Trying to free capacity.");
+            if (!_is_at_capacity) {
+                _is_at_capacity = true;
+                log_stats();
+            }
 
             //// TODO: A combination of a container and algorithms should be used so that the following requirements are met:
             // 1. A mapped page entry should not be moved from one container to another when its "locked" state changes.
@@ -511,7 +1089,7 @@ namespace abc { namespace vmem {
 
             // Pass 1: Remove all unlocked pages with a keep count not higher than the average.
             count_t avg_keep_count = (_stats.unlocked_page_keep_count + _stats.unlocked_page_count - 1) / _stats.unlocked_page_count;
-            diag_base::put_any(suborigin, diag::severity::optional, 0x10a9a, "avg_keep_count=%u", (unsigned)avg_keep_count);
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10a9a, "avg_keep_count=%u", (unsigned)avg_keep_count);
 
             mapped_page_container::iterator mapped_page_itr = _mapped_pages.begin();
             while (mapped_page_itr != _mapped_pages.end()) {
@@ -538,6 +1116,9 @@ namespace abc { namespace vmem {
                 }
             }
 
+            _stats.eviction_count += static_cast<count_t>(_config.max_mapped_page_count - _mapped_pages.size());
+            _stats.eviction_latency.record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - eviction_start).count());
+
             if (_mapped_pages.size() == _config.max_mapped_page_count) {
                 diag_base::throw_exception<std::runtime_error>(suborigin, 0x10a9b, "No mapping capacity. (2) max_page_count=%zu, locked_page_count=%u, unlocked_page_count=%u", _config.max_mapped_page_count, (unsigned)_stats.locked_page_count, (unsigned)_stats.unlocked_page_count);
             }
@@ -545,15 +1126,23 @@ namespace abc { namespace vmem {
 
         diag_base::ensure(suborigin, _mapped_pages.size() < _config.max_mapped_page_count, 0x10a9c, "_mapped_pages.size() < _config.max_mapped_page_count, mapped_page_count=%zu, max_mapped_page_count=%zu", _mapped_pages.size(), _config.max_mapped_page_count);
 
-        log_stats();
+        log_stats_sampled();
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10a9d, "End: count=%zu, max_count=%zu", _mapped_pages.size(), _config.max_mapped_page_count);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10a9d, "End: count=%zu, max_count=%zu", _mapped_pages.size(), _config.max_mapped_page_count);
     }
 
 
     inline void pool::clear_linked(linked& linked) {
         constexpr const char* suborigin = "clear_linked()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x104c3, "Begin:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x104c3, "Begin:");
+
+        // Nothing to free, e.g. an unused temp container.
+        if (linked._state->front_page_pos == page_pos_nil) {
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d80, "End: empty");
+            return;
+        }
+
+        diag_base::expect(suborigin, !_config.read_only, 0x10d76, "!_config.read_only");
 
         vmem::page root_page(this, page_pos_root, diag_base::log());
         diag_base::expect(suborigin, root_page.ptr() != nullptr, 0x104c4, "root_page.ptr() != nullptr");
@@ -562,7 +1151,410 @@ namespace abc { namespace vmem {
         vmem::linked free_pages_linked(&root_linked_page->free_pages, this, diag_base::log(), true /*is_free_pages*/);
         free_pages_linked.splice(linked);
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x104c5, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x104c5, "End:");
+    }
+
+
+    inline void pool::compact_linked(linked& linked) {
+        constexpr const char* suborigin = "compact_linked()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10cef, "Begin: front_page_pos=0x%llx, back_page_pos=0x%llx",
+                (unsigned long long)linked._state->front_page_pos, (unsigned long long)linked._state->back_page_pos);
+
+        diag_base::expect(suborigin, !_config.read_only, 0x10d77, "!_config.read_only");
+
+        std::set<page_pos_t> free_page_positions = get_free_page_positions();
+
+        // Current positions of the pages in chain order, and the chain index of each occupied position.
+        std::vector<page_pos_t> page_positions;
+        std::map<page_pos_t, std::size_t> page_indexes;
+
+        for (page_pos_t page_pos = linked._state->front_page_pos; page_pos != page_pos_nil; ) {
+            page_indexes[page_pos] = page_positions.size();
+            page_positions.push_back(page_pos);
+
+            vmem::page page(this, page_pos, diag_base::log());
+            diag_base::expect(suborigin, page.ptr() != nullptr, 0x10cf1, "page.ptr() != nullptr");
+
+            page_pos = reinterpret_cast<vmem::linked_page*>(page.ptr())->next_page_pos;
+        }
+
+        // The chain goes to the lowest positions that are either free or its own, in chain order.
+        std::vector<page_pos_t> target_page_positions;
+        {
+            std::map<page_pos_t, std::size_t>::const_iterator own_itr = page_indexes.cbegin();
+            std::set<page_pos_t>::const_iterator free_itr = free_page_positions.cbegin();
+
+            while (target_page_positions.size() < page_positions.size()) {
+                if (free_itr == free_page_positions.cend() || (own_itr != page_indexes.cend() && own_itr->first < *free_itr)) {
+                    target_page_positions.push_back(own_itr->first);
+                    own_itr++;
+                }
+                else {
+                    target_page_positions.push_back(*free_itr);
+                    free_itr++;
+                }
+            }
+        }
+
+        for (std::size_t i = 0; i < page_positions.size(); i++) {
+            page_pos_t new_page_pos = target_page_positions[i];
+            if (page_positions[i] == new_page_pos) {
+                continue;
+            }
+
+            std::map<page_pos_t, std::size_t>::iterator occupant_itr = page_indexes.find(new_page_pos);
+            if (occupant_itr != page_indexes.end()) {
+                // The target is taken by a page further down the chain. Move that page out of the way.
+                if (free_page_positions.empty()) {
+                    page_pos_t scratch_page_pos = create_page();
+                    push_free_page_pos(scratch_page_pos);
+                    free_page_positions.insert(scratch_page_pos);
+                }
+
+                std::size_t occupant_index = occupant_itr->second;
+                page_indexes.erase(occupant_itr);
+
+                // Prefer the highest free position, which is the least likely to be a target.
+                page_pos_t scratch_page_pos = *free_page_positions.rbegin();
+                relocate_linked_page(linked._state, new_page_pos, scratch_page_pos, free_page_positions);
+                page_indexes[scratch_page_pos] = occupant_index;
+                page_positions[occupant_index] = scratch_page_pos;
+            }
+
+            page_indexes.erase(page_positions[i]);
+            relocate_linked_page(linked._state, page_positions[i], new_page_pos, free_page_positions);
+            page_indexes[new_page_pos] = i;
+            page_positions[i] = new_page_pos;
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10cf2, "End: front_page_pos=0x%llx, back_page_pos=0x%llx",
+                (unsigned long long)linked._state->front_page_pos, (unsigned long long)linked._state->back_page_pos);
+    }
+
+
+    // ..............................................................
+
+
+    inline void pool::open_checksums() {
+        constexpr const char* suborigin = "open_checksums()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10cff, "Begin:");
+
+        std::string crc_file_path = checksum_file_path(_config.file_path);
+
+        int flags = _config.read_only ? O_RDONLY : O_CREAT | O_RDWR;
+        _crc_fd = ::open(crc_file_path.c_str(), flags, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH);
+
+        if (_crc_fd < 0 && _config.read_only && errno == ENOENT) {
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10d78, "No checksum file.");
+        }
+        else {
+            diag_base::ensure(suborigin, _crc_fd >= 0, 0x10d00, "_crc_fd >= 0, errno=%d", errno);
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d01, "End: crc_file_path='%s'", crc_file_path.c_str());
+    }
+
+
+    inline std::uint32_t pool::read_page_checksum(page_pos_t page_pos) {
+        std::uint32_t checksum = 0;
+
+        ssize_t rb = ::pread(_crc_fd, &checksum, sizeof(checksum), static_cast<off_t>(page_pos * sizeof(checksum)));
+        if (rb != sizeof(checksum)) {
+            // Beyond the end of the side file - unknown.
+            checksum = 0;
+        }
+
+        return checksum;
+    }
+
+
+    inline void pool::write_page_checksum(page_pos_t page_pos, std::uint32_t checksum) {
+        constexpr const char* suborigin = "write_page_checksum()";
+
+        ssize_t wb = ::pwrite(_crc_fd, &checksum, sizeof(checksum), static_cast<off_t>(page_pos * sizeof(checksum)));
+        diag_base::ensure(suborigin, wb == sizeof(checksum), 0x10d02, "wb == sizeof(checksum), wb=%ld, errno=%d", (long)wb, errno);
+    }
+
+
+    inline bool pool::verify_page_checksum(page_pos_t page_pos, const void* ptr) {
+        constexpr const char* suborigin = "verify_page_checksum()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d03, "Begin: page_pos=0x%llx", (unsigned long long)page_pos);
+
+        bool is_valid = true;
+
+        std::uint32_t stored_checksum = read_page_checksum(page_pos);
+        if (stored_checksum != 0) {
+            std::uint32_t actual_checksum = crc32c(ptr, page_size);
+
+            if (actual_checksum != stored_checksum) {
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::warning, 0x10d04, "Corrupt page: page_pos=0x%llx, stored_checksum=0x%8.8x, actual_checksum=0x%8.8x",
+                        (unsigned long long)page_pos, (unsigned)stored_checksum, (unsigned)actual_checksum);
+
+                is_valid = false;
+            }
+            else if (!_config.read_only) {
+                // The page may change while it is mapped.
+                write_page_checksum(page_pos, 0);
+            }
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d05, "End: is_valid=%d", is_valid);
+
+        return is_valid;
+    }
+
+
+    // ..............................................................
+
+
+    inline void pool::open_cold_pages() {
+        constexpr const char* suborigin = "open_cold_pages()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d26, "Begin:");
+
+        std::string cold_path = cold_file_path(_config.file_path);
+
+        int flags = _config.read_only ? O_RDONLY : _config.compress_cold_pages ? O_CREAT | O_RDWR : O_RDWR;
+        _cold_fd = ::open(cold_path.c_str(), flags, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH);
+
+        if (_cold_fd < 0) {
+            diag_base::ensure(suborigin, errno == ENOENT, 0x10d27, "errno == ENOENT, errno=%d", errno);
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10d28, "No cold page file.");
+        }
+        else {
+            _cold_end = read_cold_page_index(_cold_fd, _cold_index);
+
+            for (const cold_page_index::value_type& kvp : _cold_index) {
+                _cold_live_size += static_cast<off_t>(sizeof(cold_page_header) + kvp.second.data_size);
+            }
+
+            // Drop an incomplete record from a crash.
+            int tr = _config.read_only ? 0 : ::ftruncate(_cold_fd, _cold_end);
+            diag_base::ensure(suborigin, tr == 0, 0x10d29, "tr == 0, errno=%d", errno);
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d2a, "End: cold_fd=%d, cold_page_count=%zu", _cold_fd, _cold_index.size());
+    }
+
+
+    inline bool pool::is_cold_page(const mapped_page& mapped_page) const noexcept {
+        // Compare the page's keep count with the average keep count of the unlocked pages, without dividing.
+        return mapped_page.lock_count == 0
+            && mapped_page.keep_count * _stats.unlocked_page_count <= _stats.unlocked_page_keep_count;
+    }
+
+
+    inline bool pool::compress_page(page_pos_t page_pos, const void* ptr) {
+        constexpr const char* suborigin = "compress_page()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d2b, "Begin: page_pos=0x%llx", (unsigned long long)page_pos);
+
+        std::uint8_t record[sizeof(cold_page_header) + cold_page_max_data_size];
+        std::size_t data_size = lz4_compress(ptr, page_size, record + sizeof(cold_page_header), cold_page_max_data_size);
+
+        if (data_size != 0) {
+            cold_page_header header;
+            header.page_pos = page_pos;
+            header.data_size = static_cast<item_pos_t>(data_size);
+            std::memcpy(record, &header, sizeof(header));
+
+            std::size_t record_size = sizeof(cold_page_header) + data_size;
+            ssize_t wb = ::pwrite(_cold_fd, record, record_size, _cold_end);
+            diag_base::ensure(suborigin, wb == static_cast<ssize_t>(record_size), 0x10d2c, "wb == record_size, wb=%ld, errno=%d", (long)wb, errno);
+
+            // The record is synced by punch_pending_pages() before the page's slot gets punched out.
+            cold_page_slot& slot = _cold_index[page_pos];
+            if (slot.data_size != 0) {
+                // The page's previous record becomes stale.
+                _cold_live_size -= static_cast<off_t>(sizeof(cold_page_header) + slot.data_size);
+            }
+
+            slot = cold_page_slot{ static_cast<off_t>(_cold_end + sizeof(cold_page_header)), header.data_size, 0 };
+            _cold_end += record_size;
+            _cold_live_size += static_cast<off_t>(record_size);
+
+            // Rewrite the side file once most of it is stale.
+            if (_cold_end - _cold_live_size > cold_page_stale_size_min && _cold_end > 2 * _cold_live_size) {
+                compact_cold_pages(page_pos_nil);
+            }
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d2e, "End: data_size=%zu", data_size);
+
+        return data_size != 0;
+    }
+
+
+    inline void pool::punch_page(page_pos_t page_pos) {
+        constexpr const char* suborigin = "punch_page()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d2f, "Begin: page_pos=0x%llx", (unsigned long long)page_pos);
+
+#if defined(FALLOC_FL_PUNCH_HOLE)
+        int fa = ::fallocate(_fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, static_cast<off_t>(page_pos * page_size), page_size);
+        if (fa != 0) {
+            // The file system doesn't support holes. The slot keeps its stale contents, which are ignored while the page is cold.
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10d30, "fallocate() failed: errno=%d", errno);
+        }
+#endif
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d31, "End:");
+    }
+
+
+    inline void pool::punch_pending_pages() {
+        constexpr const char* suborigin = "punch_pending_pages()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10fdd, "Begin: pending_page_count=%zu", _pending_punch_pages.size());
+
+        // The records must be durable before the pages' slots get punched out.
+        int sn = ::fdatasync(_cold_fd);
+        diag_base::ensure(suborigin, sn == 0, 0x10d2d, "sn == 0, errno=%d", errno);
+
+        for (page_pos_t page_pos : _pending_punch_pages) {
+            punch_page(page_pos);
+        }
+
+        _pending_punch_pages.clear();
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10fde, "End:");
+    }
+
+
+    inline bool pool::decompress_page(page_pos_t page_pos, void* ptr) {
+        constexpr const char* suborigin = "decompress_page()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d32, "Begin: page_pos=0x%llx", (unsigned long long)page_pos);
+
+        bool is_valid = true;
+
+        cold_page_index::iterator slot_itr = _cold_index.find(page_pos);
+
+        std::vector<page_pos_t>::iterator pending_itr = std::find(_pending_punch_pages.begin(), _pending_punch_pages.end(), page_pos);
+        if (pending_itr != _pending_punch_pages.end()) {
+            // The slot hasn't been punched out yet, so it still has the page's contents, which match the record.
+            _pending_punch_pages.erase(pending_itr);
+
+            if (slot_itr != _cold_index.end()) {
+                std::uint32_t checksum = crc32c(ptr, page_size);
+                slot_itr->second.page_checksum = checksum != 0 ? checksum : 1;
+            }
+        }
+        else if (slot_itr != _cold_index.end() && !is_page_hole(_fd, page_pos)) {
+            // The page has been restored into its slot before. The pool file takes precedence over the record.
+            if (!_config.read_only) {
+                _cold_live_size -= static_cast<off_t>(sizeof(cold_page_header) + slot_itr->second.data_size);
+                _cold_index.erase(slot_itr);
+            }
+        }
+        else if (slot_itr != _cold_index.end() && _config.read_only) {
+            // The file mapping is read-only. Replace it with a private page, and restore the contents there.
+            void* private_ptr = mmap(ptr, page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+            diag_base::ensure(suborigin, private_ptr == ptr, 0x10d79, "private_ptr == ptr, errno=%d", errno);
+
+            is_valid = read_cold_page(_cold_fd, slot_itr->second, ptr);
+
+            int mp = mprotect(ptr, page_size, PROT_READ);
+            diag_base::ensure(suborigin, mp == 0, 0x10d7a, "mp == 0, errno=%d", errno);
+        }
+        else if (slot_itr != _cold_index.end()) {
+            is_valid = read_cold_page(_cold_fd, slot_itr->second, ptr);
+
+            if (is_valid) {
+                // Keep the record. It stays current until the page gets written back into its slot.
+                // If the page doesn't change, it can be punched out again without being compressed.
+                std::uint32_t checksum = crc32c(ptr, page_size);
+                slot_itr->second.page_checksum = checksum != 0 ? checksum : 1;
+            }
+            else {
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::warning, 0x10d35, "Corrupt cold page: page_pos=0x%llx, data_off=0x%llx, data_size=%u",
+                        (unsigned long long)page_pos, (unsigned long long)slot_itr->second.data_off, (unsigned)slot_itr->second.data_size);
+            }
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d36, "End: is_valid=%d", is_valid);
+
+        return is_valid;
+    }
+
+
+    inline void pool::compact_cold_pages(page_pos_t page_count) {
+        constexpr const char* suborigin = "compact_cold_pages()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d37, "Begin: cold_end=0x%llx, cold_page_count=%zu", (unsigned long long)_cold_end, _cold_index.size());
+
+        std::string cold_path = cold_file_path(_config.file_path);
+        std::string tmp_path = cold_path + ".tmp";
+
+        int tmp_fd = ::open(tmp_path.c_str(), O_CREAT | O_TRUNC | O_RDWR, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH);
+        diag_base::ensure(suborigin, tmp_fd >= 0, 0x10d38, "tmp_fd >= 0, errno=%d", errno);
+
+        // Pending records are kept only while their slots are holes.
+        if (!_pending_punch_pages.empty()) {
+            punch_pending_pages();
+        }
+
+        // Dropping a record is only safe once the page's slot is durable.
+        if (!_config.read_only) {
+            int sn = ::fdatasync(_fd);
+            diag_base::ensure(suborigin, sn == 0, 0x10f76, "sn == 0, errno=%d", errno);
+        }
+
+        cold_page_index tmp_index;
+        off_t tmp_end = 0;
+
+        for (const cold_page_index::value_type& kvp : _cold_index) {
+            if (kvp.first >= page_count) {
+                continue;
+            }
+
+            if (_mapped_pages.find(kvp.first) != _mapped_pages.end()) {
+                // Keep the record of a mapped page, so it can be punched out again without being compressed.
+                if (!_config.compress_cold_pages) {
+                    continue;
+                }
+            }
+            else if (!is_page_hole(_fd, kvp.first)) {
+                // The page has been restored into its slot.
+                continue;
+            }
+
+            std::uint8_t record[sizeof(cold_page_header) + cold_page_max_data_size];
+
+            cold_page_header header;
+            header.page_pos = kvp.first;
+            header.data_size = kvp.second.data_size;
+            std::memcpy(record, &header, sizeof(header));
+
+            ssize_t rb = ::pread(_cold_fd, record + sizeof(cold_page_header), kvp.second.data_size, kvp.second.data_off);
+            diag_base::ensure(suborigin, rb == kvp.second.data_size, 0x10d39, "rb == data_size, rb=%ld, errno=%d", (long)rb, errno);
+
+            std::size_t record_size = sizeof(cold_page_header) + kvp.second.data_size;
+            ssize_t wb = ::pwrite(tmp_fd, record, record_size, tmp_end);
+            diag_base::ensure(suborigin, wb == static_cast<ssize_t>(record_size), 0x10d3a, "wb == record_size, wb=%ld, errno=%d", (long)wb, errno);
+
+            tmp_index[kvp.first] = cold_page_slot{ static_cast<off_t>(tmp_end + sizeof(cold_page_header)), kvp.second.data_size, kvp.second.page_checksum };
+            tmp_end += record_size;
+        }
+
+        int sn = ::fdatasync(tmp_fd);
+        diag_base::ensure(suborigin, sn == 0, 0x10d3b, "sn == 0, errno=%d", errno);
+
+        int rn = ::rename(tmp_path.c_str(), cold_path.c_str());
+        diag_base::ensure(suborigin, rn == 0, 0x10d3c, "rn == 0, errno=%d", errno);
+
+        ::close(_cold_fd);
+        _cold_fd = tmp_fd;
+        _cold_end = tmp_end;
+        _cold_live_size = tmp_end;
+        _cold_index = std::move(tmp_index);
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d3d, "End: cold_end=0x%llx, cold_page_count=%zu", (unsigned long long)_cold_end, _cold_index.size());
+    }
+
+
+    // ..............................................................
+
+
+    inline void pool::log_stats_sampled() noexcept {
+        if (_config.log_stats_interval != 0 && ++_log_stats_op_count >= _config.log_stats_interval) {
+            _log_stats_op_count = 0;
+            log_stats();
+        }
     }
 
 
@@ -573,10 +1565,52 @@ namespace abc { namespace vmem {
         count_t map_hit_percent = map_count == 0 ? 0 : 100 * _stats.map_hit_count / map_count;
         count_t map_miss_percent = map_count == 0 ? 0 : 100 * _stats.map_miss_count / map_count;
 
-        diag_base::put_any(suborigin, diag::severity::verbose, 0x10a9e, "Pages: container=%zu, locked=%u, unlocked=%u", _mapped_pages.size(), (unsigned)_stats.locked_page_count, (unsigned)_stats.unlocked_page_count);
-        diag_base::put_any(suborigin, diag::severity::verbose, 0x10a9f, "Map: hit=%u (%u%%), miss=%u (%u%%)", (unsigned)_stats.map_hit_count, (unsigned)map_hit_percent, (unsigned)_stats.map_miss_count, (unsigned)map_miss_percent);
-        diag_base::put_any(suborigin, diag::severity::verbose, 0x10aa0, "Keep: locked=%u, unlocked=%u", (unsigned)_stats.locked_page_keep_count, (unsigned)_stats.unlocked_page_keep_count);
-        diag_base::put_any(suborigin, diag::severity::verbose, 0x10aa1, "Capacity: count=%u", (unsigned)_stats.free_capacity_count);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::verbose, 0x10a9e, "Pages: container=%zu, locked=%u, unlocked=%u", _mapped_pages.size(), (unsigned)_stats.locked_page_count, (unsigned)_stats.unlocked_page_count);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::verbose, 0x10a9f, "Map: hit=%u (%u%%), miss=%u (%u%%)", (unsigned)_stats.map_hit_count, (unsigned)map_hit_percent, (unsigned)_stats.map_miss_count, (unsigned)map_miss_percent);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::verbose, 0x10aa0, "Keep: locked=%u, unlocked=%u", (unsigned)_stats.locked_page_keep_count, (unsigned)_stats.unlocked_page_keep_count);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::verbose, 0x10aa1, "Capacity: count=%u, evictions=%u", (unsigned)_stats.free_capacity_count, (unsigned)_stats.eviction_count);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::verbose, 0x10d64, "IO: msyncs=%u, grown_bytes=%llu", (unsigned)_stats.msync_count, (unsigned long long)_stats.grown_byte_count);
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::verbose, 0x10d5f, "Extents: mapped=%u, huge_page_bytes=%zu", (unsigned)_stats.mapped_extent_count, _stats.huge_page_byte_count);
+    }
+
+
+    // --------------------------------------------------------------
+
+
+    inline void latency_histogram::record(std::uint64_t ns) noexcept {
+        std::size_t bucket = 0;
+        for (std::uint64_t n = ns >> 1; n != 0 && bucket < latency_bucket_count - 1; n >>= 1) {
+            bucket++;
+        }
+
+        buckets[bucket]++;
+        sample_count++;
+        total_ns += ns;
+
+        if (ns > max_ns) {
+            max_ns = ns;
+        }
+    }
+
+
+    inline std::uint64_t latency_histogram::percentile(double percent) const noexcept {
+        if (sample_count == 0) {
+            return 0;
+        }
+
+        double threshold = sample_count * percent / 100.0;
+        count_t cumulative_count = 0;
+
+        for (std::size_t bucket = 0; bucket < latency_bucket_count - 1; bucket++) {
+            cumulative_count += buckets[bucket];
+
+            if (cumulative_count >= threshold) {
+                std::uint64_t upper_bound = (static_cast<std::uint64_t>(1) << (bucket + 1)) - 1;
+                return upper_bound < max_ns ? upper_bound : max_ns;
+            }
+        }
+
+        return max_ns;
     }
 
 
@@ -584,10 +1618,92 @@ namespace abc { namespace vmem {
 
 
     inline pool_config::pool_config(const char* file_path, std::size_t max_mapped_page_count, bool sync_pages_on_unlock, bool sync_locked_pages_on_destroy)
+        : pool_config(file_path, max_mapped_page_count,
+                      (sync_pages_on_unlock ? pool_option::sync_pages_on_unlock : pool_option::none)
+                      | (sync_locked_pages_on_destroy ? pool_option::sync_locked_pages_on_destroy : pool_option::none)) {
+    }
+
+
+    inline pool_config::pool_config(const char* file_path, std::size_t max_mapped_page_count, pool_options_t options, std::size_t log_stats_interval)
         : file_path(file_path)
         , max_mapped_page_count(max_mapped_page_count)
-        , sync_pages_on_unlock(sync_pages_on_unlock)
-        , sync_locked_pages_on_destroy(sync_locked_pages_on_destroy) {
+        , sync_pages_on_unlock((options & pool_option::sync_pages_on_unlock) != 0)
+        , sync_locked_pages_on_destroy((options & pool_option::sync_locked_pages_on_destroy) != 0)
+        , verify_page_checksums((options & pool_option::verify_page_checksums) != 0)
+        , compress_cold_pages((options & pool_option::compress_cold_pages) != 0)
+        , use_huge_pages((options & pool_option::use_huge_pages) != 0)
+        , log_stats_interval(log_stats_interval)
+        , read_only((options & pool_option::read_only) != 0) {
+    }
+
+
+    inline std::string checksum_file_path(const std::string& file_path) {
+        return file_path + ".crc";
+    }
+
+
+    // --------------------------------------------------------------
+
+
+    inline std::string cold_file_path(const std::string& file_path) {
+        return file_path + ".cold";
+    }
+
+
+    inline off_t read_cold_page_index(int cold_fd, cold_page_index& index) {
+        off_t off = 0;
+
+        cold_page_header header;
+        while (::pread(cold_fd, &header, sizeof(header), off) == sizeof(header)) {
+            off_t data_off = off + sizeof(header);
+
+            if (header.data_size == 0) {
+                index.erase(header.page_pos);
+            }
+            else {
+                // Stop at an incomplete record.
+                std::uint8_t last_byte;
+                if (header.data_size > cold_page_max_data_size || ::pread(cold_fd, &last_byte, 1, data_off + header.data_size - 1) != 1) {
+                    break;
+                }
+
+                index[header.page_pos] = cold_page_slot{ data_off, header.data_size, 0 };
+            }
+
+            off = data_off + header.data_size;
+        }
+
+        return off;
+    }
+
+
+    inline bool read_cold_page(int cold_fd, const cold_page_slot& slot, void* page) noexcept {
+        std::uint8_t data[cold_page_max_data_size];
+
+        if (slot.data_size > cold_page_max_data_size || ::pread(cold_fd, data, slot.data_size, slot.data_off) != slot.data_size) {
+            return false;
+        }
+
+        return lz4_decompress(data, slot.data_size, page, page_size) == page_size;
+    }
+
+
+    inline bool is_page_hole(int fd, page_pos_t page_pos) noexcept {
+#if defined(SEEK_DATA)
+        off_t page_off = static_cast<off_t>(page_pos * page_size);
+        off_t data_off = ::lseek(fd, page_off, SEEK_DATA);
+
+        if (data_off < 0) {
+            // ENXIO means there is no data past page_off. Otherwise, assume the record is current, which is what it was before SEEK_DATA.
+            return true;
+        }
+
+        return data_off >= page_off + static_cast<off_t>(page_size);
+#else
+        (void)fd;
+        (void)page_pos;
+        return true;
+#endif
     }
 
 
@@ -0,0 +1,496 @@
+/*
+MIT License
+
+Copyright (c) 2018-2026 Zlatko Michailov 
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#pragma once
+
+#include <cstring>
+#include <utility>
+
+#include "../diag/diag_ready.h"
+#include "page.h"
+#include "i/priority_queue.i.h"
+
+
+namespace abc { namespace vmem {
+
+    template <typename T>
+    inline constexpr std::size_t priority_queue_page_capacity() noexcept {
+        // A page with capacity C has C + 1 child page positions.
+        return (page_size - sizeof(priority_queue_page_header) - sizeof(page_pos_t)) / (sizeof(page_pos_t) + sizeof(T));
+    }
+
+
+    // --------------------------------------------------------------
+
+
+    template <typename T, typename Less>
+    inline constexpr const char* priority_queue<T, Less>::origin() noexcept {
+        return "abc::vmem::priority_queue";
+    }
+
+
+    template <typename T, typename Less>
+    inline constexpr std::size_t priority_queue<T, Less>::page_capacity() noexcept {
+        return priority_queue_page_capacity<T>();
+    }
+
+
+    template <typename T, typename Less>
+    inline constexpr std::size_t priority_queue<T, Less>::page_child_count() noexcept {
+        return page_capacity() + 1;
+    }
+
+
+    template <typename T, typename Less>
+    inline constexpr bool priority_queue<T, Less>::is_uninit(const priority_queue_state* state) noexcept {
+        return
+            // nil
+            (
+                state != nullptr
+                && state->root_page_pos == page_pos_nil
+                && state->last_page_pos == page_pos_nil
+                && state->item_size == 0
+            )
+            ||
+            // zero
+            (
+                state != nullptr
+                && state->root_page_pos == 0
+                && state->last_page_pos == 0
+                && state->item_size == 0
+            );
+    }
+
+
+    template <typename T, typename Less>
+    inline priority_queue<T, Less>::priority_queue(priority_queue_state* state, vmem::pool* pool, diag::log_ostream* log)
+        : diag_base(abc::copy(origin()), log)
+        , _state(state)
+        , _pool(pool)
+        , _less() {
+
+        constexpr const char* suborigin = "priority_queue()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d81, "Begin: state=%p, pool=%p", state, pool);
+
+        diag_base::expect(suborigin, state != nullptr, 0x10d82, "state != nullptr");
+        diag_base::expect(suborigin, pool != nullptr, 0x10d83, "pool != nullptr");
+        diag_base::expect(suborigin, page_capacity() >= 2, 0x10d84, "page_capacity() >= 2");
+        diag_base::expect(suborigin, sizeof(heap_page) <= page_size, 0x10d85, "sizeof(heap_page) <= page_size");
+
+        if (is_uninit(state)) {
+            _state->root_page_pos = page_pos_nil;
+            _state->last_page_pos = page_pos_nil;
+            _state->page_count = 0;
+            _state->total_item_count = 0;
+            _state->item_size = sizeof(T);
+        }
+
+        diag_base::ensure(suborigin, _state->item_size == sizeof(T), 0x10d86, "_state->item_size == sizeof(T)");
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d87, "End: root_page_pos=0x%llx, page_count=%zu, total_item_count=%zu",
+            (unsigned long long)_state->root_page_pos, _state->page_count, _state->total_item_count);
+    }
+
+
+    template <typename T, typename Less>
+    inline bool priority_queue<T, Less>::empty() const noexcept {
+        return _state->total_item_count == 0;
+    }
+
+
+    template <typename T, typename Less>
+    inline std::size_t priority_queue<T, Less>::size() const noexcept {
+        return _state->total_item_count;
+    }
+
+
+    template <typename T, typename Less>
+    inline T priority_queue<T, Less>::top() const {
+        constexpr const char* suborigin = "top()";
+        diag_base::expect(suborigin, !empty(), 0x10d88, "!empty()");
+
+        vmem::page page(_pool, _state->root_page_pos, diag_base::log());
+        diag_base::expect(suborigin, page.ptr() != nullptr, 0x10d89, "page.ptr() != nullptr");
+
+        const heap_page* root_page = reinterpret_cast<const heap_page*>(page.ptr());
+
+        return root_page->items[0];
+    }
+
+
+    template <typename T, typename Less>
+    inline void priority_queue<T, Less>::push(const_reference item) {
+        constexpr const char* suborigin = "push()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d8a, "Begin: total_item_count=%zu", _state->total_item_count);
+
+        vmem::page page(nullptr);
+        heap_page* last_page = nullptr;
+
+        if (_state->last_page_pos != page_pos_nil) {
+            page = vmem::page(_pool, _state->last_page_pos, diag_base::log());
+            diag_base::expect(suborigin, page.ptr() != nullptr, 0x10d8b, "page.ptr() != nullptr");
+
+            last_page = reinterpret_cast<heap_page*>(page.ptr());
+        }
+
+        if (last_page == nullptr || last_page->item_count == page_capacity()) {
+            last_page = push_page(page);
+        }
+
+        item_pos_t item_pos = last_page->item_count++;
+        std::memmove(&last_page->items[item_pos], &item, sizeof(T));
+        _state->total_item_count++;
+
+        page_pos_t page_pos = page.pos();
+        page = vmem::page(nullptr);
+
+        sift_up(page_pos, item_pos);
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d8c, "End: total_item_count=%zu, page_count=%zu", _state->total_item_count, _state->page_count);
+    }
+
+
+    template <typename T, typename Less>
+    inline void priority_queue<T, Less>::pop() {
+        constexpr const char* suborigin = "pop()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d8d, "Begin: total_item_count=%zu", _state->total_item_count);
+
+        diag_base::expect(suborigin, !empty(), 0x10d8e, "!empty()");
+
+        // Take the last item out.
+        T item;
+        {
+            vmem::page page(_pool, _state->last_page_pos, diag_base::log());
+            diag_base::expect(suborigin, page.ptr() != nullptr, 0x10d8f, "page.ptr() != nullptr");
+
+            heap_page* last_page = reinterpret_cast<heap_page*>(page.ptr());
+            diag_base::expect(suborigin, last_page->item_count > 0, 0x10d90, "last_page->item_count > 0");
+
+            std::memmove(&item, &last_page->items[--last_page->item_count], sizeof(T));
+            _state->total_item_count--;
+
+            if (last_page->item_count == 0) {
+                pop_page(page);
+            }
+        }
+
+        // Put the last item on top, and restore the heap.
+        if (!empty()) {
+            {
+                vmem::page page(_pool, _state->root_page_pos, diag_base::log());
+                diag_base::expect(suborigin, page.ptr() != nullptr, 0x10d91, "page.ptr() != nullptr");
+
+                heap_page* root_page = reinterpret_cast<heap_page*>(page.ptr());
+                std::memmove(&root_page->items[0], &item, sizeof(T));
+            }
+
+            sift_down(_state->root_page_pos, 0);
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d92, "End: total_item_count=%zu, page_count=%zu", _state->total_item_count, _state->page_count);
+    }
+
+
+    template <typename T, typename Less>
+    inline void priority_queue<T, Less>::clear() {
+        constexpr const char* suborigin = "clear()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d93, "Begin: page_count=%zu", _state->page_count);
+
+        // Free the pages bottom-up, so that no parent is freed before its children have been located.
+        for (std::size_t index = _state->page_count; index-- > 0; ) {
+            vmem::page page(_pool, page_pos_at(index), diag_base::log());
+            page.free();
+        }
+
+        _state->root_page_pos = page_pos_nil;
+        _state->last_page_pos = page_pos_nil;
+        _state->page_count = 0;
+        _state->total_item_count = 0;
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d94, "End:");
+    }
+
+
+    // ..............................................................
+
+
+    template <typename T, typename Less>
+    inline typename priority_queue<T, Less>::heap_page* priority_queue<T, Less>::push_page(vmem::page& page) {
+        constexpr const char* suborigin = "push_page()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d95, "Begin: page_count=%zu", _state->page_count);
+
+        // Locate the parent before allocating, to keep the number of locked pages low.
+        page_pos_t parent_page_pos = page_pos_nil;
+        std::size_t parent_slot = 0;
+
+        if (_state->page_count > 0) {
+            parent_page_pos = page_pos_at((_state->page_count - 1) / page_child_count());
+            parent_slot = (_state->page_count - 1) % page_child_count();
+        }
+
+        page = vmem::page(nullptr);
+        page = vmem::page(_pool, diag_base::log());
+        diag_base::expect(suborigin, page.pos() != page_pos_nil, 0x10d96, "page.pos() != page_pos_nil");
+        diag_base::expect(suborigin, page.ptr() != nullptr, 0x10d97, "page.ptr() != nullptr");
+
+        std::memset(page.ptr(), 0, page_size);
+
+        heap_page* new_page = reinterpret_cast<heap_page*>(page.ptr());
+        new_page->parent_page_pos = page_pos_nil;
+        for (std::size_t slot = 0; slot < page_child_count(); slot++) {
+            new_page->child_page_pos[slot] = page_pos_nil;
+        }
+
+        if (parent_page_pos == page_pos_nil) {
+            _state->root_page_pos = page.pos();
+        }
+        else {
+            vmem::page parent_page(_pool, parent_page_pos, diag_base::log());
+            diag_base::expect(suborigin, parent_page.ptr() != nullptr, 0x10d98, "parent_page.ptr() != nullptr");
+
+            heap_page* parent = reinterpret_cast<heap_page*>(parent_page.ptr());
+            diag_base::expect(suborigin, parent->child_page_pos[parent_slot] == page_pos_nil, 0x10d99, "parent->child_page_pos[parent_slot] == page_pos_nil");
+
+            parent->child_page_pos[parent_slot] = page.pos();
+            new_page->parent_page_pos = parent_page_pos;
+            new_page->parent_slot = static_cast<item_pos_t>(parent_slot);
+        }
+
+        _state->last_page_pos = page.pos();
+        _state->page_count++;
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d9a, "End: page_pos=0x%llx, page_count=%zu", (unsigned long long)page.pos(), _state->page_count);
+
+        return new_page;
+    }
+
+
+    template <typename T, typename Less>
+    inline void priority_queue<T, Less>::pop_page(vmem::page& page) {
+        constexpr const char* suborigin = "pop_page()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d9b, "Begin: page_pos=0x%llx, page_count=%zu", (unsigned long long)page.pos(), _state->page_count);
+
+        const heap_page* last_page = reinterpret_cast<const heap_page*>(page.ptr());
+        diag_base::expect(suborigin, page.pos() == _state->last_page_pos, 0x10d9c, "page.pos() == _state->last_page_pos");
+        diag_base::expect(suborigin, last_page->item_count == 0, 0x10d9d, "last_page->item_count == 0");
+
+        if (last_page->parent_page_pos != page_pos_nil) {
+            vmem::page parent_page(_pool, last_page->parent_page_pos, diag_base::log());
+            diag_base::expect(suborigin, parent_page.ptr() != nullptr, 0x10d9e, "parent_page.ptr() != nullptr");
+
+            heap_page* parent = reinterpret_cast<heap_page*>(parent_page.ptr());
+            parent->child_page_pos[last_page->parent_slot] = page_pos_nil;
+        }
+
+        page.free();
+        _state->page_count--;
+
+        if (_state->page_count == 0) {
+            _state->root_page_pos = page_pos_nil;
+            _state->last_page_pos = page_pos_nil;
+        }
+        else {
+            _state->last_page_pos = page_pos_at(_state->page_count - 1);
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d9f, "End: last_page_pos=0x%llx, page_count=%zu", (unsigned long long)_state->last_page_pos, _state->page_count);
+    }
+
+
+    template <typename T, typename Less>
+    inline page_pos_t priority_queue<T, Less>::page_pos_at(std::size_t index) const {
+        constexpr const char* suborigin = "page_pos_at()";
+        diag_base::expect(suborigin, index < _state->page_count, 0x10da0, "index < _state->page_count");
+
+        // Collect the slots from the page up to the root.
+        constexpr std::size_t max_depth = sizeof(std::size_t) * 8;
+        std::size_t slots[max_depth];
+        std::size_t depth = 0;
+
+        for (; index > 0; index = (index - 1) / page_child_count()) {
+            slots[depth++] = (index - 1) % page_child_count();
+        }
+
+        // Walk down from the root.
+        page_pos_t page_pos = _state->root_page_pos;
+
+        while (depth-- > 0) {
+            vmem::page page(_pool, page_pos, diag_base::log());
+            diag_base::expect(suborigin, page.ptr() != nullptr, 0x10da1, "page.ptr() != nullptr");
+
+            const heap_page* hpage = reinterpret_cast<const heap_page*>(page.ptr());
+            page_pos = hpage->child_page_pos[slots[depth]];
+            diag_base::ensure(suborigin, page_pos != page_pos_nil, 0x10da2, "page_pos != page_pos_nil");
+        }
+
+        return page_pos;
+    }
+
+
+    template <typename T, typename Less>
+    inline void priority_queue<T, Less>::sift_up(page_pos_t page_pos, std::size_t item_pos) {
+        constexpr const char* suborigin = "sift_up()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10da3, "Begin: page_pos=0x%llx, item_pos=%zu", (unsigned long long)page_pos, item_pos);
+
+        vmem::page page(_pool, page_pos, diag_base::log());
+        diag_base::expect(suborigin, page.ptr() != nullptr, 0x10da4, "page.ptr() != nullptr");
+
+        heap_page* hpage = reinterpret_cast<heap_page*>(page.ptr());
+
+        for (;;) {
+            if (item_pos > 0) {
+                // Within the page.
+                std::size_t parent_item_pos = (item_pos - 1) / 2;
+
+                if (!_less(hpage->items[item_pos], hpage->items[parent_item_pos])) {
+                    break;
+                }
+
+                std::swap(hpage->items[item_pos], hpage->items[parent_item_pos]);
+                item_pos = parent_item_pos;
+            }
+            else {
+                // Across to the parent page - the page root is a virtual child of a bottom item on the parent page.
+                if (hpage->parent_page_pos == page_pos_nil) {
+                    break;
+                }
+
+                vmem::page parent_page(_pool, hpage->parent_page_pos, diag_base::log());
+                diag_base::expect(suborigin, parent_page.ptr() != nullptr, 0x10da5, "parent_page.ptr() != nullptr");
+
+                heap_page* parent = reinterpret_cast<heap_page*>(parent_page.ptr());
+                std::size_t parent_item_pos = (hpage->parent_slot + page_capacity() - 1) / 2;
+
+                if (!_less(hpage->items[0], parent->items[parent_item_pos])) {
+                    break;
+                }
+
+                std::swap(hpage->items[0], parent->items[parent_item_pos]);
+
+                page = std::move(parent_page);
+                hpage = parent;
+                item_pos = parent_item_pos;
+            }
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10da6, "End: page_pos=0x%llx, item_pos=%zu", (unsigned long long)page.pos(), item_pos);
+    }
+
+
+    template <typename T, typename Less>
+    inline void priority_queue<T, Less>::sift_down(page_pos_t page_pos, std::size_t item_pos) {
+        constexpr const char* suborigin = "sift_down()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10da7, "Begin: page_pos=0x%llx, item_pos=%zu", (unsigned long long)page_pos, item_pos);
+
+        vmem::page page(_pool, page_pos, diag_base::log());
+        diag_base::expect(suborigin, page.ptr() != nullptr, 0x10da8, "page.ptr() != nullptr");
+
+        heap_page* hpage = reinterpret_cast<heap_page*>(page.ptr());
+
+        for (;;) {
+            std::size_t child_item_pos = 2 * item_pos + 1;
+
+            if (child_item_pos < page_capacity()) {
+                // Within the page.
+                if (child_item_pos >= hpage->item_count) {
+                    break;
+                }
+
+                if (child_item_pos + 1 < hpage->item_count && _less(hpage->items[child_item_pos + 1], hpage->items[child_item_pos])) {
+                    child_item_pos++;
+                }
+
+                // When the page capacity is even, the last in-page child has a sibling - the root of the child page in slot 0.
+                if (2 * item_pos + 2 == page_capacity() && hpage->child_page_pos[0] != page_pos_nil) {
+                    vmem::page child_page(_pool, hpage->child_page_pos[0], diag_base::log());
+                    diag_base::expect(suborigin, child_page.ptr() != nullptr, 0x10f54, "child_page.ptr() != nullptr");
+
+                    heap_page* child = reinterpret_cast<heap_page*>(child_page.ptr());
+                    if (_less(child->items[0], hpage->items[child_item_pos])) {
+                        if (!_less(child->items[0], hpage->items[item_pos])) {
+                            break;
+                        }
+
+                        std::swap(hpage->items[item_pos], child->items[0]);
+
+                        page = std::move(child_page);
+                        hpage = child;
+                        item_pos = 0;
+                        continue;
+                    }
+                }
+
+                if (!_less(hpage->items[child_item_pos], hpage->items[item_pos])) {
+                    break;
+                }
+
+                std::swap(hpage->items[item_pos], hpage->items[child_item_pos]);
+                item_pos = child_item_pos;
+            }
+            else {
+                // Across to a child page - pick the child page with the lesser root.
+                std::size_t slot = child_item_pos - page_capacity();
+                page_pos_t child_page_pos = page_pos_nil;
+                T child_item { };
+
+                for (std::size_t s = slot; s < slot + 2 && s < page_child_count(); s++) {
+                    if (hpage->child_page_pos[s] == page_pos_nil) {
+                        continue;
+                    }
+
+                    vmem::page child_page(_pool, hpage->child_page_pos[s], diag_base::log());
+                    diag_base::expect(suborigin, child_page.ptr() != nullptr, 0x10da9, "child_page.ptr() != nullptr");
+
+                    const heap_page* child = reinterpret_cast<const heap_page*>(child_page.ptr());
+                    if (child_page_pos == page_pos_nil || _less(child->items[0], child_item)) {
+                        child_page_pos = child_page.pos();
+                        std::memmove(&child_item, &child->items[0], sizeof(T));
+                    }
+                }
+
+                if (child_page_pos == page_pos_nil || !_less(child_item, hpage->items[item_pos])) {
+                    break;
+                }
+
+                vmem::page child_page(_pool, child_page_pos, diag_base::log());
+                diag_base::expect(suborigin, child_page.ptr() != nullptr, 0x10daa, "child_page.ptr() != nullptr");
+
+                heap_page* child = reinterpret_cast<heap_page*>(child_page.ptr());
+                std::swap(hpage->items[item_pos], child->items[0]);
+
+                page = std::move(child_page);
+                hpage = child;
+                item_pos = 0;
+            }
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10dab, "End: page_pos=0x%llx, item_pos=%zu", (unsigned long long)page.pos(), item_pos);
+    }
+
+
+    // --------------------------------------------------------------
+
+} }
@@ -46,9 +46,9 @@ namespace abc { namespace vmem {
         , _byte_pos(byte_pos) {
 
         constexpr const char* suborigin = "ptr()";
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10aa2, "Begin: pool=%p, page_pos=0x%llu, byte_pos=%u, page_ptr=%p", _page.pool(), (unsigned long long)_page.pos(), _byte_pos, _page.ptr());
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10aa2, "Begin: pool=%p, page_pos=0x%llu, byte_pos=%u, page_ptr=%p", _page.pool(), (unsigned long long)_page.pos(), _byte_pos, _page.ptr());
 
-        diag_base::put_any(suborigin, diag::severity::callstack, 0x10aa3, "End:");
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10aa3, "End:");
     }
 
 
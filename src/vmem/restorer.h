@@ -0,0 +1,118 @@
+/*
+MIT License
+
+Copyright (c) 2018-2026 Zlatko Michailov 
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#pragma once
+
+#include <cstring>
+#include <vector>
+#include <sys/types.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "../root/util.h"
+#include "../diag/diag_ready.h"
+#include "pool.h"
+#include "i/restorer.i.h"
+
+
+namespace abc { namespace vmem {
+
+    inline constexpr const char* restorer::origin() noexcept {
+        return "abc::vmem::restorer";
+    }
+
+
+    inline restorer::restorer(const char* file_path, diag::log_ostream* log)
+        : diag_base(abc::copy(origin()), log)
+        , _file_path(file_path != nullptr ? file_path : "") {
+
+        constexpr const char* suborigin = "restorer()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e1d, "Begin: file_path='%s'", _file_path.c_str());
+
+        diag_base::expect(suborigin, !_file_path.empty(), 0x10e1e, "!_file_path.empty()");
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e1f, "End:");
+    }
+
+
+    inline std::size_t restorer::apply_increment(std::istream& stream) {
+        constexpr const char* suborigin = "apply_increment()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e20, "Begin: file_path='%s'", _file_path.c_str());
+
+        // The header has const members, so it is read into raw memory.
+        std::uint8_t header_buffer[sizeof(backup_increment_header)];
+        stream.read(reinterpret_cast<char*>(header_buffer), sizeof(header_buffer));
+        diag_base::expect(suborigin, stream.good(), 0x10e21, "stream.good()");
+
+        const backup_increment_header* header = reinterpret_cast<const backup_increment_header*>(header_buffer);
+        const backup_increment_header expected_header;
+        diag_base::expect(suborigin, std::memcmp(header->signature, expected_header.signature, sizeof(expected_header.signature)) == 0, 0x10e22, "signature");
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10e23, "page_count=%llu, record_count=%llu", (unsigned long long)header->page_count, (unsigned long long)header->record_count);
+
+        int fd = ::open(_file_path.c_str(), O_RDWR);
+        diag_base::ensure(suborigin, fd >= 0, 0x10e24, "fd >= 0, errno=%d", errno);
+
+        std::size_t written_count = 0;
+
+        try {
+            int tr = ::ftruncate(fd, static_cast<off_t>(header->page_count * page_size));
+            diag_base::ensure(suborigin, tr == 0, 0x10e25, "tr == 0, errno=%d", errno);
+
+            std::vector<std::uint8_t> page_buffer(page_size);
+
+            for (page_pos_t i = 0; i < header->record_count; i++) {
+                page_pos_t page_pos = page_pos_nil;
+                stream.read(reinterpret_cast<char*>(&page_pos), sizeof(page_pos));
+                stream.read(reinterpret_cast<char*>(page_buffer.data()), page_size);
+                diag_base::expect(suborigin, stream.good(), 0x10e26, "stream.good(), record=%llu", (unsigned long long)i);
+                diag_base::expect(suborigin, page_pos < header->page_count, 0x10e27, "page_pos < header->page_count, page_pos=0x%llx", (unsigned long long)page_pos);
+
+                ssize_t wb = ::pwrite(fd, page_buffer.data(), page_size, static_cast<off_t>(page_pos * page_size));
+                diag_base::ensure(suborigin, wb == page_size, 0x10e28, "wb == page_size, wb=%ld, errno=%d", (long)wb, errno);
+
+                written_count++;
+            }
+
+            int sn = ::fdatasync(fd);
+            diag_base::ensure(suborigin, sn == 0, 0x10e29, "sn == 0, errno=%d", errno);
+        }
+        catch (...) {
+            ::close(fd);
+            throw;
+        }
+
+        ::close(fd);
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10e2a, "End: written_count=%zu", written_count);
+
+        return written_count;
+    }
+
+
+    // --------------------------------------------------------------
+
+} }
@@ -0,0 +1,351 @@
+/*
+MIT License
+
+Copyright (c) 2018-2026 Zlatko Michailov 
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#pragma once
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "../root/util.h"
+#include "../root/crc32c.h"
+#include "../diag/diag_ready.h"
+#include "pool.h"
+#include "i/scrubber.i.h"
+
+
+namespace abc { namespace vmem {
+
+    inline constexpr const char* scrubber::origin() noexcept {
+        return "abc::vmem::scrubber";
+    }
+
+
+    inline scrubber::scrubber(const char* file_path, std::chrono::microseconds page_pause, std::chrono::milliseconds pass_pause, diag::log_ostream* log)
+        : diag_base(abc::copy(origin()), log)
+        , _file_path(file_path)
+        , _page_pause(page_pause)
+        , _pass_pause(pass_pause)
+        , _thread()
+        , _stop_mutex()
+        , _stop_condition()
+        , _stop_requested(false)
+        , _cold_fd(-1)
+        , _cold_index{ }
+        , _linked_state_locations() {
+
+        constexpr const char* suborigin = "scrubber()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d06, "Begin: file_path='%s'", _file_path.c_str());
+
+        diag_base::expect(suborigin, !_file_path.empty(), 0x10d07, "!_file_path.empty()");
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d08, "End:");
+    }
+
+
+    inline scrubber::~scrubber() noexcept {
+        stop();
+    }
+
+
+    inline void scrubber::add_linked_state(page_pos_t page_pos, item_pos_t item_pos) {
+        constexpr const char* suborigin = "add_linked_state()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f5a, "Begin: page_pos=0x%llx, item_pos=0x%x", (unsigned long long)page_pos, (unsigned)item_pos);
+
+        diag_base::expect(suborigin, !_thread.joinable(), 0x10f5b, "!_thread.joinable()");
+        diag_base::expect(suborigin, item_pos <= page_size - sizeof(linked_state), 0x10f5c, "item_pos <= page_size - sizeof(linked_state)");
+
+        _linked_state_locations.emplace_back(page_pos, item_pos);
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f5d, "End:");
+    }
+
+
+    inline std::size_t scrubber::scrub() {
+        constexpr const char* suborigin = "scrub()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d09, "Begin: file_path='%s'", _file_path.c_str());
+
+        std::size_t problem_count = 0;
+
+        int fd = ::open(_file_path.c_str(), O_RDONLY);
+        diag_base::ensure(suborigin, fd >= 0, 0x10d0a, "fd >= 0, errno=%d", errno);
+
+        page_pos_t page_count = static_cast<page_pos_t>(::lseek(fd, 0, SEEK_END)) / page_size;
+
+        // Cold pages are read from the cold page side file.
+        _cold_index.clear();
+        _cold_fd = ::open(cold_file_path(_file_path).c_str(), O_RDONLY);
+        if (_cold_fd >= 0) {
+            read_cold_page_index(_cold_fd, _cold_index);
+        }
+
+        std::uint8_t buffer[page_size];
+        if (page_count < page_pos_start + 1 || !read_page(fd, page_pos_root, buffer)) {
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::warning, 0x10d0b, "Pool file too short: page_count=%llu", (unsigned long long)page_count);
+            problem_count++;
+        }
+        else {
+            const vmem::root_page& root_page = *reinterpret_cast<const vmem::root_page*>(buffer);
+
+            problem_count += scrub_root_page(root_page);
+            problem_count += scrub_page_checksums(fd, page_count);
+            problem_count += scrub_linked(fd, page_count, root_page.free_pages);
+            problem_count += scrub_linked_states(fd, page_count);
+        }
+
+        if (_cold_fd >= 0) {
+            ::close(_cold_fd);
+            _cold_fd = -1;
+        }
+
+        ::close(fd);
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::important, 0x10d0c, "Scrubbed: page_count=%llu, problem_count=%zu", (unsigned long long)page_count, problem_count);
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d0d, "End: problem_count=%zu", problem_count);
+
+        return problem_count;
+    }
+
+
+    inline std::size_t scrubber::scrub_root_page(const root_page& root_page) {
+        constexpr const char* suborigin = "scrub_root_page()";
+
+        std::size_t problem_count = 0;
+
+        vmem::root_page root_page_layout;
+        if (root_page.version != root_page_layout.version
+            || std::strncmp(root_page.signature, root_page_layout.signature, sizeof(root_page_layout.signature)) != 0
+            || root_page.page_size != page_size) {
+
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::warning, 0x10d0e, "Corrupt root page: version=%u, page_size=%u", (unsigned)root_page.version, (unsigned)root_page.page_size);
+            problem_count++;
+        }
+
+        return problem_count;
+    }
+
+
+    inline std::size_t scrubber::scrub_page_checksums(int fd, page_pos_t page_count) {
+        constexpr const char* suborigin = "scrub_page_checksums()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d0f, "Begin: page_count=%llu", (unsigned long long)page_count);
+
+        std::size_t problem_count = 0;
+
+        int crc_fd = ::open(checksum_file_path(_file_path).c_str(), O_RDONLY);
+        if (crc_fd < 0) {
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::optional, 0x10d10, "No checksum file.");
+        }
+        else {
+            std::uint8_t buffer[page_size];
+
+            for (page_pos_t page_pos = 0; page_pos < page_count && !wait_for_stop(_page_pause); page_pos++) {
+                std::uint32_t stored_checksum = 0;
+                ssize_t rb = ::pread(crc_fd, &stored_checksum, sizeof(stored_checksum), static_cast<off_t>(page_pos * sizeof(stored_checksum)));
+
+                // 0 means the checksum is unknown, e.g. the page is currently mapped.
+                if (rb != sizeof(stored_checksum) || stored_checksum == 0) {
+                    continue;
+                }
+
+                if (!read_page(fd, page_pos, buffer)) {
+                    ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::warning, 0x10d3e, "Unreadable page: page_pos=0x%llx", (unsigned long long)page_pos);
+                    problem_count++;
+                    continue;
+                }
+
+                std::uint32_t actual_checksum = crc32c(buffer, page_size);
+                if (actual_checksum != stored_checksum) {
+                    // The page may have been mapped and changed in the meantime. Re-read the stored checksum.
+                    std::uint32_t stored_checksum2 = 0;
+                    rb = ::pread(crc_fd, &stored_checksum2, sizeof(stored_checksum2), static_cast<off_t>(page_pos * sizeof(stored_checksum2)));
+
+                    if (rb == sizeof(stored_checksum2) && stored_checksum2 == stored_checksum) {
+                        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::warning, 0x10d11, "Corrupt page: page_pos=0x%llx, stored_checksum=0x%8.8x, actual_checksum=0x%8.8x",
+                                (unsigned long long)page_pos, (unsigned)stored_checksum, (unsigned)actual_checksum);
+                        problem_count++;
+                    }
+                }
+            }
+
+            ::close(crc_fd);
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d12, "End: problem_count=%zu", problem_count);
+
+        return problem_count;
+    }
+
+
+    inline std::size_t scrubber::scrub_linked_states(int fd, page_pos_t page_count) {
+        constexpr const char* suborigin = "scrub_linked_states()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f5e, "Begin: count=%zu", _linked_state_locations.size());
+
+        std::size_t problem_count = 0;
+        std::uint8_t buffer[page_size];
+
+        for (const std::pair<page_pos_t, item_pos_t>& location : _linked_state_locations) {
+            if (location.first >= page_count || !read_page(fd, location.first, buffer)) {
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::warning, 0x10f5f, "Unreadable linked state: page_pos=0x%llx, item_pos=0x%x", (unsigned long long)location.first, (unsigned)location.second);
+                problem_count++;
+                continue;
+            }
+
+            linked_state linked_state;
+            std::memcpy(&linked_state, buffer + location.second, sizeof(linked_state));
+
+            problem_count += scrub_linked(fd, page_count, linked_state);
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f60, "End: problem_count=%zu", problem_count);
+
+        return problem_count;
+    }
+
+
+    inline std::size_t scrubber::scrub_linked(int fd, page_pos_t page_count, const linked_state& linked_state) {
+        constexpr const char* suborigin = "scrub_linked()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d13, "Begin: front_page_pos=0x%llx", (unsigned long long)linked_state.front_page_pos);
+
+        std::size_t problem_count = 0;
+        std::uint8_t buffer[page_size];
+
+        page_pos_t prev_page_pos = page_pos_nil;
+        page_pos_t page_pos = linked_state.front_page_pos;
+        page_pos_t linked_page_count = 0;
+
+        while (page_pos != page_pos_nil && problem_count == 0 && !wait_for_stop(_page_pause)) {
+            if (page_pos >= page_count || pool::is_required_page(page_pos)) {
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::warning, 0x10d14, "Linked page out of range: page_pos=0x%llx, prev_page_pos=0x%llx", (unsigned long long)page_pos, (unsigned long long)prev_page_pos);
+                problem_count++;
+            }
+            else if (++linked_page_count > page_count) {
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::warning, 0x10d15, "Linked page chain has a cycle: page_pos=0x%llx", (unsigned long long)page_pos);
+                problem_count++;
+            }
+            else if (read_page(fd, page_pos, buffer)) {
+                const vmem::linked_page* linked_page = reinterpret_cast<const vmem::linked_page*>(buffer);
+
+                if (linked_page->page_pos != page_pos || linked_page->prev_page_pos != prev_page_pos) {
+                    ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::warning, 0x10d16, "Corrupt linked page: page_pos=0x%llx, linked_page->page_pos=0x%llx, linked_page->prev_page_pos=0x%llx, prev_page_pos=0x%llx",
+                            (unsigned long long)page_pos, (unsigned long long)linked_page->page_pos, (unsigned long long)linked_page->prev_page_pos, (unsigned long long)prev_page_pos);
+                    problem_count++;
+                }
+
+                prev_page_pos = page_pos;
+                page_pos = linked_page->next_page_pos;
+            }
+            else {
+                ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::warning, 0x10d3f, "Unreadable linked page: page_pos=0x%llx", (unsigned long long)page_pos);
+                problem_count++;
+            }
+        }
+
+        if (problem_count == 0 && page_pos == page_pos_nil && prev_page_pos != linked_state.back_page_pos) {
+            ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::warning, 0x10d17, "Corrupt linked page chain: back_page_pos=0x%llx, last_page_pos=0x%llx",
+                    (unsigned long long)linked_state.back_page_pos, (unsigned long long)prev_page_pos);
+            problem_count++;
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d18, "End: linked_page_count=%llu, problem_count=%zu", (unsigned long long)linked_page_count, problem_count);
+
+        return problem_count;
+    }
+
+
+    inline bool scrubber::read_page(int fd, page_pos_t page_pos, void* buffer) const noexcept {
+        cold_page_index::const_iterator slot_itr = _cold_index.find(page_pos);
+        if (slot_itr != _cold_index.end() && is_page_hole(fd, page_pos)) {
+            return read_cold_page(_cold_fd, slot_itr->second, buffer);
+        }
+
+        ssize_t rb = ::pread(fd, buffer, page_size, static_cast<off_t>(page_pos * page_size));
+
+        return rb == static_cast<ssize_t>(page_size);
+    }
+
+
+    // ..............................................................
+
+
+    inline void scrubber::start() {
+        constexpr const char* suborigin = "start()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d19, "Begin:");
+
+        diag_base::expect(suborigin, !_thread.joinable(), 0x10d1a, "!_thread.joinable()");
+
+        {
+            std::lock_guard<std::mutex> lock(_stop_mutex);
+            _stop_requested = false;
+        }
+
+        _thread = std::thread(thread_func, this);
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10d1b, "End:");
+    }
+
+
+    inline void scrubber::stop() noexcept {
+        if (_thread.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(_stop_mutex);
+                _stop_requested = true;
+            }
+
+            _stop_condition.notify_all();
+            _thread.join();
+        }
+    }
+
+
+    template <typename Duration>
+    inline bool scrubber::wait_for_stop(Duration duration) {
+        std::unique_lock<std::mutex> lock(_stop_mutex);
+
+        if (duration.count() > 0) {
+            _stop_condition.wait_for(lock, duration, [this]() { return _stop_requested; });
+        }
+
+        return _stop_requested;
+    }
+
+
+    inline void scrubber::thread_func(scrubber* this_ptr) noexcept {
+        constexpr const char* suborigin = "thread_func()";
+
+        do {
+            try {
+                this_ptr->scrub();
+            }
+            catch (const std::exception& ex) {
+                ABC_DIAG_PUT_ANY(this_ptr->put_any, suborigin, diag::severity::warning, 0x10d1c, "Scrub failed: %s", ex.what());
+            }
+        }
+        while (!this_ptr->wait_for_stop(this_ptr->_pass_pause));
+    }
+
+} }
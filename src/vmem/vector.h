@@ -0,0 +1,333 @@
+/*
+MIT License
+
+Copyright (c) 2018-2026 Zlatko Michailov 
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#pragma once
+
+#include "container.h"
+#include "list.h"
+#include "i/vector.i.h"
+
+
+namespace abc { namespace vmem {
+
+    template <typename T>
+    inline vector<T>::vector(vector_state* state, vmem::pool* pool, diag::log_ostream* log)
+        : base(&state->items, balance_insert, balance_erase, pool, log)
+        , _state(state)
+        , _pool(pool)
+        , _page_levels(&state->page_levels, pool, log) {
+    }
+
+
+    template <typename T>
+    inline void vector<T>::push_back(const_reference item) {
+        constexpr const char* suborigin = "push_back()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f8a, "Begin: size=%zu", base::size());
+
+        page_pos_t back_page_pos = _state->items.back_page_pos;
+
+        base::push_back(item);
+
+        if (_state->items.back_page_pos != back_page_pos) {
+            // A new back page has been linked. All the pages before it are full.
+            page_pos_t new_page_pos = _state->items.back_page_pos;
+
+            {
+                vmem::page page(_pool, new_page_pos, diag_base::log());
+                diag_base::expect(suborigin, page.ptr() != nullptr, 0x10f8b, "page.ptr() != nullptr");
+
+                reinterpret_cast<vector_page*>(page.ptr())->header.page_index = (base::size() - 1) / page_capacity();
+            }
+
+            if (back_page_pos != page_pos_nil) {
+                push_back_page(new_page_pos);
+            }
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f8c, "End: size=%zu, page_level_count=%zu", base::size(), _page_levels.size());
+    }
+
+
+    template <typename T>
+    inline void vector<T>::pop_back() {
+        constexpr const char* suborigin = "pop_back()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f8d, "Begin: size=%zu", base::size());
+
+        page_pos_t back_page_pos = _state->items.back_page_pos;
+
+        base::pop_back();
+
+        if (_state->items.back_page_pos != back_page_pos && !_page_levels.empty()) {
+            pop_back_page();
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f8e, "End: size=%zu, page_level_count=%zu", base::size(), _page_levels.size());
+    }
+
+
+    template <typename T>
+    inline void vector<T>::clear() {
+        for (page_level_stack_iterator level_itr = _page_levels.begin(); level_itr != _page_levels.end(); level_itr++) {
+            // IMPORTANT: Save the ptr instance to keep the page locked.
+            vmem::ptr<stack_state> level_state_ptr = level_itr.operator->();
+
+            page_level level(level_state_ptr.operator->(), _pool, diag_base::log());
+            level.clear();
+        }
+
+        _page_levels.clear();
+        base::clear();
+    }
+
+
+    // ..............................................................
+
+
+    template <typename T>
+    inline typename vector<T>::reference vector<T>::operator [](std::size_t index) {
+        return *iterator_at(index);
+    }
+
+
+    template <typename T>
+    inline typename vector<T>::const_reference vector<T>::operator [](std::size_t index) const {
+        return *iterator_at(index);
+    }
+
+
+    template <typename T>
+    inline typename vector<T>::iterator vector<T>::iterator_at(std::size_t index) const {
+        constexpr const char* suborigin = "iterator_at()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f8f, "Begin: index=%zu, size=%zu", index, base::size());
+
+        diag_base::expect(suborigin, index <= base::size(), 0x10f90, "index <= size()");
+
+        iterator result(this, _state->items.back_page_pos, item_pos_nil, iterator_edge::end, diag_base::log());
+
+        if (index < base::size()) {
+            page_pos_t page_pos = page_pos_at(index / page_capacity());
+            result = iterator(this, page_pos, static_cast<item_pos_t>(index % page_capacity()), iterator_edge::none, diag_base::log());
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f91, "End: result.page_pos=0x%llx, result.item_pos=0x%x, result.edge=%u",
+                (unsigned long long)result.page_pos(), (unsigned)result.item_pos(), result.edge());
+
+        return result;
+    }
+
+
+    template <typename T>
+    inline std::size_t vector<T>::index_of(const_iterator itr) const {
+        constexpr const char* suborigin = "index_of()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f92, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x, itr.edge=%u",
+                (unsigned long long)itr.page_pos(), (unsigned)itr.item_pos(), itr.edge());
+
+        diag_base::expect(suborigin, itr.is_valid(this), 0x10f93, "itr.is_valid(this)");
+        diag_base::expect(suborigin, itr.is_end() || itr.can_deref(), 0x10f94, "itr.is_end() || itr.can_deref()");
+
+        std::size_t result = base::size();
+
+        if (!itr.is_end()) {
+            vmem::page page(_pool, itr.page_pos(), diag_base::log());
+            diag_base::expect(suborigin, page.ptr() != nullptr, 0x10f95, "page.ptr() != nullptr");
+
+            result = reinterpret_cast<const vector_page*>(page.ptr())->header.page_index * page_capacity() + itr.item_pos();
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f96, "End: result=%zu", result);
+
+        return result;
+    }
+
+
+    template <typename T>
+    inline typename vector<T>::iterator vector<T>::advance(const_iterator itr, std::ptrdiff_t n) const {
+        constexpr const char* suborigin = "advance()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f97, "Begin: itr.page_pos=0x%llx, itr.item_pos=0x%x, itr.edge=%u, n=%lld",
+                (unsigned long long)itr.page_pos(), (unsigned)itr.item_pos(), itr.edge(), (long long)n);
+
+        diag_base::expect(suborigin, itr.is_valid(this), 0x10f98, "itr.is_valid(this)");
+
+        // rbegin() is right before index 0.
+        std::ptrdiff_t index = itr.is_rbegin() ? -1 : static_cast<std::ptrdiff_t>(index_of(itr));
+        index += n;
+
+        iterator result = base::end();
+
+        if (index < 0) {
+            result = base::rbegin();
+        }
+        else if (static_cast<std::size_t>(index) < base::size()) {
+            result = iterator_at(static_cast<std::size_t>(index));
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f99, "End: result.page_pos=0x%llx, result.item_pos=0x%x, result.edge=%u",
+                (unsigned long long)result.page_pos(), (unsigned)result.item_pos(), result.edge());
+
+        return result;
+    }
+
+
+    template <typename T>
+    inline std::ptrdiff_t vector<T>::distance(const_iterator first, const_iterator last) const {
+        return static_cast<std::ptrdiff_t>(index_of(last)) - static_cast<std::ptrdiff_t>(index_of(first));
+    }
+
+
+    // ..............................................................
+
+
+    template <typename T>
+    inline page_pos_t vector<T>::page_pos_at(std::size_t page_index) const {
+        constexpr const char* suborigin = "page_pos_at()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f9a, "Begin: page_index=%zu, page_level_count=%zu", page_index, _page_levels.size());
+
+        page_pos_t page_pos = _state->items.front_page_pos;
+
+        if (!_page_levels.empty()) {
+            // The number of item pages under an entry on the top level.
+            std::size_t stride = 1;
+            for (std::size_t level = 1; level < _page_levels.size(); level++) {
+                stride *= page_level::page_capacity();
+            }
+
+            // The top level state is the back item on the level stack. The top level has a single page.
+            {
+                vmem::page page(_pool, _state->page_levels.back_page_pos, diag_base::log());
+                diag_base::expect(suborigin, page.ptr() != nullptr, 0x10f9b, "page.ptr() != nullptr");
+
+                const container_page<stack_state, noheader>* level_stack_page = reinterpret_cast<const container_page<stack_state, noheader>*>(page.ptr());
+                const stack_state& top_level_state = level_stack_page->items[level_stack_page->item_count - 1];
+                diag_base::expect(suborigin, top_level_state.front_page_pos == top_level_state.back_page_pos, 0x10f9c, "top_level.front_page_pos == top_level.back_page_pos");
+
+                page_pos = top_level_state.front_page_pos;
+            }
+
+            // Go down one page per level.
+            for (std::size_t level = _page_levels.size(); level > 0; level--) {
+                vmem::page page(_pool, page_pos, diag_base::log());
+                diag_base::expect(suborigin, page.ptr() != nullptr, 0x10f9d, "page.ptr() != nullptr");
+
+                const container_page<page_pos_t, noheader>* level_page = reinterpret_cast<const container_page<page_pos_t, noheader>*>(page.ptr());
+
+                std::size_t item_pos = (page_index / stride) % page_level::page_capacity();
+                diag_base::expect(suborigin, item_pos < level_page->item_count, 0x10f9e, "item_pos < level_page->item_count, item_pos=%zu, item_count=%u", item_pos, (unsigned)level_page->item_count);
+
+                page_pos = level_page->items[item_pos];
+                stride /= page_level::page_capacity();
+            }
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10f9f, "End: page_pos=0x%llx", (unsigned long long)page_pos);
+
+        return page_pos;
+    }
+
+
+    template <typename T>
+    inline void vector<T>::push_back_page(page_pos_t page_pos) {
+        constexpr const char* suborigin = "push_back_page()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10fa0, "Begin: page_pos=0x%llx", (unsigned long long)page_pos);
+
+        page_pos_t below_front_page_pos = _state->items.front_page_pos;
+        page_pos_t new_page_pos = page_pos;
+
+        page_level_stack_iterator level_itr = _page_levels.begin();
+        for (;;) {
+            if (level_itr == _page_levels.end()) {
+                // The level below has just got its second page. Add a level on top of it.
+                stack_state level_state;
+                page_level level(&level_state, _pool, diag_base::log());
+                level.push_back(below_front_page_pos);
+                level.push_back(new_page_pos);
+
+                _page_levels.push_back(level_state);
+                break;
+            }
+
+            // IMPORTANT: Save the ptr instance to keep the page locked.
+            vmem::ptr<stack_state> level_state_ptr = level_itr.operator->();
+
+            page_level level(level_state_ptr.operator->(), _pool, diag_base::log());
+            page_pos_t level_back_page_pos = level_state_ptr->back_page_pos;
+            level.push_back(new_page_pos);
+
+            if (level_state_ptr->back_page_pos == level_back_page_pos) {
+                break;
+            }
+
+            // This level has got a new page too.
+            below_front_page_pos = level_state_ptr->front_page_pos;
+            new_page_pos = level_state_ptr->back_page_pos;
+            level_itr++;
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10fa1, "End: page_level_count=%zu", _page_levels.size());
+    }
+
+
+    template <typename T>
+    inline void vector<T>::pop_back_page() {
+        constexpr const char* suborigin = "pop_back_page()";
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10fa2, "Begin: page_level_count=%zu", _page_levels.size());
+
+        bool should_pop_level = false;
+
+        std::size_t level_number = 0;
+        for (page_level_stack_iterator level_itr = _page_levels.begin(); level_itr != _page_levels.end(); level_itr++, level_number++) {
+            // IMPORTANT: Save the ptr instance to keep the page locked.
+            vmem::ptr<stack_state> level_state_ptr = level_itr.operator->();
+
+            page_level level(level_state_ptr.operator->(), _pool, diag_base::log());
+
+            if (level.size() == 2) {
+                // The level below is down to a single page, which needs no index. This is the top level.
+                diag_base::expect(suborigin, level_number + 1 == _page_levels.size(), 0x10fa3, "level_number + 1 == page_level_count, level_number=%zu, page_level_count=%zu", level_number, _page_levels.size());
+
+                level.clear();
+                should_pop_level = true;
+                break;
+            }
+
+            page_pos_t level_back_page_pos = level_state_ptr->back_page_pos;
+            level.pop_back();
+
+            if (level_state_ptr->back_page_pos == level_back_page_pos) {
+                break;
+            }
+        }
+
+        if (should_pop_level) {
+            _page_levels.pop_back();
+        }
+
+        ABC_DIAG_PUT_ANY(diag_base::put_any, suborigin, diag::severity::callstack, 0x10fa4, "End: page_level_count=%zu", _page_levels.size());
+    }
+
+
+    // --------------------------------------------------------------
+
+} }
@@ -23,6 +23,8 @@ SOFTWARE.
 */
 
 
+#include <cstring>
+
 #include "inc/ascii.h"
 
 
@@ -237,3 +239,98 @@ bool test_ascii_less_i_n(test_context& context) {
     return passed;
 }
 
+
+
+namespace {
+    // Reference predicates, written without the table.
+    bool ref_is_digit(char ch)        { return '0' <= ch && ch <= '9'; }
+    bool ref_is_hex(char ch)          { return ref_is_digit(ch) || ('A' <= ch && ch <= 'F') || ('a' <= ch && ch <= 'f'); }
+    bool ref_is_alpha(char ch)        { return ('A' <= ch && ch <= 'Z') || ('a' <= ch && ch <= 'z'); }
+    bool ref_is_space(char ch)        { return ch == ' ' || ch == '\t'; }
+    bool ref_is_control(char ch)      { return (0x00 <= ch && ch <= 0x1f) || ch == 0x7f; }
+    bool ref_is_abcprint(char ch)     { return 0x21 <= ch && ch <= 0x7e; }
+    bool ref_is_http_separator(char ch) {
+        return ref_is_space(ch) || (ch != '\0' && std::strchr("()<>[]{}@,;:\\/\"?=", ch) != nullptr);
+    }
+    bool ref_is_http_token(char ch)   { return ref_is_abcprint(ch) && !ref_is_http_separator(ch); }
+    bool ref_is_json_space(char ch)   { return ref_is_space(ch) || ch == '\r' || ch == '\n'; }
+}
+
+
+bool test_ascii_char_class(test_context& context) {
+    bool passed = true;
+
+    for (int code = 0; code < 256; code++) {
+        char ch = static_cast<char>(code);
+
+        passed = context.are_equal(abc::ascii::is_digit(ch), ref_is_digit(ch), 0x10ed0, "%d") && passed;
+        passed = context.are_equal(abc::ascii::is_hex(ch), ref_is_hex(ch), 0x10ed1, "%d") && passed;
+        passed = context.are_equal(abc::ascii::is_alpha(ch), ref_is_alpha(ch), 0x10ed2, "%d") && passed;
+        passed = context.are_equal(abc::ascii::is_space(ch), ref_is_space(ch), 0x10ed3, "%d") && passed;
+        passed = context.are_equal(abc::ascii::is_control(ch), ref_is_control(ch), 0x10ed4, "%d") && passed;
+        passed = context.are_equal(abc::ascii::is_abcprint(ch), ref_is_abcprint(ch), 0x10ed5, "%d") && passed;
+        passed = context.are_equal(abc::ascii::is_abcprint_or_space(ch), ref_is_abcprint(ch) || ref_is_space(ch), 0x10ed6, "%d") && passed;
+        passed = context.are_equal(abc::ascii::http::is_separator(ch), ref_is_http_separator(ch), 0x10ed7, "%d") && passed;
+        passed = context.are_equal(abc::ascii::http::is_token(ch), ref_is_http_token(ch), 0x10ed8, "%d") && passed;
+        passed = context.are_equal(abc::ascii::json::is_space(ch), ref_is_json_space(ch), 0x10ed9, "%d") && passed;
+        passed = context.are_equal(abc::ascii::json::is_string_content(ch), ch != '"' && ch != '\\', 0x10eda, "%d") && passed;
+
+        if (!passed) {
+            context.log()->put_any("test_ascii_char_class", "", abc::diag::severity::important, 0x10edb, "code=0x%2.2x", code);
+            break;
+        }
+    }
+
+    return passed;
+}
+
+
+bool test_ascii_scan_while(test_context& context) {
+    using abc::ascii::char_class_t;
+    namespace char_class = abc::ascii::char_class;
+
+    const char_class_t classes[] = {
+        char_class::digit, char_class::hex, char_class::abcprint, char_class::abcprint_or_space,
+        char_class::stdprint, char_class::http_token, char_class::json_string_content, char_class::any,
+    };
+
+    // Long enough to exercise the 32-char and the 16-char SIMD loops as well as the scalar tail.
+    constexpr std::size_t buffer_size = 100;
+    char buffer[buffer_size];
+
+    bool passed = true;
+
+    for (char_class_t cls : classes) {
+        // Fill the buffer with a char that belongs to the class.
+        char fill = '0';
+        for (int code = 0; code < 256; code++) {
+            if (abc::ascii::is_class(static_cast<char>(code), cls)) {
+                fill = static_cast<char>(code);
+                break;
+            }
+        }
+
+        for (std::size_t stop = 0; stop <= buffer_size && passed; stop++) {
+            for (int code = 0; code < 256 && passed; code++) {
+                std::memset(buffer, fill, buffer_size);
+                if (stop < buffer_size) {
+                    buffer[stop] = static_cast<char>(code);
+                }
+
+                std::size_t expected = 0;
+                while (expected < buffer_size && abc::ascii::is_class(buffer[expected], cls)) {
+                    expected++;
+                }
+
+                std::size_t actual = abc::ascii::scan_while(buffer, buffer_size, cls);
+                passed = context.are_equal(actual, expected, 0x10edc, "%zu") && passed;
+
+                if (!passed) {
+                    context.log()->put_any("test_ascii_scan_while", "", abc::diag::severity::important, 0x10edd, "cls=0x%x, stop=%zu, code=0x%2.2x", (unsigned)cls, stop, code);
+                }
+            }
+        }
+    }
+
+    return passed;
+}
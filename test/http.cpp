@@ -29,6 +29,7 @@ SOFTWARE.
 
 #include "inc/stream.h"
 #include "inc/http.h"
+#include "inc/json.h"
 
 
 bool test_http_request_istream_extraspaces(test_context& context) {
@@ -1406,3 +1407,284 @@ bool test_http_server_move(test_context& context) {
 
     return passed;
 }
+
+
+// --------------------------------------------------------------
+
+
+bool test_http_request_reader_chunked(test_context& context) {
+    char content[] =
+        "POST /upload HTTP/1.1\r\n"
+        "Transfer-Encoding: gzip, chunked\r\n"
+        "\r\n"
+        "5;name=value\r\n"
+        "Hello\r\n"
+        "7\r\n"
+        ", world\r\n"
+        "0\r\n"
+        "Trailer-Name: trailer value\r\n"
+        "\r\n"
+        "GET /next HTTP/1.1\r\n"
+        "\r\n";
+
+    abc::stream::buffer_streambuf sb(content, 0, std::strlen(content), nullptr, 0, 0);
+
+    bool passed = true;
+
+    {
+        abc::net::http::request_reader reader(&sb, context.log());
+
+        abc::net::http::request request = reader.get_request();
+        passed = context.are_equal(request.resource.path.c_str(), "/upload", 0x10e6a) && passed;
+
+        // A single read never spans chunks.
+        std::string body = reader.get_body(3);
+        passed = context.are_equal(body.c_str(), "Hel", 0x10e6b) && passed;
+
+        body = reader.get_body(abc::size::k1);
+        passed = context.are_equal(body.c_str(), "lo", 0x10e6c) && passed;
+
+        body = reader.get_body(abc::size::k1);
+        passed = context.are_equal(body.c_str(), ", world", 0x10e6d) && passed;
+        passed = context.are_equal(reader.is_body_complete(), false, 0x10e6e, "%d") && passed;
+
+        body = reader.get_body(abc::size::k1);
+        passed = context.are_equal(body.c_str(), "", 0x10e6f) && passed;
+        passed = context.are_equal(reader.is_body_complete(), true, 0x10e70, "%d") && passed;
+
+        body = reader.get_body(abc::size::k1);
+        passed = context.are_equal(body.c_str(), "", 0x10e71) && passed;
+    }
+
+    // The next request starts right after the chunked body.
+    {
+        abc::net::http::request_reader reader(&sb, context.log());
+
+        abc::net::http::request request = reader.get_request();
+        passed = context.are_equal(request.method.c_str(), "GET", 0x10e72) && passed;
+        passed = context.are_equal(request.resource.path.c_str(), "/next", 0x10e73) && passed;
+    }
+
+    return passed;
+}
+
+
+bool test_http_response_writer_chunked(test_context& context) {
+    const char expected[] = 
+        "HTTP/1.1 200 OK\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n"
+        "4\r\n"
+        "Hell\r\n"
+        "4\r\n"
+        "o, w\r\n"
+        "4\r\n"
+        "orld\r\n"
+        "1\r\n"
+        "!\r\n"
+        "0\r\n"
+        "\r\n";
+
+    std::stringbuf sb(std::ios_base::out);
+    abc::net::http::response_writer writer(&sb, context.log());
+
+    abc::net::http::response response;
+    response.protocol = "HTTP/1.1";
+    response.status_code = 200;
+    response.reason_phrase = "OK";
+    response.headers = {
+        { "Transfer-Encoding", "chunked" },
+    };
+
+    writer.put_response(response);
+
+    {
+        abc::net::http::body_ostreambuf<abc::net::http::response_writer> body_sb(&writer, 4);
+        body_sb.sputn("Hello, world!", 13);
+        body_sb.end_body();
+    }
+
+    bool passed = true;
+
+    passed = context.are_equal(sb.str().c_str(), expected, 0x10e74) && passed;
+
+    return passed;
+}
+
+
+bool test_http_chunked_json_stream(test_context& context) {
+    std::stringbuf sb(std::ios_base::in | std::ios_base::out);
+
+    // Write
+    {
+        abc::net::http::response_writer writer(&sb, context.log());
+
+        abc::net::http::response response;
+        response.protocol = "HTTP/1.1";
+        response.status_code = 200;
+        response.reason_phrase = "OK";
+        response.headers = {
+            { "Content-Type", "application/json" },
+            { "Transfer-Encoding", "chunked" },
+        };
+
+        writer.put_response(response);
+
+        abc::net::http::body_ostreambuf<abc::net::http::response_writer> body_sb(&writer, abc::size::_8);
+        abc::net::json::writer json(&body_sb, context.log());
+
+        abc::net::json::value body = 
+            abc::net::json::literal::object {
+                { "n", 42.0 },
+                { "s", "a string that spans several chunks" },
+            };
+
+        json.put_value(body);
+        body_sb.end_body();
+    }
+
+    bool passed = true;
+
+    // Read
+    {
+        abc::net::http::response_reader reader(&sb, context.log());
+
+        abc::net::http::response response = reader.get_response();
+        passed = context.are_equal(response.status_code, (abc::net::http::status_code_t)200, 0x10e75, "%u") && passed;
+
+        abc::net::http::body_istreambuf<abc::net::http::response_reader> body_sb(&reader, abc::size::_8);
+        abc::net::json::reader json(&body_sb, context.log());
+        abc::net::json::value body = json.get_value();
+
+        passed = context.are_equal(body.type(), abc::net::json::value_type::object, 0x10e76, "%u") && passed;
+        passed = context.are_equal(body.object()["n"].number(), 42.0, 0x10e77, "%f") && passed;
+        passed = context.are_equal(body.object()["s"].string().c_str(), "a string that spans several chunks", 0x10e78) && passed;
+
+        // Only the last chunk is left.
+        passed = context.are_equal(reader.get_body(abc::size::k1).c_str(), "", 0x10e79) && passed;
+        passed = context.are_equal(reader.is_body_complete(), true, 0x10e7a, "%d") && passed;
+    }
+
+    return passed;
+}
+
+
+// --------------------------------------------------------------
+
+
+bool test_http_request_head_complete(test_context& context) {
+    char content[] =
+        "POST /path/a%20b?p=1&q=2 HTTP/1.1\r\n"
+        "Host: localhost\r\n"
+        "Content-Length:3\r\n"
+        "X-Spaces:   inner   spaces   \r\n"
+        "\r\n"
+        "abc";
+
+    bool passed = true;
+
+    abc::net::http::request_head head;
+    abc::net::http::head_status status = abc::net::http::util::parse_request_head(content, std::strlen(content), head);
+    passed = context.are_equal((unsigned)status, (unsigned)abc::net::http::head_status::complete, 0x10eba, "%u") && passed;
+    passed = context.are_equal(head.size, std::strlen(content) - 3, 0x10ebb, "%zu") && passed;
+
+    // The spans point into the buffer.
+    passed = context.are_equal(head.method.data == content, true, 0x10ebc, "%d") && passed;
+    passed = context.are_equal(head.method.to_string().c_str(), "POST", 0x10ebd) && passed;
+    passed = context.are_equal(head.target.to_string().c_str(), "/path/a%20b?p=1&q=2", 0x10ebe) && passed;
+    passed = context.are_equal(head.protocol.to_string().c_str(), "HTTP/1.1", 0x10ebf) && passed;
+    passed = context.are_equal(head.header_count, (std::size_t)3, 0x10ec0, "%zu") && passed;
+
+    const abc::net::http::span* value = head.find_header("content-length");
+    passed = context.are_equal(value != nullptr, true, 0x10ec1, "%d") && passed;
+    if (value != nullptr) {
+        passed = context.are_equal(value->to_string().c_str(), "3", 0x10ec2) && passed;
+    }
+
+    value = head.find_header("X-Spaces");
+    passed = context.are_equal(value != nullptr, true, 0x10ec3, "%d") && passed;
+    if (value != nullptr) {
+        passed = context.are_equal(value->to_string().c_str(), "inner   spaces", 0x10ec4) && passed;
+    }
+
+    passed = context.are_equal(head.find_header("Connection") == nullptr, true, 0x10ec5, "%d") && passed;
+
+    // A reader positioned after the head reads the body.
+    abc::stream::buffer_streambuf sb(content, head.size, std::strlen(content), nullptr, 0, 0);
+    abc::net::http::request_reader reader(&sb, context.log());
+
+    abc::net::http::request request = reader.get_request(head);
+    passed = context.are_equal(request.method.c_str(), "POST", 0x10ec6) && passed;
+    passed = context.are_equal(request.resource.path.c_str(), "/path/a b", 0x10ec7) && passed;
+    passed = context.are_equal(request.resource.query["q"].c_str(), "2", 0x10ec8) && passed;
+    passed = context.are_equal(request.protocol.c_str(), "HTTP/1.1", 0x10ec9) && passed;
+    passed = context.are_equal(request.headers["HOST"].c_str(), "localhost", 0x10eca) && passed;
+
+    std::string body = reader.get_body(abc::size::k1);
+    passed = context.are_equal(body.c_str(), "abc", 0x10ecb) && passed;
+
+    return passed;
+}
+
+
+bool test_http_request_head_incomplete(test_context& context) {
+    const char content[] =
+        "GET /path HTTP/1.1\r\n"
+        "Host: localhost\r\n"
+        "\r\n";
+
+    bool passed = true;
+
+    // Every prefix is incomplete, but not unsupported.
+    std::size_t content_len = std::strlen(content);
+    for (std::size_t len = 0; len < content_len; len++) {
+        abc::net::http::request_head head;
+        abc::net::http::head_status status = abc::net::http::util::parse_request_head(content, len, head);
+
+        passed = context.are_equal((unsigned)status, (unsigned)abc::net::http::head_status::incomplete, 0x10ecc, "%u") && passed;
+    }
+
+    abc::net::http::request_head head;
+    abc::net::http::head_status status = abc::net::http::util::parse_request_head(content, content_len, head);
+    passed = context.are_equal((unsigned)status, (unsigned)abc::net::http::head_status::complete, 0x10ecd, "%u") && passed;
+
+    return passed;
+}
+
+
+bool test_http_request_head_unsupported(test_context& context) {
+    const char* contents[] = {
+        "GET  /path HTTP/1.1\r\n\r\n",
+        "GET /path HTTP/1.1\n\r\n",
+        "GET /path HTTP/1\r\n\r\n",
+        "GET /path\r\n\r\n",
+        "G(T /path HTTP/1.1\r\n\r\n",
+        "GET /path HTTP/1.1\r\nHost : localhost\r\n\r\n",
+        "GET /path HTTP/1.1\r\nHost: localhost\r\n  continued\r\n\r\n",
+        "GET /path HTTP/1.1\r\nNo-Colon\r\n\r\n",
+    };
+
+    bool passed = true;
+
+    for (const char* content : contents) {
+        abc::net::http::request_head head;
+        abc::net::http::head_status status = abc::net::http::util::parse_request_head(content, std::strlen(content), head);
+
+        passed = context.are_equal((unsigned)status, (unsigned)abc::net::http::head_status::unsupported, 0x10ece, "%u") && passed;
+    }
+
+    // The stream reader still reads folded headers.
+    char content[] =
+        "GET /path HTTP/1.1\r\n"
+        "Folded: first\r\n"
+        "  second\r\n"
+        "\r\n";
+
+    abc::stream::buffer_streambuf sb(content, 0, std::strlen(content), nullptr, 0, 0);
+    abc::net::http::request_reader reader(&sb, context.log());
+
+    abc::net::http::request request = reader.get_request();
+    passed = context.are_equal(request.headers["Folded"].c_str(), "first second", 0x10ecf) && passed;
+
+    return passed;
+}
@@ -39,3 +39,6 @@ bool test_ascii_less(test_context& context);
 bool test_ascii_less_n(test_context& context);
 bool test_ascii_less_i(test_context& context);
 bool test_ascii_less_i_n(test_context& context);
+
+bool test_ascii_char_class(test_context& context);
+bool test_ascii_scan_while(test_context& context);
@@ -90,3 +90,10 @@ bool test_http_response_reader_move(test_context& context);
 bool test_http_response_writer_move(test_context& context);
 bool test_http_client_move(test_context& context);
 bool test_http_server_move(test_context& context);
+
+bool test_http_request_reader_chunked(test_context& context);
+bool test_http_response_writer_chunked(test_context& context);
+bool test_http_chunked_json_stream(test_context& context);
+bool test_http_request_head_complete(test_context& context);
+bool test_http_request_head_incomplete(test_context& context);
+bool test_http_request_head_unsupported(test_context& context);
@@ -27,6 +27,7 @@ SOFTWARE.
 
 #include "../../src/net/socket.h"
 #include "../../src/net/endpoint.h"
+#include "../../src/net/async_client.h"
 #ifdef __ABC__OPENSSL
 #include "../../src/net/openssl/socket.h"
 #endif
@@ -38,9 +39,22 @@ bool test_udp_socket(test_context& context);
 
 bool test_tcp_socket(test_context& context);
 bool test_tcp_socket_stream_move(test_context& context);
+bool test_tcp_socket_stream_blocks(test_context& context);
+bool test_tcp_socket_accept_exhausted(test_context& context);
 bool test_tcp_socket_http_json_stream(test_context& context);
 
 bool test_http_endpoint_json_stream(test_context& context);
+bool test_http_endpoint_workers(test_context& context);
+bool test_http_endpoint_keep_alive(test_context& context);
+bool test_http_endpoint_file_range(test_context& context);
+bool test_https_endpoint_file_range(test_context& context);
+bool test_http_endpoint_file_cache(test_context& context);
+bool test_http_file_cache_lru(test_context& context);
+bool test_http_router(test_context& context);
+bool test_http_endpoint_routes(test_context& context);
+bool test_http_async_client_pool(test_context& context);
+bool test_http_async_client_framing(test_context& context);
+bool test_http_async_client_errors(test_context& context);
 
 bool test_openssl_tcp_socket(test_context& context);
 bool test_openssl_tcp_socket_stream_move(test_context& context);
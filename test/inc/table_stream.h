@@ -26,6 +26,7 @@ SOFTWARE.
 #pragma once
 
 #include "../../src/diag/log.h"
+#include "../../src/diag/diag_ready.h"
 
 #include "test.h"
 
@@ -36,6 +37,7 @@ bool test_line_test(test_context& context);
 
 bool test_table_move(test_context& context);
 bool test_log_move(test_context& context);
+bool test_log_severity_floor(test_context& context);
 
 bool test_line_move(test_context& context);
 bool test_line_debug_move(test_context& context);
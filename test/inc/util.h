@@ -26,8 +26,12 @@ SOFTWARE.
 #pragma once
 
 #include "../../src/root/util.h"
+#include "../../src/root/crc32c.h"
+#include "../../src/root/lz4.h"
 
 #include "test.h"
 
 
 bool test_util_strprintf(test_context& context);
+bool test_util_crc32c(test_context& context);
+bool test_util_lz4(test_context& context);
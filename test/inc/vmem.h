@@ -34,6 +34,15 @@ bool test_vmem_pool_fit(test_context& context);
 bool test_vmem_pool_exceed(test_context& context);
 bool test_vmem_pool_reopen(test_context& context);
 bool test_vmem_pool_freepages(test_context& context);
+bool test_vmem_pool_compact(test_context& context);
+bool test_vmem_pool_compact_map(test_context& context);
+bool test_vmem_pool_checksum(test_context& context);
+bool test_vmem_pool_scrub_linked(test_context& context);
+bool test_vmem_pool_cold(test_context& context);
+bool test_vmem_pool_huge(test_context& context);
+bool test_vmem_pool_stats(test_context& context);
+bool test_vmem_pool_readonly(test_context& context);
+bool test_vmem_pool_backup(test_context& context);
 
 bool test_vmem_linked_mixedone(test_context& context);
 bool test_vmem_linked_mixedmany(test_context& context);
@@ -44,15 +53,24 @@ bool test_vmem_list_insert(test_context& context);
 bool test_vmem_list_insertmany(test_context& context);
 bool test_vmem_list_erase(test_context& context);
 bool test_vmem_list_find(test_context& context);
+bool test_vmem_list_at(test_context& context);
+bool test_vmem_list_at_index(test_context& context);
+bool test_vmem_vector_at(test_context& context);
 
 bool test_vmem_temp_destructor(test_context& context);
 
+bool test_vmem_log(test_context& context);
+bool test_vmem_priority_queue(test_context& context);
+bool test_vmem_priority_queue_even_capacity(test_context& context);
+
 bool test_vmem_map_insert(test_context& context);
 bool test_vmem_map_insertmany(test_context& context);
 bool test_vmem_map_erase(test_context& context);
 bool test_vmem_map_erasemany(test_context& context);
 bool test_vmem_map_mixed(test_context& context);
 bool test_vmem_map_clear(test_context& context);
+bool test_vmem_map_bounds(test_context& context);
+bool test_vmem_map_indexed(test_context& context);
 
 bool test_vmem_string_iterator(test_context& context);
 bool test_vmem_string_stream(test_context& context);
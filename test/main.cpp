@@ -61,6 +61,8 @@ int main(int /*argc*/, const char* argv[]) {
                 { "test_ascii_less_n",                               test_ascii_less_n },
                 { "test_ascii_less_i",                               test_ascii_less_i },
                 { "test_ascii_less_i_n",                             test_ascii_less_i_n },
+                { "test_ascii_char_class",                           test_ascii_char_class },
+                { "test_ascii_scan_while",                           test_ascii_scan_while },
             } },
             { "timestamp", {
                 { "test_null_timestamp",                             test_null_timestamp },
@@ -71,6 +73,8 @@ int main(int /*argc*/, const char* argv[]) {
             } },
             { "util", {
                 { "test_util_strprintf",                             test_util_strprintf },
+                { "test_util_crc32c",                                test_util_crc32c },
+                { "test_util_lz4",                                   test_util_lz4 },
             } },
             { "buffer_streambuf", {
                 { "test_buffer_streambuf_1_char",                    test_buffer_streambuf_1_char },
@@ -98,6 +102,7 @@ int main(int /*argc*/, const char* argv[]) {
                 { "test_line_test",                                  test_line_test },
                 { "test_table_move",                                 test_table_move },
                 { "test_log_move",                                   test_log_move },
+                { "test_log_severity_floor",                         test_log_severity_floor },
                 { "test_line_move",                                  test_line_move },
                 { "test_line_debug_move",                            test_line_debug_move },
                 { "test_line_diag_move",                             test_line_diag_move },
@@ -161,6 +166,12 @@ int main(int /*argc*/, const char* argv[]) {
                 { "test_http_response_writer_move",                  test_http_response_writer_move },
                 { "test_http_client_move",                           test_http_client_move },
                 { "test_http_server_move",                           test_http_server_move },
+                { "test_http_request_reader_chunked",                test_http_request_reader_chunked },
+                { "test_http_response_writer_chunked",               test_http_response_writer_chunked },
+                { "test_http_chunked_json_stream",                   test_http_chunked_json_stream },
+                { "test_http_request_head_complete",                 test_http_request_head_complete },
+                { "test_http_request_head_incomplete",               test_http_request_head_incomplete },
+                { "test_http_request_head_unsupported",              test_http_request_head_unsupported },
             } },
             { "json", {
                 { "test_json_value_empty",                           test_json_value_empty },
@@ -253,13 +264,26 @@ int main(int /*argc*/, const char* argv[]) {
                 { "test_udp_socket",                                 test_udp_socket },
                 { "test_tcp_socket",                                 test_tcp_socket },
                 { "test_tcp_socket_stream_move",                     test_tcp_socket_stream_move },
+                { "test_tcp_socket_stream_blocks",                   test_tcp_socket_stream_blocks },
+                { "test_tcp_socket_accept_exhausted",                test_tcp_socket_accept_exhausted },
                 { "test_tcp_socket_http_json_stream",                test_tcp_socket_http_json_stream },
                 { "test_http_endpoint_json_stream",                  test_http_endpoint_json_stream },
+                { "test_http_endpoint_workers",                      test_http_endpoint_workers },
+                { "test_http_endpoint_keep_alive",                   test_http_endpoint_keep_alive },
+                { "test_http_endpoint_file_range",                   test_http_endpoint_file_range },
+                { "test_http_endpoint_file_cache",                   test_http_endpoint_file_cache },
+                { "test_http_file_cache_lru",                        test_http_file_cache_lru },
+                { "test_http_router",                                test_http_router },
+                { "test_http_endpoint_routes",                       test_http_endpoint_routes },
+                { "test_http_async_client_pool",                     test_http_async_client_pool },
+                { "test_http_async_client_framing",                  test_http_async_client_framing },
+                { "test_http_async_client_errors",                   test_http_async_client_errors },
 #ifdef __ABC__OPENSSL
                 { "test_openssl_tcp_socket",                         test_openssl_tcp_socket },
                 { "test_openssl_tcp_socket_stream_move",             test_openssl_tcp_socket_stream_move },
                 { "test_openssl_tcp_socket_http_json_stream",        test_openssl_tcp_socket_http_json_stream },
                 { "test_https_endpoint_json_stream",                 test_https_endpoint_json_stream },
+                { "test_https_endpoint_file_range",                  test_https_endpoint_file_range },
 #endif
             } },
             { "vmem", {
@@ -267,6 +291,15 @@ int main(int /*argc*/, const char* argv[]) {
                 { "test_vmem_pool_exceed",                           test_vmem_pool_exceed },
                 { "test_vmem_pool_reopen",                           test_vmem_pool_reopen },
                 { "test_vmem_pool_freepages",                        test_vmem_pool_freepages },
+                { "test_vmem_pool_compact",                          test_vmem_pool_compact },
+                { "test_vmem_pool_compact_map",                      test_vmem_pool_compact_map },
+                { "test_vmem_pool_checksum",                         test_vmem_pool_checksum },
+                { "test_vmem_pool_scrub_linked",                     test_vmem_pool_scrub_linked },
+                { "test_vmem_pool_cold",                             test_vmem_pool_cold },
+                { "test_vmem_pool_huge",                             test_vmem_pool_huge },
+                { "test_vmem_pool_stats",                            test_vmem_pool_stats },
+                { "test_vmem_pool_readonly",                         test_vmem_pool_readonly },
+                { "test_vmem_pool_backup",                           test_vmem_pool_backup },
                 { "test_vmem_linked_mixedone",                       test_vmem_linked_mixedone },
                 { "test_vmem_linked_mixedmany",                      test_vmem_linked_mixedmany },
                 { "test_vmem_linked_splice",                         test_vmem_linked_splice },
@@ -275,13 +308,21 @@ int main(int /*argc*/, const char* argv[]) {
                 { "test_vmem_list_insertmany",                       test_vmem_list_insertmany },
                 { "test_vmem_list_erase",                            test_vmem_list_erase },
                 { "test_vmem_list_find",                             test_vmem_list_find },
+                { "test_vmem_list_at",                               test_vmem_list_at },
+                { "test_vmem_list_at_index",                         test_vmem_list_at_index },
+                { "test_vmem_vector_at",                             test_vmem_vector_at },
                 { "test_vmem_temp_destructor",                       test_vmem_temp_destructor },
+                { "test_vmem_log",                                   test_vmem_log },
+                { "test_vmem_priority_queue",                        test_vmem_priority_queue },
+                { "test_vmem_priority_queue_even_capacity",          test_vmem_priority_queue_even_capacity },
                 { "test_vmem_map_insert",                            test_vmem_map_insert },
                 { "test_vmem_map_insertmany",                        test_vmem_map_insertmany },
                 { "test_vmem_map_erase",                             test_vmem_map_erase },
                 { "test_vmem_map_erasemany",                         test_vmem_map_erasemany },
                 { "test_vmem_map_mixed",                             test_vmem_map_mixed },
                 { "test_vmem_map_clear",                             test_vmem_map_clear },
+                { "test_vmem_map_bounds",                            test_vmem_map_bounds },
+                { "test_vmem_map_indexed",                           test_vmem_map_indexed },
                 { "test_vmem_string_iterator",                       test_vmem_string_iterator },
                 { "test_vmem_string_stream",                         test_vmem_string_stream },
                 { "test_vmem_pool_move",                             test_vmem_pool_move },
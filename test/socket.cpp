@@ -23,8 +23,16 @@ SOFTWARE.
 */
 
 
+#include <array>
+#include <atomic>
 #include <cctype>
+#include <cstdlib>
+#include <fstream>
 #include <thread>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <vector>
 
 #include "inc/http.h"
 #include "inc/json.h"
@@ -277,6 +285,113 @@ bool test_openssl_tcp_socket_stream_move(test_context& context) {
 }
 
 
+bool test_tcp_socket_stream_blocks(test_context& context) {
+    constexpr const char* suborigin = "test_tcp_socket_stream_blocks";
+    constexpr const char* server_port = "31009";
+    constexpr std::size_t buffer_size = 64;
+    constexpr std::size_t content_size = abc::size::k64 + 3;
+    bool passed = true;
+
+    // Blocks that are smaller and larger than the buffers go through both the buffered and the direct paths.
+    std::vector<char> content(content_size);
+    for (std::size_t i = 0; i < content_size; i++) {
+        content[i] = static_cast<char>('a' + i % 26);
+    }
+
+    abc::net::tcp_server_socket server(abc::net::socket::family::ipv4, context.log());
+    server.bind(server_port);
+    server.listen(5);
+
+    std::thread client_thread(
+        [&passed, &context, &content, server_port] () {
+        try {
+            abc::net::tcp_client_socket client(abc::net::socket::family::ipv4, context.log());
+            client.connect("localhost", server_port);
+
+            abc::net::tcp_client_socket_streambuf sb(&client, buffer_size, buffer_size, context.log());
+            std::ostream client_out(&sb);
+
+            client_out.write(content.data(), 10);
+            client_out.put(content[10]);
+            client_out.write(content.data() + 11, content_size - 11);
+            client_out.flush();
+            passed = context.are_equal(client_out.good(), true, 0x10e33, "%d") && passed;
+        }
+        catch (const std::exception& ex) {
+            context.log()->put_any(origin, suborigin, abc::diag::severity::important, 0x10e34, "client: EXCEPTION: %s", ex.what());
+            throw;
+        }
+    });
+
+    std::unique_ptr<abc::net::tcp_client_socket> connection = server.accept();
+
+    abc::net::tcp_client_socket_streambuf sb(connection.get(), buffer_size, buffer_size, context.log());
+    std::istream connection_in(&sb);
+
+    std::vector<char> received(content_size);
+    connection_in.read(received.data(), 10);
+    received[10] = static_cast<char>(connection_in.get());
+    connection_in.read(received.data() + 11, content_size - 11);
+    passed = context.are_equal<std::size_t>(static_cast<std::size_t>(connection_in.gcount()), content_size - 11, 0x10e35, "%zu") && passed;
+    passed = context.are_equal(received == content, true, 0x10e36, "%d") && passed;
+
+    client_thread.join();
+    return passed;
+}
+
+
+bool test_tcp_socket_accept_exhausted(test_context& context) {
+    constexpr const char* server_port = "31020";
+    bool passed = true;
+
+    abc::net::tcp_server_socket server(abc::net::socket::family::ipv4, context.log());
+    server.bind(server_port);
+    server.listen(5);
+    server.set_blocking(false);
+
+    // The kernel completes the handshake, so the connection is pending on the listener.
+    abc::net::tcp_client_socket client(abc::net::socket::family::ipv4, context.log());
+    client.connect("localhost", server_port);
+
+    // Lower the descriptor limit to the lowest free descriptor, so that the process runs out of descriptors.
+    int lowest_free_fd = ::dup(0);
+    ::close(lowest_free_fd);
+
+    rlimit original_limit{ };
+    ::getrlimit(RLIMIT_NOFILE, &original_limit);
+    rlimit lowered_limit = original_limit;
+    lowered_limit.rlim_cur = static_cast<rlim_t>(lowest_free_fd);
+    ::setrlimit(RLIMIT_NOFILE, &lowered_limit);
+
+    bool is_exhausted = false;
+    bool thrown = false;
+    abc::net::socket::fd_t fd = abc::net::socket::fd::invalid;
+    try {
+        fd = server.try_accept_fd(is_exhausted);
+    }
+    catch (const std::exception&) {
+        thrown = true;
+    }
+
+    ::setrlimit(RLIMIT_NOFILE, &original_limit);
+
+    passed = context.are_equal(thrown, false, 0x10fca, "%d") && passed;
+    passed = context.are_equal(is_exhausted, true, 0x10fcb, "%d") && passed;
+    passed = context.are_equal(fd, abc::net::socket::fd::invalid, 0x10fcc, "%d") && passed;
+
+    // Once descriptors are available again, the pending connection gets accepted.
+    fd = server.try_accept_fd(is_exhausted);
+    passed = context.are_equal(is_exhausted, false, 0x10fcd, "%d") && passed;
+    passed = context.are_equal(fd != abc::net::socket::fd::invalid, true, 0x10fce, "%d") && passed;
+
+    if (fd != abc::net::socket::fd::invalid) {
+        ::close(fd);
+    }
+
+    return passed;
+}
+
+
 // --------------------------------------------------------------
 
 
@@ -628,3 +743,1157 @@ bool test_https_endpoint_json_stream(test_context& context) {
 
     return passed;
 }
+
+
+// --------------------------------------------------------------
+
+
+class test_counting_endpoint
+    : public abc::net::http::endpoint {
+
+    using base = abc::net::http::endpoint;
+    using diag_base = abc::diag::diag_ready<const char*>;
+
+public:
+    test_counting_endpoint(std::size_t expected_count, abc::net::http::endpoint_config&& config, abc::diag::log_ostream* log);
+
+protected:
+    virtual std::unique_ptr<abc::net::tcp_server_socket> create_server_socket() override;
+    virtual void process_rest_request(abc::net::http::server& http, const abc::net::http::request& request) override;
+
+protected:
+    const std::size_t _expected_count;
+    std::atomic_size_t _count;
+};
+
+
+inline test_counting_endpoint::test_counting_endpoint(std::size_t expected_count, abc::net::http::endpoint_config&& config, abc::diag::log_ostream* log)
+    : base("test_counting_endpoint", std::move(config), log)
+    , _expected_count(expected_count)
+    , _count(0) {
+}
+
+
+inline std::unique_ptr<abc::net::tcp_server_socket> test_counting_endpoint::create_server_socket() {
+    return std::unique_ptr<abc::net::tcp_server_socket>(new abc::net::tcp_server_socket(abc::net::socket::family::ipv4, diag_base::log()));
+}
+
+
+inline void test_counting_endpoint::process_rest_request(abc::net::http::server& http, const abc::net::http::request& /*request*/) {
+    base::send_simple_response(http, abc::net::http::status_code::OK, abc::net::http::reason_phrase::OK, abc::net::http::content_type::text, "ok", 0x10e44);
+
+    if (++_count == _expected_count) {
+        base::set_shutdown_requested();
+    }
+}
+
+
+bool test_http_endpoint_workers(test_context& context) {
+    constexpr const char* suborigin = "test_http_endpoint_workers";
+    constexpr const char* server_port = "31010";
+    constexpr std::size_t client_count = 8;
+    bool passed = true;
+
+    // Fewer workers than clients, so that connections have to wait in the queue.
+    abc::net::http::endpoint_config config(
+        server_port,            // port
+        client_count,           // listen_queue_size
+        context.process_path,   // root_dir (Note: No trailing slash!)
+        "/resources/",          // files_prefix
+        "", "", "",             // cert_file_path, pkey_file_path, pkey_file_password
+        2                       // worker_count
+    );
+
+    test_counting_endpoint endpoint(client_count, std::move(config), context.log());
+    std::future<void> done = endpoint.start_async();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    std::array<bool, client_count> client_passed;
+    std::vector<std::thread> client_threads;
+
+    for (std::size_t i = 0; i < client_count; i++) {
+        client_passed[i] = false;
+
+        client_threads.emplace_back(
+            [&context, &client_passed, i, server_port] () {
+            try {
+                abc::net::tcp_client_socket client(abc::net::socket::family::ipv4, context.log());
+                client.connect("localhost", server_port);
+
+                abc::net::tcp_client_socket_streambuf sb(&client, context.log());
+                abc::net::http::client http(&sb, context.log());
+
+                abc::net::http::request request;
+                request.method = abc::net::http::method::GET;
+                request.resource.path = "/count";
+                request.protocol = abc::net::http::protocol::HTTP_11;
+                request.headers = {
+                    { abc::net::http::header::Connection, abc::net::http::connection::close },
+                };
+                http.put_request(request);
+
+                abc::net::http::response response = http.get_response();
+                std::string body = http.get_body(abc::size::k1);
+
+                client_passed[i] = response.status_code == abc::net::http::status_code::OK && body == "ok";
+            }
+            catch (const std::exception& ex) {
+                context.log()->put_any(origin, suborigin, abc::diag::severity::important, 0x10e45, "client: EXCEPTION: %s", ex.what());
+            }
+        });
+    }
+
+    for (std::size_t i = 0; i < client_count; i++) {
+        client_threads[i].join();
+        passed = context.are_equal(client_passed[i], true, 0x10e46, "%d") && passed;
+    }
+
+    done.wait();
+
+    return passed;
+}
+
+
+bool keep_alive_get_count(test_context& context, abc::net::tcp_client_socket_streambuf& sb, abc::diag::tag_t tag) {
+    abc::net::http::client http(&sb, context.log());
+    abc::net::http::response response = http.get_response();
+
+    // The body must be read by Content-Length, because the connection stays open.
+    std::size_t content_length = std::strtoul(response.headers[abc::net::http::header::Content_Length].c_str(), nullptr, 10);
+    std::string body = http.get_body(content_length);
+
+    bool passed = true;
+    passed = context.are_equal(response.status_code, abc::net::http::status_code::OK, tag, "%u") && passed;
+    passed = context.are_equal(body.c_str(), "ok", tag) && passed;
+
+    return passed;
+}
+
+
+bool test_http_endpoint_keep_alive(test_context& context) {
+    constexpr const char* suborigin = "test_http_endpoint_keep_alive";
+    constexpr const char* server_port = "31011";
+    constexpr std::size_t pipelined_count = 3;
+    constexpr std::size_t max_requests_per_connection = pipelined_count + 1;
+    bool passed = true;
+
+    abc::net::http::endpoint_config config(
+        server_port,                    // port
+        5,                              // listen_queue_size
+        context.process_path,           // root_dir (Note: No trailing slash!)
+        "/resources/",                  // files_prefix
+        "", "", "",                     // cert_file_path, pkey_file_path, pkey_file_password
+        1,                              // worker_count
+        max_requests_per_connection     // max_requests_per_connection
+    );
+
+    // One connection is capped, and another one is closed by the client after a request with a chunked body.
+    test_counting_endpoint endpoint(max_requests_per_connection + 2, std::move(config), context.log());
+    std::future<void> done = endpoint.start_async();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    const char get_count[] = 
+        "GET /count HTTP/1.1\r\n"
+        "\r\n";
+
+    // The endpoint doesn't read the body, so it has to skip it.
+    const char post_count_chunked[] = 
+        "POST /count HTTP/1.1\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n"
+        "3\r\n"
+        "abc\r\n"
+        "0\r\n"
+        "\r\n";
+
+    const char get_count_close[] = 
+        "GET /count HTTP/1.1\r\n"
+        "Connection: keep-alive, close\r\n"
+        "\r\n";
+
+    try {
+        abc::net::tcp_client_socket client(abc::net::socket::family::ipv4, context.log());
+        client.connect("localhost", server_port);
+
+        abc::net::tcp_client_socket_streambuf sb(&client, context.log());
+
+        // Pipelined requests are sent at once, and get responses in order.
+        for (std::size_t i = 0; i < pipelined_count; i++) {
+            sb.sputn(get_count, sizeof(get_count) - 1);
+        }
+
+        for (std::size_t i = 0; i < pipelined_count; i++) {
+            passed = keep_alive_get_count(context, sb, 0x10e56) && passed;
+        }
+
+        // Let the connection go idle before the last allowed request.
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        sb.sputn(get_count, sizeof(get_count) - 1);
+        passed = keep_alive_get_count(context, sb, 0x10e57) && passed;
+
+        // The server closes the connection after max_requests_per_connection.
+        passed = context.are_equal(sb.sgetc(), std::char_traits<char>::eof(), 0x10e58, "%d") && passed;
+    }
+    catch (const std::exception& ex) {
+        context.log()->put_any(origin, suborigin, abc::diag::severity::important, 0x10e59, "client: EXCEPTION: %s", ex.what());
+        passed = false;
+    }
+
+    try {
+        abc::net::tcp_client_socket client(abc::net::socket::family::ipv4, context.log());
+        client.connect("localhost", server_port);
+
+        abc::net::tcp_client_socket_streambuf sb(&client, context.log());
+
+        sb.sputn(post_count_chunked, sizeof(post_count_chunked) - 1);
+        sb.sputn(get_count_close, sizeof(get_count_close) - 1);
+        passed = keep_alive_get_count(context, sb, 0x10e69) && passed;
+        passed = keep_alive_get_count(context, sb, 0x10e5a) && passed;
+
+        // The server closes the connection when the client asks for it.
+        passed = context.are_equal(sb.sgetc(), std::char_traits<char>::eof(), 0x10e5b, "%d") && passed;
+    }
+    catch (const std::exception& ex) {
+        context.log()->put_any(origin, suborigin, abc::diag::severity::important, 0x10e5c, "client: EXCEPTION: %s", ex.what());
+        passed = false;
+    }
+
+    done.wait();
+
+    return passed;
+}
+
+
+// --------------------------------------------------------------
+
+
+#ifdef __ABC__OPENSSL
+class test_counting_https_endpoint
+    : public test_counting_endpoint {
+
+    using base = test_counting_endpoint;
+    using diag_base = abc::diag::diag_ready<const char*>;
+
+public:
+    test_counting_https_endpoint(std::size_t expected_count, abc::net::http::endpoint_config&& config, abc::diag::log_ostream* log);
+
+protected:
+    virtual std::unique_ptr<abc::net::tcp_server_socket> create_server_socket() override;
+};
+
+
+inline test_counting_https_endpoint::test_counting_https_endpoint(std::size_t expected_count, abc::net::http::endpoint_config&& config, abc::diag::log_ostream* log)
+    : base(expected_count, std::move(config), log) {
+}
+
+
+inline std::unique_ptr<abc::net::tcp_server_socket> test_counting_https_endpoint::create_server_socket() {
+    return std::unique_ptr<abc::net::tcp_server_socket>(new abc::net::openssl::tcp_server_socket(config().cert_file_path.c_str(), config().pkey_file_path.c_str(), config().pkey_file_password.c_str(), verify_client, abc::net::socket::family::ipv4, diag_base::log()));
+}
+#endif
+
+
+static constexpr const char range_file_path[] = "/resources/range.bin";
+static constexpr std::size_t range_file_size = 100 * abc::size::k1 + 7; // Larger than the stream buffers.
+
+
+std::string make_range_file(test_context& context) {
+    std::string dir = abc::parent_path(context.process_path);
+    dir.append("/resources");
+    ::mkdir(dir.c_str(), 0755);
+
+    std::string content;
+    content.reserve(range_file_size);
+    for (std::size_t i = 0; i < range_file_size; i++) {
+        content.push_back(static_cast<char>('a' + (i * 7) % 26));
+    }
+
+    std::string filepath = abc::parent_path(context.process_path);
+    filepath.append(range_file_path);
+
+    std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+    file.write(content.data(), content.size());
+
+    return content;
+}
+
+
+bool get_file_range(test_context& context, abc::net::tcp_client_socket_streambuf& sb, const char* range, abc::net::http::status_code_t expected_status_code, const char* expected_content_range, const std::string& expected_body, abc::diag::tag_t tag) {
+    abc::net::http::client http(&sb, context.log());
+
+    abc::net::http::request request;
+    request.method = abc::net::http::method::GET;
+    request.resource.path = range_file_path;
+    request.protocol = abc::net::http::protocol::HTTP_11;
+    if (range != nullptr) {
+        request.headers[abc::net::http::header::Range] = range;
+    }
+
+    http.put_request(request);
+
+    abc::net::http::response response = http.get_response();
+
+    std::size_t content_length = std::strtoul(response.headers[abc::net::http::header::Content_Length].c_str(), nullptr, 10);
+    std::string body = content_length > 0 ? http.get_body(content_length) : std::string();
+
+    bool passed = true;
+    passed = context.are_equal(response.status_code, expected_status_code, tag, "%u") && passed;
+    passed = context.are_equal(response.headers[abc::net::http::header::Accept_Ranges].c_str(), "bytes", tag) && passed;
+    passed = context.are_equal(response.headers[abc::net::http::header::Content_Range].c_str(), expected_content_range, tag) && passed;
+    passed = context.are_equal(body.length(), expected_body.length(), tag, "%zu") && passed;
+    passed = context.are_equal(body == expected_body, true, tag, "%d") && passed;
+
+    return passed;
+}
+
+
+bool endpoint_file_range(test_context& context, abc::net::http::endpoint* endpoint, abc::net::tcp_client_socket* client, const char* server_port) {
+    constexpr const char* suborigin = "endpoint_file_range";
+    bool passed = true;
+
+    std::string content = make_range_file(context);
+    std::string size = std::to_string(range_file_size);
+
+    std::future<void> done = endpoint->start_async();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    try {
+        client->connect("localhost", server_port);
+
+        abc::net::tcp_client_socket_streambuf sb(client, context.log());
+
+        // All the responses come over the same connection, so each body must be exact.
+        passed = get_file_range(context, sb, nullptr, abc::net::http::status_code::OK, "", content, 0x10e87) && passed;
+        passed = get_file_range(context, sb, "bytes=10-19", abc::net::http::status_code::Partial_Content, ("bytes 10-19/" + size).c_str(), content.substr(10, 10), 0x10e88) && passed;
+        passed = get_file_range(context, sb, "bytes=100000-", abc::net::http::status_code::Partial_Content, ("bytes 100000-" + std::to_string(range_file_size - 1) + "/" + size).c_str(), content.substr(100000), 0x10e89) && passed;
+        passed = get_file_range(context, sb, "bytes=-5", abc::net::http::status_code::Partial_Content, ("bytes " + std::to_string(range_file_size - 5) + "-" + std::to_string(range_file_size - 1) + "/" + size).c_str(), content.substr(range_file_size - 5), 0x10e8a) && passed;
+        passed = get_file_range(context, sb, ("bytes=" + size + "-").c_str(), abc::net::http::status_code::Range_Not_Satisfiable, ("bytes */" + size).c_str(), std::string(), 0x10e8b) && passed;
+
+        // Oversized numbers saturate, and must not wrap around.
+        passed = get_file_range(context, sb, "bytes=5-99999999999999999999999", abc::net::http::status_code::Partial_Content, ("bytes 5-" + std::to_string(range_file_size - 1) + "/" + size).c_str(), content.substr(5), 0x10f57) && passed;
+        passed = get_file_range(context, sb, "bytes=99999999999999999999999-", abc::net::http::status_code::Range_Not_Satisfiable, ("bytes */" + size).c_str(), std::string(), 0x10f58) && passed;
+
+        // Multiple ranges are not supported, so the whole file is sent.
+        passed = get_file_range(context, sb, "bytes=0-1,5-6", abc::net::http::status_code::OK, "", content, 0x10e8c) && passed;
+
+        // Shut down.
+        abc::net::http::client http(&sb, context.log());
+
+        abc::net::http::request request;
+        request.method = abc::net::http::method::GET;
+        request.resource.path = "/count";
+        request.protocol = abc::net::http::protocol::HTTP_11;
+        request.headers = {
+            { abc::net::http::header::Connection, abc::net::http::connection::close },
+        };
+        http.put_request(request);
+
+        abc::net::http::response response = http.get_response();
+        passed = context.are_equal(response.status_code, abc::net::http::status_code::OK, 0x10e8d, "%u") && passed;
+    }
+    catch (const std::exception& ex) {
+        context.log()->put_any(origin, suborigin, abc::diag::severity::important, 0x10e8e, "client: EXCEPTION: %s", ex.what());
+        passed = false;
+    }
+
+    done.wait();
+
+    return passed;
+}
+
+
+bool test_http_endpoint_file_range(test_context& context) {
+    std::string root_dir = abc::parent_path(context.process_path);
+
+    // Disable the file cache, so that the file gets sent with sendfile().
+    abc::net::http::endpoint_config config(
+        "31012",                // port
+        5,                      // listen_queue_size
+        root_dir.c_str(),       // root_dir (Note: No trailing slash!)
+        "/resources/",          // files_prefix
+        "", "", "",             // cert_file_path, pkey_file_path, pkey_file_password
+        0,                      // worker_count
+        100,                    // max_requests_per_connection
+        std::chrono::seconds(5),// keep_alive_timeout
+        0                       // file_cache_size
+    );
+
+    test_counting_endpoint endpoint(1, std::move(config), context.log());
+
+    abc::net::tcp_client_socket client(abc::net::socket::family::ipv4, context.log());
+
+    return endpoint_file_range(context, &endpoint, &client, "31012");
+}
+
+
+bool test_https_endpoint_file_range(test_context& context) {
+    bool passed = true;
+
+#ifdef __ABC__OPENSSL
+    std::string root_dir = abc::parent_path(context.process_path);
+    std::string cert_path = make_filepath(context, context.process_path, cert_filename);
+    std::string pkey_path = make_filepath(context, context.process_path, pkey_filename);
+
+    abc::net::http::endpoint_config config(
+        "31013",                // port
+        5,                      // listen_queue_size
+        root_dir.c_str(),       // root_dir (Note: No trailing slash!)
+        "/resources/",          // files_prefix
+        cert_path.c_str(),
+        pkey_path.c_str(),
+        pkey_password,
+        0,                      // worker_count
+        100,                    // max_requests_per_connection
+        std::chrono::seconds(5),// keep_alive_timeout
+        0                       // file_cache_size
+    );
+
+    // Over TLS, the file is sent through a buffer.
+    test_counting_https_endpoint endpoint(1, std::move(config), context.log());
+
+    abc::net::openssl::tcp_client_socket client(verify_server, abc::net::socket::family::ipv4, context.log());
+
+    passed = endpoint_file_range(context, &endpoint, &client, "31013") && passed;
+#else
+    passed = context.are_equal(0, 0, 0x10e8f) && passed;
+#endif
+
+    return passed;
+}
+
+
+// --------------------------------------------------------------
+
+
+static constexpr const char cache_file_path[] = "/resources/cache.js";
+
+
+void write_cache_file(test_context& context, const char* suffix, const std::string& content) {
+    std::string filepath = abc::parent_path(context.process_path);
+    filepath.append(cache_file_path);
+    filepath.append(suffix);
+
+    std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+    file.write(content.data(), content.size());
+}
+
+
+void age_cache_file(test_context& context, const char* suffix) {
+    std::string filepath = abc::parent_path(context.process_path);
+    filepath.append(cache_file_path);
+    filepath.append(suffix);
+
+    // Move the modification time an hour back.
+    struct stat st;
+    ::stat(filepath.c_str(), &st);
+
+    struct timespec times[2] = { st.st_atim, st.st_mtim };
+    times[1].tv_sec -= 3600;
+    ::utimensat(AT_FDCWD, filepath.c_str(), times, 0);
+}
+
+
+bool get_cache_file(test_context& context, abc::net::tcp_client_socket_streambuf& sb, const char* accept_encoding, const std::string& if_none_match, abc::net::http::status_code_t expected_status_code, const char* expected_content_encoding, const std::string& expected_body, std::string& etag, abc::diag::tag_t tag) {
+    abc::net::http::client http(&sb, context.log());
+
+    abc::net::http::request request;
+    request.method = abc::net::http::method::GET;
+    request.resource.path = cache_file_path;
+    request.protocol = abc::net::http::protocol::HTTP_11;
+    if (accept_encoding != nullptr) {
+        request.headers[abc::net::http::header::Accept_Encoding] = accept_encoding;
+    }
+    if (!if_none_match.empty()) {
+        request.headers[abc::net::http::header::If_None_Match] = if_none_match;
+    }
+
+    http.put_request(request);
+
+    abc::net::http::response response = http.get_response();
+
+    std::size_t content_length = std::strtoul(response.headers[abc::net::http::header::Content_Length].c_str(), nullptr, 10);
+    std::string body = content_length > 0 ? http.get_body(content_length) : std::string();
+
+    etag = response.headers[abc::net::http::header::ETag];
+
+    bool passed = true;
+    passed = context.are_equal(response.status_code, expected_status_code, tag, "%u") && passed;
+    passed = context.are_equal(etag.empty(), false, tag, "%d") && passed;
+    passed = context.are_equal(response.headers[abc::net::http::header::Content_Encoding].c_str(), expected_content_encoding, tag) && passed;
+    passed = context.are_equal(body.c_str(), expected_body.c_str(), tag) && passed;
+
+    return passed;
+}
+
+
+bool test_http_endpoint_file_cache(test_context& context) {
+    constexpr const char* suborigin = "test_http_endpoint_file_cache";
+    constexpr const char* server_port = "31014";
+    bool passed = true;
+
+    std::string root_dir = abc::parent_path(context.process_path);
+    ::mkdir((root_dir + "/resources").c_str(), 0755);
+
+    const std::string content("console.log('original');");
+    const std::string gzip_content("(gzip)");
+    const std::string br_content("(br)");
+    const std::string changed_content("console.log('changed content');");
+    write_cache_file(context, "", content);
+    write_cache_file(context, ".gz", gzip_content);
+    ::unlink((root_dir + cache_file_path + ".br").c_str());
+
+    abc::net::http::endpoint_config config(
+        server_port,            // port
+        5,                      // listen_queue_size
+        root_dir.c_str(),       // root_dir (Note: No trailing slash!)
+        "/resources/"           // files_prefix
+    );
+
+    test_counting_endpoint endpoint(1, std::move(config), context.log());
+
+    std::future<void> done = endpoint.start_async();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    try {
+        abc::net::tcp_client_socket client(abc::net::socket::family::ipv4, context.log());
+        client.connect("localhost", server_port);
+
+        abc::net::tcp_client_socket_streambuf sb(&client, context.log());
+
+        std::string etag;
+        std::string other_etag;
+
+        // Miss, hit, and a matching ETag.
+        passed = get_cache_file(context, sb, nullptr, "", abc::net::http::status_code::OK, "", content, etag, 0x10ea4) && passed;
+        passed = get_cache_file(context, sb, nullptr, "", abc::net::http::status_code::OK, "", content, other_etag, 0x10ea5) && passed;
+        passed = context.are_equal(other_etag.c_str(), etag.c_str(), 0x10ea6) && passed;
+        passed = get_cache_file(context, sb, nullptr, etag, abc::net::http::status_code::Not_Modified, "", "", other_etag, 0x10ea7) && passed;
+        passed = get_cache_file(context, sb, nullptr, "\"other\", W/" + etag, abc::net::http::status_code::Not_Modified, "", "", other_etag, 0x10ea8) && passed;
+
+        // Precompressed siblings.
+        passed = get_cache_file(context, sb, "gzip, deflate", "", abc::net::http::status_code::OK, "gzip", gzip_content, other_etag, 0x10ea9) && passed;
+        passed = context.are_equal(other_etag == etag, false, 0x10eaa, "%d") && passed;
+        passed = get_cache_file(context, sb, "br, gzip", "", abc::net::http::status_code::OK, "gzip", gzip_content, other_etag, 0x10eab) && passed;
+
+        write_cache_file(context, ".br", br_content);
+        passed = get_cache_file(context, sb, "gzip, br", "", abc::net::http::status_code::OK, "br", br_content, other_etag, 0x10eac) && passed;
+        passed = get_cache_file(context, sb, "gzip, br;q=0", "", abc::net::http::status_code::OK, "gzip", gzip_content, other_etag, 0x10ead) && passed;
+        passed = get_cache_file(context, sb, "identity", "", abc::net::http::status_code::OK, "", content, other_etag, 0x10eae) && passed;
+
+        // A sibling that is older than the file is stale.
+        age_cache_file(context, ".br");
+        passed = get_cache_file(context, sb, "br", "", abc::net::http::status_code::OK, "", content, other_etag, 0x10eaf) && passed;
+
+        // A changed file gets reloaded.
+        write_cache_file(context, "", changed_content);
+        passed = get_cache_file(context, sb, nullptr, etag, abc::net::http::status_code::OK, "", changed_content, other_etag, 0x10eb0) && passed;
+        passed = context.are_equal(other_etag == etag, false, 0x10eb1, "%d") && passed;
+
+        // Shut down.
+        abc::net::http::client http(&sb, context.log());
+
+        abc::net::http::request request;
+        request.method = abc::net::http::method::GET;
+        request.resource.path = "/count";
+        request.protocol = abc::net::http::protocol::HTTP_11;
+        request.headers = {
+            { abc::net::http::header::Connection, abc::net::http::connection::close },
+        };
+        http.put_request(request);
+
+        abc::net::http::response response = http.get_response();
+        passed = context.are_equal(response.status_code, abc::net::http::status_code::OK, 0x10eb2, "%u") && passed;
+    }
+    catch (const std::exception& ex) {
+        context.log()->put_any(origin, suborigin, abc::diag::severity::important, 0x10eb3, "client: EXCEPTION: %s", ex.what());
+        passed = false;
+    }
+
+    done.wait();
+
+    return passed;
+}
+
+
+bool test_http_file_cache_lru(test_context& context) {
+    bool passed = true;
+
+    std::string root_dir = abc::parent_path(context.process_path);
+    ::mkdir((root_dir + "/resources").c_str(), 0755);
+
+    write_cache_file(context, ".a", "0123456789");
+    write_cache_file(context, ".b", "abcdefghij");
+    write_cache_file(context, ".c", "ABCDEFGHIJ");
+
+    const std::string path_a = root_dir + cache_file_path + ".a";
+    const std::string path_b = root_dir + cache_file_path + ".b";
+    const std::string path_c = root_dir + cache_file_path + ".c";
+
+    // Two files fit.
+    abc::net::http::file_cache cache(25, 10, context.log());
+
+    std::shared_ptr<const abc::net::http::file_cache_entry> entry_a = cache.get(path_a);
+    std::shared_ptr<const abc::net::http::file_cache_entry> entry_b = cache.get(path_b);
+    passed = context.are_equal(entry_a != nullptr && entry_b != nullptr, true, 0x10fcf, "%d") && passed;
+    passed = context.are_equal<std::size_t>(cache.size(), 20, 0x10fd0, "%zu") && passed;
+
+    // A hit makes 'a' the most recently used, so 'b' gets evicted when 'c' is loaded.
+    passed = context.are_equal(cache.get(path_a) == entry_a, true, 0x10fd1, "%d") && passed;
+    std::shared_ptr<const abc::net::http::file_cache_entry> entry_c = cache.get(path_c);
+    passed = context.are_equal(entry_c != nullptr, true, 0x10fd2, "%d") && passed;
+    passed = context.are_equal<std::size_t>(cache.size(), 20, 0x10fd3, "%zu") && passed;
+    passed = context.are_equal(cache.get(path_a) == entry_a, true, 0x10fd4, "%d") && passed;
+
+    // 'b' gets reloaded, and 'c' gets evicted.
+    passed = context.are_equal(cache.get(path_b) == entry_b, false, 0x10fd5, "%d") && passed;
+    passed = context.are_equal(cache.get(path_a) == entry_a, true, 0x10fd6, "%d") && passed;
+    passed = context.are_equal(cache.get(path_c) == entry_c, false, 0x10fd7, "%d") && passed;
+
+    // A file that doesn't exist is not cached.
+    passed = context.are_equal(cache.get(root_dir + cache_file_path + ".missing") == nullptr, true, 0x10fd8, "%d") && passed;
+
+    cache.clear();
+    passed = context.are_equal<std::size_t>(cache.size(), 0, 0x10fd9, "%zu") && passed;
+
+    return passed;
+}
+
+
+// --------------------------------------------------------------
+
+
+bool find_route(test_context& context, const abc::net::http::router& router, const char* method, const char* path,
+                abc::net::http::route_status expected_status, const abc::net::http::route_handler* expected_handler, const char* expected_params, abc::diag::tag_t tag) {
+    abc::net::http::route_params params;
+    const abc::net::http::route_handler* handler = nullptr;
+    abc::net::http::route_status status = router.find(method, path, params, handler);
+
+    // Params are formatted as "name=value;..."
+    std::string actual_params;
+    for (std::size_t i = 0; i < params.count; i++) {
+        actual_params.append(params.names[i]).append("=").append(params.values[i].to_string()).append(";");
+    }
+
+    bool passed = true;
+    passed = context.are_equal((unsigned)status, (unsigned)expected_status, tag, "%u") && passed;
+    passed = context.are_equal(handler == expected_handler, true, tag, "%d") && passed;
+    passed = context.are_equal(actual_params.c_str(), expected_params, tag) && passed;
+
+    return passed;
+}
+
+
+bool test_http_router(test_context& context) {
+    using abc::net::http::route_status;
+    namespace method = abc::net::http::method;
+
+    abc::net::http::router router(context.log());
+
+    const abc::net::http::route_handler* handlers[7] = { };
+    const char* templates[] = {
+        "/games",
+        "/games/{game_id}",
+        "/games/current",
+        "/games/{game_id}/players/{player_id}",
+        "/games/{game_id}/players/current",
+        "/games/last/moves",
+        "/",
+    };
+
+    for (std::size_t i = 0; i < sizeof(templates) / sizeof(templates[0]); i++) {
+        router.add(method::GET, templates[i], [] (abc::net::http::server&, const abc::net::http::request&, const abc::net::http::route_params&) { });
+    }
+
+    router.add(method::POST, "/games", [] (abc::net::http::server&, const abc::net::http::request&, const abc::net::http::route_params&) { });
+    router.add(method::GET, "/players/{player_id}", [] (abc::net::http::server&, const abc::net::http::request_head&, const abc::net::http::route_params&) { });
+
+    // Get a pointer to the handler of each route. Each template matches itself as a path.
+    abc::net::http::route_params params;
+    for (std::size_t i = 0; i < sizeof(templates) / sizeof(templates[0]); i++) {
+        router.find(method::GET, templates[i], params, handlers[i]);
+    }
+
+    const abc::net::http::route_handler* post_handler = nullptr;
+    router.find(method::POST, "/games", params, post_handler);
+
+    bool passed = true;
+
+    // Literals, case-insensitively.
+    passed = find_route(context, router, method::GET, "/games", route_status::found, handlers[0], "", 0x10ee8) && passed;
+    passed = find_route(context, router, method::GET, "/GAMES", route_status::found, handlers[0], "", 0x10ee9) && passed;
+    passed = find_route(context, router, method::GET, "/", route_status::found, handlers[6], "", 0x10eea) && passed;
+
+    // A literal takes precedence over a parameter.
+    passed = find_route(context, router, method::GET, "/games/current", route_status::found, handlers[2], "", 0x10eeb) && passed;
+    passed = find_route(context, router, method::GET, "/games/12", route_status::found, handlers[1], "game_id=12;", 0x10eec) && passed;
+    passed = find_route(context, router, method::GET, "/games/12/players/current", route_status::found, handlers[4], "game_id=12;", 0x10eed) && passed;
+    passed = find_route(context, router, method::GET, "/games/12/players/34", route_status::found, handlers[3], "game_id=12;player_id=34;", 0x10eee) && passed;
+
+    // A literal that leads to a dead end falls back to a parameter.
+    passed = find_route(context, router, method::GET, "/games/last", route_status::found, handlers[1], "game_id=last;", 0x10eef) && passed;
+    passed = find_route(context, router, method::GET, "/games/last/players/5", route_status::found, handlers[3], "game_id=last;player_id=5;", 0x10ef0) && passed;
+    passed = find_route(context, router, method::GET, "/games/last/moves", route_status::found, handlers[5], "", 0x10ef1) && passed;
+
+    // No match.
+    passed = find_route(context, router, method::GET, "/games/", route_status::not_found, nullptr, "", 0x10ef2) && passed;
+    passed = find_route(context, router, method::GET, "/games/12/moves", route_status::not_found, nullptr, "", 0x10ef3) && passed;
+    passed = find_route(context, router, method::GET, "/games/12/players", route_status::not_found, nullptr, "", 0x10ef4) && passed;
+    passed = find_route(context, router, method::GET, "/other", route_status::not_found, nullptr, "", 0x10ef5) && passed;
+    passed = find_route(context, router, method::GET, "", route_status::not_found, nullptr, "", 0x10ef6) && passed;
+
+    // Methods.
+    passed = find_route(context, router, method::POST, "/games/12", route_status::method_not_allowed, nullptr, "", 0x10ef7) && passed;
+    passed = find_route(context, router, method::POST, "/games", route_status::found, post_handler, "", 0x10ef8) && passed;
+    passed = context.are_equal(post_handler != nullptr && post_handler != handlers[0], true, 0x10ef9, "%d") && passed;
+
+    // A route with a route_head_handler, found by spans.
+    passed = find_route(context, router, method::GET, "/players/5", route_status::found, nullptr, "player_id=5;", 0x10f6c) && passed;
+
+    const char target[] = "/Players/5?x=1";
+    abc::net::http::request_head head;
+    head.target = abc::net::http::span(target, sizeof(target) - 1);
+
+    const abc::net::http::route_handler* handler = nullptr;
+    const abc::net::http::route_head_handler* head_handler = nullptr;
+    route_status status = router.find(abc::net::http::span(method::GET, 3), head.path(), params, handler, head_handler);
+    passed = context.are_equal((unsigned)status, (unsigned)route_status::found, 0x10f6d, "%u") && passed;
+    passed = context.are_equal(handler == nullptr && head_handler != nullptr, true, 0x10f6e, "%d") && passed;
+    passed = context.are_equal(params.find("player_id").to_string().c_str(), "5", 0x10f6f) && passed;
+
+    status = router.find(abc::net::http::span(method::GET, 3), abc::net::http::span(templates[0], std::strlen(templates[0])), params, handler, head_handler);
+    passed = context.are_equal(handler == handlers[0] && head_handler == nullptr, true, 0x10f70, "%d") && passed;
+
+    return passed;
+}
+
+
+// --------------------------------------------------------------
+
+
+class test_routing_endpoint
+    : public abc::net::http::endpoint {
+
+    using base = abc::net::http::endpoint;
+    using diag_base = abc::diag::diag_ready<const char*>;
+
+public:
+    test_routing_endpoint(abc::net::http::endpoint_config&& config, abc::diag::log_ostream* log);
+
+protected:
+    virtual std::unique_ptr<abc::net::tcp_server_socket> create_server_socket() override;
+
+private:
+    void get_player(abc::net::http::server& http, const abc::net::http::request& request, const abc::net::http::route_params& params);
+    void get_score(abc::net::http::server& http, const abc::net::http::request_head& head, const abc::net::http::route_params& params);
+};
+
+
+inline test_routing_endpoint::test_routing_endpoint(abc::net::http::endpoint_config&& config, abc::diag::log_ostream* log)
+    : base("test_routing_endpoint", std::move(config), log) {
+
+    base::add_route(abc::net::http::method::GET, "/games",
+        [this] (abc::net::http::server& http, const abc::net::http::request& /*request*/, const abc::net::http::route_params& /*params*/) {
+            base::send_simple_response(http, abc::net::http::status_code::OK, abc::net::http::reason_phrase::OK, abc::net::http::content_type::text, "games", 0x10efa);
+        });
+
+    base::add_route(abc::net::http::method::GET, "/games/{game_id}/players/{player_id}",
+        [this] (abc::net::http::server& http, const abc::net::http::request& request, const abc::net::http::route_params& params) {
+            get_player(http, request, params);
+        });
+
+    base::add_route(abc::net::http::method::GET, "/scores/{game_id}",
+        [this] (abc::net::http::server& http, const abc::net::http::request_head& head, const abc::net::http::route_params& params) {
+            get_score(http, head, params);
+        });
+}
+
+
+inline std::unique_ptr<abc::net::tcp_server_socket> test_routing_endpoint::create_server_socket() {
+    return std::unique_ptr<abc::net::tcp_server_socket>(new abc::net::tcp_server_socket(abc::net::socket::family::ipv4, diag_base::log()));
+}
+
+
+inline void test_routing_endpoint::get_player(abc::net::http::server& http, const abc::net::http::request& /*request*/, const abc::net::http::route_params& params) {
+    constexpr const char* suborigin = "get_player";
+
+    std::string player_id = params.find("player_id").to_string();
+    base::require(suborigin, 0x10efb, player_id != "0",
+        abc::net::http::status_code::Bad_Request, abc::net::http::reason_phrase::Bad_Request, abc::net::http::content_type::text, "Invalid player_id.");
+
+    std::string body = params.find("game_id").to_string() + "/" + player_id;
+    base::send_simple_response(http, abc::net::http::status_code::OK, abc::net::http::reason_phrase::OK, abc::net::http::content_type::text, body.c_str(), 0x10efc);
+}
+
+
+inline void test_routing_endpoint::get_score(abc::net::http::server& http, const abc::net::http::request_head& head, const abc::net::http::route_params& params) {
+    constexpr const char* suborigin = "get_score";
+
+    abc::net::http::span game_id = params.find("game_id");
+    base::require(suborigin, 0x10f71, !game_id.equals_i("0"),
+        abc::net::http::status_code::Bad_Request, abc::net::http::reason_phrase::Bad_Request, abc::net::http::content_type::text, "Invalid game_id.");
+
+    std::string body = "score " + game_id.to_string() + " " + head.method.to_string();
+
+    const abc::net::http::span* score_tag = head.find_header("Z-Score-Tag");
+    if (score_tag != nullptr) {
+        body += " " + score_tag->to_string();
+    }
+
+    base::send_simple_response(http, abc::net::http::status_code::OK, abc::net::http::reason_phrase::OK, abc::net::http::content_type::text, body.c_str(), 0x10f72);
+}
+
+
+bool get_route(test_context& context, abc::net::tcp_client_socket_streambuf& sb, const char* method, const char* path, abc::net::http::status_code_t expected_status_code, const char* expected_body, abc::diag::tag_t tag) {
+    abc::net::http::client http(&sb, context.log());
+
+    abc::net::http::request request;
+    request.method = method;
+    request.resource.path = path;
+    request.protocol = abc::net::http::protocol::HTTP_11;
+    http.put_request(request);
+
+    abc::net::http::response response = http.get_response();
+    std::size_t content_length = std::strtoul(response.headers[abc::net::http::header::Content_Length].c_str(), nullptr, 10);
+    std::string body = http.get_body(content_length);
+
+    bool passed = true;
+    passed = context.are_equal(response.status_code, expected_status_code, tag, "%u") && passed;
+    if (expected_body != nullptr) {
+        passed = context.are_equal(body.c_str(), expected_body, tag) && passed;
+    }
+
+    return passed;
+}
+
+
+bool test_http_endpoint_routes(test_context& context) {
+    constexpr const char* suborigin = "test_http_endpoint_routes";
+    constexpr const char* server_port = "31015";
+    bool passed = true;
+
+    abc::net::http::endpoint_config config(
+        server_port,            // port
+        5,                      // listen_queue_size
+        context.process_path,   // root_dir (Note: No trailing slash!)
+        "/resources/"           // files_prefix
+    );
+
+    test_routing_endpoint endpoint(std::move(config), context.log());
+    std::future<void> done = endpoint.start_async();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    try {
+        abc::net::tcp_client_socket client(abc::net::socket::family::ipv4, context.log());
+        client.connect("localhost", server_port);
+
+        abc::net::tcp_client_socket_streambuf sb(&client, context.log());
+
+        passed = get_route(context, sb, abc::net::http::method::GET, "/Games", abc::net::http::status_code::OK, "games", 0x10efd) && passed;
+        passed = get_route(context, sb, abc::net::http::method::GET, "/games/7/players/42", abc::net::http::status_code::OK, "7/42", 0x10efe) && passed;
+        passed = get_route(context, sb, abc::net::http::method::GET, "/games/7/players/0", abc::net::http::status_code::Bad_Request, "Invalid player_id.", 0x10eff) && passed;
+        passed = get_route(context, sb, abc::net::http::method::POST, "/games", abc::net::http::status_code::Method_Not_Allowed, nullptr, 0x10f00) && passed;
+        passed = get_route(context, sb, abc::net::http::method::GET, "/games/7", abc::net::http::status_code::Not_Found, nullptr, 0x10f01) && passed;
+
+        // Routes with a route_head_handler.
+        passed = get_route(context, sb, abc::net::http::method::GET, "/Scores/7", abc::net::http::status_code::OK, "score 7 GET", 0x10f73) && passed;
+        passed = get_route(context, sb, abc::net::http::method::GET, "/scores/0", abc::net::http::status_code::Bad_Request, "Invalid game_id.", 0x10f74) && passed;
+        passed = get_route(context, sb, abc::net::http::method::POST, "/scores/7", abc::net::http::status_code::Method_Not_Allowed, nullptr, 0x10f75) && passed;
+
+        // A head with more headers than can be parsed in place is read as a stream, and still gets to the route_head_handler.
+        {
+            abc::net::http::client http(&sb, context.log());
+
+            abc::net::http::request request;
+            request.method = abc::net::http::method::GET;
+            request.resource.path = "/scores/8";
+            request.protocol = abc::net::http::protocol::HTTP_11;
+            for (std::size_t i = 0; i < abc::net::http::max_request_head_headers + 6; i++) {
+                request.headers[abc::strprintf("X-Filler-%03zu", i)] = "filler";
+            }
+            request.headers["Z-Score-Tag"] = "many";
+            http.put_request(request);
+
+            abc::net::http::response response = http.get_response();
+            std::size_t content_length = std::strtoul(response.headers[abc::net::http::header::Content_Length].c_str(), nullptr, 10);
+            std::string body = http.get_body(content_length);
+
+            passed = context.are_equal(response.status_code, abc::net::http::status_code::OK, 0x10fdb, "%u") && passed;
+            passed = context.are_equal(body.c_str(), "score 8 GET many", 0x10fdc) && passed;
+        }
+
+        // The default route shuts the endpoint down.
+        passed = get_route(context, sb, abc::net::http::method::POST, "/shutdown", abc::net::http::status_code::OK, nullptr, 0x10f02) && passed;
+    }
+    catch (const std::exception& ex) {
+        context.log()->put_any(origin, suborigin, abc::diag::severity::important, 0x10f03, "client: EXCEPTION: %s", ex.what());
+        passed = false;
+    }
+
+    done.wait();
+
+    return passed;
+}
+
+
+// --------------------------------------------------------------
+
+
+abc::net::http::request async_request(const char* method, const char* path) {
+    abc::net::http::request request;
+    request.method = method;
+    request.resource.path = path;
+
+    return request;
+}
+
+
+bool test_http_async_client_pool(test_context& context) {
+    constexpr const char* suborigin = "test_http_async_client_pool";
+    constexpr const char* server_port = "31016";
+    constexpr std::size_t request_count = 8;
+    constexpr std::size_t max_connections_per_host = 2;
+    bool passed = true;
+
+    abc::net::http::endpoint_config config(
+        server_port,            // port
+        5,                      // listen_queue_size
+        context.process_path,   // root_dir (Note: No trailing slash!)
+        "/resources/"           // files_prefix
+    );
+
+    test_counting_endpoint endpoint(2 * request_count, std::move(config), context.log());
+    std::future<void> done = endpoint.start_async();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    abc::net::http::async_client client(abc::net::http::async_client_config(max_connections_per_host), context.log());
+
+    try {
+        // More concurrent requests than connections, so that requests have to wait for a connection.
+        std::vector<std::future<abc::net::http::async_response>> futures;
+        for (std::size_t i = 0; i < request_count; i++) {
+            futures.push_back(client.send_async("localhost", server_port, async_request(abc::net::http::method::GET, "/count")));
+        }
+
+        for (std::future<abc::net::http::async_response>& future : futures) {
+            abc::net::http::async_response response = future.get();
+
+            passed = context.are_equal(response.response.status_code, abc::net::http::status_code::OK, 0x10f40, "%u") && passed;
+            passed = context.are_equal(response.body.c_str(), "ok", 0x10f41) && passed;
+        }
+
+        passed = context.are_equal(client.connect_count() <= max_connections_per_host, true, 0x10f42, "%d") && passed;
+
+        // The second round reuses the kept-alive connections.
+        std::size_t connect_count = client.connect_count();
+        std::atomic_size_t ok_count(0);
+        std::atomic_size_t completed_count(0);
+        std::promise<void> all_completed;
+
+        for (std::size_t i = 0; i < request_count; i++) {
+            client.send_async("localhost", server_port, async_request(abc::net::http::method::POST, "/count"), std::string("{}"),
+                [&ok_count, &completed_count, &all_completed] (std::exception_ptr error, abc::net::http::async_response&& response) {
+                    if (error == nullptr && response.response.status_code == abc::net::http::status_code::OK && response.body == "ok") {
+                        ok_count++;
+                    }
+
+                    if (++completed_count == request_count) {
+                        all_completed.set_value();
+                    }
+                });
+        }
+
+        all_completed.get_future().wait();
+
+        passed = context.are_equal(ok_count.load(), request_count, 0x10f43, "%zu") && passed;
+        passed = context.are_equal(client.connect_count(), connect_count, 0x10f44, "%zu") && passed;
+    }
+    catch (const std::exception& ex) {
+        context.log()->put_any(origin, suborigin, abc::diag::severity::important, 0x10f45, "client: EXCEPTION: %s", ex.what());
+        passed = false;
+    }
+
+    done.wait();
+
+    return passed;
+}
+
+
+std::string read_request_head(abc::net::tcp_client_socket_streambuf& sb) {
+    std::string head;
+
+    while (head.length() < 4 || head.compare(head.length() - 4, 4, "\r\n\r\n") != 0) {
+        int ch = sb.sbumpc();
+        if (ch == std::char_traits<char>::eof()) {
+            break;
+        }
+
+        head.push_back(static_cast<char>(ch));
+    }
+
+    return head;
+}
+
+
+bool test_http_async_client_framing(test_context& context) {
+    constexpr const char* suborigin = "test_http_async_client_framing";
+    constexpr const char* server_port = "31017";
+    bool passed = true;
+
+    const char response_chunked[] =
+        "HTTP/1.1 200 OK\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n"
+        "7;ext=1\r\n"
+        "hello, \r\n"
+        "5\r\n"
+        "world\r\n"
+        "0\r\n"
+        "Trailer-Name: Trailer-Value\r\n"
+        "\r\n";
+
+    const char response_head[] =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Length: 5\r\n"
+        "\r\n";
+
+    // An interim response precedes the final one, whose body ends when the connection is closed.
+    const char response_close[] =
+        "HTTP/1.1 100 Continue\r\n"
+        "\r\n"
+        "HTTP/1.1 200 OK\r\n"
+        "Connection: close\r\n"
+        "\r\n"
+        "bye";
+
+    abc::net::tcp_server_socket server(abc::net::socket::family::ipv4, context.log());
+    server.bind(server_port);
+    server.listen(5);
+
+    // A single connection, so that the requests have to wait for it one after another.
+    std::thread server_thread(
+        [&context, &server, &response_chunked, &response_head, &response_close] () {
+        try {
+            std::unique_ptr<abc::net::tcp_client_socket> connection = server.accept();
+            abc::net::tcp_client_socket_streambuf sb(connection.get(), context.log());
+
+            read_request_head(sb);
+            sb.sputn(response_chunked, sizeof(response_chunked) - 1);
+            sb.pubsync();
+
+            read_request_head(sb);
+            sb.sputn(response_head, sizeof(response_head) - 1);
+            sb.pubsync();
+
+            read_request_head(sb);
+            sb.sputn(response_close, sizeof(response_close) - 1);
+            sb.pubsync();
+        }
+        catch (const std::exception& ex) {
+            context.log()->put_any(origin, "test_http_async_client_framing", abc::diag::severity::important, 0x10f46, "server: EXCEPTION: %s", ex.what());
+        }
+    });
+
+    try {
+        abc::net::http::async_client client(abc::net::http::async_client_config(1), context.log());
+
+        std::future<abc::net::http::async_response> chunked = client.send_async("localhost", server_port, async_request(abc::net::http::method::GET, "/chunked"));
+        std::future<abc::net::http::async_response> head = client.send_async("localhost", server_port, async_request(abc::net::http::method::HEAD, "/head"));
+        std::future<abc::net::http::async_response> close = client.send_async("localhost", server_port, async_request(abc::net::http::method::GET, "/close"));
+
+        abc::net::http::async_response response = chunked.get();
+        passed = context.are_equal(response.response.status_code, abc::net::http::status_code::OK, 0x10f47, "%u") && passed;
+        passed = context.are_equal(response.body.c_str(), "hello, world", 0x10f48) && passed;
+
+        response = head.get();
+        passed = context.are_equal(response.response.status_code, abc::net::http::status_code::OK, 0x10f49, "%u") && passed;
+        passed = context.are_equal(response.body.c_str(), "", 0x10f4a) && passed;
+
+        response = close.get();
+        passed = context.are_equal(response.response.status_code, abc::net::http::status_code::OK, 0x10f4b, "%u") && passed;
+        passed = context.are_equal(response.body.c_str(), "bye", 0x10f4c) && passed;
+
+        passed = context.are_equal(client.connect_count(), (std::size_t)1, 0x10f4d, "%zu") && passed;
+    }
+    catch (const std::exception& ex) {
+        context.log()->put_any(origin, suborigin, abc::diag::severity::important, 0x10f4e, "client: EXCEPTION: %s", ex.what());
+        passed = false;
+    }
+
+    server_thread.join();
+
+    return passed;
+}
+
+
+bool test_http_async_client_errors(test_context& context) {
+    constexpr const char* suborigin = "test_http_async_client_errors";
+    constexpr const char* refused_port = "31018";
+    constexpr const char* silent_port = "31019";
+    bool passed = true;
+
+    // The listener never accepts, so connects complete but requests never get a response.
+    abc::net::tcp_server_socket server(abc::net::socket::family::ipv4, context.log());
+    server.bind(silent_port);
+    server.listen(5);
+
+    abc::net::http::async_client_config config(
+        4,                                      // max_connections_per_host
+        std::chrono::milliseconds(500),         // connect_timeout
+        std::chrono::milliseconds(300)          // request_timeout
+    );
+
+    abc::net::http::async_client client(std::move(config), context.log());
+
+    bool is_refused = false;
+    try {
+        client.send_async("localhost", refused_port, async_request(abc::net::http::method::GET, "/refused")).get();
+    }
+    catch (const std::exception& ex) {
+        context.log()->put_any(origin, suborigin, abc::diag::severity::optional, 0x10f4f, "refused: %s", ex.what());
+        is_refused = true;
+    }
+
+    passed = context.are_equal(is_refused, true, 0x10f50, "%d") && passed;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    bool is_timed_out = false;
+    try {
+        client.send_async("localhost", silent_port, async_request(abc::net::http::method::GET, "/silent")).get();
+    }
+    catch (const std::exception& ex) {
+        context.log()->put_any(origin, suborigin, abc::diag::severity::optional, 0x10f51, "timed out: %s", ex.what());
+        is_timed_out = true;
+    }
+
+    std::chrono::milliseconds elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    passed = context.are_equal(is_timed_out, true, 0x10f52, "%d") && passed;
+    passed = context.are_equal(elapsed >= std::chrono::milliseconds(300) && elapsed < std::chrono::seconds(5), true, 0x10f53, "%d") && passed;
+
+    // The host is resolved off the calling thread, and the failure is delivered through the callback.
+    std::promise<std::thread::id> unresolved_thread;
+    client.send_async("host.invalid", silent_port, async_request(abc::net::http::method::GET, "/unresolved"), std::string(),
+        [&unresolved_thread] (std::exception_ptr error, abc::net::http::async_response&& /*response*/) {
+            if (error != nullptr) {
+                unresolved_thread.set_value(std::this_thread::get_id());
+            }
+            else {
+                unresolved_thread.set_value(std::thread::id());
+            }
+        });
+
+    std::thread::id unresolved_thread_id = unresolved_thread.get_future().get();
+
+    passed = context.are_equal(unresolved_thread_id != std::thread::id(), true, 0x10ffc, "%d") && passed;
+    passed = context.are_equal(unresolved_thread_id != std::this_thread::get_id(), true, 0x10ffd, "%d") && passed;
+
+    return passed;
+}
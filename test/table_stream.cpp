@@ -24,6 +24,7 @@ SOFTWARE.
 
 
 #include <cstdio>
+#include <cstring>
 
 #include "inc/clock.h"
 #include "inc/stream.h"
@@ -278,6 +279,55 @@ bool test_log_move(test_context& context) {
 }
 
 
+class test_floor_diag
+    : protected abc::diag::diag_ready<const char*> {
+
+    using diag_base = abc::diag::diag_ready<const char*>;
+
+public:
+    test_floor_diag(abc::diag::log_ostream* log)
+        : diag_base("test_floor_diag", log) {
+    }
+
+    void put(abc::diag::severity_t severity, int& eval_count) {
+        ABC_DIAG_PUT_ANY(diag_base::put_any, "put()", severity, 93, "eval_count=%d", ++eval_count);
+    }
+};
+
+
+bool test_log_severity_floor(test_context& context) {
+    char actual[abc::size::_256 + 1] = { };
+    abc::stream::buffer_streambuf sb(nullptr, 0, 0, actual, 0, sizeof(actual) - 1);
+
+    bool passed = true;
+
+    abc::stream::table_ostream table(&sb);
+    abc::diag::test_line_ostream<test_clock> line(&table);
+    test_log_filter filter("", abc::diag::severity::debug);
+    abc::diag::log_ostream log(&line, &filter);
+
+    // The floor is a compile-time constant.
+    static_assert(abc::diag::severity::is_compiled(abc::diag::severity::critical), "critical entries are always compiled in");
+    static_assert(!abc::diag::severity::is_compiled(ABC_MIN_LOG_SEVERITY + 1), "entries below the floor are compiled out");
+
+    test_floor_diag diag(&log);
+    int eval_count = 0;
+
+    // An entry at the floor is written, and its arguments are evaluated.
+    diag.put(ABC_MIN_LOG_SEVERITY, eval_count);
+    passed = context.are_equal(eval_count, 1, 0x10fe0, "%d") && passed;
+    passed = context.are_equal(std::strstr(actual, "eval_count=1") != nullptr, true, 0x10fe1, "%d") && passed;
+
+    // An entry below the floor is neither written, nor are its arguments evaluated.
+    std::size_t actual_len = std::strlen(actual);
+    diag.put(ABC_MIN_LOG_SEVERITY + 1, eval_count);
+    passed = context.are_equal(eval_count, 1, 0x10fe2, "%d") && passed;
+    passed = context.are_equal(std::strlen(actual), actual_len, 0x10fe3, "%zu") && passed;
+
+    return passed;
+}
+
+
 bool test_line_move(test_context& context) {
     char actual[abc::size::_256 + 1] = { };
     abc::stream::buffer_streambuf sb(nullptr, 0, 0, actual, 0, sizeof(actual) - 1);
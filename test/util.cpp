@@ -31,6 +31,7 @@ bool test_util_strprintf(test_context& context) {
 
     std::string str = abc::strprintf("%d %4.4u", -23, 45);
     passed = context.are_equal(str.c_str(), "-23 0045", 0x10c70) && passed;
+    passed = context.are_equal<std::size_t>(str.size(), 8, 0x10fc0, "%zu") && passed;
 
     str = abc::strprintf("%2d %s %3d %s %4d %s", 2, "IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,",
         5, "FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE", 9, "AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER");
@@ -38,6 +39,84 @@ bool test_util_strprintf(test_context& context) {
         "  5 FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE "
         "   9 AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER", 0x10c71) && passed;
 
+    str = abc::strprintf("%s", "");
+    passed = context.are_equal<std::size_t>(str.size(), 0, 0x10fc1, "%zu") && passed;
+
+    return passed;
+}
+
+
+bool test_util_crc32c(test_context& context) {
+    bool passed = true;
+
+    passed = context.are_equal<unsigned>(abc::crc32c("", 0), 0x00000000U, 0x10d20, "0x%8.8x") && passed;
+    passed = context.are_equal<unsigned>(abc::crc32c("123456789", 9), 0xe3069283U, 0x10d21, "0x%8.8x") && passed;
+
+    // Continuation.
+    std::uint32_t crc = abc::crc32c("1234", 4);
+    passed = context.are_equal<unsigned>(abc::crc32c("56789", 5, crc), 0xe3069283U, 0x10d22, "0x%8.8x") && passed;
+
+    // 32 bytes of zeros.
+    std::uint8_t zeros[32] = { };
+    passed = context.are_equal<unsigned>(abc::crc32c(zeros, sizeof(zeros)), 0x8a9136aaU, 0x10d23, "0x%8.8x") && passed;
+
+    // The dispatched implementation matches the lookup table at every length and alignment.
+    std::uint8_t bytes[67];
+    for (std::size_t i = 0; i < sizeof(bytes); i++) {
+        bytes[i] = static_cast<std::uint8_t>(i * 37 + 11);
+    }
+
+    bool all_equal = true;
+    for (std::size_t offset = 0; offset < 8; offset++) {
+        for (std::size_t size = 0; offset + size <= sizeof(bytes); size++) {
+            std::uint32_t expected = ~abc::crc32c_update_table(~0U, bytes + offset, size);
+            all_equal = abc::crc32c(bytes + offset, size) == expected && all_equal;
+        }
+    }
+    passed = context.are_equal<bool>(all_equal, true, 0x10f59, "%d") && passed;
+
+    return passed;
+}
+
+
+bool test_util_lz4(test_context& context) {
+    bool passed = true;
+
+    constexpr std::size_t src_size = 4096;
+    std::uint8_t src[src_size];
+    std::uint8_t compressed[abc::lz4_compress_bound(src_size)];
+    std::uint8_t decompressed[src_size];
+
+    // Compressible.
+    for (std::size_t i = 0; i < src_size; i++) {
+        src[i] = static_cast<std::uint8_t>((i / 16) % 7);
+    }
+
+    std::size_t compressed_size = abc::lz4_compress(src, src_size, compressed, sizeof(compressed));
+    passed = context.are_equal<bool>(compressed_size > 0 && compressed_size < src_size / 8, true, 0x10d47, "%d") && passed;
+    passed = context.are_equal<std::size_t>(abc::lz4_decompress(compressed, compressed_size, decompressed, sizeof(decompressed)), src_size, 0x10d48, "%zu") && passed;
+    passed = context.are_equal<int>(std::memcmp(src, decompressed, src_size), 0, 0x10d49, "%d") && passed;
+
+    // Doesn't fit.
+    passed = context.are_equal<std::size_t>(abc::lz4_compress(src, src_size, compressed, compressed_size - 1), 0, 0x10d4a, "%zu") && passed;
+    passed = context.are_equal<std::size_t>(abc::lz4_decompress(compressed, compressed_size, decompressed, src_size - 1), 0, 0x10d4b, "%zu") && passed;
+
+    // Incompressible.
+    std::uint32_t seed = 12345;
+    for (std::size_t i = 0; i < src_size; i++) {
+        seed = seed * 1103515245U + 12345U;
+        src[i] = static_cast<std::uint8_t>(seed >> 24);
+    }
+
+    compressed_size = abc::lz4_compress(src, src_size, compressed, sizeof(compressed));
+    passed = context.are_equal<bool>(compressed_size >= src_size, true, 0x10d4c, "%d") && passed;
+    passed = context.are_equal<std::size_t>(abc::lz4_decompress(compressed, compressed_size, decompressed, sizeof(decompressed)), src_size, 0x10d4d, "%zu") && passed;
+    passed = context.are_equal<int>(std::memcmp(src, decompressed, src_size), 0, 0x10d4e, "%d") && passed;
+
+    // Corrupt: a match offset before the start of the output.
+    const std::uint8_t corrupt[] = { 0x10, 'a', 0x02, 0x00 };
+    passed = context.are_equal<std::size_t>(abc::lz4_decompress(corrupt, sizeof(corrupt), decompressed, sizeof(decompressed)), 0, 0x10d4f, "%zu") && passed;
+
     return passed;
 }
 
@@ -25,6 +25,7 @@ SOFTWARE.
 
 #include <array>
 #include <algorithm>
+#include <sstream>
 
 #include "inc/vmem.h"
 
@@ -38,6 +39,7 @@ constexpr std::size_t max_mapped_page_count_free   = 6;
 constexpr std::size_t max_mapped_page_count_linked = 5;
 constexpr std::size_t max_mapped_page_count_list   = 5;
 constexpr std::size_t max_mapped_page_count_map    = 6;
+constexpr std::size_t max_mapped_page_count_compact = 8;
 
 using LinkedPageData = unsigned long long;
 struct LinkedPage : abc::vmem::linked_page {
@@ -83,6 +85,15 @@ struct Key {
 };
 using Value = std::uint64_t;
 
+struct Job {
+    std::uint64_t                 priority;
+    std::array<std::uint8_t, 248> dummy;
+
+    bool operator < (const Job& other) const noexcept {
+        return priority < other.priority;
+    }
+};
+
 
 bool insert_list_items(test_context& context, abc::vmem::list<ItemMany>& list, std::size_t count);
 
@@ -243,6 +254,491 @@ bool test_vmem_pool_freepages(test_context& context) {
 }
 
 
+bool test_vmem_pool_compact(test_context& context) {
+    bool passed = true;
+
+    abc::vmem::pool_config config("out/test/pool_compact.vmem", max_mapped_page_count_compact);
+    abc::vmem::pool pool(std::move(config), context.log());
+
+    abc::vmem::list_state list_state1;
+    abc::vmem::list<ItemMany> list1(&list_state1, &pool, context.log());
+
+    abc::vmem::list_state list_state2;
+    abc::vmem::list<ItemMany> list2(&list_state2, &pool, context.log());
+
+    passed = insert_list_items(context, list1, 16) && passed;
+    passed = insert_list_items(context, list2, 16) && passed;
+    // list1: | (2) | (3) | (4) | (5) |
+    // list2: | (6) | (7) | (8) | (9) |
+
+    // Nothing to release yet.
+    passed = context.are_equal<std::size_t>(pool.compact(), 0, 0x10cf3, "%zu") && passed;
+
+    list1.clear();
+    // free: 2, 3, 4, 5
+
+    // The free pages are not at the tail.
+    passed = context.are_equal<std::size_t>(pool.compact(), 0, 0x10cf4, "%zu") && passed;
+
+    list2.compact();
+    // list2: | (2) | (3) | (4) | (5) |
+    // free: 6, 7, 8, 9
+
+    abc::vmem::list<ItemMany>::iterator itr = list2.begin();
+    for (std::size_t i = 0; i < 16; i++) {
+        passed = context.are_equal<unsigned long long>(itr->data, i, 0x10cf5, "0x%2.2llx") && passed;
+        passed = context.are_equal<unsigned long long>(itr.page_pos(), 2 + i / 4, 0x10cf6, "0x%llx") && passed;
+        itr++;
+    }
+    passed = context.are_equal<bool>(itr == list2.end(), true, 0x10cf7, "%d") && passed;
+    passed = context.are_equal<unsigned long long>(list2.back().data, 0x0f, 0x10cf8, "0x%2.2llx") && passed;
+
+    passed = context.are_equal<std::size_t>(pool.compact(), 4, 0x10cf9, "%zu") && passed;
+
+    struct stat file_stat;
+    ::stat("out/test/pool_compact.vmem", &file_stat);
+    passed = context.are_equal<long long>(file_stat.st_size, 6 * abc::vmem::page_size, 0x10cfa, "%lld") && passed;
+
+    // New pages are appended after the truncated tail.
+    abc::vmem::page page6(&pool, context.log());
+    passed = context.are_equal<unsigned long long>(page6.pos(), 6, 0x10cfb, "0x%llx") && passed;
+
+    return passed;
+}
+
+
+bool test_vmem_pool_compact_map(test_context& context) {
+    bool passed = true;
+
+    constexpr std::size_t count = 200;
+
+    abc::vmem::pool_config config("out/test/pool_compact_map.vmem", max_mapped_page_count_map);
+    abc::vmem::pool pool(std::move(config), context.log());
+
+    abc::vmem::page start_page(&pool, abc::vmem::page_pos_start, context.log());
+    abc::vmem::map<Key, Value> map(reinterpret_cast<abc::vmem::map_state*>(start_page.ptr()), &pool, context.log());
+
+    abc::vmem::list_state list_state;
+    abc::vmem::list<ItemMany> list(&list_state, &pool, context.log());
+
+    // Interleave the map pages with list pages.
+    for (std::size_t i = 0; i < count; i++) {
+        abc::vmem::map<Key, Value>::value_type item{ };
+        item.key.data = i;
+        item.value = 0x90000000 + i;
+        map.insert(item);
+
+        ItemMany list_item{ };
+        list_item.data = i;
+        list.push_back(list_item);
+    }
+
+    list.clear();
+    map.compact();
+
+    passed = context.are_equal<std::size_t>(map.size(), count, 0x10f81, "%zu") && passed;
+
+    // The key levels lead to the relocated pages.
+    for (std::size_t i = 0; i < count; i++) {
+        Key key{ };
+        key.data = i;
+
+        abc::vmem::map<Key, Value>::iterator itr = map.find(key);
+        passed = context.are_equal<bool>(itr != map.end(), true, 0x10f82, "%d") && passed;
+        passed = context.are_equal<unsigned long long>(itr->value, 0x90000000 + i, 0x10f83, "0x%llx") && passed;
+    }
+
+    // The value pages are in chain order.
+    abc::vmem::page_pos_t page_pos = abc::vmem::page_pos_nil;
+    std::size_t i = 0;
+    for (abc::vmem::map<Key, Value>::iterator itr = map.begin(); itr != map.end(); itr++, i++) {
+        passed = context.are_equal<unsigned long long>(itr->key.data, i, 0x10f84, "%llu") && passed;
+        passed = context.are_equal<bool>(page_pos == abc::vmem::page_pos_nil || page_pos <= itr.page_pos(), true, 0x10f85, "%d") && passed;
+        page_pos = itr.page_pos();
+    }
+    passed = context.are_equal<std::size_t>(i, count, 0x10f86, "%zu") && passed;
+
+    // The freed list pages have been taken, so the tail can be released.
+    passed = context.are_equal<bool>(pool.compact() > 0, true, 0x10f87, "%d") && passed;
+
+    // The map is still usable.
+    passed = context.are_equal<std::size_t>(map.erase(Key{ }), 1, 0x10f88, "%zu") && passed;
+    passed = context.are_equal<std::size_t>(map.size(), count - 1, 0x10f89, "%zu") && passed;
+
+    return passed;
+}
+
+
+bool test_vmem_pool_checksum(test_context& context) {
+    bool passed = true;
+
+    constexpr const char* file_path = "out/test/pool_checksum.vmem";
+    abc::vmem::page_pos_t page_pos = abc::vmem::page_pos_nil;
+
+    {
+        abc::vmem::pool_config config(file_path, max_mapped_page_count_min, abc::vmem::pool_option::verify_page_checksums);
+        abc::vmem::pool pool(std::move(config), context.log());
+
+        abc::vmem::page page(&pool, context.log());
+        page_pos = page.pos();
+        std::memset(page.ptr(), 0x77, abc::vmem::page_size);
+    }
+
+    abc::vmem::scrubber scrubber(file_path, std::chrono::microseconds(0), std::chrono::milliseconds(0), context.log());
+    passed = context.are_equal<std::size_t>(scrubber.scrub(), 0, 0x10d1d, "%zu") && passed;
+
+    // Corrupt a byte of the page while the pool is closed.
+    {
+        int fd = ::open(file_path, O_RDWR);
+        std::uint8_t corrupt = 0x78;
+        ::pwrite(fd, &corrupt, sizeof(corrupt), static_cast<off_t>(page_pos * abc::vmem::page_size + 100));
+        ::close(fd);
+    }
+
+    passed = context.are_equal<std::size_t>(scrubber.scrub(), 1, 0x10d1e, "%zu") && passed;
+
+    {
+        abc::vmem::pool_config config(file_path, max_mapped_page_count_min, abc::vmem::pool_option::verify_page_checksums);
+        abc::vmem::pool pool(std::move(config), context.log());
+
+        bool thrown = false;
+        try {
+            abc::vmem::page page(&pool, page_pos, context.log());
+        }
+        catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        passed = context.are_equal(thrown, true, 0x10d1f, "%d") && passed;
+    }
+
+    return passed;
+}
+
+
+bool test_vmem_pool_scrub_linked(test_context& context) {
+    bool passed = true;
+
+    constexpr const char* file_path = "out/test/pool_scrub_linked.vmem";
+    abc::vmem::page_pos_t second_page_pos = abc::vmem::page_pos_nil;
+
+    {
+        abc::vmem::pool_config config(file_path, max_mapped_page_count_list);
+        abc::vmem::pool pool(std::move(config), context.log());
+
+        abc::vmem::page start_page(&pool, abc::vmem::page_pos_start, context.log());
+        abc::vmem::list<ItemMany> list(reinterpret_cast<abc::vmem::list_state*>(start_page.ptr()), &pool, context.log());
+
+        passed = insert_list_items(context, list, 16) && passed;
+
+        abc::vmem::list<ItemMany>::iterator itr = list.begin();
+        for (std::size_t i = 0; i < 4; i++) {
+            itr++;
+        }
+        second_page_pos = itr.page_pos();
+    }
+
+    abc::vmem::scrubber scrubber(file_path, std::chrono::microseconds(0), std::chrono::milliseconds(0), context.log());
+    scrubber.add_linked_state(abc::vmem::page_pos_start, 0);
+    passed = context.are_equal<std::size_t>(scrubber.scrub(), 0, 0x10f61, "%zu") && passed;
+
+    // Break the back link of the second page while the pool is closed.
+    {
+        int fd = ::open(file_path, O_RDWR);
+        abc::vmem::page_pos_t corrupt = abc::vmem::page_pos_nil;
+        ::pwrite(fd, &corrupt, sizeof(corrupt), static_cast<off_t>(second_page_pos * abc::vmem::page_size + offsetof(abc::vmem::linked_page, prev_page_pos)));
+        ::close(fd);
+    }
+
+    passed = context.are_equal<std::size_t>(scrubber.scrub(), 1, 0x10f62, "%zu") && passed;
+
+    return passed;
+}
+
+
+bool test_vmem_pool_cold(test_context& context) {
+    bool passed = true;
+
+    constexpr const char* file_path = "out/test/pool_cold.vmem";
+    constexpr abc::vmem::page_pos_t page_count = 8;
+
+    {
+        abc::vmem::pool_config config(file_path, max_mapped_page_count_min, abc::vmem::pool_option::verify_page_checksums | abc::vmem::pool_option::compress_cold_pages);
+        abc::vmem::pool pool(std::move(config), context.log());
+
+        // Pages 2..7 - more than can be mapped at a time.
+        for (abc::vmem::page_pos_t page_pos = abc::vmem::page_pos_start + 1; page_pos < page_count; page_pos++) {
+            abc::vmem::page page(&pool, context.log());
+            passed = context.are_equal<unsigned long long>(page.pos(), page_pos, 0x10d40, "0x%llx") && passed;
+            std::memset(page.ptr(), static_cast<int>(page_pos), abc::vmem::page_size);
+        }
+
+        // Evicted pages are restored.
+        for (abc::vmem::page_pos_t page_pos = abc::vmem::page_pos_start + 1; page_pos < page_count; page_pos++) {
+            abc::vmem::page page(&pool, page_pos, context.log());
+            passed = verify_bytes(context, page.ptr(), 0, abc::vmem::page_size, static_cast<std::uint8_t>(page_pos), 0x10d41) && passed;
+        }
+
+        struct stat cold_stat;
+        ::stat(abc::vmem::cold_file_path(file_path).c_str(), &cold_stat);
+        long long cold_size = cold_stat.st_size;
+
+        // Unchanged pages are not compressed again.
+        for (abc::vmem::page_pos_t page_pos = abc::vmem::page_pos_start + 1; page_pos < page_count; page_pos++) {
+            abc::vmem::page page(&pool, page_pos, context.log());
+            passed = verify_bytes(context, page.ptr(), 0, abc::vmem::page_size, static_cast<std::uint8_t>(page_pos), 0x10f77) && passed;
+        }
+
+        ::stat(abc::vmem::cold_file_path(file_path).c_str(), &cold_stat);
+        passed = context.are_equal<long long>(cold_stat.st_size, cold_size, 0x10f78, "%lld") && passed;
+    }
+
+    struct stat file_stat;
+    ::stat(abc::vmem::cold_file_path(file_path).c_str(), &file_stat);
+    passed = context.are_equal<bool>(file_stat.st_size > 0, true, 0x10d42, "%d") && passed;
+
+    // The slots of the cold pages, which are punched out in a batch, have been punched out by the time the pool is destroyed.
+    {
+        int fd = ::open(file_path, O_RDONLY);
+        std::size_t hole_count = 0;
+        for (abc::vmem::page_pos_t page_pos = abc::vmem::page_pos_start + 1; page_pos < page_count; page_pos++) {
+            if (abc::vmem::is_page_hole(fd, page_pos)) {
+                hole_count++;
+            }
+        }
+        ::close(fd);
+
+        passed = context.are_equal<bool>(hole_count > 0, true, 0x10fdf, "%d") && passed;
+    }
+
+    abc::vmem::scrubber scrubber(file_path, std::chrono::microseconds(0), std::chrono::milliseconds(0), context.log());
+    passed = context.are_equal<std::size_t>(scrubber.scrub(), 0, 0x10d43, "%zu") && passed;
+
+    {
+        // An existing cold page file is honored even when compression is off.
+        abc::vmem::pool_config config(file_path, max_mapped_page_count_min);
+        abc::vmem::pool pool(std::move(config), context.log());
+
+        for (abc::vmem::page_pos_t page_pos = abc::vmem::page_pos_start + 1; page_pos < page_count; page_pos++) {
+            abc::vmem::page page(&pool, page_pos, context.log());
+            passed = verify_bytes(context, page.ptr(), 0, abc::vmem::page_size, static_cast<std::uint8_t>(page_pos), 0x10d44) && passed;
+        }
+
+        // Nothing is cold anymore.
+        passed = context.are_equal<std::size_t>(pool.compact(), 0, 0x10d45, "%zu") && passed;
+    }
+
+    ::stat(abc::vmem::cold_file_path(file_path).c_str(), &file_stat);
+    passed = context.are_equal<long long>(file_stat.st_size, 0, 0x10d46, "%lld") && passed;
+
+    return passed;
+}
+
+
+bool test_vmem_pool_huge(test_context& context) {
+    bool passed = true;
+
+    abc::vmem::pool_config config("out/test/pool_huge.vmem", max_mapped_page_count_fit, abc::vmem::pool_option::use_huge_pages);
+    abc::vmem::pool pool(std::move(config), context.log());
+
+    // Span two extents.
+    constexpr abc::vmem::page_pos_t page_count = abc::vmem::huge_extent_page_count + 4;
+
+    for (abc::vmem::page_pos_t page_pos = abc::vmem::page_pos_start + 1; page_pos < page_count; page_pos++) {
+        abc::vmem::page page(&pool, context.log());
+        passed = context.are_equal<unsigned long long>(page.pos(), page_pos, 0x10d60, "0x%llx") && passed;
+        std::memset(page.ptr(), static_cast<int>(page_pos % 251), abc::vmem::page_size);
+    }
+
+    for (abc::vmem::page_pos_t page_pos = abc::vmem::page_pos_start + 1; page_pos < page_count; page_pos += 37) {
+        abc::vmem::page page(&pool, page_pos, context.log());
+        passed = context.are_equal<bool>(reinterpret_cast<std::uintptr_t>(page.ptr()) % abc::vmem::page_size == 0, true, 0x10d61, "%d") && passed;
+        passed = verify_bytes(context, page.ptr(), 0, abc::vmem::page_size, static_cast<std::uint8_t>(page_pos % 251), 0x10d62) && passed;
+    }
+
+    // Huge page coverage depends on the file system and the kernel settings.
+    passed = context.are_equal<bool>(pool.huge_page_byte_count() <= 2 * abc::vmem::huge_extent_size, true, 0x10d63, "%d") && passed;
+
+    return passed;
+}
+
+
+bool test_vmem_pool_stats(test_context& context) {
+    bool passed = true;
+
+    abc::vmem::pool_config config("out/test/pool_stats.vmem", max_mapped_page_count_min);
+    abc::vmem::pool pool(std::move(config), context.log());
+
+    abc::vmem::pool_stats stats = pool.stats();
+    passed = context.are_equal<unsigned long long>(stats.grown_byte_count, 2 * abc::vmem::page_size, 0x10d65, "%llu") && passed;
+    passed = context.are_equal<unsigned>(stats.eviction_count, 0, 0x10d66, "%u") && passed;
+    passed = context.are_equal<unsigned>(stats.map_in_latency.sample_count, stats.map_miss_count, 0x10d67, "%u") && passed;
+
+    // Pages 2..7 - more than can be mapped at a time.
+    for (int i = 0; i < 6; i++) {
+        abc::vmem::page page(&pool, context.log());
+    }
+
+    stats = pool.stats();
+    passed = context.are_equal<unsigned long long>(stats.grown_byte_count, 8 * abc::vmem::page_size, 0x10d68, "%llu") && passed;
+    passed = context.are_equal<bool>(stats.eviction_count > 0, true, 0x10d69, "%d") && passed;
+    passed = context.are_equal<unsigned>(stats.msync_count, stats.eviction_count, 0x10d6a, "%u") && passed;
+    passed = context.are_equal<unsigned>(stats.map_in_latency.sample_count, stats.map_miss_count, 0x10d6b, "%u") && passed;
+    passed = context.are_equal<unsigned>(stats.eviction_latency.sample_count, stats.free_capacity_count, 0x10d6c, "%u") && passed;
+
+    unsigned long long p50 = stats.map_in_latency.percentile(50);
+    unsigned long long p100 = stats.map_in_latency.percentile(100);
+    passed = context.are_equal<bool>(p50 <= p100 && p100 == stats.map_in_latency.max_ns, true, 0x10d6d, "%d") && passed;
+
+    // Histogram buckets.
+    abc::vmem::latency_histogram histogram{ };
+    histogram.record(0);
+    histogram.record(1);
+    histogram.record(1000);
+    histogram.record(1023);
+    passed = context.are_equal<unsigned>(histogram.buckets[0], 2, 0x10d6e, "%u") && passed;
+    passed = context.are_equal<unsigned>(histogram.buckets[9], 2, 0x10d6f, "%u") && passed;
+    passed = context.are_equal<unsigned long long>(histogram.percentile(50), 1, 0x10d70, "%llu") && passed;
+    passed = context.are_equal<unsigned long long>(histogram.percentile(100), 1023, 0x10d71, "%llu") && passed;
+
+    return passed;
+}
+
+
+bool test_vmem_pool_readonly(test_context& context) {
+    bool passed = true;
+
+    constexpr const char* file_path = "out/test/pool_readonly.vmem";
+    constexpr std::size_t count = 200;
+
+    {
+        abc::vmem::pool_config config(file_path, max_mapped_page_count_map);
+        abc::vmem::pool pool(std::move(config), context.log());
+
+        abc::vmem::page start_page(&pool, abc::vmem::page_pos_start, context.log());
+        abc::vmem::map<Key, Value> map(reinterpret_cast<abc::vmem::map_state*>(start_page.ptr()), &pool, context.log());
+
+        passed = insert_map_items(context, map, count) && passed;
+    }
+
+    {
+        abc::vmem::pool_config config(file_path, max_mapped_page_count_map, abc::vmem::pool_option::read_only);
+        abc::vmem::pool pool(std::move(config), context.log());
+
+        abc::vmem::page start_page(&pool, abc::vmem::page_pos_start, context.log());
+        const abc::vmem::map<Key, Value> map(reinterpret_cast<abc::vmem::map_state*>(start_page.ptr()), &pool, context.log());
+
+        passed = context.are_equal<std::size_t>(map.size(), count, 0x10d7b, "%zu") && passed;
+
+        for (std::size_t i = 0; i < count; i += 7) {
+            Key key{ };
+            key.data = i;
+
+            abc::vmem::map<Key, Value>::const_iterator itr = map.find(key);
+            passed = context.are_equal<bool>(itr != map.cend(), true, 0x10d7c, "%d") && passed;
+            passed = context.are_equal<bool>(map.contains(key), true, 0x10d7f, "%d") && passed;
+            passed = context.are_equal<unsigned long long>(itr->value, 0x90000000 + i, 0x10d7d, "0x%llx") && passed;
+        }
+
+        // Pages cannot be allocated.
+        bool thrown = false;
+        try {
+            abc::vmem::page page(&pool, context.log());
+        }
+        catch (const std::logic_error&) {
+            thrown = true;
+        }
+        passed = context.are_equal(thrown, true, 0x10d7e, "%d") && passed;
+    }
+
+    return passed;
+}
+
+
+bool test_vmem_pool_backup(test_context& context) {
+    bool passed = true;
+
+    constexpr const char* file_path = "out/test/pool_backup.vmem";
+    constexpr const char* backup_file_path = "out/test/pool_backup_copy.vmem";
+    constexpr std::size_t count = 200;
+    constexpr std::size_t more_count = 10;
+
+    std::stringstream increment_stream;
+    std::size_t full_count = 0;
+    std::size_t increment_count = 0;
+
+    {
+        abc::vmem::pool_config config(file_path, max_mapped_page_count_map);
+        abc::vmem::pool pool(std::move(config), context.log());
+
+        abc::vmem::page start_page(&pool, abc::vmem::page_pos_start, context.log());
+        abc::vmem::map<Key, Value> map(reinterpret_cast<abc::vmem::map_state*>(start_page.ptr()), &pool, context.log());
+
+        passed = insert_map_items(context, map, count) && passed;
+
+        full_count = pool.backup_to(backup_file_path);
+
+        for (std::size_t i = count; i < count + more_count; i++) {
+            abc::vmem::map<Key, Value>::value_type item{ };
+            item.key.data = i;
+            item.value = 0x90000000 + i;
+            map.insert(item);
+        }
+
+        // Only the pages changed after the full backup should be included.
+        increment_count = pool.backup(increment_stream, true /*incremental*/);
+        passed = context.are_equal<bool>(increment_count > 0 && increment_count < full_count, true, 0x10e2b, "%d") && passed;
+    }
+
+    // The full backup is a pool file.
+    {
+        abc::vmem::pool_config config(backup_file_path, max_mapped_page_count_map, abc::vmem::pool_option::read_only);
+        abc::vmem::pool pool(std::move(config), context.log());
+
+        abc::vmem::page start_page(&pool, abc::vmem::page_pos_start, context.log());
+        const abc::vmem::map<Key, Value> map(reinterpret_cast<abc::vmem::map_state*>(start_page.ptr()), &pool, context.log());
+
+        passed = context.are_equal<std::size_t>(map.size(), count, 0x10e2c, "%zu") && passed;
+    }
+
+    {
+        abc::vmem::restorer restorer(backup_file_path, context.log());
+        std::size_t written_count = restorer.apply_increment(increment_stream);
+        passed = context.are_equal<std::size_t>(written_count, increment_count, 0x10e2d, "%zu") && passed;
+    }
+
+    // The restored copy includes the changes from the incremental backup.
+    {
+        abc::vmem::pool_config config(backup_file_path, max_mapped_page_count_map, abc::vmem::pool_option::read_only);
+        abc::vmem::pool pool(std::move(config), context.log());
+
+        abc::vmem::page start_page(&pool, abc::vmem::page_pos_start, context.log());
+        const abc::vmem::map<Key, Value> map(reinterpret_cast<abc::vmem::map_state*>(start_page.ptr()), &pool, context.log());
+
+        passed = context.are_equal<std::size_t>(map.size(), count + more_count, 0x10e2e, "%zu") && passed;
+
+        for (std::size_t i = 0; i < count + more_count; i += 7) {
+            Key key{ };
+            key.data = i;
+
+            abc::vmem::map<Key, Value>::const_iterator itr = map.find(key);
+            passed = context.are_equal<bool>(itr != map.cend(), true, 0x10e2f, "%d") && passed;
+            passed = context.are_equal<unsigned long long>(itr->value, 0x90000000 + i, 0x10e30, "0x%llx") && passed;
+        }
+
+        // A read-only pool can be backed up while pages are locked. Nothing can change through it, so the increment after a full backup is empty.
+        std::stringstream readonly_full_stream;
+        std::size_t readonly_full_count = pool.backup(readonly_full_stream);
+        passed = context.are_equal<bool>(readonly_full_count > 0, true, 0x10fc2, "%d") && passed;
+
+        std::stringstream readonly_increment_stream;
+        std::size_t readonly_increment_count = pool.backup(readonly_increment_stream, true /*incremental*/);
+        passed = context.are_equal<std::size_t>(readonly_increment_count, 0, 0x10fc3, "%zu") && passed;
+    }
+
+    return passed;
+}
+
+
 bool test_vmem_linked_mixedone(test_context& context) {
     bool passed = true;
 
@@ -930,6 +1426,248 @@ bool test_vmem_list_find(test_context& context) {
 }
 
 
+bool test_vmem_list_at(test_context& context) {
+    bool passed = true;
+
+    abc::vmem::pool_config config("out/test/list_at.vmem", max_mapped_page_count_list);
+    abc::vmem::pool pool(std::move(config), context.log());
+
+    abc::vmem::list_state list_state;
+    abc::vmem::list<ItemMany> list(&list_state, &pool, context.log());
+
+    passed = insert_list_items(context, list, 16) && passed;
+    // | (2)         | (3)         | (4)         | (5)
+    // | 00 01 02 03 | 04 05 06 07 | 08 09 0a 0b | 0c 0d 0e 0f
+
+    // operator [] and index_of()
+    for (std::size_t i = 0; i < list.size(); i++) {
+        passed = context.are_equal<unsigned long long>(list[i].data, i, 0x10ccd, "0x%2.2llx") && passed;
+
+        abc::vmem::list<ItemMany>::iterator itr = list.iterator_at(i);
+        passed = context.are_equal<std::size_t>(list.index_of(itr), i, 0x10cce, "%zu") && passed;
+    }
+    passed = context.are_equal<bool>(list.iterator_at(list.size()) == list.end(), true, 0x10ccf, "%d") && passed;
+    passed = context.are_equal<std::size_t>(list.index_of(list.end()), list.size(), 0x10cd0, "%zu") && passed;
+
+    // advance() forward across pages
+    abc::vmem::list<ItemMany>::iterator itr_expected = abc::vmem::list<ItemMany>::iterator(&list, 4U, 2U, abc::vmem::iterator_edge::none, context.log());
+    abc::vmem::list<ItemMany>::iterator itr_actual = list.advance(list.begin(), 0x0a);
+    passed = context.are_equal<bool>(itr_actual == itr_expected, true, 0x10cd1, "%d") && passed;
+
+    itr_actual = list.advance(list.rbegin(), 0x0b);
+    passed = context.are_equal<bool>(itr_actual == itr_expected, true, 0x10cd2, "%d") && passed;
+
+    itr_actual = list.advance(itr_actual, 6);
+    passed = context.are_equal<bool>(itr_actual == list.end(), true, 0x10cd3, "%d") && passed;
+
+    // advance() backward across pages
+    itr_expected = abc::vmem::list<ItemMany>::iterator(&list, 3U, 1U, abc::vmem::iterator_edge::none, context.log());
+    itr_actual = list.advance(list.end(), -0x0b);
+    passed = context.are_equal<bool>(itr_actual == itr_expected, true, 0x10cd4, "%d") && passed;
+
+    itr_actual = list.advance(list.rend(), -0x0a);
+    passed = context.are_equal<bool>(itr_actual == itr_expected, true, 0x10cd5, "%d") && passed;
+
+    itr_actual = list.advance(itr_actual, -6);
+    passed = context.are_equal<bool>(itr_actual == list.rbegin(), true, 0x10cd6, "%d") && passed;
+
+    // distance()
+    abc::vmem::list<ItemMany>::iterator itr_first = abc::vmem::list<ItemMany>::iterator(&list, 3U, 1U, abc::vmem::iterator_edge::none, context.log());
+    abc::vmem::list<ItemMany>::iterator itr_last = abc::vmem::list<ItemMany>::iterator(&list, 5U, 0U, abc::vmem::iterator_edge::none, context.log());
+    passed = context.are_equal<long long>(list.distance(itr_first, itr_last), 7, 0x10cd7, "%lld") && passed;
+    passed = context.are_equal<long long>(list.distance(itr_last, itr_first), -7, 0x10cd8, "%lld") && passed;
+    passed = context.are_equal<long long>(list.distance(list.begin(), list.end()), 16, 0x10cd9, "%lld") && passed;
+
+    // Erase to unbalance pages, and verify again.
+    list.erase(list.iterator_at(5));
+    list.erase(list.iterator_at(5));
+    list.erase(list.iterator_at(9));
+    // 00 01 02 03 04 07 08 09 0a 0c 0d 0e 0f
+
+    const unsigned long long expected[] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x07, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x0f };
+    constexpr std::size_t expected_len = sizeof(expected) / sizeof(unsigned long long);
+    passed = context.are_equal<std::size_t>(list.size(), expected_len, 0x10cda, "%zu") && passed;
+
+    for (std::size_t i = 0; i < expected_len; i++) {
+        passed = context.are_equal<unsigned long long>(list[i].data, expected[i], 0x10cdb, "0x%2.2llx") && passed;
+        passed = context.are_equal<std::size_t>(list.index_of(list.iterator_at(i)), i, 0x10cdc, "%zu") && passed;
+    }
+
+    return passed;
+}
+
+
+bool test_vmem_list_at_index(test_context& context) {
+    bool passed = true;
+
+    constexpr std::size_t count = 200;
+
+    abc::vmem::pool_config config("out/test/list_at_index.vmem", max_mapped_page_count_list);
+    abc::vmem::pool pool(std::move(config), context.log());
+
+    abc::vmem::list_state list_state;
+    abc::vmem::list<ItemMany> list(&list_state, &pool, context.log());
+
+    std::vector<std::uint64_t> expected;
+
+    ItemMany item{ };
+    for (std::size_t i = 0; i < count; i++) {
+        item.data = i;
+        list.push_back(item);
+        expected.push_back(item.data);
+    }
+
+    // Once the index is built, finding an item by index, or the index of an item, doesn't map any page.
+    passed = context.are_equal<unsigned long long>(list[0].data, 0, 0x11003, "%llu") && passed;
+
+    abc::vmem::pool_stats stats = pool.stats();
+    std::size_t map_count = stats.map_hit_count + stats.map_miss_count;
+    abc::vmem::list<ItemMany>::iterator itr_middle = list.iterator_at(count / 2);
+    std::size_t index_middle = list.index_of(itr_middle);
+    stats = pool.stats();
+    passed = context.are_equal<std::size_t>(stats.map_hit_count + stats.map_miss_count - map_count, 0, 0x11005, "%zu") && passed;
+
+    passed = context.are_equal<std::size_t>(index_middle, count / 2, 0x11004, "%zu") && passed;
+    passed = context.are_equal<unsigned long long>(itr_middle->data, count / 2, 0x1100c, "%llu") && passed;
+
+    // Insert and erase at pseudo-random positions, so that pages get split and merged, while the index is kept up to date.
+    std::uint32_t seed = 12345;
+    for (std::size_t i = 0; i < 2 * count; i++) {
+        seed = seed * 1103515245 + 12345;
+        std::size_t index = (seed >> 8) % (expected.size() + 1);
+
+        if ((seed >> 4) % 3 != 0) {
+            item.data = 0x1000 + i;
+            list.insert(list.iterator_at(index), item);
+            expected.insert(expected.begin() + index, item.data);
+        }
+        else if (index < expected.size()) {
+            list.erase(list.iterator_at(index));
+            expected.erase(expected.begin() + index);
+        }
+
+        std::size_t probe = index < expected.size() ? index : expected.size() - 1;
+        passed = context.are_equal<unsigned long long>(list[probe].data, expected[probe], 0x11006, "0x%llx") && passed;
+    }
+
+    passed = context.are_equal<std::size_t>(list.size(), expected.size(), 0x11007, "%zu") && passed;
+
+    std::size_t i = 0;
+    for (abc::vmem::list<ItemMany>::const_iterator itr = list.cbegin(); itr != list.cend(); itr++, i++) {
+        passed = context.are_equal<unsigned long long>(itr->data, expected[i], 0x11008, "0x%llx") && passed;
+        passed = context.are_equal<std::size_t>(list.index_of(itr), i, 0x11009, "%zu") && passed;
+    }
+
+    // Changes made through another instance over the same state are picked up.
+    {
+        abc::vmem::list<ItemMany> other_list(&list_state, &pool, context.log());
+        for (std::size_t j = 0; j < 10; j++) {
+            item.data = 0x2000 + j;
+            other_list.push_front(item);
+            expected.insert(expected.begin(), item.data);
+        }
+        other_list.erase(other_list.begin());
+        expected.erase(expected.begin());
+    }
+
+    for (std::size_t j = 0; j < expected.size(); j += 7) {
+        passed = context.are_equal<unsigned long long>(list[j].data, expected[j], 0x1100a, "0x%llx") && passed;
+    }
+
+    passed = context.are_equal<long long>(list.distance(list.begin(), list.end()), static_cast<long long>(expected.size()), 0x1100b, "%lld") && passed;
+
+    list.clear();
+
+    return passed;
+}
+
+
+bool test_vmem_vector_at(test_context& context) {
+    bool passed = true;
+
+    abc::vmem::pool_config config("out/test/vector_at.vmem", max_mapped_page_count_list);
+    abc::vmem::pool pool(std::move(config), context.log());
+
+    abc::vmem::vector_state vector_state;
+    abc::vmem::vector<ItemMany> vector(&vector_state, &pool, context.log());
+
+    // Enough item pages for two page index levels.
+    const std::size_t count = (abc::vmem::stack<abc::vmem::page_pos_t>::page_capacity() + 8) * abc::vmem::vector<ItemMany>::page_capacity();
+
+    for (std::size_t i = 0; i < count; i++) {
+        ItemMany item{ };
+        item.data = i;
+        vector.push_back(item);
+    }
+    passed = context.are_equal<std::size_t>(vector.size(), count, 0x10fa5, "%zu") && passed;
+    passed = context.are_equal<std::size_t>(vector_state.page_levels.total_item_count, 2, 0x10fa6, "%zu") && passed;
+
+    // operator [] and index_of()
+    std::size_t i = 0;
+    for (abc::vmem::vector<ItemMany>::iterator itr = vector.begin(); itr != vector.end(); itr++, i++) {
+        passed = context.are_equal<unsigned long long>(itr->data, i, 0x10fa7, "0x%llx") && passed;
+        passed = context.are_equal<std::size_t>(vector.index_of(itr), i, 0x10fa8, "%zu") && passed;
+    }
+
+    for (i = 0; i < count; i += 37) {
+        passed = context.are_equal<unsigned long long>(vector[i].data, i, 0x10fa9, "0x%llx") && passed;
+        passed = context.are_equal<std::size_t>(vector.index_of(vector.iterator_at(i)), i, 0x10faa, "%zu") && passed;
+    }
+    passed = context.are_equal<bool>(vector.iterator_at(count) == vector.end(), true, 0x10fab, "%d") && passed;
+    passed = context.are_equal<std::size_t>(vector.index_of(vector.end()), count, 0x10fac, "%zu") && passed;
+
+    // One page per level, plus the level stack and the item page - regardless of the index.
+    abc::vmem::pool_stats stats = pool.stats();
+    unsigned map_count = stats.map_hit_count + stats.map_miss_count;
+    passed = context.are_equal<unsigned long long>(vector[5].data, 5, 0x10fad, "0x%llx") && passed;
+    stats = pool.stats();
+    unsigned front_map_count = stats.map_hit_count + stats.map_miss_count - map_count;
+
+    map_count = stats.map_hit_count + stats.map_miss_count;
+    passed = context.are_equal<unsigned long long>(vector[count - 5].data, count - 5, 0x10fae, "0x%llx") && passed;
+    stats = pool.stats();
+    unsigned back_map_count = stats.map_hit_count + stats.map_miss_count - map_count;
+
+    passed = context.are_equal<unsigned>(back_map_count, front_map_count, 0x10faf, "%u") && passed;
+    passed = context.are_equal<bool>(back_map_count <= 5, true, 0x10fb0, "%d") && passed;
+
+    // advance() and distance()
+    passed = context.are_equal<unsigned long long>(vector.advance(vector.begin(), 1000)->data, 1000, 0x10fb1, "0x%llx") && passed;
+    passed = context.are_equal<unsigned long long>(vector.advance(vector.end(), -1)->data, count - 1, 0x10fb2, "0x%llx") && passed;
+    passed = context.are_equal<unsigned long long>(vector.advance(vector.iterator_at(1000), -999)->data, 1, 0x10fb3, "0x%llx") && passed;
+    passed = context.are_equal<bool>(vector.advance(vector.rbegin(), 1) == vector.begin(), true, 0x10fb4, "%d") && passed;
+    passed = context.are_equal<bool>(vector.advance(vector.begin(), -1) == vector.rbegin(), true, 0x10fb5, "%d") && passed;
+    passed = context.are_equal<bool>(vector.advance(vector.begin(), static_cast<std::ptrdiff_t>(count)) == vector.end(), true, 0x10fb6, "%d") && passed;
+    passed = context.are_equal<long long>(vector.distance(vector.iterator_at(10), vector.iterator_at(2000)), 1990, 0x10fb7, "%lld") && passed;
+    passed = context.are_equal<long long>(vector.distance(vector.begin(), vector.end()), static_cast<long long>(count), 0x10fb8, "%lld") && passed;
+
+    // Pop down to two pages, then to one. The page index levels go away.
+    while (vector.size() > abc::vmem::vector<ItemMany>::page_capacity() + 1) {
+        vector.pop_back();
+    }
+    passed = context.are_equal<std::size_t>(vector_state.page_levels.total_item_count, 1, 0x10fb9, "%zu") && passed;
+    passed = context.are_equal<unsigned long long>(vector[vector.size() - 1].data, vector.size() - 1, 0x10fba, "0x%llx") && passed;
+
+    vector.pop_back();
+    passed = context.are_equal<std::size_t>(vector_state.page_levels.total_item_count, 0, 0x10fbb, "%zu") && passed;
+    passed = context.are_equal<unsigned long long>(vector[2].data, 2, 0x10fbc, "0x%llx") && passed;
+
+    // Grow again, and clear.
+    for (i = vector.size(); i < 3 * abc::vmem::vector<ItemMany>::page_capacity(); i++) {
+        ItemMany item{ };
+        item.data = i;
+        vector.push_back(item);
+    }
+    passed = context.are_equal<unsigned long long>(vector[2 * abc::vmem::vector<ItemMany>::page_capacity() + 1].data, 2 * abc::vmem::vector<ItemMany>::page_capacity() + 1, 0x10fbd, "0x%llx") && passed;
+
+    vector.clear();
+    passed = context.are_equal<bool>(vector.empty(), true, 0x10fbe, "%d") && passed;
+    passed = context.are_equal<std::size_t>(vector_state.page_levels.total_item_count, 0, 0x10fbf, "%zu") && passed;
+
+    return passed;
+}
+
+
 bool test_vmem_temp_destructor(test_context& context) {
     bool passed = true;
 
@@ -965,6 +1703,269 @@ bool test_vmem_temp_destructor(test_context& context) {
 }
 
 
+bool test_vmem_log(test_context& context) {
+    bool passed = true;
+
+    constexpr const char* file_path = "out/test/log.vmem";
+    constexpr std::size_t count = 50;
+    constexpr std::size_t page_capacity = abc::vmem::log<ItemMany>::page_capacity();
+
+    {
+        abc::vmem::pool_config config(file_path, max_mapped_page_count_min);
+        abc::vmem::pool pool(std::move(config), context.log());
+
+        abc::vmem::page start_page(&pool, abc::vmem::page_pos_start, context.log());
+        abc::vmem::log<ItemMany> log(reinterpret_cast<abc::vmem::log_state*>(start_page.ptr()), &pool, context.log());
+
+        passed = context.are_equal<bool>(log.empty(), true, 0x10dcf, "%d") && passed;
+
+        ItemMany item{ };
+        for (std::size_t i = 0; i < count; i++) {
+            item.data = 0x5000 + i;
+            abc::vmem::seq_t seq = log.push_back(item);
+            passed = context.are_equal<unsigned long long>(seq, i, 0x10dd0, "%llu") && passed;
+        }
+
+        passed = context.are_equal<std::size_t>(log.size(), count, 0x10dd1, "%zu") && passed;
+
+        for (std::size_t i = 0; i < count; i += 7) {
+            passed = context.are_equal<unsigned long long>(log.at(i).data, 0x5000 + i, 0x10dd2, "0x%llx") && passed;
+        }
+
+        // Read across pages, past the end.
+        ItemMany items[20];
+        std::size_t read_count = log.read(count - 15, items, 20);
+        passed = context.are_equal<std::size_t>(read_count, 15, 0x10dd3, "%zu") && passed;
+        for (std::size_t i = 0; i < read_count; i++) {
+            passed = context.are_equal<unsigned long long>(items[i].data, 0x5000 + count - 15 + i, 0x10dd4, "0x%llx") && passed;
+        }
+
+        // Only whole pages are truncated.
+        log.truncate_front(2 * page_capacity + 1);
+        passed = context.are_equal<unsigned long long>(log.front_seq(), 2 * page_capacity, 0x10dd5, "%llu") && passed;
+        passed = context.are_equal<std::size_t>(log.size(), count - 2 * page_capacity, 0x10dd6, "%zu") && passed;
+        passed = context.are_equal<unsigned long long>(log.at(log.front_seq()).data, 0x5000 + 2 * page_capacity, 0x10dd7, "0x%llx") && passed;
+    }
+
+    // Reopen.
+    {
+        abc::vmem::pool_config config(file_path, max_mapped_page_count_min);
+        abc::vmem::pool pool(std::move(config), context.log());
+
+        abc::vmem::page start_page(&pool, abc::vmem::page_pos_start, context.log());
+        abc::vmem::log<ItemMany> log(reinterpret_cast<abc::vmem::log_state*>(start_page.ptr()), &pool, context.log());
+
+        passed = context.are_equal<unsigned long long>(log.front_seq(), 2 * page_capacity, 0x10dd8, "%llu") && passed;
+        passed = context.are_equal<unsigned long long>(log.next_seq(), count, 0x10dd9, "%llu") && passed;
+
+        ItemMany item{ };
+        item.data = 0x5000 + count;
+        passed = context.are_equal<unsigned long long>(log.push_back(item), count, 0x10dda, "%llu") && passed;
+        passed = context.are_equal<unsigned long long>(log.at(count).data, 0x5000 + count, 0x10ddb, "0x%llx") && passed;
+
+        // Truncate everything.
+        log.truncate_front(log.next_seq());
+        passed = context.are_equal<bool>(log.empty(), true, 0x10ddc, "%d") && passed;
+        passed = context.are_equal<unsigned long long>(log.front_seq(), count + 1, 0x10ddd, "%llu") && passed;
+
+        // Sequence numbers are not reused.
+        passed = context.are_equal<unsigned long long>(log.push_back(item), count + 1, 0x10dde, "%llu") && passed;
+
+        log.clear();
+        passed = context.are_equal<bool>(log.empty(), true, 0x10ddf, "%d") && passed;
+        passed = context.are_equal<unsigned long long>(log.next_seq(), count + 2, 0x10de0, "%llu") && passed;
+    }
+
+    // Sequence number addressing maps only the page of the item, regardless of where the item is.
+    {
+        constexpr std::size_t many_count = 40 * page_capacity + 3;
+
+        abc::vmem::pool_config config("out/test/log_index.vmem", max_mapped_page_count_fit);
+        abc::vmem::pool pool(std::move(config), context.log());
+
+        abc::vmem::page start_page(&pool, abc::vmem::page_pos_start, context.log());
+        abc::vmem::log_state* state = reinterpret_cast<abc::vmem::log_state*>(start_page.ptr());
+        abc::vmem::log<ItemMany> log(state, &pool, context.log());
+
+        ItemMany item{ };
+        for (std::size_t i = 0; i < many_count; i++) {
+            item.data = 0x6000 + i;
+            log.push_back(item);
+        }
+
+        std::size_t map_counts[3];
+        const std::size_t seqs[3] = { 1, many_count / 2, many_count - page_capacity - 1 };
+        for (std::size_t i = 0; i < 3; i++) {
+            abc::vmem::pool_stats stats = pool.stats();
+            std::size_t map_count = stats.map_hit_count + stats.map_miss_count;
+            passed = context.are_equal<unsigned long long>(log.at(seqs[i]).data, 0x6000 + seqs[i], 0x10fe7, "0x%llx") && passed;
+            stats = pool.stats();
+            map_counts[i] = stats.map_hit_count + stats.map_miss_count - map_count;
+        }
+        passed = context.are_equal<std::size_t>(map_counts[0], 1, 0x10fe8, "%zu") && passed;
+        passed = context.are_equal<std::size_t>(map_counts[1], 1, 0x10fe9, "%zu") && passed;
+        passed = context.are_equal<std::size_t>(map_counts[2], 1, 0x10fea, "%zu") && passed;
+
+        // Another instance over the same state appends and truncates. The index follows.
+        {
+            abc::vmem::log<ItemMany> other_log(state, &pool, context.log());
+            for (std::size_t i = many_count; i < many_count + page_capacity; i++) {
+                item.data = 0x6000 + i;
+                other_log.push_back(item);
+            }
+
+            other_log.truncate_front(3 * page_capacity);
+        }
+
+        passed = context.are_equal<unsigned long long>(log.front_seq(), 3 * page_capacity, 0x10feb, "%llu") && passed;
+        passed = context.are_equal<unsigned long long>(log.at(3 * page_capacity).data, 0x6000 + 3 * page_capacity, 0x10fec, "0x%llx") && passed;
+        passed = context.are_equal<unsigned long long>(log.at(many_count + page_capacity - 1).data, 0x6000 + many_count + page_capacity - 1, 0x10fed, "0x%llx") && passed;
+
+        // Another instance clears the log, and starts over.
+        {
+            abc::vmem::log<ItemMany> other_log(state, &pool, context.log());
+            other_log.clear();
+
+            item.data = 0x7000;
+            other_log.push_back(item);
+        }
+
+        passed = context.are_equal<unsigned long long>(log.at(many_count + page_capacity).data, 0x7000, 0x10fee, "0x%llx") && passed;
+
+        log.clear();
+    }
+
+    return passed;
+}
+
+
+bool test_vmem_priority_queue(test_context& context) {
+    bool passed = true;
+
+    constexpr const char* file_path = "out/test/priority_queue.vmem";
+    constexpr std::size_t count = 1000;
+
+    // Pseudo-random priorities with duplicates.
+    std::uint64_t seed = 0x1234;
+    auto next_priority = [&seed] () -> std::uint64_t {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (seed >> 33) % 500;
+    };
+
+    {
+        abc::vmem::pool_config config(file_path, max_mapped_page_count_min);
+        abc::vmem::pool pool(std::move(config), context.log());
+
+        abc::vmem::page start_page(&pool, abc::vmem::page_pos_start, context.log());
+        abc::vmem::priority_queue<Job> queue(reinterpret_cast<abc::vmem::priority_queue_state*>(start_page.ptr()), &pool, context.log());
+
+        passed = context.are_equal<bool>(queue.empty(), true, 0x10dac, "%d") && passed;
+
+        Job job{ };
+        for (std::size_t i = 0; i < count; i++) {
+            job.priority = next_priority();
+            queue.push(job);
+        }
+
+        passed = context.are_equal<std::size_t>(queue.size(), count, 0x10dad, "%zu") && passed;
+
+        // Interleave - pop one, push one.
+        std::uint64_t prev_priority = 0;
+        for (std::size_t i = 0; i < count / 2; i++) {
+            Job top = queue.top();
+            passed = context.are_equal<bool>(prev_priority <= top.priority, true, 0x10dae, "%d") && passed;
+            queue.pop();
+
+            // Keep the pushed items not less than the popped ones, so the order must still be non-decreasing.
+            job.priority = top.priority + next_priority();
+            queue.push(job);
+            prev_priority = top.priority;
+        }
+
+        passed = context.are_equal<std::size_t>(queue.size(), count, 0x10daf, "%zu") && passed;
+    }
+
+    // Reopen, and drain.
+    {
+        abc::vmem::pool_config config(file_path, max_mapped_page_count_min);
+        abc::vmem::pool pool(std::move(config), context.log());
+
+        abc::vmem::page start_page(&pool, abc::vmem::page_pos_start, context.log());
+        abc::vmem::priority_queue<Job> queue(reinterpret_cast<abc::vmem::priority_queue_state*>(start_page.ptr()), &pool, context.log());
+
+        passed = context.are_equal<std::size_t>(queue.size(), count, 0x10db0, "%zu") && passed;
+
+        std::uint64_t prev_priority = 0;
+        std::size_t popped = 0;
+        for (; !queue.empty(); popped++) {
+            Job top = queue.top();
+            passed = context.are_equal<bool>(prev_priority <= top.priority, true, 0x10db1, "%d") && passed;
+            queue.pop();
+            prev_priority = top.priority;
+        }
+
+        passed = context.are_equal<std::size_t>(popped, count, 0x10db2, "%zu") && passed;
+
+        // Refill - the freed pages must be reused.
+        Job job{ };
+        for (std::size_t i = 0; i < count; i++) {
+            job.priority = next_priority();
+            queue.push(job);
+        }
+
+        abc::vmem::pool_stats stats = pool.stats();
+        passed = context.are_equal<unsigned long long>(stats.grown_byte_count, 0, 0x10db3, "%llu") && passed;
+
+        queue.clear();
+        passed = context.are_equal<bool>(queue.empty(), true, 0x10db4, "%d") && passed;
+    }
+
+    return passed;
+}
+
+
+bool test_vmem_priority_queue_even_capacity(test_context& context) {
+    bool passed = true;
+
+    // std::uint64_t gives an even page capacity, where the last in-page child has a sibling on a child page.
+    constexpr const char* file_path = "out/test/priority_queue_even.vmem";
+    constexpr std::size_t count = 20000;
+
+    std::uint64_t seed = 0x5678;
+    auto next_priority = [&seed] () -> std::uint64_t {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return seed >> 16;
+    };
+
+    abc::vmem::pool_config config(file_path, max_mapped_page_count_min);
+    abc::vmem::pool pool(std::move(config), context.log());
+
+    abc::vmem::page start_page(&pool, abc::vmem::page_pos_start, context.log());
+    abc::vmem::priority_queue<std::uint64_t> queue(reinterpret_cast<abc::vmem::priority_queue_state*>(start_page.ptr()), &pool, context.log());
+
+    for (std::size_t i = 0; i < count; i++) {
+        queue.push(next_priority());
+    }
+
+    std::size_t out_of_order = 0;
+    std::size_t popped = 0;
+    for (std::uint64_t prev = 0; !queue.empty(); popped++) {
+        std::uint64_t top = queue.top();
+        if (top < prev) {
+            out_of_order++;
+        }
+
+        queue.pop();
+        prev = top;
+    }
+
+    passed = context.are_equal<std::size_t>(out_of_order, 0, 0x10f55, "%zu") && passed;
+    passed = context.are_equal<std::size_t>(popped, count, 0x10f56, "%zu") && passed;
+
+    return passed;
+}
+
+
 bool test_vmem_map_insert(test_context& context) {
     using Iterator = abc::vmem::map<Key, Value>::const_iterator;
     using IteratorBool = std::pair<Iterator, bool>;
@@ -1652,6 +2653,202 @@ bool test_vmem_map_clear(test_context& context) {
 }
 
 
+bool test_vmem_map_bounds(test_context& context) {
+    bool passed = true;
+
+    abc::vmem::pool_config config("out/test/map_bounds.vmem", max_mapped_page_count_map);
+    abc::vmem::pool pool(std::move(config), context.log());
+
+    abc::vmem::map_state map_state;
+    abc::vmem::map<Key, Value> map(&map_state, &pool, context.log());
+    const abc::vmem::map<Key, Value>& cmap = map;
+
+    constexpr std::size_t count = 60;
+    auto make_key = [] (std::uint64_t data) -> Key {
+        Key key{ };
+        key.data = data;
+        return key;
+    };
+
+    // Empty map.
+    passed = context.are_equal<bool>(map.lower_bound(make_key(0)) == map.end(), true, 0x10e03, "%d") && passed;
+    passed = context.are_equal<bool>(map.find_range(make_key(0), make_key(10)).empty(), true, 0x10e04, "%d") && passed;
+
+    // Even keys only.
+    for (std::size_t i = 0; i < count; i++) {
+        abc::vmem::map<Key, Value>::value_type item;
+        item.key = make_key(2 * i);
+        item.value = 0x90000000 + 2 * i;
+        map.insert(item);
+    }
+
+    for (std::uint64_t data = 0; data <= 2 * count; data++) {
+        std::uint64_t expected_lower = (data + 1) / 2 * 2;
+        std::uint64_t expected_upper = data / 2 * 2 + 2;
+
+        abc::vmem::map<Key, Value>::const_iterator lower = cmap.lower_bound(make_key(data));
+        if (expected_lower < 2 * count) {
+            passed = context.are_equal<bool>(lower != cmap.cend(), true, 0x10e05, "%d") && passed;
+            passed = context.are_equal<unsigned long long>(lower->key.data, expected_lower, 0x10e06, "%llu") && passed;
+        }
+        else {
+            passed = context.are_equal<bool>(lower == cmap.cend(), true, 0x10e07, "%d") && passed;
+        }
+
+        abc::vmem::map<Key, Value>::iterator upper = map.upper_bound(make_key(data));
+        if (expected_upper < 2 * count) {
+            passed = context.are_equal<bool>(upper != map.end(), true, 0x10e08, "%d") && passed;
+            passed = context.are_equal<unsigned long long>(upper->key.data, expected_upper, 0x10e09, "%llu") && passed;
+        }
+        else {
+            passed = context.are_equal<bool>(upper == map.end(), true, 0x10e0a, "%d") && passed;
+        }
+
+        abc::vmem::map<Key, Value>::range equal = map.equal_range(make_key(data));
+        passed = context.are_equal<bool>(equal.empty(), data % 2 != 0 || data >= 2 * count, 0x10e0b, "%d") && passed;
+    }
+
+    // Bounded range.
+    std::uint64_t expected_data = 10;
+    for (const abc::vmem::map<Key, Value>::value_type& item : cmap.find_range(make_key(9), make_key(31))) {
+        passed = context.are_equal<unsigned long long>(item.key.data, expected_data, 0x10e0c, "%llu") && passed;
+        passed = context.are_equal<unsigned long long>(item.value, 0x90000000 + expected_data, 0x10e0d, "0x%llx") && passed;
+        expected_data += 2;
+    }
+    passed = context.are_equal<unsigned long long>(expected_data, 32, 0x10e0e, "%llu") && passed;
+
+    // Range to the end.
+    std::size_t tail_count = 0;
+    for (const abc::vmem::map<Key, Value>::value_type& item : map.find_range(make_key(2 * count - 10), make_key(3 * count))) {
+        passed = context.are_equal<bool>(item.key.data >= 2 * count - 10, true, 0x10e0f, "%d") && passed;
+        tail_count++;
+    }
+    passed = context.are_equal<std::size_t>(tail_count, 5, 0x10e10, "%zu") && passed;
+
+    map.clear();
+
+    return passed;
+}
+
+
+bool test_vmem_map_indexed(test_context& context) {
+    bool passed = true;
+
+    struct Employee {
+        std::uint32_t dept;
+        std::uint64_t salary;
+    };
+
+    struct States {
+        abc::vmem::map_state employees;
+        abc::vmem::map_state by_dept;
+        abc::vmem::map_state by_salary;
+    };
+
+    using EmployeeMap = abc::vmem::indexed_map<std::uint64_t, Employee>;
+
+    constexpr const char* file_path = "out/test/map_indexed.vmem";
+    constexpr std::size_t count = 100;
+
+    auto dept_of = [] (const std::uint64_t& /*id*/, const Employee& employee) -> std::uint32_t { return employee.dept; };
+    auto salary_of = [] (const std::uint64_t& /*id*/, const Employee& employee) -> std::uint64_t { return employee.salary; };
+
+    {
+        abc::vmem::pool_config config(file_path, max_mapped_page_count_map);
+        abc::vmem::pool pool(std::move(config), context.log());
+
+        abc::vmem::page start_page(&pool, abc::vmem::page_pos_start, context.log());
+        States* states = reinterpret_cast<States*>(start_page.ptr());
+
+        EmployeeMap employees(&states->employees, &pool, context.log());
+        abc::vmem::map_index<std::uint64_t, Employee, std::uint32_t>* by_dept = employees.add_index<std::uint32_t>(&states->by_dept, dept_of);
+
+        abc::vmem::list_state list_state;
+        abc::vmem::list<ItemMany> list(&list_state, &pool, context.log());
+
+        // Interleave the map pages with list pages.
+        for (std::size_t i = 0; i < count; i++) {
+            EmployeeMap::value_type item;
+            item.key = i;
+            item.value.dept = static_cast<std::uint32_t>(i % 5);
+            item.value.salary = 1000 + (i * 37) % 100;
+            passed = context.are_equal<bool>(employees.insert(item).second, true, 0x10df1, "%d") && passed;
+
+            ItemMany list_item{ };
+            list_item.data = i;
+            list.push_back(list_item);
+        }
+
+        passed = context.are_equal<std::size_t>(by_dept->size(), count, 0x10df2, "%zu") && passed;
+        passed = context.are_equal<std::size_t>(by_dept->count(3), count / 5, 0x10df3, "%zu") && passed;
+
+        // Built from the existing items.
+        abc::vmem::map_index<std::uint64_t, Employee, std::uint64_t>* by_salary = employees.add_index<std::uint64_t>(&states->by_salary, salary_of);
+        passed = context.are_equal<std::size_t>(by_salary->size(), count, 0x10df4, "%zu") && passed;
+
+        // Range query - salaries in [1010, 1020).
+        std::size_t range_count = 0;
+        std::uint64_t prev_salary = 1010;
+        for (auto itr = by_salary->lower_bound(1010); itr != by_salary->lower_bound(1020); itr++) {
+            passed = context.are_equal<bool>(prev_salary <= itr->key.index_key && itr->key.index_key < 1020, true, 0x10df5, "%d") && passed;
+            passed = context.are_equal<unsigned long long>(employees.find(itr->key.key)->value.salary, itr->key.index_key, 0x10df6, "%llu") && passed;
+            prev_salary = itr->key.index_key;
+            range_count++;
+        }
+        passed = context.are_equal<std::size_t>(range_count, 10, 0x10df7, "%zu") && passed;
+
+        // Erase all employees of dept 3.
+        for (std::size_t i = 3; i < count; i += 5) {
+            passed = context.are_equal<std::size_t>(employees.erase(i), 1, 0x10df8, "%zu") && passed;
+        }
+
+        passed = context.are_equal<std::size_t>(by_dept->count(3), 0, 0x10df9, "%zu") && passed;
+        passed = context.are_equal<std::size_t>(by_dept->size(), count - count / 5, 0x10dfa, "%zu") && passed;
+        passed = context.are_equal<std::size_t>(by_salary->size(), count - count / 5, 0x10dfb, "%zu") && passed;
+
+        // Compact the map together with its indexes.
+        list.clear();
+        employees.compact();
+
+        passed = context.are_equal<std::size_t>(employees.size(), count - count / 5, 0x10ff1, "%zu") && passed;
+        passed = context.are_equal<std::size_t>(by_dept->count(2), count / 5, 0x10ff2, "%zu") && passed;
+
+        std::size_t dept_count = 0;
+        for (auto itr = by_dept->lower_bound(2); itr != by_dept->upper_bound(2); itr++) {
+            EmployeeMap::const_iterator employee_itr = employees.find(itr->key.key);
+            passed = context.are_equal<bool>(employee_itr != employees.end(), true, 0x10ff3, "%d") && passed;
+            passed = context.are_equal<unsigned>(employee_itr->value.dept, 2, 0x10ff4, "%u") && passed;
+            dept_count++;
+        }
+        passed = context.are_equal<std::size_t>(dept_count, count / 5, 0x10ff5, "%zu") && passed;
+
+        // The freed list pages have been taken, so the tail can be released.
+        passed = context.are_equal<bool>(pool.compact() > 0, true, 0x10ff6, "%d") && passed;
+    }
+
+    // Reopen - the indexes are not rebuilt.
+    {
+        abc::vmem::pool_config config(file_path, max_mapped_page_count_map);
+        abc::vmem::pool pool(std::move(config), context.log());
+
+        abc::vmem::page start_page(&pool, abc::vmem::page_pos_start, context.log());
+        States* states = reinterpret_cast<States*>(start_page.ptr());
+
+        EmployeeMap employees(&states->employees, &pool, context.log());
+        abc::vmem::map_index<std::uint64_t, Employee, std::uint32_t>* by_dept = employees.add_index<std::uint32_t>(&states->by_dept, dept_of);
+        abc::vmem::map_index<std::uint64_t, Employee, std::uint64_t>* by_salary = employees.add_index<std::uint64_t>(&states->by_salary, salary_of);
+
+        passed = context.are_equal<std::size_t>(by_dept->count(1), count / 5, 0x10dfc, "%zu") && passed;
+
+        employees.clear();
+        passed = context.are_equal<bool>(by_dept->empty(), true, 0x10dfd, "%d") && passed;
+        passed = context.are_equal<bool>(by_salary->empty(), true, 0x10dfe, "%d") && passed;
+    }
+
+    return passed;
+}
+
+
 bool test_vmem_string_iterator(test_context& context) {
     bool passed = true;
 